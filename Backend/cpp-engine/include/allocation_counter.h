@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Process-wide count of global operator new calls. The counting operators
+ * live in src/allocation_hooks.cpp, which only the shipped binary (and the
+ * benchmark suite) link; everywhere else isInstalled() is false and the
+ * counts stay at zero. Counting also stays off until enable() is called
+ * (by `--bench`), so ordinary runs pay one relaxed load per allocation.
+ */
+namespace AllocationCounter {
+
+bool isInstalled();
+void enable();
+uint64_t allocations();
+uint64_t allocatedBytes();
+
+// Called by the counting operators only; recordAllocation ignores calls until enable()
+void markInstalled();
+void recordAllocation(std::size_t bytes);
+
+}  // namespace AllocationCounter
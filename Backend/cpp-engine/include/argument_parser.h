@@ -4,6 +4,8 @@
 #include <string>
 #include <vector>
 
+#include <nlohmann/json_fwd.hpp>
+
 // Forward declare TradingConfig - will be included via the implementation file
 struct TradingConfig;
 
@@ -12,9 +14,14 @@ public:
     ArgumentParser();
     
     TradingConfig parseArguments(int argc, char* argv[]);
+    // Same keys as the --simulate --config file; shared with the Python binding
+    TradingConfig parseConfigJson(const nlohmann::json& config);
+    // Inverse of parseConfigJson: parseConfigJson(configToJson(c)) reproduces c
+    nlohmann::json configToJson(const TradingConfig& config);
     
 private:
     void parseSymbols(const std::string& symbol_list, std::vector<std::string>& symbols);
+    void parseIntegerList(const std::string& list, std::vector<int>& values);
     void parseKeyValueFormat(const std::string& arg, TradingConfig& config);
     void parseKeyValuePairFormat(const std::string& key, const std::string& value, TradingConfig& config);
     void setDefaults(TradingConfig& config);
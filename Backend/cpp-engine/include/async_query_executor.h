@@ -0,0 +1,93 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <deque>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <libpq-fe.h>
+
+#include "query_cursor.h"
+#include "result.h"
+
+/**
+ * Runs queries on a small pool of non-blocking libpq connections driven by
+ * one poll() event loop thread. submit() returns immediately with a future,
+ * so callers can issue several queries, keep computing, and consume each
+ * result (as a QueryCursor over the completed result) as it arrives.
+ * Connections are opened asynchronously on demand, up to the pool size; one
+ * query runs per connection at a time and the rest wait in FIFO order.
+ */
+class AsyncQueryExecutor {
+public:
+    static constexpr size_t DEFAULT_CONNECTIONS = 4;
+
+    explicit AsyncQueryExecutor(std::string connection_string, size_t max_connections = DEFAULT_CONNECTIONS);
+    ~AsyncQueryExecutor();
+
+    // Non-copyable, non-movable: the loop thread refers to this object
+    AsyncQueryExecutor(const AsyncQueryExecutor&) = delete;
+    AsyncQueryExecutor& operator=(const AsyncQueryExecutor&) = delete;
+
+    std::future<Result<QueryCursor>> submit(std::string query, std::vector<std::string> params = {},
+                                            QueryResultFormat format = QueryResultFormat::BINARY);
+
+    // Cancel in-flight queries, fail queued ones and stop the loop; idempotent
+    void shutdown();
+
+    size_t getMaxConnections() const { return max_connections_; }
+    size_t getCompletedCount() const { return completed_.load(std::memory_order_relaxed); }
+
+private:
+    struct Request {
+        std::string query;
+        std::vector<std::string> params;
+        QueryResultFormat format;
+        std::promise<Result<QueryCursor>> promise;
+    };
+
+    enum class SlotState {
+        DISCONNECTED,
+        CONNECTING,
+        IDLE,
+        BUSY,
+        FAILED      // Connect failed; retried once the queue has drained
+    };
+
+    struct Slot {
+        PGconn* connection = nullptr;
+        SlotState state = SlotState::DISCONNECTED;
+        PostgresPollingStatusType connect_poll = PGRES_POLLING_WRITING;
+        bool flush_pending = false;
+        std::unique_ptr<Request> request;
+        PGresult* result = nullptr;
+        std::string error;
+    };
+
+    std::string connection_string_;
+    size_t max_connections_;
+
+    std::mutex mutex_;
+    std::deque<std::unique_ptr<Request>> pending_;
+    bool stopping_ = false;
+
+    int wake_pipe_[2] = {-1, -1};
+    std::atomic<size_t> completed_{0};
+    std::thread loop_;
+
+    void run();
+    void wake();
+    void startConnecting(Slot& slot);
+    void advanceConnect(Slot& slot);
+    // True when the request went back to the queue because the connection had dropped
+    bool dispatch(Slot& slot, std::unique_ptr<Request> request);
+    void readResults(Slot& slot);
+    void complete(Slot& slot, Result<QueryCursor> result);
+    void resetConnection(Slot& slot, SlotState state);
+    void failPending(ErrorCode code, const std::string& message);
+};
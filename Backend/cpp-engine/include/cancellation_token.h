@@ -0,0 +1,57 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+// Why a run was asked to stop early
+enum class CancellationReason : int {
+    NONE = 0,
+    REQUESTED,          // cancel() called in-process
+    SIGNAL_TERMINATE,   // SIGTERM
+    SIGNAL_USER,        // SIGUSR1
+    DEADLINE            // --deadline-ms budget exhausted
+};
+
+/**
+ * Cooperative cancellation flag with an optional wall-clock budget.
+ * Long-running loops poll isCancelled() at natural boundaries (one simulated
+ * day, one loaded symbol) and stop cleanly, keeping whatever they produced.
+ * Signal handlers only store to a lock-free atomic; tokens pick the pending
+ * signal up on their next poll.
+ */
+class CancellationToken {
+public:
+    CancellationToken() = default;
+
+    // Non-copyable, non-movable: loops hold a pointer to the token they poll
+    CancellationToken(const CancellationToken&) = delete;
+    CancellationToken& operator=(const CancellationToken&) = delete;
+
+    // Start a budget measured from now (<= 0 clears it)
+    void setDeadline(std::chrono::milliseconds budget);
+    bool hasDeadline() const { return deadline_ns_.load(std::memory_order_relaxed) != 0; }
+
+    void cancel(CancellationReason reason = CancellationReason::REQUESTED);
+    bool isCancelled();
+    CancellationReason getReason() const { return static_cast<CancellationReason>(reason_.load(std::memory_order_acquire)); }
+    std::string getReasonString() const;
+
+    // Clear the reason and deadline (pending process signals are kept)
+    void reset();
+
+    // Route SIGTERM/SIGUSR1 into the pending-signal flag; a second SIGTERM terminates immediately
+    static void installSignalHandlers();
+    static void restoreSignalHandlers();
+    static void clearPendingSignal();
+
+    static std::string reasonToString(CancellationReason reason);
+
+private:
+    std::atomic<int> reason_{static_cast<int>(CancellationReason::NONE)};
+    std::atomic<int64_t> deadline_ns_{0};  // steady_clock nanoseconds since epoch, 0 = none
+
+    static std::atomic<int> pending_signal_reason_;
+    static void handleSignal(int signal_number);
+};
@@ -1,10 +1,12 @@
 #pragma once
 
+#include <memory>
 #include <string>
 
 #include "argument_parser.h"
 
 // Forward declarations
+class SimulationBundle;
 class TradingEngine;
 
 class CommandDispatcher {
@@ -20,6 +22,9 @@ private:
     int executeSimulationFromConfig(const std::string& config_file);
     int executeStatus();
     int executeMemoryReport();
+    int executeReplay(const std::string& bundle_file);
+    int executeBench(int argc, char* argv[]);
+    int executeJournalDump(const std::string& journal_file);
     int showHelp(const char* program_name);
     
     void printHeader();
@@ -27,7 +32,11 @@ private:
     
     // Common execution methods to eliminate duplication
     void setupStrategy(TradingEngine& engine, const TradingConfig& config, bool verbose = false);
-    int executeCommonSimulation(const TradingConfig& config, bool verbose = false);
+    int executeCommonSimulation(const TradingConfig& config, bool verbose = false,
+                                std::shared_ptr<SimulationBundle> replay_bundle = nullptr);
+    // Attach a capture bundle when config.capture_path is set; nullptr otherwise
+    std::shared_ptr<SimulationBundle> startCapture(TradingEngine& engine, const TradingConfig& config);
+    void finishCapture(const std::shared_ptr<SimulationBundle>& bundle, const std::string& path);
     TradingConfig loadConfigFromFile(const std::string& config_file);
     
     ArgumentParser arg_parser;
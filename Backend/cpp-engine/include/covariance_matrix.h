@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+/**
+ * Dense symmetric covariance matrix of daily returns (population estimator).
+ * Built from a row-major returns matrix (observations x assets) with a blocked
+ * rank-1 update kernel whose inner loop runs over contiguous memory, so the
+ * compiler can vectorize it without reassociating floating point sums.
+ */
+class CovarianceMatrix {
+public:
+    CovarianceMatrix() = default;
+    explicit CovarianceMatrix(size_t assets);
+
+    // Build from a row-major returns matrix: returns[t * assets + i]
+    static CovarianceMatrix fromReturns(const std::vector<double>& returns, size_t observations, size_t assets);
+
+    size_t size() const { return assets_; }
+    size_t getObservationCount() const { return observations_; }
+    void setObservationCount(size_t observations) { observations_ = observations; }
+
+    double operator()(size_t i, size_t j) const { return values_[i * assets_ + j]; }
+    double& at(size_t i, size_t j) { return values_[i * assets_ + j]; }
+    const std::vector<double>& data() const { return values_; }
+
+    // Per-asset and pairwise statistics
+    double variance(size_t i) const { return (*this)(i, i); }
+    double annualizedVolatility(size_t i) const;
+    double correlation(size_t i, size_t j) const;
+
+    // Equal-risk-contribution weights (sum to 1) via cyclical coordinate descent
+    std::vector<double> equalRiskContributionWeights(int max_iterations = 1000, double tolerance = 1e-10) const;
+
+    // Fraction of portfolio variance contributed by each asset
+    std::vector<double> riskContributions(const std::vector<double>& weights) const;
+
+private:
+    size_t assets_ = 0;
+    size_t observations_ = 0;
+    std::vector<double> values_;
+};
+
+/**
+ * Rolling-window covariance over the most recent `window` return observations.
+ * Each push is an O(n^2) rank-1 add/remove on running cross-product sums;
+ * sums are rebuilt from the stored window once per window length to bound drift.
+ */
+class RollingCovariance {
+public:
+    RollingCovariance() = default;
+    RollingCovariance(size_t assets, size_t window);
+
+    void reset(size_t assets, size_t window);
+
+    // Add one observation of returns for every asset (length == assets)
+    void push(const std::vector<double>& returns);
+
+    size_t size() const { return assets_; }
+    size_t getWindow() const { return window_; }
+    size_t getObservationCount() const { return count_; }
+    bool isReady() const { return count_ >= 2; }
+
+    CovarianceMatrix covariance() const;
+
+private:
+    size_t assets_ = 0;
+    size_t window_ = 0;
+    size_t head_ = 0;
+    size_t count_ = 0;
+    size_t updates_since_rebuild_ = 0;
+
+    std::vector<double> rows_;   // window x assets circular storage
+    std::vector<double> sums_;   // per-asset return sums
+    std::vector<double> cross_;  // assets x assets cross-product sums
+
+    void addOuterProduct(const double* row, double sign);
+    void rebuild();
+};
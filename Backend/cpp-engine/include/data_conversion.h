@@ -3,18 +3,39 @@
 #include <map>
 #include <stdexcept>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include "technical_indicators.h"
 
 namespace DataConversion {
     
+    // Column names a result set uses for each price field (e.g. "open" or "open_price")
+    struct PriceRowLayout {
+        std::string date;
+        std::string open;
+        std::string high;
+        std::string low;
+        std::string close;
+        std::string volume;
+    };
+    
     // Standard price data conversion from database format
     std::vector<PriceData> convertToTechnicalData(const std::vector<std::map<std::string, std::string>>& db_data);
     
     // Convert single database row to PriceData
     PriceData convertRowToPriceData(const std::map<std::string, std::string>& row);
     
+    // Pick the column names from a row; false when a required field is missing
+    bool resolvePriceRowLayout(const std::map<std::string, std::string>& row, PriceRowLayout& layout);
+    
+    // Convert a row with an already resolved layout; false (no exception) on missing or bad fields
+    bool convertRow(const std::map<std::string, std::string>& row, const PriceRowLayout& layout, PriceData& data);
+    
+    // Allocation-free std::from_chars parsing; the whole text must be consumed
+    bool parseDouble(std::string_view text, double& value);
+    bool parseLong(std::string_view text, long& value);
+    
     // Safe string to double conversion with error handling
     double safeStringToDouble(const std::string& str, const std::string& field_name = "");
     
@@ -4,9 +4,11 @@
 #include <string>
 #include <vector>
 
+#include "cancellation_token.h"
 #include "market_data.h"
 #include "memory_optimizable.h"
 #include "result.h"
+#include "trading_calendar.h"
 #include "trading_strategy.h"
 
 // Helper struct for date range operations
@@ -38,13 +40,15 @@ public:
     Result<std::map<std::string, std::vector<PriceData>>> loadMultiSymbolData(const std::vector<std::string>& symbols, 
                                                                               const std::string& start_date, 
                                                                               const std::string& end_date,
-                                                                              MarketData* market_data);
+                                                                              MarketData* market_data,
+                                                                              CancellationToken* cancellation = nullptr);
     
     // Rolling window management
     std::vector<PriceData> getWindow(const std::string& symbol, int windowSize);
+    // Appends each symbol's bar at `session` (a calendar session index) and updates its price
     void updateHistoricalWindows(const std::map<std::string, std::vector<PriceData>>& multi_symbol_data,
-                                const std::string& current_date,
-                                const std::map<std::string, std::map<std::string, size_t>>& symbol_date_indices,
+                                size_t session,
+                                const std::vector<std::vector<int32_t>>& session_indices,
                                 std::map<std::string, std::vector<PriceData>>& historical_windows,
                                 std::map<std::string, double>& current_prices);
     
@@ -59,7 +63,9 @@ public:
     
     // Timeline and indexing utilities
     std::vector<std::string> createUnifiedTimeline(const std::map<std::string, std::vector<PriceData>>& multi_symbol_data);
-    std::map<std::string, std::map<std::string, size_t>> createDateIndices(const std::map<std::string, std::vector<PriceData>>& multi_symbol_data);
+    // Bar index of each symbol (in multi_symbol_data order) at each calendar session, -1 without a bar
+    std::vector<std::vector<int32_t>> createSessionIndices(const std::map<std::string, std::vector<PriceData>>& multi_symbol_data,
+                                                           const TradingCalendar& calendar) const;
     
     // Memory optimization interface
     void optimizeMemory() override;
@@ -87,4 +93,9 @@ private:
                                                     const std::string& start_date,
                                                     const std::string& end_date,
                                                     MarketData* market_data) const;
+    // Map a fetched result onto the no_data / conversion_failed errors
+    Result<std::vector<PriceData>> checkSymbolData(const std::string& symbol,
+                                                  const std::string& start_date,
+                                                  const std::string& end_date,
+                                                  Result<std::vector<PriceData>> symbol_result) const;
 };
\ No newline at end of file
@@ -8,7 +8,9 @@
 #include <libpq-fe.h>
 #include <nlohmann/json.hpp>
 
+#include "query_cursor.h"
 #include "result.h"
+#include "technical_indicators.h"
 #include "trading_exceptions.h"
 
 /**
@@ -45,6 +47,9 @@ public:
     
     // Query execution
     Result<void> executeQuery(const std::string& query);
+    // Streaming typed cursor; the connection must not be used for other queries until it is exhausted
+    Result<QueryCursor> openCursor(const std::string& query, const std::vector<std::string>& params = {},
+                                   QueryResultFormat format = QueryResultFormat::BINARY);
     Result<std::vector<std::map<std::string, std::string>>> selectQuery(const std::string& query);
     
     // Prepared statement methods for secure queries
@@ -60,6 +65,13 @@ public:
         const std::string& end_date
     );
     
+    // Typed price bars decoded straight from the binary result
+    Result<std::vector<PriceData>> getStockPriceData(
+        const std::string& symbol,
+        const std::string& start_date,
+        const std::string& end_date
+    );
+    
     Result<std::vector<std::string>> getAvailableSymbols();
     
     Result<bool> checkSymbolExists(const std::string& symbol);
@@ -80,8 +92,13 @@ public:
         const std::string& end_date
     );
     
+    // Query and decoder behind getStockPriceData, shared with the async executor path
+    static const char* const PRICE_DATA_QUERY;
+    static Result<std::vector<PriceData>> readPriceData(QueryCursor& cursor);
+    
     // Utility methods
     std::string getLastError() const;
+    const std::string& getConnectionString() const { return connection_string_; }
     nlohmann::json getConnectionInfo() const;
     
     // Static methods for environment-based connection
@@ -102,6 +119,9 @@ private:
     // Helper methods
     void buildConnectionString();
     Result<PGresult*> executeQueryInternal(const std::string& query);
+    Result<std::vector<std::map<std::string, std::string>>> collectRows(QueryCursor& cursor);
+    Result<std::vector<std::string>> collectTextColumn(QueryCursor& cursor, const std::string& column_name);
+    Result<bool> fetchSingleBool(QueryCursor& cursor, const std::string& column_name);
     void handleError(const std::string& operation);
 };
 
@@ -1,7 +1,9 @@
 #pragma once
 
 #include <chrono>
+#include <cstdint>
 #include <string>
+#include <string_view>
 
 /**
  * Date and time utility functions for the trading platform.
@@ -44,4 +46,30 @@ std::chrono::system_clock::time_point stringToTimePoint(const std::string& date)
  */
 std::string timePointToString(const std::chrono::system_clock::time_point& time_point);
 
+/**
+ * Days since 1970-01-01 for a proleptic Gregorian calendar date.
+ * @param year Calendar year
+ * @param month Month 1-12
+ * @param day Day of month 1-31
+ * @return Day number (negative before 1970)
+ */
+int32_t daysFromCivil(int year, int month, int day);
+
+/**
+ * Parse a fixed-format YYYY-MM-DD date into a day number, without allocation.
+ * A time part after 'T' or ' ' (as in database timestamps) is ignored.
+ * @param date The date text
+ * @param days Receives days since 1970-01-01; untouched on failure
+ * @return true if the text starts with a valid calendar date
+ */
+bool parseIsoDate(std::string_view date, int32_t& days);
+
+/**
+ * Pack a YYYY-MM-DD date into the integer YYYYMMDD (sortable, fixed width).
+ * A time part after 'T' or ' ' is ignored, as in parseIsoDate.
+ * @param date The date string in YYYY-MM-DD format
+ * @return Packed date, or 0 if the string is not a valid date
+ */
+int32_t dateToYyyymmdd(const std::string& date);
+
 } // namespace DateTimeUtils
\ No newline at end of file
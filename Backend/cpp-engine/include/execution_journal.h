@@ -0,0 +1,116 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <nlohmann/json_fwd.hpp>
+
+#include "order.h"
+#include "result.h"
+#include "technical_indicators.h"
+
+// Why an order event happened; stored as a 16-bit code
+enum class JournalReason : uint16_t {
+    NONE = 0,
+    STRATEGY_SIGNAL = 1,       // Market order from a strategy signal
+    RESTING_ORDER = 2,         // Limit or stop order crossed by a bar
+    REBALANCE = 3,
+    DELISTING = 4,             // Forced exit or cancellation when a symbol stops trading
+    EXECUTION_FAILED = 5,      // The portfolio refused the fill (cash or holdings)
+    PARTICIPATION_CAP = 6,     // The ADV cap left nothing (or less) to fill
+    INVALID_ORDER = 7,
+    INSUFFICIENT_POSITION = 8  // A resting sell outgrew the shares held when it filled
+};
+
+/**
+ * Fixed header at offset 0 of a journal file (little-endian, 64 bytes).
+ * Offsets: magic 0, version 4, record_size 8, symbol_count 12,
+ * symbol_table_offset 16, records_offset 24, capacity 32, record_count 40.
+ * record_count is published with a release store after each record is
+ * written, so a reader that loads it with acquire sees complete records.
+ */
+struct JournalHeader {
+    static constexpr uint32_t MAGIC = 0x4C4A4554;  // "TEJL"
+    static constexpr uint32_t VERSION = 1;
+
+    uint32_t magic;
+    uint32_t version;
+    uint32_t record_size;
+    uint32_t symbol_count;
+    uint64_t symbol_table_offset;
+    uint64_t records_offset;
+    uint64_t capacity;
+    std::atomic<uint64_t> record_count;
+    uint64_t padding[2];
+};
+
+/**
+ * One order event (48 bytes). Offsets: sequence 0, order_id 8, day 16
+ * (days since 1970-01-01), symbol_id 20 (index into the symbol table),
+ * quantity 24, side 28 (1 buy, 2 sell), order_kind 29 (OrderKind),
+ * status 30 (OrderStatus), price 32, reason 40 (JournalReason).
+ */
+struct JournalRecord {
+    uint64_t sequence;
+    uint64_t order_id;
+    int32_t day;
+    uint32_t symbol_id;
+    int32_t quantity;
+    uint8_t side;
+    uint8_t order_kind;
+    uint8_t status;
+    uint8_t reserved0;
+    double price;
+    uint16_t reason;
+    uint16_t reserved[3];
+};
+
+static_assert(sizeof(JournalHeader) == 64, "Journal header must stay 64 bytes");
+static_assert(sizeof(JournalRecord) == 48, "Journal record must stay 48 bytes");
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "Journal requires lock-free 64-bit atomics");
+
+/**
+ * Append-only, memory-mapped audit log of order lifecycle events: placed
+ * (PENDING), FILLED, REJECTED and CANCELLED, with ids, symbol id, day, side,
+ * quantity, price and a reason code. Appending copies one fixed-size record
+ * into the mapping; when the mapping is full the file is doubled in place
+ * with ftruncate/mremap, so the execution path never touches the heap.
+ * Symbols are written once, as a table of NUL-padded names, when the journal
+ * is opened. Any process can map the file read-only while it grows.
+ */
+class ExecutionJournal {
+public:
+    static constexpr size_t SYMBOL_SIZE = 32;   // Bytes per symbol table entry, NUL padded
+
+    ExecutionJournal() = default;
+    ~ExecutionJournal();
+
+    // Non-copyable, non-movable: records point into the mapping
+    ExecutionJournal(const ExecutionJournal&) = delete;
+    ExecutionJournal& operator=(const ExecutionJournal&) = delete;
+
+    // Create (or truncate) the journal; symbol ids are positions in `symbols`
+    Result<void> open(const std::string& path, const std::vector<std::string>& symbols,
+                      uint64_t initial_capacity = 4096);
+    void close();
+    bool isOpen() const { return header_ != nullptr; }
+
+    // No-op returning false when the journal is not open or cannot grow
+    bool append(uint64_t order_id, uint32_t symbol_id, int32_t day, Signal side, OrderKind kind,
+                OrderStatus status, int quantity, double price, JournalReason reason);
+    uint64_t getRecordCount() const;
+
+    // Map a journal read-only and render its symbols and events as JSON
+    static Result<nlohmann::json> readJson(const std::string& path);
+
+private:
+    bool grow();
+
+    int fd_ = -1;
+    uint8_t* base_ = nullptr;
+    size_t mapped_size_ = 0;
+    JournalHeader* header_ = nullptr;
+};
@@ -6,6 +6,7 @@
 #include "memory_optimizable.h"
 #include "portfolio.h"
 #include "result.h"
+#include "trade_ledger.h"
 #include "trading_exceptions.h"
 #include "trading_strategy.h"
 
@@ -36,6 +37,10 @@ public:
     int getSuccessfulExecutions() const;
     int getFailedExecutions() const;
     
+    // FIFO lot ledger of all fills routed through this service
+    TradeLedger& getTradeLedger();
+    const TradeLedger& getTradeLedger() const;
+    
     // Memory optimization interface
     void optimizeMemory() override;
     size_t getMemoryUsage() const override;
@@ -44,6 +49,7 @@ public:
 private:
     std::vector<TradingSignal> executed_signals_;
     int failed_executions_counter_ = 0;
+    TradeLedger trade_ledger_;
     
     // Internal execution logic
     Result<void> executeBuySignal(const TradingSignal& signal, 
@@ -8,6 +8,7 @@
 struct BacktestResult;
 struct TradingSignal;
 struct PriceData;
+struct RoundTrip;
 
 namespace JsonHelpers {
     
@@ -20,11 +21,17 @@ namespace JsonHelpers {
     // Convert vector of TradingSignals to JSON array
     nlohmann::json tradingSignalsToJsonArray(const std::vector<TradingSignal>& signals);
     
+    // Convert closed round trips to JSON array
+    nlohmann::json roundTripsToJsonArray(const std::vector<RoundTrip>& round_trips);
+    
     // Create equity curve JSON with dates
     nlohmann::json createEquityCurveJson(const std::vector<double>& equity_curve,
                                         const std::vector<PriceData>& price_data,
                                         const std::string& start_date);
     
+    // Create columnar rolling risk metrics JSON object (NaN warm-up values become null)
+    nlohmann::json createRollingMetricsJson(const BacktestResult& result);
+    
     // Create performance metrics JSON object
     nlohmann::json createPerformanceMetricsJson(const BacktestResult& result);
     
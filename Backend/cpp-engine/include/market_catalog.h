@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "database_connection.h"
+#include "result.h"
+
+// Per-symbol metadata: price aggregates plus the row from the stocks table
+struct SymbolCatalogEntry {
+    std::string symbol;
+
+    // Aggregates over stock_prices_daily (dates as YYYY-MM-DD)
+    std::string first_date;
+    std::string last_date;
+    int64_t row_count = 0;
+
+    // Columns of the stocks table as text, empty when the symbol is not listed there
+    bool listed = false;
+    std::map<std::string, std::string> temporal_info;
+
+    bool hasPrices() const { return row_count > 0; }
+};
+
+/**
+ * In-memory catalog of the market data: which symbols have prices, over
+ * which dates and how many bars, plus their listing metadata. It is built
+ * by two queries (one grouped aggregate over the whole price table, one scan
+ * of `stocks`), so MarketData loads it only for universe-wide questions such
+ * as getAvailableSymbols. Once loaded, symbol validation, date ranges and
+ * data summaries are answered without touching the database. Instances are
+ * immutable; MarketData swaps in a new one when the catalog is invalidated.
+ */
+class MarketCatalog {
+public:
+    explicit MarketCatalog(std::vector<SymbolCatalogEntry> entries, uint64_t epoch = 0);
+
+    // Query both sources and build a catalog stamped with the given epoch
+    static Result<std::shared_ptr<const MarketCatalog>> load(DatabaseConnection& db_connection, uint64_t epoch);
+
+    const SymbolCatalogEntry* find(const std::string& symbol) const;
+    bool hasPrices(const std::string& symbol) const;
+    // Sorted symbols with at least one price bar
+    const std::vector<std::string>& getSymbolsWithPrices() const { return symbols_with_prices_; }
+
+    // Bars in [start_date, end_date] when the aggregates determine the answer
+    // (range covers or misses the whole history); -1 for a partial overlap
+    int64_t countInRange(const std::string& symbol, const std::string& start_date, const std::string& end_date) const;
+
+    size_t size() const { return entries_.size(); }
+    uint64_t getEpoch() const { return epoch_; }
+    size_t getMemoryUsage() const;
+
+private:
+    std::vector<SymbolCatalogEntry> entries_;  // Sorted by symbol
+    std::vector<std::string> symbols_with_prices_;
+    uint64_t epoch_;
+};
@@ -1,5 +1,8 @@
 #pragma once
 
+#include <chrono>
+#include <cstdint>
+#include <future>
 #include <map>
 #include <memory>
 #include <mutex>
@@ -8,12 +11,37 @@
 
 #include <nlohmann/json.hpp>
 
+#include "async_query_executor.h"
 #include "database_connection.h"
+#include "market_catalog.h"
 #include "memory_optimizable.h"
 #include "result.h"
+#include "simulation_bundle.h"
 #include "technical_indicators.h"
 #include "trading_exceptions.h"
 
+/**
+ * Immutable latest-close table for every symbol, loaded with one query.
+ * Symbols are sorted, so a lookup is a binary search over flat arrays.
+ * Readers hold a shared_ptr, so a refresh never invalidates a snapshot
+ * that is still in use.
+ */
+struct PriceSnapshot {
+    std::vector<std::string> symbols;
+    std::vector<double> closes;
+    std::vector<int32_t> dates;  // Days since 1970-01-01 of each close
+    std::chrono::steady_clock::time_point loaded_at;
+    uint64_t version = 0;
+    
+    // Reorder the columns into the bytewise symbol order indexOf searches in
+    void sortBySymbol();
+    // Index into the arrays, -1 if the symbol has no prices
+    int indexOf(const std::string& symbol) const;
+    bool isFresh(std::chrono::milliseconds ttl, std::chrono::steady_clock::time_point now) const {
+        return now - loaded_at < ttl;
+    }
+};
+
 /**
  * MarketData class handles historical price data access from DB.
  * Provides methods to fetch stock prices for specific date ranges and symbols.
@@ -39,13 +67,28 @@ public:
     // Configuration
     void setDatabaseConnection(std::unique_ptr<DatabaseConnection> db_conn);
     void enableCache(bool enable = true);
+    void setSnapshotTtl(std::chrono::milliseconds ttl);
     bool isConnected() const;
     
+    // Capture records every simulation input read through this object into
+    // the bundle; replay answers those reads from the bundle and never opens
+    // a database connection. Pass nullptr to stop.
+    void setCaptureBundle(std::shared_ptr<SimulationBundle> bundle);
+    void setReplayBundle(std::shared_ptr<SimulationBundle> bundle);
+    bool isReplaying() const { return replay_bundle_ != nullptr; }
+    // A database connection or a replay bundle
+    bool hasDataSource() const;
+    
     // Basic price access
     Result<double> getLatestPrice(const std::string& symbol) const;
     Result<std::map<std::string, double>> getCurrentPrices() const;
     Result<std::map<std::string, double>> getCurrentPrices(const std::vector<std::string>& symbols) const;
     
+    // Latest closes for all symbols; reloaded once older than the TTL.
+    // While one caller reloads, others keep reading the previous snapshot.
+    Result<std::shared_ptr<const PriceSnapshot>> getPriceSnapshot() const;
+    Result<std::shared_ptr<const PriceSnapshot>> refreshPriceSnapshot() const;
+    
     // Historical data access (returns database format for conversion to PriceData)
     Result<std::vector<std::map<std::string, std::string>>> getHistoricalPrices(
         const std::string& symbol,
@@ -59,6 +102,32 @@ public:
         const std::string& end_date
     ) const;
     
+    // Typed bars decoded from the binary result, without intermediate row maps
+    Result<std::vector<PriceData>> getHistoricalPriceData(
+        const std::string& symbol,
+        const std::string& start_date,
+        const std::string& end_date
+    ) const;
+    
+    // Same bars, queried in the background on the async executor; decoding
+    // happens in the thread that calls get() on the future
+    std::future<Result<std::vector<PriceData>>> requestHistoricalPriceData(
+        const std::string& symbol,
+        const std::string& start_date,
+        const std::string& end_date
+    ) const;
+    
+    // Event loop over a separate connection pool, created on first use; nullptr without a
+    // database or with a connection limit of 0
+    AsyncQueryExecutor* getAsyncExecutor() const;
+    // Upper bound on the pool's connections (default AsyncQueryExecutor::DEFAULT_CONNECTIONS, 0 = synchronous)
+    void setAsyncConnectionLimit(size_t max_connections);
+    // Create the pool for a batch of queries, with no more connections than the batch can use
+    void reserveAsyncConnections(size_t query_count) const;
+    // Shut the pool down and close its connections; the next request opens a new one
+    void closeAsyncExecutor() const;
+    bool hasAsyncExecutor() const;
+    
     // Date range utilities
     Result<std::vector<std::map<std::string, std::string>>> getPricesForDateRange(
         const std::string& symbol,
@@ -68,9 +137,24 @@ public:
     
     Result<std::map<std::string, std::string>> getPriceForDate(const std::string& symbol, const std::string& date) const;
     
-    // Symbol validation and discovery
+    // Symbol validation and discovery. Per-symbol checks use the market catalog when it is
+    // already loaded and indexed per-symbol queries otherwise; only getAvailableSymbols loads it
     Result<bool> symbolExists(const std::string& symbol) const;
     Result<std::vector<std::string>> getAvailableSymbols() const;
+    Result<std::map<std::string, std::string>> getStockTemporalInfo(const std::string& symbol) const;
+    // Listed and not delisted on the date (is_stock_tradeable in the database)
+    Result<bool> isStockTradeable(const std::string& symbol, const std::string& date) const;
+    // isStockTradeable on every bar's date, recorded into `bundle`. The answers are derived from
+    // one lookup of the symbol's listing window rather than a query per day; replay copies the
+    // captured answers
+    Result<void> recordTradeableDays(const std::string& symbol, const std::vector<PriceData>& bars,
+                                     SimulationBundle& bundle) const;
+    
+    // Catalog loaded on first use and kept until invalidated
+    Result<std::shared_ptr<const MarketCatalog>> getCatalog() const;
+    // Install a catalog built elsewhere, e.g. shared by several engines
+    void setCatalog(std::shared_ptr<const MarketCatalog> catalog);
+    void invalidateCatalog();
     
     // Data validation and statistics
     Result<int> getDataPointCount(const std::string& symbol, 
@@ -103,14 +187,41 @@ public:
     std::string getMemoryReport() const override;
 
 private:
-    std::unique_ptr<DatabaseConnection> db_connection_;
+    // Created by connection() on first use when constructed without one
+    mutable std::unique_ptr<DatabaseConnection> db_connection_;
+    mutable bool connect_from_environment_ = false;
+    mutable std::mutex connection_mutex_;
     mutable std::map<std::string, double> price_cache_;
     mutable std::mutex cache_mutex_;
     bool cache_enabled_;
     
+    static constexpr int64_t DEFAULT_SNAPSHOT_TTL_MS = 5000;
+    
+    // Swapped with std::atomic_load/atomic_store; the mutex only serializes reloads
+    mutable std::shared_ptr<const PriceSnapshot> snapshot_;
+    mutable std::mutex snapshot_refresh_mutex_;
+    mutable uint64_t snapshot_version_ = 0;
+    std::chrono::milliseconds snapshot_ttl_{DEFAULT_SNAPSHOT_TTL_MS};
+    
+    // Same publication scheme as the snapshot; the epoch counts reloads
+    mutable std::shared_ptr<const MarketCatalog> catalog_;
+    mutable std::mutex catalog_mutex_;
+    mutable uint64_t catalog_epoch_ = 0;
+    
+    mutable std::unique_ptr<AsyncQueryExecutor> async_executor_;
+    mutable std::mutex executor_mutex_;
+    size_t async_connection_limit_ = AsyncQueryExecutor::DEFAULT_CONNECTIONS;
+    
+    std::shared_ptr<SimulationBundle> capture_bundle_;
+    std::shared_ptr<SimulationBundle> replay_bundle_;
+    
     // Helper methods
+    DatabaseConnection* connection() const;
     Result<void> ensureConnection() const;
     void cachePrice(const std::string& symbol, double price) const;
     Result<double> getCachedPrice(const std::string& symbol) const;
+    Result<std::shared_ptr<const PriceSnapshot>> loadPriceSnapshot() const;
+    // The current catalog without loading one; null when none is loaded or caching is off
+    std::shared_ptr<const MarketCatalog> loadedCatalog() const;
 };
 
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "result.h"
+#include "technical_indicators.h"
+
+// A good-till-cancelled order resting in an OrderBook
+struct RestingOrder {
+    uint64_t id = 0;
+    Signal side = Signal::BUY;
+    OrderKind kind = OrderKind::LIMIT;
+    double price = 0.0;          // Limit price, or stop trigger level
+    int shares = 0;
+    std::string placed_date;
+};
+
+struct OrderFill {
+    RestingOrder order;
+    double fill_price = 0.0;
+};
+
+/**
+ * Resting limit and stop orders for one symbol. Buy limits, sell limits,
+ * buy stops and sell stops each live in their own price-time ordered map,
+ * keyed so the orders a bar reaches first are at the front. Crossing a bar
+ * pops from the front of each map until the first level the bar's high/low
+ * does not reach, so a bar costs O(log n + fills) however many orders rest.
+ *
+ * Limits fill at their price or better; stops trigger at their level and fill
+ * there or worse. Either way a bar that gaps through the level fills at the open.
+ */
+class OrderBook {
+public:
+    OrderBook() = default;
+
+    // Returns the order's id; kind must be LIMIT or STOP. A non-zero id is kept (so a caller can
+    // share one id space across books, or re-place a partial fill under its original id)
+    Result<uint64_t> place(Signal side, OrderKind kind, double price, int shares, const std::string& date,
+                           uint64_t id = 0);
+    bool cancel(uint64_t id);
+    void clear();
+
+    // Removes and returns every order the bar reaches: sells before buys, each side in
+    // price-time priority
+    std::vector<OrderFill> cross(double open, double high, double low);
+
+    bool empty() const { return index_.empty(); }
+    size_t size() const { return index_.size(); }
+    const RestingOrder* find(uint64_t id) const;
+
+    // Visits every resting order, book by book
+    template <typename Visitor>
+    void forEachOrder(Visitor&& visit) const {
+        for (const auto& book : books_) {
+            for (const auto& entry : book) {
+                visit(entry.second);
+            }
+        }
+    }
+
+    size_t getMemoryUsage() const;
+
+private:
+    // Level first (negated for the maps crossed from the highest price down), then id for time priority
+    using Key = std::pair<double, uint64_t>;
+
+    enum Book { SELL_STOP, SELL_LIMIT, BUY_STOP, BUY_LIMIT, BOOK_COUNT };
+
+    static Book bookFor(Signal side, OrderKind kind);
+    static bool crossedFromTop(Book book) { return book == SELL_STOP || book == BUY_LIMIT; }
+
+    void crossBook(Book book, double open, double high, double low, std::vector<OrderFill>& fills);
+
+    std::array<std::map<Key, RestingOrder>, BOOK_COUNT> books_;
+    std::unordered_map<uint64_t, std::pair<Book, Key>> index_;
+    uint64_t next_id_ = 1;
+};
@@ -36,6 +36,7 @@ public:
     bool hasPosition(const std::string& symbol) const;
     Position getPosition(const std::string& symbol) const;
     std::vector<std::string> getSymbols() const;
+    const std::map<std::string, Position>& getPositions() const;
     int getPositionCount() const;
     
     // Trading operations
@@ -1,12 +1,17 @@
 #pragma once
 
 #include <map>
+#include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
+#include "covariance_matrix.h"
 #include "memory_optimizable.h"
 #include "portfolio.h"
 #include "result.h"
+#include "ring_buffer.h"
+#include "trading_calendar.h"
 #include "trading_strategy.h"
 
 // Portfolio allocation strategies for multi-symbol portfolios
@@ -29,6 +34,7 @@ struct AllocationConfig {
     double rebalancing_threshold;                   // Trigger rebalancing when allocation drifts by this %
     int rebalancing_frequency_days;                 // Rebalance every N days
     double cash_reserve_pct;                        // Percentage to keep as cash (e.g., 0.05 = 5%)
+    int lookback_days;                              // Daily prices kept per symbol for risk estimates
     
     // Risk management
     double max_sector_concentration;                // Maximum allocation to single sector
@@ -38,7 +44,7 @@ struct AllocationConfig {
     AllocationConfig() : strategy(AllocationStrategy::EQUAL_WEIGHT), 
                         max_position_weight(0.3), min_position_weight(0.05),
                         enable_rebalancing(true), rebalancing_threshold(0.05),
-                        rebalancing_frequency_days(30), cash_reserve_pct(0.05),
+                        rebalancing_frequency_days(30), cash_reserve_pct(0.05), lookback_days(60),
                         max_sector_concentration(0.4), correlation_limit(0.8),
                         enable_momentum_filtering(false) {}
 };
@@ -58,15 +64,55 @@ struct AllocationResult {
                         rebalancing_needed(false) {}
 };
 
+// Single order emitted by a rebalancing pass
+struct RebalanceOrder {
+    std::string symbol;
+    Signal side;                                     // BUY or SELL
+    int shares;
+    double price;
+    
+    RebalanceOrder() : side(Signal::HOLD), shares(0), price(0.0) {}
+    RebalanceOrder(const std::string& sym, Signal s, int qty, double p) 
+        : symbol(sym), side(s), shares(qty), price(p) {}
+};
+
+// Batch of rebalancing orders; sells precede buys so their proceeds fund the buys
+struct RebalancePlan {
+    std::vector<RebalanceOrder> orders;
+    double invested_value;                           // Value of the positions being rebalanced
+    double turnover;                                 // Traded value as a fraction of invested value
+    
+    RebalancePlan() : invested_value(0.0), turnover(0.0) {}
+};
+
 class PortfolioAllocator : public IMemoryOptimizable {
 private:
     AllocationConfig config_;
-    std::map<std::string, std::vector<double>> price_history_;  // For volatility/momentum calculations
-    std::map<std::string, double> last_rebalance_weights_;      // Last rebalancing allocation
+    std::map<std::string, RingBuffer<double>> price_history_;   // Trailing daily prices (lookback_days each)
     std::string last_rebalance_date_;                           // Date of last rebalancing
-    std::map<std::string, double> current_target_weights_;      // Current target allocation weights
+    size_t days_since_rebalance_;                               // Trading days recorded since the last rebalance
+    std::shared_ptr<const TradingCalendar> calendar_;           // Run calendar; rebalance periods count its sessions
+    int32_t rebalance_anchor_day_;                              // Last rebalance, or the first session before one
     double initial_capital_;                                    // Initial capital for allocation-based position sizing
     
+    // Symbol-indexed dense state: entry i of every array refers to symbols_[i]
+    std::vector<std::string> symbols_;
+    std::unordered_map<std::string, size_t> symbol_index_;
+    std::vector<double> target_weights_;                        // Current target allocation weights
+    std::vector<double> rebalance_weights_;                     // Weights set by the last rebalance
+    bool has_rebalance_weights_;
+    std::vector<double> current_shares_;                        // Held shares at the last valuation
+    std::vector<double> current_prices_;                        // Prices at the last valuation (0 when unknown)
+    std::vector<double> current_values_;                        // Position values at the last valuation
+    
+    // Daily-return covariance kept current by recordDailyPrices; covariance_symbols_[i] is asset i.
+    // Reseeded from price_history_ whenever a day leaves the symbols out of step
+    mutable RollingCovariance rolling_covariance_;
+    mutable std::vector<std::string> covariance_symbols_;
+    mutable std::unordered_map<std::string, size_t> covariance_index_;
+    mutable bool covariance_stale_;
+    std::vector<double> covariance_row_;                        // Scratch row of daily returns
+    
 public:
     explicit PortfolioAllocator(const AllocationConfig& config = AllocationConfig());
     
@@ -109,6 +155,11 @@ public:
         const std::map<std::string, double>& current_prices,
         const std::string& current_date
     );
+    bool shouldRebalance(
+        const Portfolio& current_portfolio,
+        const std::map<std::string, double>& current_prices,
+        int32_t current_day
+    );
     
     Result<AllocationResult> calculateRebalancing(
         const Portfolio& current_portfolio,
@@ -116,6 +167,13 @@ public:
         double total_portfolio_value
     );
     
+    // Target-vs-current share deltas for every held symbol, as one batch of orders
+    Result<RebalancePlan> calculateRebalanceOrders(
+        const Portfolio& current_portfolio,
+        const std::map<std::string, double>& current_prices,
+        const std::string& current_date
+    );
+    
     // Position sizing for individual trades
     Result<double> calculatePositionSize(
         const std::string& symbol,
@@ -131,7 +189,13 @@ public:
     void updateConfig(const AllocationConfig& config);
     void updatePriceHistory(const std::string& symbol, const std::vector<double>& prices);
     void updatePriceHistory(const std::map<std::string, std::vector<double>>& all_prices);
+    void recordDailyPrices(const std::map<std::string, double>& prices);
     void setTargetAllocation(const std::map<std::string, double>& target_weights, double initial_capital);
+    // Forget price history, targets and rebalance state so a new run starts clean
+    void resetState();
+    // Count rebalance periods in the calendar's sessions from its first session on;
+    // without a calendar they count days passed to recordDailyPrices
+    void setTradingCalendar(std::shared_ptr<const TradingCalendar> calendar);
     
     // Analytics and reporting
     double calculateAllocationDrift(
@@ -144,16 +208,47 @@ public:
         const std::map<std::string, double>& current_prices
     );
     
-    AllocationConfig getConfig() const { return config_; }
+    const AllocationConfig& getConfig() const { return config_; }
+    const std::string& getLastRebalanceDate() const { return last_rebalance_date_; }
+    // First session a rebalance can happen on; TradingCalendar::NO_DAY without a calendar
+    int32_t getNextRebalanceDay() const;
     
 private:
     // Helper methods for calculations
-    double calculateVolatility(const std::vector<double>& prices) const;
-    double calculateMomentum(const std::vector<double>& prices) const;
+    double calculateVolatility(const RingBuffer<double>& prices) const;
+    double calculateMomentum(const RingBuffer<double>& prices) const;
     double calculateCorrelation(const std::vector<double>& prices1, const std::vector<double>& prices2) const;
+    
+    // Covariance of daily returns over the trailing window common to all symbols with history;
+    // symbols without history get the default volatility and zero covariance
+    CovarianceMatrix buildCovarianceMatrix(const std::vector<std::string>& symbols,
+                                           std::vector<bool>& has_history) const;
+    // Rebuild the rolling covariance from the trailing window every tracked history shares
+    void reseedRollingCovariance() const;
+    
     std::vector<std::string> applyRiskFilters(const std::vector<std::string>& symbols, const std::map<std::string, double>& current_prices) const;
     void enforceConstraints(AllocationResult& result) const;
-    bool isRebalancingDue(const std::string& current_date) const;
+    bool isRebalancingDue(int32_t current_day) const;
+    
+    // Held symbols' values redistributed by weight (dense arrays, one pass)
+    RebalancePlan buildRebalanceOrders(const std::vector<std::string>& symbols,
+                                       const std::vector<double>& shares,
+                                       const std::vector<double>& prices,
+                                       const std::vector<double>& weights) const;
+    
+    size_t historyCapacity() const;
+    
+    // Dense symbol index management; map-based inputs are adapted through these
+    static constexpr size_t NO_SYMBOL = static_cast<size_t>(-1);
+    size_t registerSymbol(const std::string& symbol);
+    size_t findSymbol(const std::string& symbol) const;
+    void assignWeights(const std::map<std::string, double>& weights, std::vector<double>& dense);
+    
+    // Refresh current_shares_/current_prices_/current_values_ from the portfolio in one pass
+    void updateCurrentValues(const Portfolio& portfolio, const std::map<std::string, double>& current_prices);
+    
+    // Clip each weight into [min_weight, max_weight] (zero stays zero); returns the number clipped
+    static size_t clipWeights(std::vector<double>& weights, double min_weight, double max_weight);
     
 public:
     // Memory optimization interface
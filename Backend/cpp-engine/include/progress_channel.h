@@ -0,0 +1,99 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "result.h"
+
+// Lifecycle state published alongside each progress record
+enum class ProgressState : uint32_t {
+    RUNNING = 0,
+    FINISHED = 1,
+    FAILED = 2,
+    TRUNCATED = 3      // Stopped early by a deadline, signal or cancellation; the result covers a prefix
+};
+
+// Consistent copy of the channel contents as seen by a reader
+struct ProgressSnapshot {
+    uint64_t sequence = 0;
+    uint64_t day_index = 0;
+    uint64_t total_days = 0;
+    double equity = 0.0;
+    int64_t trades = 0;
+    ProgressState state = ProgressState::RUNNING;
+    std::string date;
+};
+
+/**
+ * Fixed binary layout of the progress file (little-endian, 128 bytes).
+ * Offsets: magic 0, version 4, sequence 8, day_index 16, total_days 24,
+ * equity 32 (IEEE double bits), trades 40, state 48, date 56 (16 bytes,
+ * NUL padded). The sequence is odd while a write is in progress; readers
+ * retry until they observe the same even sequence before and after copying.
+ */
+struct ProgressChannelLayout {
+    static constexpr uint32_t MAGIC = 0x43504554;  // "TEPC"
+    static constexpr uint32_t VERSION = 1;
+    static constexpr size_t DATE_SIZE = 16;
+
+    uint32_t magic;
+    uint32_t version;
+    std::atomic<uint64_t> sequence;
+    std::atomic<uint64_t> day_index;
+    std::atomic<uint64_t> total_days;
+    std::atomic<uint64_t> equity_bits;
+    std::atomic<int64_t> trades;
+    std::atomic<uint32_t> state;
+    uint32_t reserved;
+    std::atomic<uint64_t> date_words[DATE_SIZE / sizeof(uint64_t)];
+    uint8_t padding[56];
+};
+
+static_assert(sizeof(ProgressChannelLayout) == 128, "Progress channel layout must stay 128 bytes");
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "Progress channel requires lock-free 64-bit atomics");
+
+/**
+ * Memory-mapped, seqlock-protected progress record shared with the API.
+ * The engine publishes with a handful of atomic stores and no allocation or
+ * formatting; any process can map the same file read-only and poll it at
+ * whatever rate it likes.
+ */
+class ProgressChannel {
+public:
+    ProgressChannel() = default;
+    ~ProgressChannel();
+
+    // Non-copyable but movable
+    ProgressChannel(const ProgressChannel&) = delete;
+    ProgressChannel& operator=(const ProgressChannel&) = delete;
+    ProgressChannel(ProgressChannel&& other) noexcept;
+    ProgressChannel& operator=(ProgressChannel&& other) noexcept;
+
+    // Create (or truncate) the file and map it for publishing
+    Result<void> openForWriting(const std::string& path);
+    // Map an existing channel file read-only
+    Result<void> openForReading(const std::string& path);
+    void close();
+
+    bool isOpen() const { return layout_ != nullptr; }
+    const std::string& getPath() const { return path_; }
+
+    // Writer side: a single writer is assumed
+    void publish(uint64_t day_index, uint64_t total_days, const std::string& date,
+                 double equity, int64_t trades, ProgressState state = ProgressState::RUNNING);
+    void setState(ProgressState state);
+
+    // Reader side: retries until a consistent record is copied
+    Result<ProgressSnapshot> read() const;
+
+private:
+    ProgressChannelLayout* layout_ = nullptr;
+    bool writable_ = false;
+    std::string path_;
+
+    Result<void> mapFile(const std::string& path, bool writable);
+    void beginWrite();
+    void endWrite();
+};
@@ -4,6 +4,7 @@
 #include <string>
 
 #include "portfolio.h"
+#include "progress_channel.h"
 #include "result.h"
 #include "technical_indicators.h"
 #include "trading_exceptions.h"
@@ -24,6 +25,15 @@ public:
     void setProgressReporting(bool enabled);
     Result<void> setProgressInterval(int interval);
     
+    // Optional shared-memory channel; while open it replaces the JSON lines on stderr
+    Result<void> openProgressChannel(const std::string& path);
+    void closeProgressChannel();
+    bool hasProgressChannel() const { return progress_channel_.isOpen(); }
+    
+    // Publish the latest simulation state to the channel (no-op when closed)
+    void publishProgress(size_t current_step, size_t total_steps, const std::string& date,
+                         double portfolio_value, int total_trades);
+    
     // Progress reporting methods
     Result<void> reportProgress(size_t current_step, 
                                 size_t total_steps, 
@@ -42,11 +52,14 @@ public:
                                      int total_trades);
     
     void reportError(const std::string& error_message);
+    // Final channel state of a run that returned a result: FINISHED, or TRUNCATED when it was cut short
+    void reportCompletion(bool truncated);
 
 private:
     std::function<void(const std::string&)> progress_callback_;
     bool enable_progress_reporting_;
     int progress_interval_;
+    ProgressChannel progress_channel_;
     
     // Internal progress calculation
     double calculateProgressPercentage(size_t current, size_t total) const;
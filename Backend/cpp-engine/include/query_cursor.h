@@ -0,0 +1,123 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <libpq-fe.h>
+
+#include "result.h"
+
+// How a column is going to be read; checked against the column type once
+enum class QueryValueKind {
+    BOOL,
+    INT64,      // int2/int4/int8
+    DOUBLE,     // float4/float8 and integers
+    DATE,       // date, timestamp, timestamptz
+    TEXT        // text/varchar/char/name, or any column of a text-format cursor
+};
+
+enum class QueryResultFormat {
+    TEXT = 0,
+    BINARY = 1
+};
+
+// Column handle resolved once per query, then used for every row
+struct QueryColumn {
+    int index = -1;
+    Oid type = 0;
+};
+
+/**
+ * Decoders for PostgreSQL binary wire values (network byte order).
+ * Dates are returned as days since 1970-01-01; timestamps as microseconds
+ * since 1970-01-01 UTC.
+ */
+namespace PgBinary {
+    constexpr Oid BOOL_OID = 16;
+    constexpr Oid NAME_OID = 19;
+    constexpr Oid INT8_OID = 20;
+    constexpr Oid INT2_OID = 21;
+    constexpr Oid INT4_OID = 23;
+    constexpr Oid TEXT_OID = 25;
+    constexpr Oid FLOAT4_OID = 700;
+    constexpr Oid FLOAT8_OID = 701;
+    constexpr Oid BPCHAR_OID = 1042;
+    constexpr Oid VARCHAR_OID = 1043;
+    constexpr Oid DATE_OID = 1082;
+    constexpr Oid TIMESTAMP_OID = 1114;
+    constexpr Oid TIMESTAMPTZ_OID = 1184;
+
+    bool isCompatible(Oid type, QueryValueKind kind);
+
+    int64_t decodeInt64(Oid type, const char* value);
+    double decodeDouble(Oid type, const char* value);
+    int32_t decodeDate(Oid type, const char* value);
+    int64_t decodeTimestamp(Oid type, const char* value);
+
+    // YYYY-MM-DD for days since 1970-01-01
+    std::string formatDate(int32_t days_since_epoch);
+    // YYYY-MM-DDTHH:MM:SS+00:00 for microseconds since 1970-01-01 UTC
+    std::string formatTimestamp(int64_t micros_since_epoch);
+}
+
+/**
+ * Forward-only cursor over a query result. Rows are streamed from the
+ * server (chunked rows mode where libpq provides it, single-row mode
+ * otherwise), so memory stays bounded by one chunk no matter how large the
+ * scan is. Column handles are resolved once with column(), and values are
+ * decoded straight from the binary wire format, without any per-row maps.
+ */
+class QueryCursor {
+public:
+    explicit QueryCursor(PGconn* connection);
+    ~QueryCursor();
+    
+    // Cursor over an already completed result (takes ownership of it)
+    static QueryCursor fromResult(PGresult* result, QueryResultFormat format);
+
+    // Non-copyable but movable
+    QueryCursor(const QueryCursor&) = delete;
+    QueryCursor& operator=(const QueryCursor&) = delete;
+    QueryCursor(QueryCursor&& other) noexcept;
+    QueryCursor& operator=(QueryCursor&& other) noexcept;
+
+    // Send the query with text parameters; rows arrive in the requested format
+    Result<void> start(const std::string& query, const std::vector<std::string>& params,
+                       QueryResultFormat format = QueryResultFormat::BINARY);
+    // Advance to the next row; false once the result is exhausted
+    Result<bool> next();
+    // Stop early: cancel the rest of the scan and drain the connection
+    void cancel();
+
+    // Valid after the first next() call (including one that returned false)
+    Result<QueryColumn> column(const std::string& name, QueryValueKind kind) const;
+    int columnCount() const;
+    std::string columnName(int index) const;
+
+    // Current row accessors; the column kind was checked by column()
+    bool isNull(const QueryColumn& column) const;
+    bool getBool(const QueryColumn& column) const;
+    int64_t getInt64(const QueryColumn& column) const;
+    double getDouble(const QueryColumn& column) const;
+    int32_t getDate(const QueryColumn& column) const;
+    int64_t getTimestamp(const QueryColumn& column) const;
+    std::string_view getText(const QueryColumn& column) const;
+
+    size_t getRowsRead() const { return rows_read_; }
+
+private:
+    PGconn* connection_;
+    PGresult* current_ = nullptr;
+    int row_ = -1;
+    bool started_ = false;
+    bool finished_ = false;
+    QueryResultFormat format_ = QueryResultFormat::BINARY;
+    size_t rows_read_ = 0;
+
+    const char* value(const QueryColumn& column) const { return PQgetvalue(current_, row_, column.index); }
+    void clearCurrent();
+    void drain();
+};
@@ -69,6 +69,7 @@ enum class ErrorCode {
     ENGINE_MULTI_SYMBOL_FAILED,
     ENGINE_PORTFOLIO_ACCESS_FAILED,
     ENGINE_RESULTS_GENERATION_FAILED,
+    ENGINE_CANCELLED,
     
     // System/General errors
     SYSTEM_MEMORY_ALLOCATION_FAILED,
@@ -1,9 +1,15 @@
 #pragma once
 
 #include <map>
+#include <memory>
+#include <string>
 #include <vector>
 
 #include "portfolio.h"
+#include "rolling_metrics.h"
+#include "streaming_metrics.h"
+#include "trade_ledger.h"
+#include "trading_calendar.h"
 #include "trading_strategy.h"
 
 // Structs for organized metrics
@@ -67,15 +73,47 @@ public:
     PerformanceMetrics calculateMetrics(const std::vector<TradingSignal>& trades, double initialCapital) const;
     RiskMetrics calculateRiskMetrics(const std::vector<double>& returns) const;
     
+    // Streaming accumulation, updated once per simulated day
+    void configureRollingMetrics(const std::vector<int>& windows, bool underwater_curve);
+    void beginStreaming(double starting_capital);
+    void recordEquity(double portfolio_value);
+    // Also records the session the value closed on, so the annualized return spans calendar sessions
+    void recordEquity(double portfolio_value, int32_t day);
+    void setTradingCalendar(std::shared_ptr<const TradingCalendar> calendar);
+    const StreamingMetrics& getStreamingMetrics() const;
+    const RollingMetrics& getRollingMetrics() const;
+    
     // Complete result finalization
-    void finalizeResults(BacktestResult& result, const Portfolio& portfolio);
+    // Trade statistics come from the ledger when given, otherwise from result.round_trips
+    void finalizeResults(BacktestResult& result, const Portfolio& portfolio, const TradeLedger* trade_ledger = nullptr);
     
 private:
+    // Accumulators fed by the simulation loop
+    StreamingMetrics streaming_metrics_;
+    RollingMetrics rolling_metrics_;
+    std::shared_ptr<const TradingCalendar> calendar_;
+    int32_t first_day_ = TradingCalendar::NO_DAY;   // First and last sessions passed to recordEquity
+    int32_t last_day_ = TradingCalendar::NO_DAY;
+    
+    // Returns the loop accumulator when it matches the result, otherwise replays the equity curve
+    const StreamingMetrics& selectMetrics(const BacktestResult& result, StreamingMetrics& replayed) const;
+    
+    // Metric calculations driven by the accumulator
+    void calculatePortfolioMetrics(BacktestResult& result, const Portfolio& portfolio, const StreamingMetrics& metrics) const;
+    void calculateComprehensiveMetrics(BacktestResult& result, const StreamingMetrics& metrics,
+                                       const TradeStatistics& statistics) const;
+    
+    // Trade metric calculations driven by closed round trip statistics
+    void calculateTradeMetrics(BacktestResult& result, const TradeStatistics& statistics) const;
+    void calculatePerSymbolMetrics(BacktestResult& result, const Portfolio& portfolio,
+                                   const std::map<std::string, TradeStatistics>& symbol_statistics) const;
+    void calculateRollingMetrics(BacktestResult& result, const StreamingMetrics& metrics);
+    
     // Helper methods for specific calculations
-    void calculateAnnualizedReturn(BacktestResult& result) const;
-    void calculateVolatility(BacktestResult& result) const;
-    void calculateProfitFactor(BacktestResult& result) const;
-    void calculateWinLossMetrics(BacktestResult& result) const;
+    void calculateAnnualizedReturn(BacktestResult& result, const StreamingMetrics& metrics) const;
+    void calculateVolatility(BacktestResult& result, const StreamingMetrics& metrics) const;
+    void calculateProfitFactor(BacktestResult& result, const TradeStatistics& statistics) const;
+    void calculateWinLossMetrics(BacktestResult& result, const TradeStatistics& statistics) const;
     void calculateDiversificationRatio(BacktestResult& result) const;
     
     // Trade analysis helpers
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <nlohmann/json_fwd.hpp>
+
+#include "result.h"
+
+struct BacktestResult;
+
+// Element type of a result column
+enum class ResultColumnType : uint32_t {
+    FLOAT64 = 1,
+    INT32 = 2,
+    INT64 = 3
+};
+
+/**
+ * Fixed header at offset 0 of a result file (little-endian, 64 bytes).
+ * Offsets: magic 0, version 4, file_size 8, metadata_offset 16,
+ * metadata_size 24, directory_offset 32, column_count 40.
+ */
+struct ResultFileHeader {
+    static constexpr uint32_t MAGIC = 0x46524554;  // "TERF"
+    static constexpr uint32_t VERSION = 1;
+
+    uint32_t magic;
+    uint32_t version;
+    uint64_t file_size;
+    uint64_t metadata_offset;
+    uint64_t metadata_size;
+    uint64_t directory_offset;
+    uint32_t column_count;
+    uint32_t reserved;
+    uint64_t padding[2];
+};
+
+/**
+ * Column directory entry (64 bytes). Data starts at `offset` (64-byte
+ * aligned) and holds `length` elements of `element_size` bytes.
+ */
+struct ResultColumnEntry {
+    static constexpr size_t NAME_SIZE = 40;
+
+    char name[NAME_SIZE];  // NUL padded
+    uint32_t type;         // ResultColumnType
+    uint32_t element_size;
+    uint64_t offset;
+    uint64_t length;
+};
+
+static_assert(sizeof(ResultFileHeader) == 64, "Result file header must stay 64 bytes");
+static_assert(sizeof(ResultColumnEntry) == 64, "Result column entry must stay 64 bytes");
+
+// Column to be written: points at caller-owned data
+struct ResultColumn {
+    std::string name;
+    ResultColumnType type;
+    const void* data;
+    uint64_t length;
+};
+
+/**
+ * Self-describing binary result file for handing large results to the API
+ * without piping JSON through stdout. The file holds the header, a column
+ * directory, 64-byte aligned columnar arrays and a JSON metadata blob;
+ * readers map it and use the columns in place (numpy.frombuffer with the
+ * directory offsets, or ResultFile::column here).
+ */
+class ResultFile {
+public:
+    ResultFile() = default;
+    ~ResultFile();
+
+    // Non-copyable, non-movable: column pointers point into the mapping
+    ResultFile(const ResultFile&) = delete;
+    ResultFile& operator=(const ResultFile&) = delete;
+
+    // Write through a temporary mapping and rename into place; returns the file size
+    static Result<uint64_t> write(const std::string& path, const std::string& metadata,
+                                  const std::vector<ResultColumn>& columns);
+    // Lay out a backtest: equity, round trip and signal columns plus the remaining JSON as metadata
+    static Result<uint64_t> writeBacktest(const std::string& path, const BacktestResult& result,
+                                          const nlohmann::json& result_json);
+
+    // Map an existing result file read-only and validate its directory
+    Result<void> open(const std::string& path);
+    void close();
+    bool isOpen() const { return data_ != nullptr; }
+
+    const ResultFileHeader& header() const { return *reinterpret_cast<const ResultFileHeader*>(data_); }
+    std::string metadata() const;
+    const ResultColumnEntry* findColumn(const std::string& name) const;
+
+    // Typed view of a column; nullptr if missing or of another type
+    template<typename T>
+    const T* column(const std::string& name, size_t& length) const {
+        const ResultColumnEntry* entry = findColumn(name);
+        if (!entry || entry->element_size != sizeof(T) || entry->type != static_cast<uint32_t>(typeOf<T>())) {
+            length = 0;
+            return nullptr;
+        }
+        length = entry->length;
+        return reinterpret_cast<const T*>(data_ + entry->offset);
+    }
+
+private:
+    const uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+
+    template<typename T>
+    static constexpr ResultColumnType typeOf();
+};
+
+template<> constexpr ResultColumnType ResultFile::typeOf<double>() { return ResultColumnType::FLOAT64; }
+template<> constexpr ResultColumnType ResultFile::typeOf<int32_t>() { return ResultColumnType::INT32; }
+template<> constexpr ResultColumnType ResultFile::typeOf<int64_t>() { return ResultColumnType::INT64; }
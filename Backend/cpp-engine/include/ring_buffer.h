@@ -0,0 +1,107 @@
+#pragma once
+
+#include <cstddef>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+/**
+ * Contiguous circular buffer with O(1) push/pop at both logical ends.
+ * Element 0 is the oldest entry. push_back grows the storage when full,
+ * while push_overwrite keeps a fixed capacity and evicts the oldest entry,
+ * which makes it suitable for fixed-length sliding windows.
+ */
+template <typename T>
+class RingBuffer {
+public:
+    RingBuffer() = default;
+    explicit RingBuffer(size_t capacity) : storage_(capacity) {}
+
+    size_t size() const { return size_; }
+    size_t capacity() const { return storage_.size(); }
+    bool empty() const { return size_ == 0; }
+    bool full() const { return size_ == storage_.size(); }
+
+    T& operator[](size_t index) { return storage_[physicalIndex(index)]; }
+    const T& operator[](size_t index) const { return storage_[physicalIndex(index)]; }
+
+    T& front() { checkNotEmpty(); return storage_[head_]; }
+    const T& front() const { checkNotEmpty(); return storage_[head_]; }
+    T& back() { checkNotEmpty(); return storage_[physicalIndex(size_ - 1)]; }
+    const T& back() const { checkNotEmpty(); return storage_[physicalIndex(size_ - 1)]; }
+
+    // Append, growing the storage when full
+    void push_back(T value) {
+        if (full()) {
+            grow();
+        }
+        storage_[physicalIndex(size_)] = std::move(value);
+        ++size_;
+    }
+
+    // Append into a fixed-capacity window, evicting the oldest element when full
+    void push_overwrite(T value) {
+        if (storage_.empty()) {
+            return;
+        }
+        if (full()) {
+            storage_[head_] = std::move(value);
+            head_ = (head_ + 1) % storage_.size();
+            return;
+        }
+        storage_[physicalIndex(size_)] = std::move(value);
+        ++size_;
+    }
+
+    void pop_front() {
+        checkNotEmpty();
+        storage_[head_] = T();
+        head_ = (head_ + 1) % storage_.size();
+        --size_;
+    }
+
+    void pop_back() {
+        checkNotEmpty();
+        storage_[physicalIndex(size_ - 1)] = T();
+        --size_;
+    }
+
+    void clear() {
+        for (size_t i = 0; i < size_; ++i) {
+            storage_[physicalIndex(i)] = T();
+        }
+        head_ = 0;
+        size_ = 0;
+    }
+
+    // Discard all elements and set a new capacity
+    void reset(size_t capacity) {
+        storage_.assign(capacity, T());
+        head_ = 0;
+        size_ = 0;
+    }
+
+private:
+    std::vector<T> storage_;
+    size_t head_ = 0;
+    size_t size_ = 0;
+
+    size_t physicalIndex(size_t index) const {
+        return (head_ + index) % storage_.size();
+    }
+
+    void checkNotEmpty() const {
+        if (size_ == 0) {
+            throw std::out_of_range("RingBuffer is empty");
+        }
+    }
+
+    void grow() {
+        std::vector<T> grown(storage_.empty() ? 8 : storage_.size() * 2);
+        for (size_t i = 0; i < size_; ++i) {
+            grown[i] = std::move(storage_[physicalIndex(i)]);
+        }
+        storage_ = std::move(grown);
+        head_ = 0;
+    }
+};
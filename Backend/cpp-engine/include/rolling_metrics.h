@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstddef>
+#include <deque>
+#include <utility>
+#include <vector>
+
+#include "ring_buffer.h"
+#include "trading_strategy.h"
+
+/**
+ * RollingMetrics produces rolling-window risk series in a single O(n) pass.
+ * Each window keeps running sums of daily returns and squared returns over a
+ * fixed-size ring buffer, and a monotonic deque of equity values for the
+ * trailing window high. The underwater curve uses the running all-time peak.
+ * Nothing is tracked until windows or the underwater curve are requested.
+ */
+class RollingMetrics {
+public:
+    RollingMetrics() = default;
+
+    // Select which series to produce; clears any previous state
+    void configure(const std::vector<int>& windows, bool track_underwater);
+    bool isEnabled() const { return !windows_.empty() || track_underwater_; }
+
+    // Start a new series with the first equity observation
+    void reset(double initial_value);
+
+    // Record the next equity observation, appending one point to every series
+    void update(double equity_value);
+
+    const std::vector<RollingMetricSeries>& getSeries() const { return series_; }
+    const std::vector<double>& getUnderwaterCurve() const { return underwater_; }
+    size_t getObservationCount() const { return observation_count_; }
+
+    // Hand the accumulated series over to a result
+    void moveInto(BacktestResult& result);
+
+private:
+    struct WindowState {
+        size_t window = 0;
+        RingBuffer<double> returns;
+        double sum = 0.0;
+        double sum_sq = 0.0;
+        size_t updates_since_resum = 0;
+        std::deque<std::pair<size_t, double>> max_deque;  // (observation index, equity), decreasing values
+    };
+
+    std::vector<int> windows_;
+    bool track_underwater_ = false;
+
+    std::vector<WindowState> states_;
+    std::vector<RollingMetricSeries> series_;
+    std::vector<double> underwater_;
+
+    size_t observation_count_ = 0;
+    double last_value_ = 0.0;
+    double peak_value_ = 0.0;
+
+    void appendPoint(double equity_value, bool has_return, double daily_return);
+    static void resum(WindowState& state);
+};
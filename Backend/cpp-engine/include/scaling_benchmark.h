@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <nlohmann/json_fwd.hpp>
+
+#include "result.h"
+
+class SimulationBundle;
+struct TradingConfig;
+
+/**
+ * Throughput benchmark behind `--bench`. Each case generates a synthetic
+ * universe (symbols x years of business-day bars), serves it from a
+ * SimulationBundle in place of the database and runs one strategy through
+ * TradingOrchestrator::runBacktest. Reports wall time, bars per second,
+ * peak RSS and heap allocations per bar for every case as JSON.
+ */
+class ScalingBenchmark {
+public:
+    struct Options {
+        std::vector<int> symbol_counts = {1, 10, 100, 1000};
+        std::vector<int> years = {1, 10, 30};
+        std::vector<std::string> strategies = {"ma_crossover", "rsi"};
+        uint64_t seed = 42;
+    };
+
+    // Random-walk bars for `symbol_count` symbols over `years` x 252 business days
+    // ending 2023-12-29; fills the symbols and date range of `config`
+    static std::shared_ptr<SimulationBundle> generateUniverse(int symbol_count, int years, uint64_t seed,
+                                                              TradingConfig& config);
+
+    Result<nlohmann::json> run(const Options& options) const;
+
+private:
+    nlohmann::json runCase(const std::string& strategy, int symbol_count, int years, uint64_t seed) const;
+
+    // Resets the kernel's peak RSS counter; false when /proc/self/clear_refs is unavailable
+    static bool resetPeakRss();
+    static long readPeakRssKb();
+};
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "result.h"
+#include "technical_indicators.h"
+
+#ifndef TRADING_ENGINE_VERSION
+#define TRADING_ENGINE_VERSION "unknown"
+#endif
+
+/**
+ * Everything a simulation read from the database, plus the resolved config
+ * and engine version, so the run can be repeated without a database.
+ * MarketData records into a bundle in capture mode (`--capture FILE`) and
+ * answers from it in replay mode (`--replay FILE`). The file is a compact
+ * little-endian binary layout: price series are stored column by column,
+ * ISO dates and midnight-UTC timestamps as int32 day numbers and
+ * tradability as bitmaps.
+ */
+class SimulationBundle {
+public:
+    static constexpr uint32_t MAGIC = 0x42534554;  // "TESB"
+    static constexpr uint32_t VERSION = 2;
+
+    SimulationBundle() = default;
+
+    // Non-copyable: shared between MarketData and the command that saves it
+    SimulationBundle(const SimulationBundle&) = delete;
+    SimulationBundle& operator=(const SimulationBundle&) = delete;
+
+    // Config as the JSON accepted by ArgumentParser::parseConfigJson
+    void setConfigJson(std::string config_json);
+    std::string getConfigJson() const;
+    void setEngineVersion(std::string version);
+    std::string getEngineVersion() const;
+
+    // Capture side; the last value recorded for a key wins
+    void recordSymbolExists(const std::string& symbol, bool exists);
+    void recordTemporalInfo(const std::string& symbol, const std::map<std::string, std::string>& info);
+    void recordPriceData(const std::string& symbol, const std::string& start_date, const std::string& end_date,
+                         const std::vector<PriceData>& data);
+    void recordTradeable(const std::string& symbol, const std::string& date, bool tradeable);
+
+    // Replay side; false when the value was never captured
+    bool lookupSymbolExists(const std::string& symbol, bool& exists) const;
+    bool lookupTemporalInfo(const std::string& symbol, std::map<std::string, std::string>& info) const;
+    bool lookupPriceData(const std::string& symbol, const std::string& start_date, const std::string& end_date,
+                         std::vector<PriceData>& data) const;
+    bool lookupTradeable(const std::string& symbol, const std::string& date, bool& tradeable) const;
+
+    size_t getPriceSeriesCount() const;
+    size_t getPriceRowCount() const;
+
+    // Write through a temporary file and rename into place; returns the file size
+    Result<uint64_t> save(const std::string& path) const;
+    static Result<std::shared_ptr<SimulationBundle>> load(const std::string& path);
+
+private:
+    mutable std::mutex mutex_;
+    std::string config_json_;
+    std::string engine_version_ = TRADING_ENGINE_VERSION;
+    std::map<std::string, bool> symbol_exists_;
+    std::map<std::string, std::map<std::string, std::string>> temporal_info_;
+    // Keyed by symbol, start and end date joined with '\n'
+    std::map<std::string, std::vector<PriceData>> price_data_;
+    std::map<std::string, std::map<std::string, bool>> tradeable_;
+
+    static std::string seriesKey(const std::string& symbol, const std::string& start_date,
+                                 const std::string& end_date);
+};
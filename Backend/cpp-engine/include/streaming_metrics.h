@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstddef>
+
+/**
+ * StreamingMetrics accumulates equity-curve statistics one observation at a time.
+ * Each update is O(1): daily returns feed a Welford mean/variance, the running
+ * peak tracks maximum drawdown, and gain/loss sums drive profit factor and
+ * downside deviation. Final metrics are read without walking the equity curve.
+ * Variance is the population variance to match ResultCalculator's batch path.
+ */
+class StreamingMetrics {
+public:
+    StreamingMetrics() = default;
+
+    // Start a new series with the first equity observation
+    void reset(double initial_value);
+    void clear();
+
+    // Record the next equity observation
+    void update(double equity_value);
+
+    // Observation counts
+    bool hasData() const { return observation_count_ > 0; }
+    size_t getObservationCount() const { return observation_count_; }
+    size_t getReturnCount() const { return return_count_; }
+
+    // Equity values
+    double getFirstValue() const { return first_value_; }
+    double getLastValue() const { return last_value_; }
+    double getPeakValue() const { return peak_value_; }
+
+    // Daily return statistics
+    double getMeanReturn() const { return mean_return_; }
+    double getReturnVariance() const;
+    double getReturnStdDev() const;
+    double getDownsideDeviation() const;
+
+    // Gain/loss statistics over daily returns
+    size_t getGainCount() const { return gain_count_; }
+    size_t getLossCount() const { return loss_count_; }
+    double getGainSum() const { return gain_sum_; }
+    double getLossSum() const { return loss_sum_; }
+    double getProfitFactor() const;
+    double getAverageGain() const;
+    double getAverageLoss() const;
+
+    // Drawdown (percentages)
+    double getMaxDrawdownPct() const { return max_drawdown_ * 100.0; }
+    double getCurrentDrawdownPct() const;
+
+    // Annualized metrics (252 trading days per year)
+    double getAnnualizedVolatilityPct() const;
+    double getSharpeRatio(double risk_free_rate = 0.02) const;
+    double getSortinoRatio(double risk_free_rate = 0.02) const;
+
+private:
+    size_t observation_count_ = 0;
+    size_t return_count_ = 0;
+
+    double first_value_ = 0.0;
+    double last_value_ = 0.0;
+    double peak_value_ = 0.0;
+    double max_drawdown_ = 0.0;
+
+    // Welford accumulators
+    double mean_return_ = 0.0;
+    double m2_ = 0.0;
+
+    double gain_sum_ = 0.0;
+    double loss_sum_ = 0.0;
+    double downside_sq_sum_ = 0.0;
+    size_t gain_count_ = 0;
+    size_t loss_count_ = 0;
+};
@@ -27,16 +27,28 @@ enum class Signal {
     HOLD
 };
 
+// MARKET fills at the signal price on the day it is generated; LIMIT and STOP rest
+// in the symbol's OrderBook at order_price until a later bar reaches them
+enum class OrderKind {
+    MARKET,
+    LIMIT,
+    STOP
+};
+
 struct TradingSignal {
     Signal signal;
     double price;
     std::string date;
     std::string reason;
     double confidence;
+    std::string symbol;  // Set by the orchestrator when the signal is tied to a traded symbol
+    OrderKind order_kind;
+    double order_price;  // Limit price or stop level; unused for MARKET
     
-    TradingSignal() : signal(Signal::HOLD), price(0.0), date(""), reason(""), confidence(0.0) {}
+    TradingSignal() : signal(Signal::HOLD), price(0.0), date(""), reason(""), confidence(0.0),
+                      order_kind(OrderKind::MARKET), order_price(0.0) {}
     TradingSignal(Signal s, double p, const std::string& d, const std::string& r, double conf = 1.0)
-        : signal(s), price(p), date(d), reason(r), confidence(conf) {}
+        : signal(s), price(p), date(d), reason(r), confidence(conf), order_kind(OrderKind::MARKET), order_price(0.0) {}
 };
 
 class TechnicalIndicators {
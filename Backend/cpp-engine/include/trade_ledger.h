@@ -0,0 +1,58 @@
+#pragma once
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "ring_buffer.h"
+#include "trading_strategy.h"
+
+/**
+ * TradeLedger keeps a FIFO queue of open lots per symbol and matches sells
+ * against the oldest lots at fill time. Each matched slice becomes a RoundTrip
+ * with realized P&L, holding period and MAE/MFE. Trade statistics are updated
+ * as round trips close, so final win/loss figures need no post-hoc scan.
+ */
+class TradeLedger {
+public:
+    TradeLedger() = default;
+
+    // Fill recording
+    void recordBuy(const std::string& symbol, int shares, double price, const std::string& date);
+    void recordSell(const std::string& symbol, int shares, double price, const std::string& date);
+
+    // Advance the symbol's bar count and widen the price range seen by its open lots
+    void markBar(const std::string& symbol, double high, double low);
+
+    // Round trips and statistics
+    const std::vector<RoundTrip>& getRoundTrips() const { return round_trips_; }
+    const TradeStatistics& getStatistics() const { return statistics_; }
+    const std::map<std::string, TradeStatistics>& getSymbolStatistics() const { return symbol_statistics_; }
+
+    // Open lot inspection
+    int getOpenShares(const std::string& symbol) const;
+    size_t getOpenLotCount(const std::string& symbol) const;
+
+    void clear();
+    size_t getMemoryUsage() const;
+
+private:
+    struct Lot {
+        int shares = 0;
+        double entry_price = 0.0;
+        std::string entry_date;
+        size_t entry_bar = 0;
+        double lowest_price = 0.0;
+        double highest_price = 0.0;
+    };
+
+    struct SymbolBook {
+        RingBuffer<Lot> lots;
+        size_t bars = 0;
+    };
+
+    std::map<std::string, SymbolBook> books_;
+    std::vector<RoundTrip> round_trips_;
+    TradeStatistics statistics_;
+    std::map<std::string, TradeStatistics> symbol_statistics_;
+};
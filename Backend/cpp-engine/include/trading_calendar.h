@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "result.h"
+
+/**
+ * Exchange sessions as integer day numbers (days since 1970-01-01), built
+ * once per run from the unified timeline. Sessions are kept as a bitmap over
+ * the days from the first to the last session, with a per-word prefix count,
+ * so membership, "business days between", "N sessions after" and year
+ * fractions are O(1) integer arithmetic instead of ISO string comparisons.
+ * Weekdays inside the range that are not sessions are holidays.
+ */
+class TradingCalendar {
+public:
+    static constexpr int32_t NO_DAY = std::numeric_limits<int32_t>::max();
+    static constexpr double SESSIONS_PER_YEAR = 252.0;
+
+    TradingCalendar() = default;
+
+    // Sorted or unsorted, duplicates allowed; every entry must start with YYYY-MM-DD
+    static Result<TradingCalendar> fromTimeline(const std::vector<std::string>& timeline);
+    static TradingCalendar fromDays(std::vector<int32_t> days);
+
+    bool empty() const { return sessions_.empty(); }
+    size_t sessionCount() const { return sessions_.size(); }
+    int32_t firstDay() const { return sessions_.empty() ? NO_DAY : sessions_.front(); }
+    int32_t lastDay() const { return sessions_.empty() ? NO_DAY : sessions_.back(); }
+
+    static bool isWeekday(int32_t day);
+    bool isSession(int32_t day) const;
+    bool isHoliday(int32_t day) const;
+    size_t holidayCount() const;
+
+    // Sessions on or before `day`; also the index one past `day`'s session
+    size_t sessionsThrough(int32_t day) const;
+    int32_t sessionAt(size_t index) const { return index < sessions_.size() ? sessions_[index] : NO_DAY; }
+
+    // Sessions in (from, to]; negative when to < from
+    int64_t businessDaysBetween(int32_t from, int32_t to) const;
+    // The session `count` sessions after `day` (count >= 1), or NO_DAY past the last session
+    int32_t addBusinessDays(int32_t day, int count) const;
+    int32_t nextRebalanceDay(int32_t last_rebalance_day, int frequency_days) const;
+    // Elapsed sessions in (from, to] over SESSIONS_PER_YEAR
+    double yearFraction(int32_t from, int32_t to) const;
+
+    size_t getMemoryUsage() const;
+
+private:
+    std::vector<int32_t> sessions_;   // Ascending, unique
+    std::vector<uint64_t> bits_;      // Bit (day - firstDay()) set for each session
+    std::vector<uint32_t> ranks_;     // Sessions before each bitmap word
+};
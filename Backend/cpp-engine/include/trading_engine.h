@@ -1,7 +1,9 @@
 #pragma once
 
+#include <cstdint>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -17,6 +19,7 @@
 #include "strategy_manager.h"
 #include "technical_indicators.h"
 #include "trading_orchestrator.h"
+#include "transaction_cost_model.h"
 #include "trading_strategy.h"
 
 // Unified configuration struct
@@ -28,9 +31,23 @@ struct TradingConfig {
     double starting_capital;
     std::string strategy_name;
     std::map<std::string, double> strategy_parameters;  // Flexible parameter storage
+    bool retain_equity_curve;                      // Store the per-day equity curve (metrics are streamed either way)
+    std::vector<int> rolling_windows;              // Rolling Sharpe/volatility windows in days (empty = disabled)
+    bool underwater_curve;                         // Emit the drawdown-from-peak series
+    std::string progress_shm_path;                 // Memory-mapped progress channel file (empty = JSON on stderr)
+    int64_t deadline_ms;                           // Wall-clock budget for the run in milliseconds (0 = none)
+    std::string result_mmap_path;                  // Write the result as a memory-mapped binary file (empty = JSON on stdout)
+    std::string capture_path;                      // Record config and database inputs to a replay bundle (empty = off)
+    std::string journal_path;                      // Append order lifecycle events to a memory-mapped journal (empty = off)
+    TransactionCostConfig transaction_costs;       // Commission, spread, impact and ADV participation cap (default: free fills)
+    bool sleeve_parallel;                          // Simulate each symbol's capital sleeve on its own thread and merge
+    int sleeve_threads;                            // Worker threads for sleeve_parallel (0 = one per core)
+    int db_async_connections;                      // Connections for concurrent price queries (capped at the symbol count, 0 = sequential)
     
     // Default constructor with sensible defaults
-    TradingConfig() : starting_capital(10000.0), strategy_name("ma_crossover") {
+    TradingConfig() : starting_capital(10000.0), strategy_name("ma_crossover"), retain_equity_curve(true),
+                      underwater_curve(false), deadline_ms(0), sleeve_parallel(false), sleeve_threads(0),
+                      db_async_connections(static_cast<int>(AsyncQueryExecutor::DEFAULT_CONNECTIONS)) {
         symbols.push_back("AAPL");  // Default single symbol
         // Set default parameters for ma_crossover strategy
         strategy_parameters["short_ma"] = 20.0;
@@ -60,6 +77,12 @@ struct TradingConfig {
     bool isMultiSymbol() const { return symbols.size() > 1; }
 };
 
+/**
+ * Owns the portfolio and the services a run needs. Services are built on
+ * first access rather than in the constructor, so commands that touch only
+ * a few of them (memory report, status) start without paying for the rest;
+ * MarketData in turn defers its database connection until the first query.
+ */
 class TradingEngine {
 public:
     TradingEngine();
@@ -98,20 +121,30 @@ public:
 private:
     Portfolio portfolio_;
     
-    // Service components (dependency injection)
-    std::unique_ptr<MarketData> market_data_;
-    std::unique_ptr<ExecutionService> execution_service_;
-    std::unique_ptr<ProgressService> progress_service_;
-    std::unique_ptr<PortfolioAllocator> portfolio_allocator_;
-    std::unique_ptr<ResultCalculator> result_calculator_;
-    std::unique_ptr<DataProcessor> data_processor_;
-    std::unique_ptr<StrategyManager> strategy_manager_;
-    std::unique_ptr<TradingOrchestrator> trading_orchestrator_;
+    // Service components (dependency injection), created lazily by the accessors
+    mutable std::unique_ptr<MarketData> market_data_;
+    mutable std::unique_ptr<ExecutionService> execution_service_;
+    mutable std::unique_ptr<ProgressService> progress_service_;
+    mutable std::unique_ptr<PortfolioAllocator> portfolio_allocator_;
+    mutable std::unique_ptr<ResultCalculator> result_calculator_;
+    mutable std::unique_ptr<DataProcessor> data_processor_;
+    mutable std::unique_ptr<StrategyManager> strategy_manager_;
+    mutable std::unique_ptr<TradingOrchestrator> trading_orchestrator_;
+    mutable std::mutex services_mutex_;  // Guards first construction; not moved
     
     // Performance optimization members
     std::map<std::string, std::vector<PriceData>> price_data_cache_;
     bool cache_enabled_;
     
     // Service initialization
-    void initializeServices();
+    template<typename T, typename Factory>
+    T* getOrCreate(std::unique_ptr<T>& service, Factory&& create) const {
+        std::lock_guard<std::mutex> lock(services_mutex_);
+        if (!service) {
+            service = create();
+        }
+        return service.get();
+    }
+    static std::unique_ptr<PortfolioAllocator> createPortfolioAllocator();
+    static std::unique_ptr<StrategyManager> createStrategyManager();
 };
\ No newline at end of file
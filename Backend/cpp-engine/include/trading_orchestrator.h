@@ -5,9 +5,12 @@
 #include <string>
 #include <vector>
 
+#include "cancellation_token.h"
 #include "data_processor.h"
+#include "execution_journal.h"
 #include "execution_service.h"
 #include "market_data.h"
+#include "order_book.h"
 #include "portfolio.h"
 #include "portfolio_allocator.h"
 #include "progress_service.h"
@@ -15,6 +18,7 @@
 #include "result_calculator.h"
 #include "strategy_manager.h"
 #include "trading_strategy.h"
+#include "transaction_cost_model.h"
 
 // Forward declarations
 struct TradingConfig;
@@ -75,16 +79,34 @@ public:
                                   PortfolioAllocator* portfolio_allocator,
                                   DataProcessor* data_processor,
                                   StrategyManager* strategy_manager,
-                                  MarketData* market_data) const;
+                                  MarketData* market_data,
+                                  ResultCalculator* result_calculator) const;
+    
+    // Sleeve-decomposed alternative to runSimulationLoop for fixed allocation weights: each
+    // symbol's sleeve of capital is simulated over its whole timeline as an independent
+    // single-symbol run, sleeves run concurrently, and their equity, trades and round trips
+    // are merged into `result`. `portfolio` receives the combined final holdings.
+    Result<void> runSleeveParallel(std::map<std::string, std::vector<PriceData>>&& multi_symbol_data,
+                                   const TradingConfig& config,
+                                   BacktestResult& result,
+                                   Portfolio& portfolio,
+                                   PortfolioAllocator* portfolio_allocator,
+                                   DataProcessor* data_processor,
+                                   StrategyManager* strategy_manager,
+                                   MarketData* market_data,
+                                   ResultCalculator* result_calculator) const;
     
     Result<void> finalizeBacktestResults(BacktestResult& result,
                                         Portfolio& portfolio,
-                                        ResultCalculator* result_calculator) const;
+                                        ResultCalculator* result_calculator,
+                                        const TradeLedger* trade_ledger = nullptr) const;
     
     // Results processing
     Result<nlohmann::json> getBacktestResultsAsJson(const BacktestResult& result,
-                                                   MarketData* market_data,
-                                                   DataProcessor* data_processor) const;
+                                                   MarketData* market_data) const;
+    
+    // Cooperative cancellation: polled once per simulated day and between symbol loads
+    CancellationToken& getCancellationToken() { return *cancellation_token_; }
     
     // Memory optimization support
     void optimizeMemoryUsage();
@@ -94,6 +116,7 @@ private:
     // Internal state for optimization
     std::map<std::string, std::vector<PriceData>> orchestrator_cache_;
     bool cache_enabled_ = false;
+    std::shared_ptr<CancellationToken> cancellation_token_ = std::make_shared<CancellationToken>();
     
     // Helper methods for orchestration flow
     Result<void> validateOrchestrationParameters(const TradingConfig& config) const;
@@ -101,6 +124,34 @@ private:
                                              Portfolio& portfolio,
                                              ExecutionService* execution_service) const;
     
+    // Execute a rebalance batch in order (sells before buys) and record the fills
+    void executeRebalanceOrders(const RebalancePlan& plan,
+                                const std::string& current_date,
+                                size_t session,
+                                int32_t day,
+                                const TransactionCostModel& costs,
+                                BacktestResult& result,
+                                Portfolio& portfolio,
+                                TradeLedger& trade_ledger,
+                                ExecutionJournal& journal,
+                                uint64_t& next_order_id) const;
+    
+    // Execute the fills one bar produced from a symbol's order book and record them; the part of
+    // an order the participation cap holds back, or all of it when the cap floors to 0 shares,
+    // goes back into `book`
+    void executeOrderFills(const std::string& symbol,
+                           size_t symbol_index,
+                           const std::vector<OrderFill>& fills,
+                           const std::string& current_date,
+                           size_t session,
+                           int32_t day,
+                           const TransactionCostModel& costs,
+                           OrderBook& book,
+                           BacktestResult& result,
+                           Portfolio& portfolio,
+                           TradeLedger& trade_ledger,
+                           ExecutionJournal& journal) const;
+    
     // Orchestration utilities
     std::string createSimulationSummary(const TradingConfig& config,
                                        const BacktestResult& result) const;
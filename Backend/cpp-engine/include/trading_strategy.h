@@ -58,6 +58,71 @@ struct SymbolPerformance {
                                                symbol_allocation_pct(0.0), final_position_value(0.0) {}
 };
 
+// Rolling-window risk series aligned with the equity curve (NaN until the window fills)
+struct RollingMetricSeries {
+    int window;                                  // Window length in daily returns
+    std::vector<double> sharpe_ratio;            // Annualized rolling Sharpe ratio
+    std::vector<double> volatility;              // Annualized rolling volatility percentage
+    std::vector<double> drawdown_pct;            // Drawdown from the trailing window high (percentage, <= 0)
+    
+    RollingMetricSeries() : window(0) {}
+    explicit RollingMetricSeries(int w) : window(w) {}
+};
+
+// Closed round trip produced by FIFO lot matching
+struct RoundTrip {
+    std::string symbol;
+    int shares;                                  // Shares closed in this round trip
+    double entry_price;
+    double exit_price;
+    std::string entry_date;
+    std::string exit_date;
+    int holding_bars;                            // Bars of the symbol between entry and exit
+    double pnl;                                  // Realized profit/loss in currency
+    double return_pct;                           // Realized return on entry cost
+    double mae_pct;                              // Maximum adverse excursion while open (percentage, <= 0)
+    double mfe_pct;                              // Maximum favourable excursion while open (percentage, >= 0)
+    
+    RoundTrip() : shares(0), entry_price(0.0), exit_price(0.0), holding_bars(0), pnl(0.0),
+                 return_pct(0.0), mae_pct(0.0), mfe_pct(0.0) {}
+};
+
+// Aggregate statistics over closed round trips
+struct TradeStatistics {
+    int winning_trades;
+    int losing_trades;
+    double gross_profit;                         // Sum of winning round trip P&L
+    double gross_loss;                           // Sum of losing round trip P&L (positive amount)
+    double cost_basis;                           // Sum of entry cost of closed round trips
+    
+    TradeStatistics() : winning_trades(0), losing_trades(0), gross_profit(0.0), gross_loss(0.0), cost_basis(0.0) {}
+    
+    void addRoundTrip(const RoundTrip& trip) {
+        if (trip.pnl > 0) {
+            winning_trades++;
+            gross_profit += trip.pnl;
+        } else {
+            losing_trades++;
+            gross_loss -= trip.pnl;
+        }
+        cost_basis += trip.entry_price * trip.shares;
+    }
+    
+    int closedTrades() const { return winning_trades + losing_trades; }
+    double netProfit() const { return gross_profit - gross_loss; }
+};
+
+// Trading costs charged by the transaction cost model over a run
+struct TransactionCostSummary {
+    bool enabled;                                // A cost model with non-zero parameters was applied
+    double commission;                           // Total commission paid
+    double slippage;                             // Total spread and market impact cost versus reference prices
+    int capped_orders;                           // Orders reduced by the ADV participation cap
+    long capped_shares;                          // Shares left unfilled by the cap
+    
+    TransactionCostSummary() : enabled(false), commission(0.0), slippage(0.0), capped_orders(0), capped_shares(0) {}
+};
+
 struct BacktestResult {
     // Multi-symbol portfolio: all symbols processed in this backtest
     std::vector<std::string> symbols;            // All symbols included in backtest
@@ -77,6 +142,7 @@ struct BacktestResult {
     // Risk and performance metrics
     double max_drawdown;                         // Maximum drawdown percentage
     double sharpe_ratio;                         // Risk-adjusted return metric
+    double sortino_ratio;                        // Downside risk-adjusted return metric
     double volatility;                           // Portfolio volatility
     double profit_factor;                        // Ratio of gross profit to gross loss
     double average_win;                          // Average winning trade amount
@@ -85,6 +151,9 @@ struct BacktestResult {
     // Time series data
     std::vector<TradingSignal> signals_generated; // All signals generated across all symbols
     std::vector<double> equity_curve;            // Portfolio value over time
+    std::vector<RoundTrip> round_trips;          // Closed trades from FIFO lot matching
+    std::vector<RollingMetricSeries> rolling_metrics; // Optional rolling risk series (empty unless requested)
+    std::vector<double> underwater_curve;        // Optional drawdown-from-peak series (percentage, <= 0)
     
     // Per-symbol performance breakdown
     std::map<std::string, SymbolPerformance> symbol_performance; // Individual symbol metrics
@@ -93,19 +162,22 @@ struct BacktestResult {
     double annualized_return;                    // Annualized return percentage
     int signals_generated_count;                 // Total signals generated (including HOLD)
     double portfolio_diversification_ratio;     // Measure of diversification effectiveness
+    TransactionCostSummary transaction_costs;   // Costs charged to fills (zero unless a cost model is configured)
     
     // Metadata
     std::string start_date;                      // Backtest start date
     std::string end_date;                        // Backtest end date
     std::string strategy_name;                   // Strategy used for backtest
     std::string error_message;                   // Error message if backtest failed
+    bool truncated;                              // Stopped early by cancellation or deadline
+    std::string truncation_reason;               // Why the run stopped early (empty unless truncated)
     
     // Constructor
     BacktestResult() : starting_capital(0), ending_value(0), total_return_pct(0), 
                       cash_remaining(0), total_trades(0), winning_trades(0), losing_trades(0), 
-                      win_rate(0), max_drawdown(0), sharpe_ratio(0), volatility(0), 
+                      win_rate(0), max_drawdown(0), sharpe_ratio(0), sortino_ratio(0), volatility(0), 
                       profit_factor(0), average_win(0), average_loss(0), annualized_return(0), 
-                      signals_generated_count(0), portfolio_diversification_ratio(0), error_message("") {}
+                      signals_generated_count(0), portfolio_diversification_ratio(0), error_message(""), truncated(false) {}
     
     // Multi-symbol support methods
     void addSymbol(const std::string& symbol) {
@@ -139,6 +211,10 @@ public:
     virtual bool validateConfig() const = 0;
     virtual std::string getDescription() const = 0;
     
+    // Fresh instance with the same configuration, for running on another thread;
+    // nullptr when the strategy cannot be copied
+    virtual std::unique_ptr<TradingStrategy> clone() const { return nullptr; }
+    
     double calculatePositionSize(double available_capital, double stock_price) const;
     double calculatePositionSize(const Portfolio& portfolio, const std::string& symbol, double stock_price, double portfolio_value) const;
     bool shouldApplyRiskManagement(const Portfolio& portfolio, const std::string& symbol) const;
@@ -162,6 +238,7 @@ public:
     void configure(const StrategyConfig& config) override;
     bool validateConfig() const override;
     std::string getDescription() const override;
+    std::unique_ptr<TradingStrategy> clone() const override;
     
     void setMovingAveragePeriods(int short_period, int long_period);
     std::pair<int, int> getMovingAveragePeriods() const;
@@ -188,6 +265,7 @@ public:
     void configure(const StrategyConfig& config) override;
     bool validateConfig() const override;
     std::string getDescription() const override;
+    std::unique_ptr<TradingStrategy> clone() const override;
     
     void setRSIParameters(int period, double oversold, double overbought);
 
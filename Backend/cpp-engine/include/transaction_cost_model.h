@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "result.h"
+#include "technical_indicators.h"
+
+// Cost parameters for a run; all zero (the default) fills at the signal price for free
+struct TransactionCostConfig {
+    double commission_per_share = 0.0;
+    double commission_pct = 0.0;           // Percentage of traded notional
+    double min_commission = 0.0;           // Floor per filled order
+    double spread_bps = 0.0;               // Full bid-ask spread; each fill crosses half of it
+    double impact_coefficient = 0.0;       // Square-root impact: coefficient x daily volatility x sqrt(shares / ADV)
+    double max_participation_pct = 0.0;    // Largest order as a percentage of ADV (0 = uncapped)
+    int adv_window = 20;                   // Bars in the trailing average daily volume
+    int volatility_window = 20;            // Bars in the trailing daily return volatility
+
+    bool isEnabled() const;
+    Result<void> validate() const;
+};
+
+// One order after the participation cap and costs
+struct FillEstimate {
+    int shares = 0;             // Shares that can trade; may be below the request when capped
+    double price = 0.0;         // Execution price after half-spread and impact
+    double commission = 0.0;    // Commission for the whole order
+    double slippage = 0.0;      // Spread and impact cost versus the reference price (>= 0)
+
+    // Per-share price with the commission folded in, as booked to the portfolio and ledger
+    double netPrice(Signal side) const;
+};
+
+/**
+ * Volume-aware fills for the simulation loop. prepare() precomputes, once per
+ * run, each symbol's trailing average daily volume and daily return volatility
+ * as arrays indexed by calendar session, so capping and costing an order in
+ * the loop is an O(1) lookup plus a few flops. The trailing windows end on the
+ * bar before the session, so an order is never costed with the volume of the
+ * bar it trades on; a symbol's first bar falls back to its own volume.
+ */
+class TransactionCostModel {
+public:
+    TransactionCostModel() = default;
+    explicit TransactionCostModel(const TransactionCostConfig& config) : config_(config) {}
+
+    // session_indices as built by DataProcessor::createSessionIndices for the same data;
+    // only indexes the symbols when no cost applies
+    void prepare(const std::map<std::string, std::vector<PriceData>>& multi_symbol_data,
+                 const std::vector<std::vector<int32_t>>& session_indices);
+
+    bool isEnabled() const { return config_.isEnabled(); }
+    const TransactionCostConfig& getConfig() const { return config_; }
+
+    // Symbol position in the prepared data (indexed even when no cost applies), or -1
+    int symbolIndex(const std::string& symbol) const;
+    double getAverageDailyVolume(size_t symbol_index, size_t session) const;
+    double getDailyVolatility(size_t symbol_index, size_t session) const;
+
+    // Caps `shares` at the participation limit and prices the rest against `reference_price`
+    FillEstimate estimate(size_t symbol_index, size_t session, Signal side, int shares,
+                          double reference_price) const;
+
+    size_t getMemoryUsage() const;
+
+private:
+    TransactionCostConfig config_;
+    std::vector<std::vector<double>> adv_;          // [symbol][session]
+    std::vector<std::vector<double>> volatility_;   // [symbol][session], daily standard deviation of log returns
+    std::unordered_map<std::string, size_t> symbol_indices_;
+};
@@ -0,0 +1,46 @@
+#include <atomic>
+#include <cstddef>
+
+#include "allocation_counter.h"
+
+namespace {
+
+// Constant-initialized, so allocations made during static initialization are counted safely
+std::atomic<bool> g_installed{false};
+std::atomic<bool> g_enabled{false};
+std::atomic<uint64_t> g_allocations{0};
+std::atomic<uint64_t> g_bytes{0};
+
+}  // namespace
+
+namespace AllocationCounter {
+
+bool isInstalled() {
+    return g_installed.load(std::memory_order_relaxed);
+}
+
+void enable() {
+    g_enabled.store(true, std::memory_order_relaxed);
+}
+
+uint64_t allocations() {
+    return g_allocations.load(std::memory_order_relaxed);
+}
+
+uint64_t allocatedBytes() {
+    return g_bytes.load(std::memory_order_relaxed);
+}
+
+void markInstalled() {
+    g_installed.store(true, std::memory_order_relaxed);
+}
+
+void recordAllocation(std::size_t bytes) {
+    if (!g_enabled.load(std::memory_order_relaxed)) {
+        return;
+    }
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    g_bytes.fetch_add(bytes, std::memory_order_relaxed);
+}
+
+}  // namespace AllocationCounter
@@ -0,0 +1,79 @@
+#include <cstdlib>
+#include <new>
+
+#include "allocation_counter.h"
+
+// Counting replacements for the global allocation functions. Linked into
+// the trading_engine executable only, so `--bench` can report allocations
+// per bar; the Python module and test binaries keep the default operators.
+// Aligned variants are left to the library and are not counted. Nothing is
+// counted until `--bench` calls AllocationCounter::enable().
+
+namespace {
+
+void* countedAllocate(std::size_t size) {
+    void* ptr = std::malloc(size == 0 ? 1 : size);
+    if (ptr) {
+        AllocationCounter::recordAllocation(size);
+    }
+    return ptr;
+}
+
+// Set before main so isInstalled() is true whenever this file is linked
+const bool g_hooks_installed = (AllocationCounter::markInstalled(), true);
+
+}  // namespace
+
+// Retries through the installed new_handler, as the library operator does
+void* operator new(std::size_t size) {
+    while (true) {
+        if (void* ptr = countedAllocate(size)) {
+            return ptr;
+        }
+        std::new_handler handler = std::get_new_handler();
+        if (!handler) {
+            throw std::bad_alloc();
+        }
+        handler();
+    }
+}
+
+void* operator new[](std::size_t size) {
+    return ::operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    try {
+        return ::operator new(size);
+    } catch (const std::bad_alloc&) {
+        return nullptr;
+    }
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    return ::operator new(size, std::nothrow);
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, const std::nothrow_t&) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept {
+    std::free(ptr);
+}
@@ -2,6 +2,8 @@
 #include <iostream>
 #include <sstream>
 
+#include <nlohmann/json.hpp>
+
 #include "argument_parser.h"
 #include "logger.h"
 #include "trading_engine.h"  // Include for TradingConfig definition
@@ -22,7 +24,8 @@ TradingConfig ArgumentParser::parseArguments(int argc, char* argv[]) {
         
         if (arg.find('=') != std::string::npos) {
             parseKeyValueFormat(arg, config);
-        } else if (i + 1 < argc && arg.substr(0, 2) == "--") {
+        } else if (i + 1 < argc && arg.substr(0, 2) == "--" && std::string(argv[i + 1]).substr(0, 2) != "--") {
+            // A flag followed by another flag (the command itself, e.g. --backtest) takes no value
             parseKeyValuePairFormat(arg, argv[++i], config);
         }
     }
@@ -46,6 +49,19 @@ void ArgumentParser::parseSymbols(const std::string& symbol_list, std::vector<st
     }
 }
 
+void ArgumentParser::parseIntegerList(const std::string& list, std::vector<int>& values) {
+    std::stringstream ss(list);
+    std::string item;
+    values.clear();
+    
+    while (std::getline(ss, item, ',')) {
+        item = trimWhitespace(item);
+        if (!item.empty()) {
+            values.push_back(std::stoi(item));
+        }
+    }
+}
+
 void ArgumentParser::parseKeyValueFormat(const std::string& arg, TradingConfig& config) {
     if (arg.find("--symbol=") == 0) {
         std::string symbol_list = arg.substr(9);
@@ -78,6 +94,36 @@ void ArgumentParser::parseKeyValueFormat(const std::string& arg, TradingConfig&
     } else if (arg.find("--rsi-overbought=") == 0) {
         config.setParameter("rsi_overbought", std::stod(arg.substr(17)));
         Logger::debug("Set rsi_overbought = ", config.getDoubleParameter("rsi_overbought"));
+    } else if (arg.find("--rolling-windows=") == 0) {
+        parseIntegerList(arg.substr(18), config.rolling_windows);
+        Logger::debug("Set ", config.rolling_windows.size(), " rolling windows");
+    } else if (arg.find("--underwater-curve=") == 0) {
+        config.underwater_curve = (arg.substr(19) == "true");
+        Logger::debug("Set underwater_curve = ", config.underwater_curve);
+    } else if (arg.find("--progress-shm=") == 0) {
+        config.progress_shm_path = arg.substr(15);
+        Logger::debug("Set progress_shm_path = '", config.progress_shm_path, "'");
+    } else if (arg.find("--deadline-ms=") == 0) {
+        config.deadline_ms = std::stoll(arg.substr(14));
+        Logger::debug("Set deadline_ms = ", config.deadline_ms);
+    } else if (arg.find("--result-mmap=") == 0) {
+        config.result_mmap_path = arg.substr(14);
+        Logger::debug("Set result_mmap_path = '", config.result_mmap_path, "'");
+    } else if (arg.find("--capture=") == 0) {
+        config.capture_path = arg.substr(10);
+        Logger::debug("Set capture_path = '", config.capture_path, "'");
+    } else if (arg.find("--journal=") == 0) {
+        config.journal_path = arg.substr(10);
+        Logger::debug("Set journal_path = '", config.journal_path, "'");
+    } else if (arg.find("--sleeve-parallel=") == 0) {
+        config.sleeve_parallel = (arg.substr(18) == "true");
+        Logger::debug("Set sleeve_parallel = ", config.sleeve_parallel);
+    } else if (arg.find("--sleeve-threads=") == 0) {
+        config.sleeve_threads = std::stoi(arg.substr(17));
+        Logger::debug("Set sleeve_threads = ", config.sleeve_threads);
+    } else if (arg.find("--db-async-connections=") == 0) {
+        config.db_async_connections = std::stoi(arg.substr(23));
+        Logger::debug("Set db_async_connections = ", config.db_async_connections);
     }
 }
 
@@ -112,6 +158,36 @@ void ArgumentParser::parseKeyValuePairFormat(const std::string& key, const std::
     } else if (key == "--rsi-overbought") {
         config.setParameter("rsi_overbought", std::stod(value));
         Logger::debug("Set rsi_overbought = ", config.getDoubleParameter("rsi_overbought"));
+    } else if (key == "--rolling-windows") {
+        parseIntegerList(value, config.rolling_windows);
+        Logger::debug("Set ", config.rolling_windows.size(), " rolling windows");
+    } else if (key == "--underwater-curve") {
+        config.underwater_curve = (value == "true");
+        Logger::debug("Set underwater_curve = ", config.underwater_curve);
+    } else if (key == "--progress-shm") {
+        config.progress_shm_path = value;
+        Logger::debug("Set progress_shm_path = '", config.progress_shm_path, "'");
+    } else if (key == "--deadline-ms") {
+        config.deadline_ms = std::stoll(value);
+        Logger::debug("Set deadline_ms = ", config.deadline_ms);
+    } else if (key == "--result-mmap") {
+        config.result_mmap_path = value;
+        Logger::debug("Set result_mmap_path = '", config.result_mmap_path, "'");
+    } else if (key == "--capture") {
+        config.capture_path = value;
+        Logger::debug("Set capture_path = '", config.capture_path, "'");
+    } else if (key == "--journal") {
+        config.journal_path = value;
+        Logger::debug("Set journal_path = '", config.journal_path, "'");
+    } else if (key == "--sleeve-parallel") {
+        config.sleeve_parallel = (value == "true");
+        Logger::debug("Set sleeve_parallel = ", config.sleeve_parallel);
+    } else if (key == "--sleeve-threads") {
+        config.sleeve_threads = std::stoi(value);
+        Logger::debug("Set sleeve_threads = ", config.sleeve_threads);
+    } else if (key == "--db-async-connections") {
+        config.db_async_connections = std::stoi(value);
+        Logger::debug("Set db_async_connections = ", config.db_async_connections);
     }
 }
 
@@ -157,4 +233,113 @@ std::string ArgumentParser::trimWhitespace(const std::string& str) {
     if (start == std::string::npos) return "";
     size_t end = str.find_last_not_of(" \t");
     return str.substr(start, end - start + 1);
-}
\ No newline at end of file
+}
+
+TradingConfig ArgumentParser::parseConfigJson(const nlohmann::json& config) {
+    TradingConfig sim_config;
+    
+    // Clear default symbols from constructor and load from config
+    sim_config.symbols.clear();
+    if (config.contains("symbols") && config["symbols"].is_array()) {
+        for (const auto& s : config["symbols"]) {
+            sim_config.symbols.push_back(s.get<std::string>());
+        }
+    } else if (config.contains("symbol")) {
+        sim_config.symbols.push_back(config.value("symbol", "AAPL"));
+    } else {
+        sim_config.symbols.push_back("AAPL");
+    }
+    
+    // Load basic configuration
+    sim_config.start_date = config.value("start_date", "2023-01-01");
+    sim_config.end_date = config.value("end_date", "2023-12-31");
+    sim_config.starting_capital = config.value("starting_capital", 10000.0);
+    sim_config.strategy_name = config.value("strategy", "ma_crossover");
+    sim_config.retain_equity_curve = config.value("retain_equity_curve", true);
+    sim_config.underwater_curve = config.value("underwater_curve", false);
+    sim_config.progress_shm_path = config.value("progress_shm", "");
+    sim_config.deadline_ms = config.value("deadline_ms", static_cast<int64_t>(0));
+    sim_config.result_mmap_path = config.value("result_mmap", "");
+    sim_config.capture_path = config.value("capture", "");
+    sim_config.journal_path = config.value("journal", "");
+    sim_config.sleeve_parallel = config.value("sleeve_parallel", false);
+    sim_config.sleeve_threads = config.value("sleeve_threads", 0);
+    sim_config.db_async_connections = config.value("db_async_connections",
+                                                   static_cast<int>(AsyncQueryExecutor::DEFAULT_CONNECTIONS));
+    if (config.contains("rolling_windows") && config["rolling_windows"].is_array()) {
+        for (const auto& window : config["rolling_windows"]) {
+            sim_config.rolling_windows.push_back(window.get<int>());
+        }
+    }
+    if (config.contains("transaction_costs") && config["transaction_costs"].is_object()) {
+        const auto& costs = config["transaction_costs"];
+        auto& cost_config = sim_config.transaction_costs;
+        cost_config.commission_per_share = costs.value("commission_per_share", 0.0);
+        cost_config.commission_pct = costs.value("commission_pct", 0.0);
+        cost_config.min_commission = costs.value("min_commission", 0.0);
+        cost_config.spread_bps = costs.value("spread_bps", 0.0);
+        cost_config.impact_coefficient = costs.value("impact_coefficient", 0.0);
+        cost_config.max_participation_pct = costs.value("max_participation_pct", 0.0);
+        cost_config.adv_window = costs.value("adv_window", 20);
+        cost_config.volatility_window = costs.value("volatility_window", 20);
+    }
+    
+    // Load strategy parameters
+    if (config.contains("strategy_parameters") && config["strategy_parameters"].is_object()) {
+        for (const auto& param : config["strategy_parameters"].items()) {
+            sim_config.strategy_parameters[param.key()] = param.value().get<double>();
+        }
+    } else {
+        // Fallback to individual parameter keys for backward compatibility
+        if (config.contains("short_ma")) {
+            sim_config.strategy_parameters["short_ma"] = config["short_ma"].get<double>();
+        }
+        if (config.contains("long_ma")) {
+            sim_config.strategy_parameters["long_ma"] = config["long_ma"].get<double>();
+        }
+        if (config.contains("rsi_period")) {
+            sim_config.strategy_parameters["rsi_period"] = config["rsi_period"].get<double>();
+        }
+        if (config.contains("rsi_oversold")) {
+            sim_config.strategy_parameters["rsi_oversold"] = config["rsi_oversold"].get<double>();
+        }
+        if (config.contains("rsi_overbought")) {
+            sim_config.strategy_parameters["rsi_overbought"] = config["rsi_overbought"].get<double>();
+        }
+    }
+    
+    return sim_config;
+}
+
+nlohmann::json ArgumentParser::configToJson(const TradingConfig& config) {
+    nlohmann::json json_config;
+    json_config["symbols"] = config.symbols;
+    json_config["start_date"] = config.start_date;
+    json_config["end_date"] = config.end_date;
+    json_config["starting_capital"] = config.starting_capital;
+    json_config["strategy"] = config.strategy_name;
+    json_config["strategy_parameters"] = config.strategy_parameters;
+    json_config["retain_equity_curve"] = config.retain_equity_curve;
+    json_config["underwater_curve"] = config.underwater_curve;
+    json_config["rolling_windows"] = config.rolling_windows;
+    json_config["progress_shm"] = config.progress_shm_path;
+    json_config["deadline_ms"] = config.deadline_ms;
+    json_config["result_mmap"] = config.result_mmap_path;
+    json_config["capture"] = config.capture_path;
+    json_config["journal"] = config.journal_path;
+    json_config["sleeve_parallel"] = config.sleeve_parallel;
+    json_config["sleeve_threads"] = config.sleeve_threads;
+    json_config["db_async_connections"] = config.db_async_connections;
+    const auto& costs = config.transaction_costs;
+    json_config["transaction_costs"] = {
+        {"commission_per_share", costs.commission_per_share},
+        {"commission_pct", costs.commission_pct},
+        {"min_commission", costs.min_commission},
+        {"spread_bps", costs.spread_bps},
+        {"impact_coefficient", costs.impact_coefficient},
+        {"max_participation_pct", costs.max_participation_pct},
+        {"adv_window", costs.adv_window},
+        {"volatility_window", costs.volatility_window},
+    };
+    return json_config;
+}
@@ -0,0 +1,353 @@
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+
+#include "async_query_executor.h"
+#include "logger.h"
+
+AsyncQueryExecutor::AsyncQueryExecutor(std::string connection_string, size_t max_connections)
+    : connection_string_(std::move(connection_string)), max_connections_(std::max<size_t>(1, max_connections)) {
+    // Self-pipe so submit() and shutdown() can interrupt poll()
+    if (pipe(wake_pipe_) == 0) {
+        for (int fd : wake_pipe_) {
+            fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+            fcntl(fd, F_SETFD, FD_CLOEXEC);
+        }
+    } else {
+        Logger::warning("Query executor wake pipe unavailable, falling back to polling: ", std::strerror(errno));
+        wake_pipe_[0] = wake_pipe_[1] = -1;
+    }
+    loop_ = std::thread(&AsyncQueryExecutor::run, this);
+}
+
+AsyncQueryExecutor::~AsyncQueryExecutor() {
+    shutdown();
+    for (int fd : wake_pipe_) {
+        if (fd >= 0) {
+            close(fd);
+        }
+    }
+}
+
+std::future<Result<QueryCursor>> AsyncQueryExecutor::submit(std::string query, std::vector<std::string> params,
+                                                            QueryResultFormat format) {
+    auto request = std::make_unique<Request>();
+    request->query = std::move(query);
+    request->params = std::move(params);
+    request->format = format;
+    auto future = request->promise.get_future();
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (stopping_) {
+            request->promise.set_value(
+                Result<QueryCursor>(ErrorCode::DATABASE_QUERY_FAILED, "Query executor is shut down"));
+            return future;
+        }
+        pending_.push_back(std::move(request));
+    }
+    wake();
+    return future;
+}
+
+void AsyncQueryExecutor::shutdown() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (stopping_) {
+            return;
+        }
+        stopping_ = true;
+    }
+    wake();
+    if (loop_.joinable()) {
+        loop_.join();
+    }
+}
+
+void AsyncQueryExecutor::wake() {
+    if (wake_pipe_[1] >= 0) {
+        char byte = 1;
+        // A full pipe already guarantees a wakeup
+        ssize_t written = write(wake_pipe_[1], &byte, 1);
+        (void)written;
+    }
+}
+
+void AsyncQueryExecutor::run() {
+    std::vector<Slot> slots(max_connections_);
+    std::vector<pollfd> fds;
+    std::vector<Slot*> owners;
+
+    while (true) {
+        std::vector<std::pair<Slot*, std::unique_ptr<Request>>> dispatches;
+        std::vector<Slot*> to_connect;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (stopping_) {
+                break;
+            }
+
+            for (auto& slot : slots) {
+                if (slot.state == SlotState::IDLE && !pending_.empty()) {
+                    dispatches.emplace_back(&slot, std::move(pending_.front()));
+                    pending_.pop_front();
+                }
+            }
+
+            // Open more connections only for queries no connecting slot will take
+            size_t connecting = static_cast<size_t>(std::count_if(slots.begin(), slots.end(), [](const Slot& slot) {
+                return slot.state == SlotState::CONNECTING;
+            }));
+            size_t demand = pending_.size() > connecting ? pending_.size() - connecting : 0;
+            for (auto& slot : slots) {
+                if (pending_.empty() && slot.state == SlotState::FAILED) {
+                    slot.state = SlotState::DISCONNECTED;
+                }
+                if (demand > 0 && slot.state == SlotState::DISCONNECTED) {
+                    to_connect.push_back(&slot);
+                    --demand;
+                }
+            }
+        }
+
+        bool requeued = false;
+        for (auto& dispatch_item : dispatches) {
+            requeued = dispatch(*dispatch_item.first, std::move(dispatch_item.second)) || requeued;
+        }
+        for (Slot* slot : to_connect) {
+            startConnecting(*slot);
+        }
+        if (requeued) {
+            continue;
+        }
+
+        // Nothing can serve the queue once every connection attempt has failed
+        bool serving = std::any_of(slots.begin(), slots.end(), [](const Slot& slot) {
+            return slot.state == SlotState::CONNECTING || slot.state == SlotState::IDLE ||
+                   slot.state == SlotState::BUSY;
+        });
+        if (!serving) {
+            auto failed = std::find_if(slots.begin(), slots.end(), [](const Slot& slot) {
+                return slot.state == SlotState::FAILED;
+            });
+            if (failed != slots.end()) {
+                failPending(ErrorCode::DATABASE_CONNECTION_FAILED, "Database connection failed: " + failed->error);
+                continue;
+            }
+        }
+
+        fds.clear();
+        owners.clear();
+        fds.push_back({wake_pipe_[0], POLLIN, 0});
+        owners.push_back(nullptr);
+        for (auto& slot : slots) {
+            short events = 0;
+            if (slot.state == SlotState::CONNECTING) {
+                events = slot.connect_poll == PGRES_POLLING_READING ? POLLIN : POLLOUT;
+            } else if (slot.state == SlotState::BUSY) {
+                events = static_cast<short>(POLLIN | (slot.flush_pending ? POLLOUT : 0));
+            } else {
+                continue;
+            }
+            fds.push_back({PQsocket(slot.connection), events, 0});
+            owners.push_back(&slot);
+        }
+
+        int ready = poll(fds.data(), static_cast<nfds_t>(fds.size()), wake_pipe_[0] < 0 ? 10 : -1);
+        if (ready < 0) {
+            if (errno != EINTR) {
+                Logger::error("Query executor poll failed: ", std::strerror(errno));
+            }
+            continue;
+        }
+
+        if (fds[0].revents & POLLIN) {
+            char buffer[64];
+            while (read(wake_pipe_[0], buffer, sizeof(buffer)) > 0) {
+            }
+        }
+
+        for (size_t i = 1; i < fds.size(); ++i) {
+            if (fds[i].revents == 0) {
+                continue;
+            }
+            Slot& slot = *owners[i];
+            if (slot.state == SlotState::CONNECTING) {
+                advanceConnect(slot);
+                continue;
+            }
+
+            if (slot.flush_pending && (fds[i].revents & POLLOUT)) {
+                int flushed = PQflush(slot.connection);
+                if (flushed < 0) {
+                    complete(slot, Result<QueryCursor>(ErrorCode::DATABASE_QUERY_FAILED,
+                                                       "Query send failed: " + std::string(PQerrorMessage(slot.connection))));
+                    resetConnection(slot, SlotState::DISCONNECTED);
+                    continue;
+                }
+                slot.flush_pending = flushed == 1;
+            }
+            if (fds[i].revents & (POLLIN | POLLERR | POLLHUP)) {
+                readResults(slot);
+            }
+        }
+    }
+
+    // Stopping: abandon in-flight queries on the server and fail everything still waiting
+    for (auto& slot : slots) {
+        if (slot.state == SlotState::BUSY) {
+            if (PGcancel* request = PQgetCancel(slot.connection)) {
+                char error_buffer[256];
+                PQcancel(request, error_buffer, sizeof(error_buffer));
+                PQfreeCancel(request);
+            }
+            complete(slot, Result<QueryCursor>(ErrorCode::DATABASE_QUERY_FAILED, "Query executor shut down"));
+        }
+        resetConnection(slot, SlotState::DISCONNECTED);
+    }
+    failPending(ErrorCode::DATABASE_QUERY_FAILED, "Query executor shut down");
+}
+
+void AsyncQueryExecutor::startConnecting(Slot& slot) {
+    slot.error.clear();
+    slot.connection = PQconnectStart(connection_string_.c_str());
+    if (!slot.connection || PQstatus(slot.connection) == CONNECTION_BAD) {
+        slot.error = slot.connection ? PQerrorMessage(slot.connection) : "out of memory";
+        resetConnection(slot, SlotState::FAILED);
+        return;
+    }
+    slot.connect_poll = PGRES_POLLING_WRITING;
+    slot.state = SlotState::CONNECTING;
+}
+
+void AsyncQueryExecutor::advanceConnect(Slot& slot) {
+    slot.connect_poll = PQconnectPoll(slot.connection);
+    if (slot.connect_poll == PGRES_POLLING_OK) {
+        PQsetnonblocking(slot.connection, 1);
+        slot.state = SlotState::IDLE;
+    } else if (slot.connect_poll == PGRES_POLLING_FAILED) {
+        slot.error = PQerrorMessage(slot.connection);
+        Logger::debug("Query executor connection failed: ", slot.error);
+        resetConnection(slot, SlotState::FAILED);
+    }
+}
+
+bool AsyncQueryExecutor::dispatch(Slot& slot, std::unique_ptr<Request> request) {
+    std::vector<const char*> param_values;
+    param_values.reserve(request->params.size());
+    for (const auto& param : request->params) {
+        param_values.push_back(param.c_str());
+    }
+
+    slot.request = std::move(request);
+    if (!PQsendQueryParams(slot.connection, slot.request->query.c_str(), static_cast<int>(param_values.size()),
+                           nullptr, param_values.data(), nullptr, nullptr,
+                           static_cast<int>(slot.request->format))) {
+        if (PQstatus(slot.connection) == CONNECTION_BAD) {
+            // The server dropped this idle connection: retry the query on a fresh one
+            std::unique_ptr<Request> retry = std::move(slot.request);
+            resetConnection(slot, SlotState::DISCONNECTED);
+            std::lock_guard<std::mutex> lock(mutex_);
+            pending_.push_front(std::move(retry));
+            return true;
+        }
+        complete(slot, Result<QueryCursor>(ErrorCode::DATABASE_QUERY_FAILED,
+                                           "Query dispatch failed: " + std::string(PQerrorMessage(slot.connection))));
+        return false;
+    }
+
+    slot.state = SlotState::BUSY;
+    int flushed = PQflush(slot.connection);
+    if (flushed < 0) {
+        complete(slot, Result<QueryCursor>(ErrorCode::DATABASE_QUERY_FAILED,
+                                           "Query send failed: " + std::string(PQerrorMessage(slot.connection))));
+        resetConnection(slot, SlotState::DISCONNECTED);
+        return false;
+    }
+    slot.flush_pending = flushed == 1;
+    return false;
+}
+
+void AsyncQueryExecutor::readResults(Slot& slot) {
+    if (!PQconsumeInput(slot.connection)) {
+        complete(slot, Result<QueryCursor>(ErrorCode::DATABASE_QUERY_FAILED,
+                                           "Query execution failed: " + std::string(PQerrorMessage(slot.connection))));
+        resetConnection(slot, SlotState::DISCONNECTED);
+        return;
+    }
+
+    while (!PQisBusy(slot.connection)) {
+        PGresult* result = PQgetResult(slot.connection);
+        if (!result) {
+            if (!slot.error.empty()) {
+                complete(slot, Result<QueryCursor>(ErrorCode::DATABASE_QUERY_FAILED, slot.error));
+            } else if (!slot.result) {
+                complete(slot, Result<QueryCursor>(ErrorCode::DATABASE_QUERY_FAILED, "Query returned no result"));
+            } else {
+                PGresult* finished = slot.result;
+                slot.result = nullptr;
+                complete(slot, Result<QueryCursor>(QueryCursor::fromResult(finished, slot.request->format)));
+            }
+            return;
+        }
+
+        ExecStatusType status = PQresultStatus(result);
+        if (status == PGRES_TUPLES_OK || status == PGRES_COMMAND_OK) {
+            if (slot.result) {
+                PQclear(slot.result);
+            }
+            slot.result = result;
+        } else {
+            // Keep the first error; later results only follow from it
+            if (slot.error.empty()) {
+                slot.error = "Query execution failed: " + std::string(PQresultErrorMessage(result));
+            }
+            PQclear(result);
+        }
+    }
+}
+
+void AsyncQueryExecutor::complete(Slot& slot, Result<QueryCursor> result) {
+    // Counted before the waiter can observe the result
+    completed_.fetch_add(1, std::memory_order_relaxed);
+    slot.request->promise.set_value(std::move(result));
+    slot.request.reset();
+    if (slot.result) {
+        PQclear(slot.result);
+        slot.result = nullptr;
+    }
+    slot.error.clear();
+    slot.flush_pending = false;
+    if (slot.state == SlotState::BUSY) {
+        slot.state = SlotState::IDLE;
+    }
+}
+
+void AsyncQueryExecutor::resetConnection(Slot& slot, SlotState state) {
+    if (slot.connection) {
+        PQfinish(slot.connection);
+        slot.connection = nullptr;
+    }
+    if (slot.result) {
+        PQclear(slot.result);
+        slot.result = nullptr;
+    }
+    slot.flush_pending = false;
+    slot.state = state;
+}
+
+void AsyncQueryExecutor::failPending(ErrorCode code, const std::string& message) {
+    std::deque<std::unique_ptr<Request>> failed;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        failed.swap(pending_);
+    }
+    for (auto& request : failed) {
+        completed_.fetch_add(1, std::memory_order_relaxed);
+        request->promise.set_value(Result<QueryCursor>(code, message));
+    }
+}
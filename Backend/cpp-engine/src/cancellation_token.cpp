@@ -0,0 +1,96 @@
+#include <csignal>
+
+#include "cancellation_token.h"
+#include "logger.h"
+
+std::atomic<int> CancellationToken::pending_signal_reason_{static_cast<int>(CancellationReason::NONE)};
+
+static_assert(std::atomic<int>::is_always_lock_free, "Signal flag must be lock-free to be async-signal-safe");
+
+void CancellationToken::setDeadline(std::chrono::milliseconds budget) {
+    if (budget.count() <= 0) {
+        deadline_ns_.store(0, std::memory_order_relaxed);
+        return;
+    }
+    auto deadline = std::chrono::steady_clock::now() + budget;
+    deadline_ns_.store(std::chrono::duration_cast<std::chrono::nanoseconds>(deadline.time_since_epoch()).count(),
+                       std::memory_order_relaxed);
+}
+
+void CancellationToken::cancel(CancellationReason reason) {
+    // First reason wins
+    int expected = static_cast<int>(CancellationReason::NONE);
+    reason_.compare_exchange_strong(expected, static_cast<int>(reason), std::memory_order_acq_rel);
+}
+
+bool CancellationToken::isCancelled() {
+    if (reason_.load(std::memory_order_acquire) != static_cast<int>(CancellationReason::NONE)) {
+        return true;
+    }
+
+    int pending = pending_signal_reason_.load(std::memory_order_relaxed);
+    if (pending != static_cast<int>(CancellationReason::NONE)) {
+        cancel(static_cast<CancellationReason>(pending));
+        return true;
+    }
+
+    int64_t deadline = deadline_ns_.load(std::memory_order_relaxed);
+    if (deadline != 0) {
+        int64_t now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+        if (now >= deadline) {
+            cancel(CancellationReason::DEADLINE);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+std::string CancellationToken::getReasonString() const {
+    return reasonToString(getReason());
+}
+
+void CancellationToken::reset() {
+    reason_.store(static_cast<int>(CancellationReason::NONE), std::memory_order_release);
+    deadline_ns_.store(0, std::memory_order_relaxed);
+}
+
+std::string CancellationToken::reasonToString(CancellationReason reason) {
+    switch (reason) {
+        case CancellationReason::NONE:             return "none";
+        case CancellationReason::REQUESTED:        return "cancelled";
+        case CancellationReason::SIGNAL_TERMINATE: return "sigterm";
+        case CancellationReason::SIGNAL_USER:      return "sigusr1";
+        case CancellationReason::DEADLINE:         return "deadline";
+    }
+    return "unknown";
+}
+
+void CancellationToken::handleSignal(int signal_number) {
+    // Async-signal-safe: only lock-free atomics, signal() and raise()
+    CancellationReason reason = (signal_number == SIGTERM) ? CancellationReason::SIGNAL_TERMINATE
+                                                           : CancellationReason::SIGNAL_USER;
+    int expected = static_cast<int>(CancellationReason::NONE);
+    if (!pending_signal_reason_.compare_exchange_strong(expected, static_cast<int>(reason)) &&
+        signal_number == SIGTERM) {
+        // Already stopping and asked again: fall back to the default action
+        std::signal(SIGTERM, SIG_DFL);
+        std::raise(SIGTERM);
+    }
+}
+
+void CancellationToken::installSignalHandlers() {
+    std::signal(SIGTERM, &CancellationToken::handleSignal);
+    std::signal(SIGUSR1, &CancellationToken::handleSignal);
+    Logger::debug("Cancellation handlers installed for SIGTERM and SIGUSR1");
+}
+
+void CancellationToken::restoreSignalHandlers() {
+    std::signal(SIGTERM, SIG_DFL);
+    std::signal(SIGUSR1, SIG_DFL);
+}
+
+void CancellationToken::clearPendingSignal() {
+    pending_signal_reason_.store(static_cast<int>(CancellationReason::NONE), std::memory_order_relaxed);
+}
@@ -1,18 +1,60 @@
 #include <algorithm>
 #include <fstream>
 #include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
 
 #include <nlohmann/json.hpp>
 
+#include "cancellation_token.h"
 #include "command_dispatcher.h"
 #include "error_utils.h"
+#include "execution_journal.h"
 #include "logger.h"
 #include "market_data.h"
 #include "result.h"
+#include "scaling_benchmark.h"
+#include "simulation_bundle.h"
 #include "trading_engine.h"
 
 using json = nlohmann::json;
 
+namespace {
+// Comma-separated list for --bench options; throws on anything that is not a list of integers
+std::vector<int> parseIntList(const std::string& option, const std::string& value) {
+    std::vector<int> values;
+    std::stringstream stream(value);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        size_t consumed = 0;
+        int parsed = 0;
+        try {
+            parsed = std::stoi(item, &consumed);
+        } catch (const std::exception&) {
+            consumed = 0;
+        }
+        if (item.empty() || consumed != item.size()) {
+            throw std::invalid_argument("Invalid value for " + option + ": " + value);
+        }
+        values.push_back(parsed);
+    }
+    return values;
+}
+
+std::vector<std::string> parseStringList(const std::string& value) {
+    std::vector<std::string> values;
+    std::stringstream stream(value);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        if (!item.empty()) {
+            values.push_back(item);
+        }
+    }
+    return values;
+}
+}  // namespace
+
 CommandDispatcher::CommandDispatcher() {}
 
 int CommandDispatcher::execute(int argc, char* argv[]) {
@@ -20,10 +62,16 @@ int CommandDispatcher::execute(int argc, char* argv[]) {
         if (argc > 1) {
             std::string command = argv[1];
             
-            if (command != "--simulate") {
+            if (command != "--simulate" && command != "--replay" && command != "--bench" &&
+                command != "--journal-dump") {
                 printHeader();
             }
             
+            // Long-running commands stop cleanly on SIGTERM/SIGUSR1 and still print their partial result
+            if (command == "--simulate" || command == "--backtest" || command == "--replay") {
+                CancellationToken::installSignalHandlers();
+            }
+            
             if (command == "--test-db") {
                 TradingConfig config = arg_parser.parseArguments(argc, argv);
                 return executeTest(config);
@@ -41,6 +89,12 @@ int CommandDispatcher::execute(int argc, char* argv[]) {
                 return executeStatus();
             } else if (command == "--memory-report") {
                 return executeMemoryReport();
+            } else if (command == "--replay" && argc > 2) {
+                return executeReplay(argv[2]);
+            } else if (command == "--bench") {
+                return executeBench(argc, argv);
+            } else if (command == "--journal-dump" && argc > 2) {
+                return executeJournalDump(argv[2]);
             } else {
                 return showHelp(argv[0]);
             }
@@ -91,6 +145,7 @@ int CommandDispatcher::executeBacktest(const TradingConfig& config) {
         try {
             TradingEngine engine(config.starting_capital);
             setupStrategy(engine, config);
+            auto capture = startCapture(engine, config);
             
             // For single-symbol backtests, ensure we have exactly one symbol
             TradingConfig backtest_config = config;
@@ -104,12 +159,13 @@ int CommandDispatcher::executeBacktest(const TradingConfig& config) {
                 return 1;
             }
             
-            auto json_result = engine.getTradingOrchestrator()->getBacktestResultsAsJson(backtest_result.getValue(), engine.getMarketData(), engine.getDataProcessor());
+            auto json_result = engine.getTradingOrchestrator()->getBacktestResultsAsJson(backtest_result.getValue(), engine.getMarketData());
             if (json_result.isError()) {
                 std::cout << "[ERROR] Failed to generate backtest results: " << json_result.getErrorMessage() << std::endl;
                 return 1;
             }
             std::cout << json_result.getValue().dump(2) << std::endl;
+            finishCapture(capture, config.capture_path);
             
         } catch (const std::exception& e) {
             std::cout << "[ERROR] Backtest failed: " << e.what() << std::endl;
@@ -227,6 +283,80 @@ int CommandDispatcher::executeMemoryReport() {
     }
 }
 
+int CommandDispatcher::executeReplay(const std::string& bundle_file) {
+    auto bundle_result = SimulationBundle::load(bundle_file);
+    if (bundle_result.isError()) {
+        std::cerr << "Error: " << bundle_result.getErrorMessage() << std::endl;
+        return 1;
+    }
+    auto bundle = bundle_result.getValue();
+    
+    if (bundle->getEngineVersion() != TRADING_ENGINE_VERSION) {
+        Logger::warning("Bundle was captured by engine ", bundle->getEngineVersion(),
+                        ", replaying with ", TRADING_ENGINE_VERSION);
+    }
+    
+    try {
+        TradingConfig config = arg_parser.parseConfigJson(json::parse(bundle->getConfigJson()));
+        // Same simulation, but output goes to stdout and the run is not cut short
+        config.capture_path.clear();
+        config.journal_path.clear();
+        config.progress_shm_path.clear();
+        config.result_mmap_path.clear();
+        config.deadline_ms = 0;
+        
+        Logger::info("Replaying ", bundle_file, ": ", bundle->getPriceSeriesCount(), " price series, ",
+                     bundle->getPriceRowCount(), " bars");
+        return executeCommonSimulation(config, false, bundle);
+    } catch (const std::exception& e) {
+        std::cerr << "Error: Invalid config in simulation bundle " << bundle_file << ": " << e.what() << std::endl;
+        return 1;
+    }
+}
+
+int CommandDispatcher::executeBench(int argc, char* argv[]) {
+    ScalingBenchmark::Options options;
+    for (int i = 2; i < argc; ++i) {
+        std::string option = argv[i];
+        if (i + 1 >= argc) {
+            std::cerr << "Error: Missing value for " << option << std::endl;
+            return 1;
+        }
+        std::string value = argv[++i];
+        if (option == "--symbols") {
+            options.symbol_counts = parseIntList(option, value);
+        } else if (option == "--years") {
+            options.years = parseIntList(option, value);
+        } else if (option == "--strategies") {
+            options.strategies = parseStringList(value);
+        } else if (option == "--seed") {
+            options.seed = std::stoull(value);
+        } else {
+            std::cerr << "Error: Unknown --bench option " << option << std::endl;
+            return 1;
+        }
+    }
+    
+    // Per-case progress goes to stderr; stdout carries only the JSON report
+    auto report = ScalingBenchmark().run(options);
+    if (report.isError()) {
+        std::cerr << "Error: " << report.getErrorMessage() << std::endl;
+        return 1;
+    }
+    std::cout << report.getValue().dump(2) << std::endl;
+    return 0;
+}
+
+int CommandDispatcher::executeJournalDump(const std::string& journal_file) {
+    auto journal = ExecutionJournal::readJson(journal_file);
+    if (journal.isError()) {
+        std::cerr << "Error: " << journal.getErrorMessage() << std::endl;
+        return 1;
+    }
+    std::cout << journal.getValue().dump(2) << std::endl;
+    return 0;
+}
+
 int CommandDispatcher::showHelp(const char* program_name) {
     printHeader();
     std::cout << "\nUsage:" << std::endl;
@@ -235,12 +365,28 @@ int CommandDispatcher::showHelp(const char* program_name) {
     std::cout << "  " << program_name << " --memory-report         Show engine memory usage statistics" << std::endl;
     std::cout << "  " << program_name << " --test-db [options]     Test database connectivity" << std::endl;
     std::cout << "  " << program_name << " --backtest [options]    Run backtest with moving average strategy" << std::endl;
+    std::cout << "  " << program_name << " --replay FILE           Rerun a captured simulation without a database" << std::endl;
+    std::cout << "  " << program_name << " --bench [options]       Measure throughput on synthetic data and output JSON" << std::endl;
+    std::cout << "  " << program_name << " --journal-dump FILE     Print an execution journal as JSON" << std::endl;
     std::cout << "  " << program_name << " --help                  Show this help" << std::endl;
     std::cout << "\nOptions:" << std::endl;
     std::cout << "  --symbol SYMBOL(S) Stock symbol(s) to analyze, comma-separated for multi-symbol (default: AAPL)" << std::endl;
     std::cout << "  --start DATE      Start date (default: 2023-01-01)" << std::endl;
     std::cout << "  --end DATE        End date (default: 2023-12-31)" << std::endl;
     std::cout << "  --capital AMOUNT  Starting capital (default: 10000)" << std::endl;
+    std::cout << "  --progress-shm PATH  Publish progress to a memory-mapped file instead of stderr" << std::endl;
+    std::cout << "  --deadline-ms MS  Stop after MS milliseconds and return the truncated result" << std::endl;
+    std::cout << "  --result-mmap PATH  Write the result as a columnar binary file and print only its location" << std::endl;
+    std::cout << "  --capture FILE    Record the config and every database input to a bundle for --replay" << std::endl;
+    std::cout << "  --journal FILE    Append every order placement, fill, rejection and cancellation to FILE" << std::endl;
+    std::cout << "  --sleeve-parallel true  Simulate each symbol's capital sleeve on its own thread and merge" << std::endl;
+    std::cout << "  --sleeve-threads N  Worker threads for --sleeve-parallel (default: one per core)" << std::endl;
+    std::cout << "  --db-async-connections N  Connections for concurrent price queries, capped at the symbol count (default: 4, 0 = sequential)" << std::endl;
+    std::cout << "\nBenchmark options:" << std::endl;
+    std::cout << "  --symbols LIST    Universe sizes to run (default: 1,10,100,1000)" << std::endl;
+    std::cout << "  --years LIST      History lengths in years of 252 bars (default: 1,10,30)" << std::endl;
+    std::cout << "  --strategies LIST Strategies to run (default: ma_crossover,rsi)" << std::endl;
+    std::cout << "  --seed N          Seed for the synthetic prices (default: 42)" << std::endl;
     return 0;
 }
 
@@ -337,13 +483,23 @@ void CommandDispatcher::setupStrategy(TradingEngine& engine, const TradingConfig
     }
 }
 
-int CommandDispatcher::executeCommonSimulation(const TradingConfig& config, bool verbose) {
+int CommandDispatcher::executeCommonSimulation(const TradingConfig& config, bool verbose,
+                                               std::shared_ptr<SimulationBundle> replay_bundle) {
     TradingEngine engine(config.starting_capital);
     setupStrategy(engine, config, verbose);
     
+    std::shared_ptr<SimulationBundle> capture;
+    if (replay_bundle) {
+        engine.getMarketData()->setReplayBundle(std::move(replay_bundle));
+    } else {
+        capture = startCapture(engine, config);
+    }
+    
     try {
         // Use unified runSimulation method for all cases
         auto result = engine.getTradingOrchestrator()->runSimulation(config, engine.getPortfolio(), engine.getMarketData(), engine.getDataProcessor(), engine.getStrategyManager(), engine.getResultCalculator());
+        // Failed runs are captured too, so the failure itself can be replayed
+        finishCapture(capture, config.capture_path);
         if (result.isError()) {
             std::cerr << "Error: " << result.getErrorMessage() << std::endl;
             if (!result.getErrorDetails().empty()) {
@@ -361,6 +517,28 @@ int CommandDispatcher::executeCommonSimulation(const TradingConfig& config, bool
     return 0;
 }
 
+std::shared_ptr<SimulationBundle> CommandDispatcher::startCapture(TradingEngine& engine, const TradingConfig& config) {
+    if (config.capture_path.empty()) {
+        return nullptr;
+    }
+    auto bundle = std::make_shared<SimulationBundle>();
+    bundle->setConfigJson(arg_parser.configToJson(config).dump());
+    engine.getMarketData()->setCaptureBundle(bundle);
+    return bundle;
+}
+
+void CommandDispatcher::finishCapture(const std::shared_ptr<SimulationBundle>& bundle, const std::string& path) {
+    if (!bundle) {
+        return;
+    }
+    auto save_result = bundle->save(path);
+    if (save_result.isError()) {
+        Logger::error("Failed to write simulation bundle: ", save_result.getErrorMessage());
+        return;
+    }
+    Logger::info("Captured simulation inputs to ", path, " (", save_result.getValue(), " bytes)");
+}
+
 TradingConfig CommandDispatcher::loadConfigFromFile(const std::string& config_file) {
     std::ifstream file(config_file);
     if (!file.is_open()) {
@@ -371,49 +549,5 @@ TradingConfig CommandDispatcher::loadConfigFromFile(const std::string& config_fi
     file >> config;
     file.close();
     
-    TradingConfig sim_config;
-    
-    // Clear default symbols from constructor and load from config
-    sim_config.symbols.clear();
-    if (config.contains("symbols") && config["symbols"].is_array()) {
-        for (const auto& s : config["symbols"]) {
-            sim_config.symbols.push_back(s.get<std::string>());
-        }
-    } else if (config.contains("symbol")) {
-        sim_config.symbols.push_back(config.value("symbol", "AAPL"));
-    } else {
-        sim_config.symbols.push_back("AAPL");
-    }
-    
-    // Load basic configuration
-    sim_config.start_date = config.value("start_date", "2023-01-01");
-    sim_config.end_date = config.value("end_date", "2023-12-31");
-    sim_config.starting_capital = config.value("starting_capital", 10000.0);
-    sim_config.strategy_name = config.value("strategy", "ma_crossover");
-    
-    // Load strategy parameters
-    if (config.contains("strategy_parameters") && config["strategy_parameters"].is_object()) {
-        for (const auto& param : config["strategy_parameters"].items()) {
-            sim_config.strategy_parameters[param.key()] = param.value().get<double>();
-        }
-    } else {
-        // Fallback to individual parameter keys for backward compatibility
-        if (config.contains("short_ma")) {
-            sim_config.strategy_parameters["short_ma"] = config["short_ma"].get<double>();
-        }
-        if (config.contains("long_ma")) {
-            sim_config.strategy_parameters["long_ma"] = config["long_ma"].get<double>();
-        }
-        if (config.contains("rsi_period")) {
-            sim_config.strategy_parameters["rsi_period"] = config["rsi_period"].get<double>();
-        }
-        if (config.contains("rsi_oversold")) {
-            sim_config.strategy_parameters["rsi_oversold"] = config["rsi_oversold"].get<double>();
-        }
-        if (config.contains("rsi_overbought")) {
-            sim_config.strategy_parameters["rsi_overbought"] = config["rsi_overbought"].get<double>();
-        }
-    }
-    
-    return sim_config;
+    return arg_parser.parseConfigJson(config);
 }
\ No newline at end of file
@@ -0,0 +1,237 @@
+#include <algorithm>
+#include <cmath>
+
+#include "covariance_matrix.h"
+
+namespace {
+constexpr size_t BLOCK_SIZE = 64;
+constexpr double TRADING_DAYS_PER_YEAR = 252.0;
+constexpr double MIN_VARIANCE = 1e-12;
+}
+
+CovarianceMatrix::CovarianceMatrix(size_t assets) : assets_(assets), values_(assets * assets, 0.0) {}
+
+CovarianceMatrix CovarianceMatrix::fromReturns(const std::vector<double>& returns, size_t observations, size_t assets) {
+    CovarianceMatrix matrix(assets);
+    matrix.observations_ = observations;
+    if (observations == 0 || assets == 0 || returns.size() < observations * assets) {
+        return matrix;
+    }
+
+    // Column means
+    std::vector<double> means(assets, 0.0);
+    for (size_t t = 0; t < observations; ++t) {
+        const double* row = &returns[t * assets];
+        for (size_t i = 0; i < assets; ++i) {
+            means[i] += row[i];
+        }
+    }
+    for (size_t i = 0; i < assets; ++i) {
+        means[i] /= static_cast<double>(observations);
+    }
+
+    // Centered copy keeps the kernel a pure multiply-add
+    std::vector<double> centered(observations * assets);
+    for (size_t t = 0; t < observations; ++t) {
+        const double* row = &returns[t * assets];
+        double* out = &centered[t * assets];
+        for (size_t i = 0; i < assets; ++i) {
+            out[i] = row[i] - means[i];
+        }
+    }
+
+    // Blocked upper-triangle accumulation: each tile of C stays cache resident
+    // while the observations stream through it
+    double* c = matrix.values_.data();
+    for (size_t ib = 0; ib < assets; ib += BLOCK_SIZE) {
+        size_t i_end = std::min(ib + BLOCK_SIZE, assets);
+        for (size_t jb = ib; jb < assets; jb += BLOCK_SIZE) {
+            size_t j_end = std::min(jb + BLOCK_SIZE, assets);
+            for (size_t t = 0; t < observations; ++t) {
+                const double* row = &centered[t * assets];
+                for (size_t i = ib; i < i_end; ++i) {
+                    const double a = row[i];
+                    double* c_row = c + i * assets;
+                    for (size_t j = std::max(jb, i); j < j_end; ++j) {
+                        c_row[j] += a * row[j];
+                    }
+                }
+            }
+        }
+    }
+
+    const double scale = 1.0 / static_cast<double>(observations);
+    for (size_t i = 0; i < assets; ++i) {
+        c[i * assets + i] *= scale;
+        for (size_t j = i + 1; j < assets; ++j) {
+            c[i * assets + j] *= scale;
+            c[j * assets + i] = c[i * assets + j];
+        }
+    }
+
+    return matrix;
+}
+
+double CovarianceMatrix::annualizedVolatility(size_t i) const {
+    return std::sqrt(std::max(0.0, variance(i)) * TRADING_DAYS_PER_YEAR);
+}
+
+double CovarianceMatrix::correlation(size_t i, size_t j) const {
+    double denominator = std::sqrt(std::max(0.0, variance(i)) * std::max(0.0, variance(j)));
+    return denominator > 0 ? (*this)(i, j) / denominator : 0.0;
+}
+
+std::vector<double> CovarianceMatrix::equalRiskContributionWeights(int max_iterations, double tolerance) const {
+    const size_t n = assets_;
+    if (n == 0) return {};
+    if (n == 1) return {1.0};
+
+    // Solve y_i * (Sigma y)_i = b for every i, starting from inverse volatility
+    const double budget = 1.0 / static_cast<double>(n);
+    std::vector<double> y(n);
+    for (size_t i = 0; i < n; ++i) {
+        y[i] = 1.0 / std::sqrt(std::max(variance(i), MIN_VARIANCE));
+    }
+
+    std::vector<double> sigma_y(n, 0.0);
+    for (size_t i = 0; i < n; ++i) {
+        const double* row = &values_[i * n];
+        double sum = 0.0;
+        for (size_t k = 0; k < n; ++k) {
+            sum += row[k] * y[k];
+        }
+        sigma_y[i] = sum;
+    }
+
+    for (int iteration = 0; iteration < max_iterations; ++iteration) {
+        double max_change = 0.0;
+
+        for (size_t i = 0; i < n; ++i) {
+            const double s_ii = std::max(variance(i), MIN_VARIANCE);
+            const double off_diagonal = sigma_y[i] - variance(i) * y[i];
+            const double updated = (-off_diagonal + std::sqrt(off_diagonal * off_diagonal + 4.0 * s_ii * budget)) / (2.0 * s_ii);
+            const double delta = updated - y[i];
+
+            if (delta != 0.0) {
+                // Sigma is symmetric, so row i doubles as column i
+                const double* row = &values_[i * n];
+                for (size_t k = 0; k < n; ++k) {
+                    sigma_y[k] += row[k] * delta;
+                }
+                y[i] = updated;
+                max_change = std::max(max_change, std::abs(delta) / updated);
+            }
+        }
+
+        if (max_change < tolerance) {
+            break;
+        }
+    }
+
+    double total = 0.0;
+    for (double value : y) total += value;
+    for (double& value : y) value /= total;
+    return y;
+}
+
+std::vector<double> CovarianceMatrix::riskContributions(const std::vector<double>& weights) const {
+    const size_t n = assets_;
+    std::vector<double> contributions(n, 0.0);
+    if (weights.size() != n || n == 0) return contributions;
+
+    double portfolio_variance = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        const double* row = &values_[i * n];
+        double marginal = 0.0;
+        for (size_t k = 0; k < n; ++k) {
+            marginal += row[k] * weights[k];
+        }
+        contributions[i] = weights[i] * marginal;
+        portfolio_variance += contributions[i];
+    }
+
+    if (portfolio_variance > 0) {
+        for (double& contribution : contributions) {
+            contribution /= portfolio_variance;
+        }
+    }
+    return contributions;
+}
+
+RollingCovariance::RollingCovariance(size_t assets, size_t window) {
+    reset(assets, window);
+}
+
+void RollingCovariance::reset(size_t assets, size_t window) {
+    assets_ = assets;
+    window_ = std::max<size_t>(window, 2);
+    head_ = 0;
+    count_ = 0;
+    updates_since_rebuild_ = 0;
+    rows_.assign(window_ * assets_, 0.0);
+    sums_.assign(assets_, 0.0);
+    cross_.assign(assets_ * assets_, 0.0);
+}
+
+void RollingCovariance::push(const std::vector<double>& returns) {
+    if (returns.size() != assets_ || assets_ == 0) {
+        return;
+    }
+
+    size_t slot;
+    if (count_ == window_) {
+        // Evict the oldest observation before overwriting its slot
+        slot = head_;
+        addOuterProduct(&rows_[slot * assets_], -1.0);
+        head_ = (head_ + 1) % window_;
+    } else {
+        slot = (head_ + count_) % window_;
+        ++count_;
+    }
+
+    std::copy(returns.begin(), returns.end(), rows_.begin() + slot * assets_);
+    addOuterProduct(&rows_[slot * assets_], 1.0);
+
+    if (++updates_since_rebuild_ >= window_) {
+        rebuild();
+    }
+}
+
+CovarianceMatrix RollingCovariance::covariance() const {
+    CovarianceMatrix matrix(assets_);
+    matrix.setObservationCount(count_);
+    if (count_ == 0) {
+        return matrix;
+    }
+
+    const double scale = 1.0 / static_cast<double>(count_);
+    for (size_t i = 0; i < assets_; ++i) {
+        const double mean_i = sums_[i] * scale;
+        for (size_t j = i; j < assets_; ++j) {
+            double value = cross_[i * assets_ + j] * scale - mean_i * sums_[j] * scale;
+            matrix.at(i, j) = value;
+            matrix.at(j, i) = value;
+        }
+    }
+    return matrix;
+}
+
+void RollingCovariance::addOuterProduct(const double* row, double sign) {
+    for (size_t i = 0; i < assets_; ++i) {
+        const double a = sign * row[i];
+        sums_[i] += a;
+        double* c_row = &cross_[i * assets_];
+        for (size_t j = i; j < assets_; ++j) {
+            c_row[j] += a * row[j];
+        }
+    }
+}
+
+void RollingCovariance::rebuild() {
+    std::fill(sums_.begin(), sums_.end(), 0.0);
+    std::fill(cross_.begin(), cross_.end(), 0.0);
+    for (size_t k = 0; k < count_; ++k) {
+        addOuterProduct(&rows_[((head_ + k) % window_) * assets_], 1.0);
+    }
+    updates_since_rebuild_ = 0;
+}
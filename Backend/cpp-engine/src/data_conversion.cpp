@@ -1,5 +1,6 @@
+#include <charconv>
 #include <iostream>
-#include <sstream>
+#include <system_error>
 
 #include "data_conversion.h"
 
@@ -9,24 +10,96 @@ std::vector<PriceData> convertToTechnicalData(const std::vector<std::map<std::st
     std::vector<PriceData> tech_data;
     tech_data.reserve(db_data.size());
     
+    // Field names are resolved on the first row and reused for the rest of the result set
+    PriceRowLayout layout;
+    bool has_layout = false;
+    
     for (const auto& row : db_data) {
-        try {
-            if (!validateDatabaseRow(row)) {
-                continue;
-            }
-            
-            PriceData data = convertRowToPriceData(row);
-            tech_data.push_back(data);
-            
-        } catch (const std::exception& e) {
-            std::cerr << "Error converting price data: " << e.what() << std::endl;
+        PriceData data;
+        if (has_layout && convertRow(row, layout, data)) {
+            tech_data.push_back(std::move(data));
             continue;
         }
+        
+        // First row, a row using other column names, or a bad value
+        PriceRowLayout row_layout;
+        if (!resolvePriceRowLayout(row, row_layout)) {
+            continue;
+        }
+        if (!convertRow(row, row_layout, data)) {
+            std::cerr << "Error converting price data: invalid numeric value in row dated "
+                      << getFieldValue(row, row_layout.date) << std::endl;
+            continue;
+        }
+        
+        layout = std::move(row_layout);
+        has_layout = true;
+        tech_data.push_back(std::move(data));
     }
     
     return tech_data;
 }
 
+bool resolvePriceRowLayout(const std::map<std::string, std::string>& row, PriceRowLayout& layout) {
+    auto pick = [&row](const char* preferred, const char* alternative, std::string& name) {
+        if (row.count(preferred)) {
+            name = preferred;
+        } else if (alternative && row.count(alternative)) {
+            name = alternative;
+        } else {
+            return false;
+        }
+        return true;
+    };
+    
+    return pick("time", "date", layout.date) && pick("open", "open_price", layout.open) &&
+           pick("high", "high_price", layout.high) && pick("low", "low_price", layout.low) &&
+           pick("close", "close_price", layout.close) && pick("volume", nullptr, layout.volume);
+}
+
+bool convertRow(const std::map<std::string, std::string>& row, const PriceRowLayout& layout, PriceData& data) {
+    auto date_it = row.find(layout.date);
+    auto open_it = row.find(layout.open);
+    auto high_it = row.find(layout.high);
+    auto low_it = row.find(layout.low);
+    auto close_it = row.find(layout.close);
+    auto volume_it = row.find(layout.volume);
+    if (date_it == row.end() || open_it == row.end() || high_it == row.end() ||
+        low_it == row.end() || close_it == row.end() || volume_it == row.end()) {
+        return false;
+    }
+    
+    if (!parseDouble(open_it->second, data.open) || !parseDouble(high_it->second, data.high) ||
+        !parseDouble(low_it->second, data.low) || !parseDouble(close_it->second, data.close) ||
+        !parseLong(volume_it->second, data.volume)) {
+        return false;
+    }
+    data.date = date_it->second;
+    return true;
+}
+
+bool parseDouble(std::string_view text, double& value) {
+    if (!text.empty() && text.front() == '+') {
+        text.remove_prefix(1);
+    }
+    if (text.empty()) {
+        return false;
+    }
+    auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+    return error == std::errc() && end == text.data() + text.size();
+}
+
+bool parseLong(std::string_view text, long& value) {
+    if (!text.empty() && text.front() == '+') {
+        text.remove_prefix(1);
+    }
+    if (text.empty()) {
+        return false;
+    }
+    auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+    return error == std::errc() && end == text.data() + text.size();
+}
+
 PriceData convertRowToPriceData(const std::map<std::string, std::string>& row) {
     PriceData data;
     
@@ -47,21 +120,21 @@ double safeStringToDouble(const std::string& str, const std::string& field_name)
         throw std::invalid_argument("Empty string for field: " + field_name);
     }
     
-    try {
-        size_t pos;
-        double value = std::stod(str, &pos);
-        
-        // Check if entire string was consumed
-        if (pos != str.length()) {
-            throw std::invalid_argument("Invalid numeric format in field: " + field_name + ", value: " + str);
-        }
-        
+    double value;
+    if (parseDouble(str, value)) {
         return value;
-    } catch (const std::invalid_argument& e) {
-        throw std::invalid_argument("Invalid double conversion for field: " + field_name + ", value: " + str);
-    } catch (const std::out_of_range& e) {
+    }
+    
+    // Only the failure path pays for classifying the error
+    double ignored;
+    std::string_view text(str);
+    if (!text.empty() && text.front() == '+') {
+        text.remove_prefix(1);
+    }
+    if (std::from_chars(text.data(), text.data() + text.size(), ignored).ec == std::errc::result_out_of_range) {
         throw std::out_of_range("Out of range double conversion for field: " + field_name + ", value: " + str);
     }
+    throw std::invalid_argument("Invalid double conversion for field: " + field_name + ", value: " + str);
 }
 
 long safeStringToLong(const std::string& str, const std::string& field_name) {
@@ -69,21 +142,20 @@ long safeStringToLong(const std::string& str, const std::string& field_name) {
         throw std::invalid_argument("Empty string for field: " + field_name);
     }
     
-    try {
-        size_t pos;
-        long value = std::stol(str, &pos);
-        
-        // Check if entire string was consumed
-        if (pos != str.length()) {
-            throw std::invalid_argument("Invalid numeric format in field: " + field_name + ", value: " + str);
-        }
-        
+    long value;
+    if (parseLong(str, value)) {
         return value;
-    } catch (const std::invalid_argument& e) {
-        throw std::invalid_argument("Invalid long conversion for field: " + field_name + ", value: " + str);
-    } catch (const std::out_of_range& e) {
+    }
+    
+    long ignored;
+    std::string_view text(str);
+    if (!text.empty() && text.front() == '+') {
+        text.remove_prefix(1);
+    }
+    if (std::from_chars(text.data(), text.data() + text.size(), ignored).ec == std::errc::result_out_of_range) {
         throw std::out_of_range("Out of range long conversion for field: " + field_name + ", value: " + str);
     }
+    throw std::invalid_argument("Invalid long conversion for field: " + field_name + ", value: " + str);
 }
 
 bool validateDatabaseRow(const std::map<std::string, std::string>& row) {
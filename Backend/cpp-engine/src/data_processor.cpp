@@ -1,26 +1,61 @@
 #include <algorithm>
+#include <future>
 #include <set>
 
 #include "data_conversion.h"
 #include "data_processor.h"
+#include "date_time_utils.h"
 #include "logger.h"
 
 Result<std::map<std::string, std::vector<PriceData>>> DataProcessor::loadMultiSymbolData(
     const std::vector<std::string>& symbols,
     const std::string& start_date,
     const std::string& end_date,
-    MarketData* market_data) {
+    MarketData* market_data,
+    CancellationToken* cancellation) {
     
     Logger::debug("Getting historical price data for ", symbols.size(), " symbols:");
     
     std::map<std::string, std::vector<PriceData>> multi_symbol_data;
     std::vector<std::string> failed_symbols;
     
+    // Issue every price query up front so the database works on the remaining
+    // symbols while earlier results are decoded. The pool holds no more connections
+    // than there are symbols and is closed again once the load is over
+    std::vector<std::future<Result<std::vector<PriceData>>>> requests;
+    if (symbols.size() > 1 && market_data && !(cancellation && cancellation->isCancelled())) {
+        market_data->reserveAsyncConnections(symbols.size());
+        requests.reserve(symbols.size());
+        for (const auto& symbol : symbols) {
+            requests.push_back(market_data->requestHistoricalPriceData(symbol, start_date, end_date));
+        }
+    }
+    
     // Fetch data for each symbol
-    for (const auto& symbol : symbols) {
+    for (size_t i = 0; i < symbols.size(); ++i) {
+        const std::string& symbol = symbols[i];
+        // Checked only between symbols: queries already issued above run to completion on the
+        // server and are not interrupted. A cancelled load returns what it has collected, and the
+        // simulation loop then stops on its first poll with a truncated result
+        if (cancellation && cancellation->isCancelled()) {
+            Logger::warning("Data loading cancelled (", cancellation->getReasonString(), ") after ",
+                           multi_symbol_data.size(), " of ", symbols.size(), " symbols");
+            if (multi_symbol_data.empty()) {
+                if (!requests.empty()) {
+                    market_data->closeAsyncExecutor();
+                }
+                return Result<std::map<std::string, std::vector<PriceData>>>(
+                    ErrorCode::ENGINE_CANCELLED,
+                    "Cancelled (" + cancellation->getReasonString() + ") before any market data was loaded");
+            }
+            break;
+        }
+        
         Logger::debug("Fetching data for symbol: ", symbol);
         
-        auto symbol_result = processSymbolData(symbol, start_date, end_date, market_data);
+        auto symbol_result = requests.empty()
+            ? processSymbolData(symbol, start_date, end_date, market_data)
+            : checkSymbolData(symbol, start_date, end_date, requests[i].get());
         
         if (symbol_result.isError()) {
             Logger::debug("Failed to process data for symbol ", symbol, ": ", symbol_result.getErrorMessage());
@@ -39,6 +74,10 @@ Result<std::map<std::string, std::vector<PriceData>>> DataProcessor::loadMultiSy
         Logger::debug("Successfully loaded ", price_data.size(), " data points for ", symbol);
     }
     
+    if (!requests.empty()) {
+        market_data->closeAsyncExecutor();
+    }
+    
     // Check if we have data for at least one symbol
     if (multi_symbol_data.empty()) {
         std::string error_msg = "No data available for any of the requested symbols: ";
@@ -65,22 +104,19 @@ Result<std::map<std::string, std::vector<PriceData>>> DataProcessor::loadMultiSy
 
 void DataProcessor::updateHistoricalWindows(
     const std::map<std::string, std::vector<PriceData>>& multi_symbol_data,
-    const std::string& current_date,
-    const std::map<std::string, std::map<std::string, size_t>>& symbol_date_indices,
+    size_t session,
+    const std::vector<std::vector<int32_t>>& session_indices,
     std::map<std::string, std::vector<PriceData>>& historical_windows,
     std::map<std::string, double>& current_prices) {
     
     // Update current prices and historical data for each symbol
+    size_t symbol_index = 0;
     for (const auto& [symbol, data] : multi_symbol_data) {
-        auto symbol_indices_it = symbol_date_indices.find(symbol);
-        if (symbol_indices_it == symbol_date_indices.end()) {
-            continue;
-        }
-        
-        auto date_it = symbol_indices_it->second.find(current_date);
-        if (date_it != symbol_indices_it->second.end()) {
+        const auto& indices = session_indices[symbol_index++];
+        int32_t bar = session < indices.size() ? indices[session] : -1;
+        if (bar >= 0) {
             // This symbol has data for current date
-            const auto& price_point = data[date_it->second];
+            const auto& price_point = data[static_cast<size_t>(bar)];
             current_prices[symbol] = price_point.close;
             historical_windows[symbol].push_back(price_point);
         }
@@ -142,19 +178,26 @@ std::vector<std::string> DataProcessor::createUnifiedTimeline(const std::map<std
     return timeline;
 }
 
-std::map<std::string, std::map<std::string, size_t>> DataProcessor::createDateIndices(
-    const std::map<std::string, std::vector<PriceData>>& multi_symbol_data) {
+std::vector<std::vector<int32_t>> DataProcessor::createSessionIndices(
+    const std::map<std::string, std::vector<PriceData>>& multi_symbol_data,
+    const TradingCalendar& calendar) const {
     
-    // Create symbol-to-data-index mappings for efficient lookups
-    std::map<std::string, std::map<std::string, size_t>> symbol_date_indices;
+    // Dense session-to-bar tables, so the loop looks bars up by index instead of by date string
+    std::vector<std::vector<int32_t>> session_indices;
+    session_indices.reserve(multi_symbol_data.size());
     for (const auto& [symbol, data] : multi_symbol_data) {
+        std::vector<int32_t> indices(calendar.sessionCount(), -1);
         for (size_t i = 0; i < data.size(); ++i) {
-            symbol_date_indices[symbol][data[i].date] = i;
+            int32_t day = 0;
+            if (DateTimeUtils::parseIsoDate(data[i].date, day) && calendar.isSession(day)) {
+                indices[calendar.sessionsThrough(day) - 1] = static_cast<int32_t>(i);
+            }
         }
         Logger::debug("Indexed ", data.size(), " data points for ", symbol);
+        session_indices.push_back(std::move(indices));
     }
     
-    return symbol_date_indices;
+    return session_indices;
 }
 
 std::string DataProcessor::createDataErrorMessage(
@@ -211,32 +254,32 @@ Result<std::vector<PriceData>> DataProcessor::processSymbolData(
     const std::string& end_date,
     MarketData* market_data) const {
     
-    auto symbol_result = market_data->getHistoricalPrices(symbol, start_date, end_date);
+    return checkSymbolData(symbol, start_date, end_date,
+                           market_data->getHistoricalPriceData(symbol, start_date, end_date));
+}
+
+Result<std::vector<PriceData>> DataProcessor::checkSymbolData(
+    const std::string& symbol,
+    const std::string& start_date,
+    const std::string& end_date,
+    Result<std::vector<PriceData>> symbol_result) const {
     
+    // Bars come back typed from the binary cursor; decode failures surface as DATA_PARSING_FAILED
     if (symbol_result.isError()) {
+        if (symbol_result.getError().code == ErrorCode::DATA_PARSING_FAILED) {
+            Logger::error("Error decoding price data for ", symbol, ": ", symbol_result.getErrorMessage());
+            std::string error_msg = createDataErrorMessage(symbol, start_date, end_date, "conversion_failed");
+            return Result<std::vector<PriceData>>(ErrorCode::DATA_PARSING_FAILED, error_msg);
+        }
         return Result<std::vector<PriceData>>(symbol_result.getError());
     }
     
-    const auto& price_data_raw = symbol_result.getValue();
-    if (price_data_raw.empty()) {
+    if (symbol_result.getValue().empty()) {
         std::string error_msg = createDataErrorMessage(symbol, start_date, end_date, "no_data");
         return Result<std::vector<PriceData>>(ErrorCode::ENGINE_NO_DATA_AVAILABLE, error_msg);
     }
     
-    try {
-        auto price_data = convertToTechnicalData(price_data_raw);
-        if (price_data.empty()) {
-            std::string error_msg = createDataErrorMessage(symbol, start_date, end_date, "conversion_failed");
-            return Result<std::vector<PriceData>>(ErrorCode::DATA_PARSING_FAILED, error_msg);
-        }
-        
-        return Result<std::vector<PriceData>>(std::move(price_data));
-        
-    } catch (const std::exception& e) {
-        Logger::error("Error converting price data for ", symbol, ": ", e.what());
-        std::string error_msg = createDataErrorMessage(symbol, start_date, end_date, "conversion_failed");
-        return Result<std::vector<PriceData>>(ErrorCode::DATA_PARSING_FAILED, error_msg);
-    }
+    return symbol_result;
 }
 
 // Memory optimization methods
@@ -192,99 +192,122 @@ Result<void> DatabaseConnection::executeQuery(const std::string& query) {
     return Result<void>();
 }
 
-Result<std::vector<std::map<std::string, std::string>>> DatabaseConnection::selectQuery(const std::string& query) {
-    auto result = executeQueryInternal(query);
-    if (result.isError()) {
-        return Result<std::vector<std::map<std::string, std::string>>>(result.getError());
+Result<QueryCursor> DatabaseConnection::openCursor(const std::string& query,
+                                                   const std::vector<std::string>& params,
+                                                   QueryResultFormat format) {
+    if (!isConnected()) {
+        auto conn_result = connect();
+        if (conn_result.isError()) {
+            return Result<QueryCursor>(conn_result.getError());
+        }
     }
     
-    PGResultWrapper wrapper(result.getValue());
-    PGresult* pg_result = result.getValue();
-    
+    QueryCursor cursor(connection_);
+    auto start_result = cursor.start(query, params, format);
+    if (start_result.isError()) {
+        return Result<QueryCursor>(start_result.getError());
+    }
+    return Result<QueryCursor>(std::move(cursor));
+}
+
+// Legacy row maps: streamed row by row, field names resolved once per query
+Result<std::vector<std::map<std::string, std::string>>> DatabaseConnection::collectRows(QueryCursor& cursor) {
     std::vector<std::map<std::string, std::string>> results;
-    int num_rows = PQntuples(pg_result);
-    int num_cols = PQnfields(pg_result);
+    std::vector<std::string> names;
+    std::vector<QueryColumn> columns;
     
-    for (int row = 0; row < num_rows; ++row) {
-        std::map<std::string, std::string> row_data;
+    while (true) {
+        auto has_row = cursor.next();
+        if (has_row.isError()) {
+            return Result<std::vector<std::map<std::string, std::string>>>(has_row.getError());
+        }
+        if (!has_row.getValue()) {
+            break;
+        }
         
-        for (int col = 0; col < num_cols; ++col) {
-            std::string field_name = PQfname(pg_result, col);
-            std::string field_value = PQgetisnull(pg_result, row, col) ? 
-                                    "" : PQgetvalue(pg_result, row, col);
-            row_data[field_name] = field_value;
+        if (columns.empty()) {
+            for (int col = 0; col < cursor.columnCount(); ++col) {
+                names.push_back(cursor.columnName(col));
+                columns.push_back(cursor.column(names.back(), QueryValueKind::TEXT).getValue());
+            }
         }
         
+        std::map<std::string, std::string> row_data;
+        for (size_t col = 0; col < columns.size(); ++col) {
+            row_data.emplace(names[col], cursor.isNull(columns[col]) ? std::string() : std::string(cursor.getText(columns[col])));
+        }
         results.push_back(std::move(row_data));
     }
     
     return Result<std::vector<std::map<std::string, std::string>>>(std::move(results));
 }
 
-Result<std::vector<std::map<std::string, std::string>>> DatabaseConnection::executePreparedQuery(
-    const std::string& query, 
-    const std::vector<std::string>& params) {
-    
-    // Ensure connection
-    if (!isConnected()) {
-        auto conn_result = connect();
-        if (conn_result.isError()) {
-            return Result<std::vector<std::map<std::string, std::string>>>(conn_result.getError());
+Result<std::vector<std::string>> DatabaseConnection::collectTextColumn(QueryCursor& cursor, const std::string& column_name) {
+    std::vector<std::string> values;
+    QueryColumn column;
+    
+    while (true) {
+        auto has_row = cursor.next();
+        if (has_row.isError()) {
+            return Result<std::vector<std::string>>(has_row.getError());
+        }
+        if (!has_row.getValue()) {
+            break;
+        }
+        
+        if (column.index < 0) {
+            auto column_result = cursor.column(column_name, QueryValueKind::TEXT);
+            if (column_result.isError()) {
+                cursor.cancel();
+                return Result<std::vector<std::string>>(column_result.getError());
+            }
+            column = column_result.getValue();
+        }
+        if (!cursor.isNull(column)) {
+            values.emplace_back(cursor.getText(column));
         }
     }
     
-    // Convert parameters to C-style arrays for PostgreSQL
-    std::vector<const char*> param_values;
-    param_values.reserve(params.size());
-    
-    for (const auto& param : params) {
-        param_values.push_back(param.c_str());
+    return Result<std::vector<std::string>>(std::move(values));
+}
+
+Result<bool> DatabaseConnection::fetchSingleBool(QueryCursor& cursor, const std::string& column_name) {
+    auto has_row = cursor.next();
+    if (has_row.isError()) {
+        return Result<bool>(has_row.getError());
     }
-    
-    // Execute parameterized query
-    PGresult* result = PQexecParams(
-        connection_,
-        query.c_str(),
-        static_cast<int>(params.size()),
-        nullptr,  // param types (NULL = infer)
-        param_values.data(),
-        nullptr,  // param lengths (NULL = text format)
-        nullptr,  // param formats (NULL = text format)
-        0         // result format (0 = text)
-    );
-    
-    if (!result) {
-        return Result<std::vector<std::map<std::string, std::string>>>(
-            ErrorCode::DATABASE_QUERY_FAILED, "Prepared query execution failed: no result returned");
+    if (!has_row.getValue()) {
+        return Result<bool>(ErrorCode::DATABASE_QUERY_FAILED, "No " + column_name + " result returned");
     }
     
-    PGResultWrapper wrapper(result);
-    
-    ExecStatusType status = PQresultStatus(result);
-    if (status != PGRES_TUPLES_OK) {
-        std::string error_msg = "Prepared query execution failed: " + std::string(PQerrorMessage(connection_));
-        return Result<std::vector<std::map<std::string, std::string>>>(ErrorCode::DATABASE_QUERY_FAILED, error_msg);
+    auto column = cursor.column(column_name, QueryValueKind::BOOL);
+    if (column.isError()) {
+        cursor.cancel();
+        return Result<bool>(column.getError());
     }
+    bool value = !cursor.isNull(column.getValue()) && cursor.getBool(column.getValue());
     
-    // Process results same as selectQuery
-    std::vector<std::map<std::string, std::string>> results;
-    int num_rows = PQntuples(result);
-    int num_cols = PQnfields(result);
-    
-    for (int row = 0; row < num_rows; ++row) {
-        std::map<std::string, std::string> row_data;
-        
-        for (int col = 0; col < num_cols; ++col) {
-            std::string field_name = PQfname(result, col);
-            std::string field_value = PQgetisnull(result, row, col) ? 
-                                    "" : PQgetvalue(result, row, col);
-            row_data[field_name] = field_value;
-        }
-        
-        results.push_back(std::move(row_data));
+    // Consume the end of the result so the connection is free again
+    auto done = cursor.next();
+    if (done.isError()) {
+        return Result<bool>(done.getError());
     }
+    return Result<bool>(value);
+}
+
+Result<std::vector<std::map<std::string, std::string>>> DatabaseConnection::selectQuery(const std::string& query) {
+    return executePreparedQuery(query, {});
+}
+
+Result<std::vector<std::map<std::string, std::string>>> DatabaseConnection::executePreparedQuery(
+    const std::string& query, 
+    const std::vector<std::string>& params) {
     
-    return Result<std::vector<std::map<std::string, std::string>>>(std::move(results));
+    auto cursor = openCursor(query, params, QueryResultFormat::TEXT);
+    if (cursor.isError()) {
+        return Result<std::vector<std::map<std::string, std::string>>>(cursor.getError());
+    }
+    return collectRows(cursor.getValue());
 }
 
 // Stock data specific queries
@@ -304,80 +327,101 @@ Result<std::vector<std::map<std::string, std::string>>> DatabaseConnection::getS
     return executePreparedQuery(query, params);
 }
 
-Result<std::vector<std::string>> DatabaseConnection::getAvailableSymbols() {
-    std::string query = "SELECT DISTINCT symbol FROM stock_prices_daily ORDER BY symbol;";
-    auto results = selectQuery(query);
+// DECIMAL has no cheap binary form; float8 decodes with a byte swap
+const char* const DatabaseConnection::PRICE_DATA_QUERY =
+    "SELECT time, open::float8 AS open, high::float8 AS high, low::float8 AS low, "
+    "close::float8 AS close, volume "
+    "FROM stock_prices_daily "
+    "WHERE symbol = $1 "
+    "AND time >= $2 "
+    "AND time <= $3 "
+    "ORDER BY time ASC;";
+
+Result<std::vector<PriceData>> DatabaseConnection::getStockPriceData(
+    const std::string& symbol, 
+    const std::string& start_date, 
+    const std::string& end_date) {
     
-    if (results.isError()) {
-        return Result<std::vector<std::string>>(results.getError());
+    auto cursor_result = openCursor(PRICE_DATA_QUERY, {symbol, start_date, end_date});
+    if (cursor_result.isError()) {
+        return Result<std::vector<PriceData>>(cursor_result.getError());
     }
-    
-    std::vector<std::string> symbols;
-    for (const auto& row : results.getValue()) {
-        auto it = row.find("symbol");
-        if (it != row.end()) {
-            symbols.push_back(it->second);
+    return readPriceData(cursor_result.getValue());
+}
+
+Result<std::vector<PriceData>> DatabaseConnection::readPriceData(QueryCursor& cursor) {
+    std::vector<PriceData> bars;
+    QueryColumn time_column, open_column, high_column, low_column, close_column, volume_column;
+    
+    while (true) {
+        auto has_row = cursor.next();
+        if (has_row.isError()) {
+            return Result<std::vector<PriceData>>(has_row.getError());
+        }
+        if (!has_row.getValue()) {
+            break;
         }
+        
+        if (time_column.index < 0) {
+            auto time_result = cursor.column("time", QueryValueKind::DATE);
+            auto open_result = cursor.column("open", QueryValueKind::DOUBLE);
+            auto high_result = cursor.column("high", QueryValueKind::DOUBLE);
+            auto low_result = cursor.column("low", QueryValueKind::DOUBLE);
+            auto close_result = cursor.column("close", QueryValueKind::DOUBLE);
+            auto volume_result = cursor.column("volume", QueryValueKind::INT64);
+            for (const auto* column : {&time_result, &open_result, &high_result, &low_result, &close_result, &volume_result}) {
+                if (column->isError()) {
+                    cursor.cancel();
+                    return Result<std::vector<PriceData>>(column->getError());
+                }
+            }
+            time_column = time_result.getValue();
+            open_column = open_result.getValue();
+            high_column = high_result.getValue();
+            low_column = low_result.getValue();
+            close_column = close_result.getValue();
+            volume_column = volume_result.getValue();
+        }
+        
+        // Incomplete bars were dropped by the text conversion too
+        if (cursor.isNull(time_column) || cursor.isNull(open_column) || cursor.isNull(high_column) ||
+            cursor.isNull(low_column) || cursor.isNull(close_column) || cursor.isNull(volume_column)) {
+            continue;
+        }
+        
+        bars.emplace_back(cursor.getDouble(open_column), cursor.getDouble(high_column),
+                          cursor.getDouble(low_column), cursor.getDouble(close_column),
+                          static_cast<long>(cursor.getInt64(volume_column)),
+                          PgBinary::formatTimestamp(cursor.getTimestamp(time_column)));
     }
     
-    return Result<std::vector<std::string>>(std::move(symbols));
+    return Result<std::vector<PriceData>>(std::move(bars));
 }
 
-Result<bool> DatabaseConnection::checkSymbolExists(const std::string& symbol) {
-    std::string query = "SELECT COUNT(*) as count FROM stock_prices_daily WHERE symbol = $1;";
-    
-    std::vector<std::string> params = {symbol};
-    auto results = executePreparedQuery(query, params);
-    
-    if (results.isError()) {
-        return Result<bool>(results.getError());
+Result<std::vector<std::string>> DatabaseConnection::getAvailableSymbols() {
+    auto cursor = openCursor("SELECT DISTINCT symbol FROM stock_prices_daily ORDER BY symbol;");
+    if (cursor.isError()) {
+        return Result<std::vector<std::string>>(cursor.getError());
     }
-    
-    const auto& result_data = results.getValue();
-    if (!result_data.empty()) {
-        auto it = result_data[0].find("count");
-        if (it != result_data[0].end()) {
-            try {
-                bool exists = std::stoi(it->second) > 0;
-                return Result<bool>(exists);
-            } catch (const std::exception& e) {
-                return Result<bool>(ErrorCode::DATA_PARSING_FAILED, 
-                                  "Failed to parse count result: " + std::string(e.what()));
-            }
-        }
+    return collectTextColumn(cursor.getValue(), "symbol");
+}
+
+Result<bool> DatabaseConnection::checkSymbolExists(const std::string& symbol) {
+    auto cursor = openCursor("SELECT EXISTS (SELECT 1 FROM stock_prices_daily WHERE symbol = $1) AS present;", {symbol});
+    if (cursor.isError()) {
+        return Result<bool>(cursor.getError());
     }
-    
-    return Result<bool>(ErrorCode::DATA_SYMBOL_NOT_FOUND, "No count result returned for symbol: " + symbol);
+    return fetchSingleBool(cursor.getValue(), "present");
 }
 
 // Temporal validation methods
 Result<bool> DatabaseConnection::checkStockTradeable(const std::string& symbol, const std::string& check_date) {
     // Use the database function to check if a stock was tradeable on a specific date
-    std::string query = "SELECT is_stock_tradeable($1, $2) as is_tradeable;";
-    
-    std::vector<std::string> params = {symbol, check_date};
-    auto results = executePreparedQuery(query, params);
-    
-    if (results.isError()) {
-        return Result<bool>(results.getError());
+    auto cursor = openCursor("SELECT is_stock_tradeable($1, $2) as is_tradeable;", {symbol, check_date});
+    if (cursor.isError()) {
+        return Result<bool>(cursor.getError());
     }
-    
-    const auto& result_data = results.getValue();
-    if (!result_data.empty()) {
-        auto it = result_data[0].find("is_tradeable");
-        if (it != result_data[0].end()) {
-            try {
-                // PostgreSQL returns 't' or 'f' for boolean values
-                bool is_tradeable = (it->second == "t" || it->second == "true");
-                return Result<bool>(is_tradeable);
-            } catch (const std::exception& e) {
-                return Result<bool>(ErrorCode::DATA_PARSING_FAILED, 
-                                  "Failed to parse tradeable result: " + std::string(e.what()));
-            }
-        }
-    }
-    
-    return Result<bool>(ErrorCode::VALIDATION_INVALID_INPUT, "No tradeable result returned for symbol: " + symbol);
+    return fetchSingleBool(cursor.getValue(), "is_tradeable");
 }
 
 Result<std::vector<std::string>> DatabaseConnection::getEligibleStocksForPeriod(
@@ -385,35 +429,21 @@ Result<std::vector<std::string>> DatabaseConnection::getEligibleStocksForPeriod(
     const std::string& end_date) {
     
     // Use the database function to get stocks eligible for a period
-    std::string query = "SELECT symbol FROM get_eligible_stocks_for_period($1, $2) ORDER BY symbol;";
-    
-    std::vector<std::string> params = {start_date, end_date};
-    auto results = executePreparedQuery(query, params);
-    
-    if (results.isError()) {
-        return Result<std::vector<std::string>>(results.getError());
-    }
-    
-    std::vector<std::string> eligible_symbols;
-    for (const auto& row : results.getValue()) {
-        auto it = row.find("symbol");
-        if (it != row.end()) {
-            eligible_symbols.push_back(it->second);
-        }
+    auto cursor = openCursor("SELECT symbol FROM get_eligible_stocks_for_period($1, $2) ORDER BY symbol;",
+                             {start_date, end_date});
+    if (cursor.isError()) {
+        return Result<std::vector<std::string>>(cursor.getError());
     }
-    
-    return Result<std::vector<std::string>>(std::move(eligible_symbols));
+    return collectTextColumn(cursor.getValue(), "symbol");
 }
 
 Result<std::map<std::string, std::string>> DatabaseConnection::getStockTemporalInfo(const std::string& symbol) {
-    // Get temporal information for a stock
+    // Get temporal information for a stock; the map keeps the database's text formatting of dates
     std::string query = "SELECT symbol, ipo_date, listing_date, delisting_date, "
                        "trading_status, exchange_status, first_trading_date, last_trading_date "
                        "FROM stocks WHERE symbol = $1;";
     
-    std::vector<std::string> params = {symbol};
-    auto results = executePreparedQuery(query, params);
-    
+    auto results = executePreparedQuery(query, {symbol});
     if (results.isError()) {
         return Result<std::map<std::string, std::string>>(results.getError());
     }
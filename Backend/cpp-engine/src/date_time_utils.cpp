@@ -17,21 +17,47 @@ std::string getCurrentDate() {
     return ss.str();
 }
 
+namespace {
+// Fixed-width run of ASCII digits; false on any other character
+bool parseDigits(std::string_view text, size_t offset, size_t count, int& value) {
+    value = 0;
+    for (size_t i = offset; i < offset + count; ++i) {
+        if (text[i] < '0' || text[i] > '9') {
+            return false;
+        }
+        value = value * 10 + (text[i] - '0');
+    }
+    return true;
+}
+
+bool splitIsoDate(std::string_view date, int& year, int& month, int& day) {
+    if (date.size() < 10 || date[4] != '-' || date[7] != '-') {
+        return false;
+    }
+    return parseDigits(date, 0, 4, year) && parseDigits(date, 5, 2, month) && parseDigits(date, 8, 2, day);
+}
+
+bool isLeapYear(int year) {
+    return (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+}
+
+int daysInMonth(int year, int month) {
+    static const int DAYS[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    return month == 2 && isLeapYear(year) ? 29 : DAYS[month - 1];
+}
+}
+
 bool isValidDateFormat(const std::string& date) {
     if (date.length() != 10) return false;
-    if (date[4] != '-' || date[7] != '-') return false;
     
-    try {
-        int year = std::stoi(date.substr(0, 4));
-        int month = std::stoi(date.substr(5, 2));
-        int day = std::stoi(date.substr(8, 2));
-        
-        return (year >= 1900 && year <= 2100 && 
-                month >= 1 && month <= 12 && 
-                day >= 1 && day <= 31);
-    } catch (const std::exception&) {
+    int year, month, day;
+    if (!splitIsoDate(date, year, month, day)) {
         return false;
     }
+    
+    return (year >= 1900 && year <= 2100 && 
+            month >= 1 && month <= 12 && 
+            day >= 1 && day <= 31);
 }
 
 std::string formatDate(const std::string& date) {
@@ -42,14 +68,16 @@ std::string formatDate(const std::string& date) {
 }
 
 std::chrono::system_clock::time_point stringToTimePoint(const std::string& date) {
-    std::tm tm = {};
-    std::stringstream ss(date);
-    ss >> std::get_time(&tm, "%Y-%m-%d");
-    
-    if (ss.fail()) {
+    int year, month, day;
+    if (!splitIsoDate(date, year, month, day)) {
         throw std::invalid_argument("Invalid date format: " + date);
     }
     
+    // Local midnight, as before
+    std::tm tm = {};
+    tm.tm_year = year - 1900;
+    tm.tm_mon = month - 1;
+    tm.tm_mday = day;
     auto time_t = std::mktime(&tm);
     return std::chrono::system_clock::from_time_t(time_t);
 }
@@ -61,4 +89,39 @@ std::string timePointToString(const std::chrono::system_clock::time_point& time_
     return ss.str();
 }
 
+int32_t daysFromCivil(int year, int month, int day) {
+    // Shift the year to start in March so the leap day is the last day of the year
+    int shifted_year = month <= 2 ? year - 1 : year;
+    int era = (shifted_year >= 0 ? shifted_year : shifted_year - 399) / 400;
+    int year_of_era = shifted_year - era * 400;
+    int day_of_year = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+    int day_of_era = year_of_era * 365 + year_of_era / 4 - year_of_era / 100 + day_of_year;
+    return era * 146097 + day_of_era - 719468;
+}
+
+bool parseIsoDate(std::string_view date, int32_t& days) {
+    if (date.size() > 10 && date[10] != 'T' && date[10] != ' ') {
+        return false;
+    }
+    
+    int year, month, day;
+    if (!splitIsoDate(date, year, month, day) || month < 1 || month > 12 ||
+        day < 1 || day > daysInMonth(year, month)) {
+        return false;
+    }
+    
+    days = daysFromCivil(year, month, day);
+    return true;
+}
+
+int32_t dateToYyyymmdd(const std::string& date) {
+    // Bar dates from the database carry a time part; parseIsoDate accepts and ignores it
+    int32_t days;
+    int year, month, day;
+    if (!parseIsoDate(date, days) || !splitIsoDate(date, year, month, day)) {
+        return 0;
+    }
+    return year * 10000 + month * 100 + day;
+}
+
 } // namespace DateTimeUtils
\ No newline at end of file
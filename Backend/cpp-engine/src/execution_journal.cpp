@@ -0,0 +1,253 @@
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <new>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <nlohmann/json.hpp>
+
+#include "execution_journal.h"
+#include "logger.h"
+#include "query_cursor.h"
+
+namespace {
+constexpr uint64_t RECORDS_ALIGNMENT = 64;
+
+uint64_t alignUp(uint64_t value) {
+    return (value + RECORDS_ALIGNMENT - 1) & ~(RECORDS_ALIGNMENT - 1);
+}
+
+const char* statusName(uint8_t status) {
+    switch (static_cast<OrderStatus>(status)) {
+        case OrderStatus::PENDING: return "PLACED";
+        case OrderStatus::FILLED: return "FILLED";
+        case OrderStatus::REJECTED: return "REJECTED";
+        case OrderStatus::CANCELLED: return "CANCELLED";
+    }
+    return "UNKNOWN";
+}
+
+const char* kindName(uint8_t kind) {
+    switch (static_cast<OrderKind>(kind)) {
+        case OrderKind::MARKET: return "MARKET";
+        case OrderKind::LIMIT: return "LIMIT";
+        case OrderKind::STOP: return "STOP";
+    }
+    return "UNKNOWN";
+}
+
+const char* reasonName(uint16_t reason) {
+    switch (static_cast<JournalReason>(reason)) {
+        case JournalReason::NONE: return "none";
+        case JournalReason::STRATEGY_SIGNAL: return "strategy_signal";
+        case JournalReason::RESTING_ORDER: return "resting_order";
+        case JournalReason::REBALANCE: return "rebalance";
+        case JournalReason::DELISTING: return "delisting";
+        case JournalReason::EXECUTION_FAILED: return "execution_failed";
+        case JournalReason::PARTICIPATION_CAP: return "participation_cap";
+        case JournalReason::INVALID_ORDER: return "invalid_order";
+        case JournalReason::INSUFFICIENT_POSITION: return "insufficient_position";
+    }
+    return "unknown";
+}
+}  // namespace
+
+ExecutionJournal::~ExecutionJournal() {
+    close();
+}
+
+Result<void> ExecutionJournal::open(const std::string& path, const std::vector<std::string>& symbols,
+                                    uint64_t initial_capacity) {
+    close();
+    for (const auto& symbol : symbols) {
+        if (symbol.size() >= SYMBOL_SIZE) {
+            return Result<void>(ErrorCode::VALIDATION_INVALID_INPUT, "Symbol too long for the execution journal: " + symbol);
+        }
+    }
+
+    const uint64_t capacity = std::max<uint64_t>(1, initial_capacity);
+    const uint64_t records_offset = alignUp(sizeof(JournalHeader) + symbols.size() * SYMBOL_SIZE);
+    const size_t file_size = static_cast<size_t>(records_offset + capacity * sizeof(JournalRecord));
+
+    int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        return Result<void>(ErrorCode::SYSTEM_FILE_ACCESS_DENIED,
+                           "Cannot create execution journal " + path + ": " + std::strerror(errno));
+    }
+    if (::ftruncate(fd, static_cast<off_t>(file_size)) != 0) {
+        int error = errno;
+        ::close(fd);
+        return Result<void>(ErrorCode::SYSTEM_FILE_ACCESS_DENIED,
+                           "Cannot size execution journal " + path + ": " + std::strerror(error));
+    }
+    void* mapping = ::mmap(nullptr, file_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (mapping == MAP_FAILED) {
+        int error = errno;
+        ::close(fd);
+        return Result<void>(ErrorCode::SYSTEM_MEMORY_ALLOCATION_FAILED,
+                           "Cannot map execution journal " + path + ": " + std::strerror(error));
+    }
+
+    fd_ = fd;
+    base_ = static_cast<uint8_t*>(mapping);
+    mapped_size_ = file_size;
+    for (size_t i = 0; i < symbols.size(); ++i) {
+        std::memcpy(base_ + sizeof(JournalHeader) + i * SYMBOL_SIZE, symbols[i].data(), symbols[i].size());
+    }
+
+    // The file is freshly truncated, so the mapping starts zeroed
+    header_ = new (base_) JournalHeader();
+    header_->magic = JournalHeader::MAGIC;
+    header_->version = JournalHeader::VERSION;
+    header_->record_size = sizeof(JournalRecord);
+    header_->symbol_count = static_cast<uint32_t>(symbols.size());
+    header_->symbol_table_offset = sizeof(JournalHeader);
+    header_->records_offset = records_offset;
+    header_->capacity = capacity;
+    header_->record_count.store(0, std::memory_order_release);
+
+    Logger::debug("Opened execution journal ", path, " for ", symbols.size(), " symbols");
+    return Result<void>();
+}
+
+void ExecutionJournal::close() {
+    if (!header_) {
+        return;
+    }
+    // Trim the unused tail so the file ends at the last record
+    const uint64_t count = header_->record_count.load(std::memory_order_acquire);
+    header_->capacity = count;
+    const size_t used_size = static_cast<size_t>(header_->records_offset + count * sizeof(JournalRecord));
+    ::munmap(base_, mapped_size_);
+    if (::ftruncate(fd_, static_cast<off_t>(used_size)) != 0) {
+        Logger::warning("Cannot trim execution journal: ", std::strerror(errno));
+    }
+    ::close(fd_);
+    fd_ = -1;
+    base_ = nullptr;
+    header_ = nullptr;
+    mapped_size_ = 0;
+}
+
+bool ExecutionJournal::append(uint64_t order_id, uint32_t symbol_id, int32_t day, Signal side, OrderKind kind,
+                              OrderStatus status, int quantity, double price, JournalReason reason) {
+    if (!header_) {
+        return false;
+    }
+    const uint64_t count = header_->record_count.load(std::memory_order_relaxed);
+    if (count == header_->capacity && !grow()) {
+        return false;
+    }
+
+    JournalRecord record = {};
+    record.sequence = count;
+    record.order_id = order_id;
+    record.day = day;
+    record.symbol_id = symbol_id;
+    record.quantity = quantity;
+    record.side = side == Signal::BUY ? 1 : 2;
+    record.order_kind = static_cast<uint8_t>(kind);
+    record.status = static_cast<uint8_t>(status);
+    record.price = price;
+    record.reason = static_cast<uint16_t>(reason);
+    std::memcpy(base_ + header_->records_offset + count * sizeof(JournalRecord), &record, sizeof(record));
+    header_->record_count.store(count + 1, std::memory_order_release);
+    return true;
+}
+
+uint64_t ExecutionJournal::getRecordCount() const {
+    return header_ ? header_->record_count.load(std::memory_order_acquire) : 0;
+}
+
+bool ExecutionJournal::grow() {
+    // Double the record area in place; the kernel may move the mapping
+    const uint64_t capacity = header_->capacity * 2;
+    const size_t new_size = static_cast<size_t>(header_->records_offset + capacity * sizeof(JournalRecord));
+    if (::ftruncate(fd_, static_cast<off_t>(new_size)) != 0) {
+        Logger::error("Cannot grow execution journal: ", std::strerror(errno));
+        return false;
+    }
+    void* mapping = ::mremap(base_, mapped_size_, new_size, MREMAP_MAYMOVE);
+    if (mapping == MAP_FAILED) {
+        Logger::error("Cannot remap execution journal: ", std::strerror(errno));
+        return false;
+    }
+    base_ = static_cast<uint8_t*>(mapping);
+    header_ = reinterpret_cast<JournalHeader*>(base_);
+    mapped_size_ = new_size;
+    header_->capacity = capacity;
+    return true;
+}
+
+Result<nlohmann::json> ExecutionJournal::readJson(const std::string& path) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return Result<nlohmann::json>(ErrorCode::SYSTEM_FILE_ACCESS_DENIED,
+                                      "Cannot open execution journal " + path + ": " + std::strerror(errno));
+    }
+    struct stat file_stat;
+    if (::fstat(fd, &file_stat) != 0 || file_stat.st_size < static_cast<off_t>(sizeof(JournalHeader))) {
+        ::close(fd);
+        return Result<nlohmann::json>(ErrorCode::SYSTEM_CONFIGURATION_ERROR, "Execution journal is too small: " + path);
+    }
+    const size_t size = static_cast<size_t>(file_stat.st_size);
+    void* mapping = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        return Result<nlohmann::json>(ErrorCode::SYSTEM_MEMORY_ALLOCATION_FAILED,
+                                      "Cannot map execution journal " + path + ": " + std::strerror(errno));
+    }
+    const auto* data = static_cast<const uint8_t*>(mapping);
+    const auto* header = reinterpret_cast<const JournalHeader*>(data);
+
+    // A live journal may be mid-append: only the published, mapped records are read
+    uint64_t count = header->record_count.load(std::memory_order_acquire);
+    const bool valid = header->magic == JournalHeader::MAGIC && header->version == JournalHeader::VERSION &&
+                       header->record_size == sizeof(JournalRecord) &&
+                       header->symbol_table_offset + static_cast<uint64_t>(header->symbol_count) * SYMBOL_SIZE <= size &&
+                       header->records_offset <= size && header->records_offset % RECORDS_ALIGNMENT == 0;
+    if (!valid) {
+        ::munmap(mapping, size);
+        return Result<nlohmann::json>(ErrorCode::SYSTEM_CONFIGURATION_ERROR,
+                                      "File is not a valid version " + std::to_string(JournalHeader::VERSION) +
+                                      " execution journal: " + path);
+    }
+    count = std::min<uint64_t>(count, (size - header->records_offset) / sizeof(JournalRecord));
+
+    std::vector<std::string> symbols(header->symbol_count);
+    for (uint32_t i = 0; i < header->symbol_count; ++i) {
+        const char* name = reinterpret_cast<const char*>(data + header->symbol_table_offset + i * SYMBOL_SIZE);
+        symbols[i].assign(name, strnlen(name, SYMBOL_SIZE));
+    }
+
+    nlohmann::json events = nlohmann::json::array();
+    const auto* records = reinterpret_cast<const JournalRecord*>(data + header->records_offset);
+    for (uint64_t i = 0; i < count; ++i) {
+        const JournalRecord& record = records[i];
+        nlohmann::json event;
+        event["sequence"] = record.sequence;
+        event["order_id"] = record.order_id;
+        event["date"] = PgBinary::formatDate(record.day);
+        event["symbol"] = record.symbol_id < symbols.size() ? nlohmann::json(symbols[record.symbol_id])
+                                                            : nlohmann::json(nullptr);
+        event["side"] = record.side == 1 ? "BUY" : "SELL";
+        event["order_type"] = kindName(record.order_kind);
+        event["status"] = statusName(record.status);
+        event["quantity"] = record.quantity;
+        event["price"] = record.price;
+        event["reason"] = reasonName(record.reason);
+        events.push_back(std::move(event));
+    }
+    ::munmap(mapping, size);
+
+    nlohmann::json journal;
+    journal["type"] = "execution_journal";
+    journal["version"] = JournalHeader::VERSION;
+    journal["symbols"] = symbols;
+    journal["record_count"] = count;
+    journal["events"] = std::move(events);
+    return Result<nlohmann::json>(std::move(journal));
+}
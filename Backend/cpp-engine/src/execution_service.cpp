@@ -84,6 +84,8 @@ Result<void> ExecutionService::executeBuySignal(const TradingSignal& signal,
                            std::to_string(static_cast<int>(position_size)) + ", Price: " + std::to_string(signal.price));
     }
     
+    trade_ledger_.recordBuy(symbol, static_cast<int>(position_size), signal.price, signal.date);
+    
     Logger::debug("Buy order SUCCESS");
     return Result<void>();
 }
@@ -113,6 +115,8 @@ Result<void> ExecutionService::executeSellSignal(const TradingSignal& signal,
                            std::to_string(shares_owned) + ", Price: " + std::to_string(signal.price));
     }
     
+    trade_ledger_.recordSell(symbol, shares_owned, signal.price, signal.date);
+    
     Logger::debug("Sell order SUCCESS");
     return Result<void>();
 }
@@ -148,6 +152,7 @@ std::vector<TradingSignal> ExecutionService::getExecutedSignals() const {
 void ExecutionService::clearExecutedSignals() {
     executed_signals_.clear();
     failed_executions_counter_ = 0;
+    trade_ledger_.clear();
 }
 
 void ExecutionService::addExecutedSignal(const TradingSignal& signal) {
@@ -167,6 +172,14 @@ int ExecutionService::getFailedExecutions() const {
     return failed_executions_counter_;
 }
 
+TradeLedger& ExecutionService::getTradeLedger() {
+    return trade_ledger_;
+}
+
+const TradeLedger& ExecutionService::getTradeLedger() const {
+    return trade_ledger_;
+}
+
 // Memory optimization methods
 void ExecutionService::optimizeMemory() {
     // Shrink executed signals vector to fit current size
@@ -177,6 +190,7 @@ size_t ExecutionService::getMemoryUsage() const {
     size_t total = sizeof(*this);
     // Calculate memory usage of executed signals vector
     total += executed_signals_.capacity() * sizeof(TradingSignal);
+    total += trade_ledger_.getMemoryUsage();
     return total;
 }
 
@@ -186,6 +200,7 @@ std::string ExecutionService::getMemoryReport() const {
     report << "  Executed signals: " << executed_signals_.size() << "\n";
     report << "  Vector capacity: " << executed_signals_.capacity() << "\n";
     report << "  Memory overhead: " << (executed_signals_.capacity() - executed_signals_.size()) * sizeof(TradingSignal) << " bytes\n";
+    report << "  Closed round trips: " << trade_ledger_.getRoundTrips().size() << "\n";
     report << "  Total estimated memory: " << getMemoryUsage() << " bytes\n";
     return report.str();
 }
@@ -1,4 +1,5 @@
 #include <algorithm>
+#include <cmath>
 
 #include "json_helpers.h"
 #include "market_data.h"
@@ -26,9 +27,26 @@ nlohmann::json backTestResultToJson(const BacktestResult& result) {
     json_result["average_loss"] = result.average_loss;
     json_result["volatility"] = result.volatility;
     json_result["annualized_return"] = result.annualized_return;
+    json_result["truncated"] = result.truncated;
+    if (result.truncated) {
+        json_result["truncation_reason"] = result.truncation_reason;
+    }
+    if (result.transaction_costs.enabled) {
+        json_result["transaction_costs"] = {
+            {"commission", result.transaction_costs.commission},
+            {"slippage", result.transaction_costs.slippage},
+            {"capped_orders", result.transaction_costs.capped_orders},
+            {"capped_shares", result.transaction_costs.capped_shares},
+        };
+    }
     
     json_result["performance_metrics"] = createPerformanceMetricsJson(result);
     json_result["signals"] = tradingSignalsToJsonArray(result.signals_generated);
+    json_result["round_trips"] = roundTripsToJsonArray(result.round_trips);
+    
+    if (!result.rolling_metrics.empty() || !result.underwater_curve.empty()) {
+        json_result["rolling_metrics"] = createRollingMetricsJson(result);
+    }
     
     return json_result;
 }
@@ -40,6 +58,9 @@ nlohmann::json tradingSignalToJson(const TradingSignal& signal) {
     sig["date"] = signal.date;
     sig["reason"] = signal.reason;
     sig["confidence"] = signal.confidence;
+    if (!signal.symbol.empty()) {
+        sig["symbol"] = signal.symbol;
+    }
     return sig;
 }
 
@@ -51,6 +72,26 @@ nlohmann::json tradingSignalsToJsonArray(const std::vector<TradingSignal>& signa
     return signals_array;
 }
 
+nlohmann::json roundTripsToJsonArray(const std::vector<RoundTrip>& round_trips) {
+    nlohmann::json trips_array = nlohmann::json::array();
+    for (const auto& trip : round_trips) {
+        nlohmann::json entry;
+        entry["symbol"] = trip.symbol;
+        entry["shares"] = trip.shares;
+        entry["entry_date"] = trip.entry_date;
+        entry["exit_date"] = trip.exit_date;
+        entry["entry_price"] = trip.entry_price;
+        entry["exit_price"] = trip.exit_price;
+        entry["holding_bars"] = trip.holding_bars;
+        entry["pnl"] = trip.pnl;
+        entry["return_pct"] = trip.return_pct;
+        entry["mae_pct"] = trip.mae_pct;
+        entry["mfe_pct"] = trip.mfe_pct;
+        trips_array.push_back(entry);
+    }
+    return trips_array;
+}
+
 nlohmann::json createEquityCurveJson(const std::vector<double>& equity_curve,
                                     const std::vector<PriceData>& price_data,
                                     const std::string& start_date) {
@@ -66,10 +107,43 @@ nlohmann::json createEquityCurveJson(const std::vector<double>& equity_curve,
     return equity_array;
 }
 
+nlohmann::json createRollingMetricsJson(const BacktestResult& result) {
+    auto to_column = [](const std::vector<double>& values) {
+        nlohmann::json column = nlohmann::json::array();
+        for (double value : values) {
+            if (std::isfinite(value)) {
+                column.push_back(value);
+            } else {
+                column.push_back(nullptr);
+            }
+        }
+        return column;
+    };
+    
+    nlohmann::json rolling;
+    nlohmann::json windows = nlohmann::json::array();
+    for (const auto& series : result.rolling_metrics) {
+        nlohmann::json window;
+        window["window"] = series.window;
+        window["sharpe_ratio"] = to_column(series.sharpe_ratio);
+        window["volatility"] = to_column(series.volatility);
+        window["drawdown_pct"] = to_column(series.drawdown_pct);
+        windows.push_back(window);
+    }
+    rolling["windows"] = windows;
+    
+    if (!result.underwater_curve.empty()) {
+        rolling["underwater_pct"] = to_column(result.underwater_curve);
+    }
+    
+    return rolling;
+}
+
 nlohmann::json createPerformanceMetricsJson(const BacktestResult& result) {
     nlohmann::json performance_metrics;
     performance_metrics["total_return_pct"] = result.total_return_pct;
     performance_metrics["sharpe_ratio"] = result.sharpe_ratio;
+    performance_metrics["sortino_ratio"] = result.sortino_ratio;
     performance_metrics["max_drawdown_pct"] = result.max_drawdown;
     performance_metrics["win_rate"] = result.win_rate;
     performance_metrics["total_trades"] = result.total_trades;
@@ -0,0 +1,146 @@
+#include <algorithm>
+
+#include "date_time_utils.h"
+#include "logger.h"
+#include "market_catalog.h"
+
+namespace {
+const char* const PRICE_AGGREGATES_QUERY =
+    "SELECT symbol, MIN(time) AS first_time, MAX(time) AS last_time, COUNT(*) AS row_count "
+    "FROM stock_prices_daily GROUP BY symbol ORDER BY symbol;";
+
+const char* const LISTINGS_QUERY =
+    "SELECT symbol, ipo_date, listing_date, delisting_date, "
+    "trading_status, exchange_status, first_trading_date, last_trading_date "
+    "FROM stocks ORDER BY symbol;";
+}
+
+MarketCatalog::MarketCatalog(std::vector<SymbolCatalogEntry> entries, uint64_t epoch)
+    : entries_(std::move(entries)), epoch_(epoch) {
+    std::sort(entries_.begin(), entries_.end(),
+              [](const SymbolCatalogEntry& a, const SymbolCatalogEntry& b) { return a.symbol < b.symbol; });
+    for (const auto& entry : entries_) {
+        if (entry.hasPrices()) {
+            symbols_with_prices_.push_back(entry.symbol);
+        }
+    }
+}
+
+Result<std::shared_ptr<const MarketCatalog>> MarketCatalog::load(DatabaseConnection& db_connection, uint64_t epoch) {
+    std::map<std::string, SymbolCatalogEntry> entries;
+
+    auto cursor_result = db_connection.openCursor(PRICE_AGGREGATES_QUERY);
+    if (cursor_result.isError()) {
+        return Result<std::shared_ptr<const MarketCatalog>>(cursor_result.getError());
+    }
+    QueryCursor& cursor = cursor_result.getValue();
+
+    QueryColumn symbol_column, first_column, last_column, count_column;
+    while (true) {
+        auto has_row = cursor.next();
+        if (has_row.isError()) {
+            return Result<std::shared_ptr<const MarketCatalog>>(has_row.getError());
+        }
+        if (!has_row.getValue()) {
+            break;
+        }
+
+        if (symbol_column.index < 0) {
+            auto symbol_result = cursor.column("symbol", QueryValueKind::TEXT);
+            auto first_result = cursor.column("first_time", QueryValueKind::DATE);
+            auto last_result = cursor.column("last_time", QueryValueKind::DATE);
+            auto count_result = cursor.column("row_count", QueryValueKind::INT64);
+            for (const auto* column : {&symbol_result, &first_result, &last_result, &count_result}) {
+                if (column->isError()) {
+                    cursor.cancel();
+                    return Result<std::shared_ptr<const MarketCatalog>>(column->getError());
+                }
+            }
+            symbol_column = symbol_result.getValue();
+            first_column = first_result.getValue();
+            last_column = last_result.getValue();
+            count_column = count_result.getValue();
+        }
+
+        SymbolCatalogEntry entry;
+        entry.symbol = std::string(cursor.getText(symbol_column));
+        entry.first_date = PgBinary::formatDate(cursor.getDate(first_column));
+        entry.last_date = PgBinary::formatDate(cursor.getDate(last_column));
+        entry.row_count = cursor.getInt64(count_column);
+        entries.emplace(entry.symbol, std::move(entry));
+    }
+
+    // Listing metadata is informational; the catalog is still usable without it
+    auto listings = db_connection.selectQuery(LISTINGS_QUERY);
+    if (listings.isError()) {
+        Logger::warning("Market catalog loaded without listing metadata: ", listings.getErrorMessage());
+    } else {
+        for (auto& row : listings.getValue()) {
+            auto symbol_it = row.find("symbol");
+            if (symbol_it == row.end()) {
+                continue;
+            }
+            SymbolCatalogEntry& entry = entries[symbol_it->second];
+            entry.symbol = symbol_it->second;
+            entry.listed = true;
+            entry.temporal_info = std::move(row);
+        }
+    }
+
+    std::vector<SymbolCatalogEntry> flat;
+    flat.reserve(entries.size());
+    for (auto& pair : entries) {
+        flat.push_back(std::move(pair.second));
+    }
+
+    Logger::debug("Loaded market catalog epoch ", epoch, " with ", flat.size(), " symbols");
+    return Result<std::shared_ptr<const MarketCatalog>>(
+        std::make_shared<const MarketCatalog>(std::move(flat), epoch));
+}
+
+const SymbolCatalogEntry* MarketCatalog::find(const std::string& symbol) const {
+    auto it = std::lower_bound(entries_.begin(), entries_.end(), symbol,
+                               [](const SymbolCatalogEntry& entry, const std::string& key) { return entry.symbol < key; });
+    if (it == entries_.end() || it->symbol != symbol) {
+        return nullptr;
+    }
+    return &*it;
+}
+
+bool MarketCatalog::hasPrices(const std::string& symbol) const {
+    const SymbolCatalogEntry* entry = find(symbol);
+    return entry && entry->hasPrices();
+}
+
+int64_t MarketCatalog::countInRange(const std::string& symbol, const std::string& start_date,
+                                    const std::string& end_date) const {
+    // Only plain dates compare correctly as strings
+    if (!DateTimeUtils::isValidDateFormat(start_date) || !DateTimeUtils::isValidDateFormat(end_date)) {
+        return -1;
+    }
+
+    const SymbolCatalogEntry* entry = find(symbol);
+    if (!entry || !entry->hasPrices() || end_date < start_date ||
+        entry->last_date < start_date || entry->first_date > end_date) {
+        return 0;
+    }
+    if (start_date <= entry->first_date && entry->last_date <= end_date) {
+        return entry->row_count;
+    }
+    return -1;
+}
+
+size_t MarketCatalog::getMemoryUsage() const {
+    size_t total = sizeof(*this) + entries_.capacity() * sizeof(SymbolCatalogEntry) +
+                   symbols_with_prices_.capacity() * sizeof(std::string);
+    for (const auto& entry : entries_) {
+        total += entry.symbol.capacity() + entry.first_date.capacity() + entry.last_date.capacity();
+        for (const auto& field : entry.temporal_info) {
+            total += field.first.capacity() + field.second.capacity() + sizeof(field);
+        }
+    }
+    for (const auto& symbol : symbols_with_prices_) {
+        total += symbol.capacity();
+    }
+    return total;
+}
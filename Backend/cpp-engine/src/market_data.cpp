@@ -1,5 +1,6 @@
 #include <algorithm>
 #include <iostream>
+#include <limits>
 #include <stdexcept>
 
 #include "date_time_utils.h"
@@ -7,19 +8,66 @@
 #include "logger.h"
 #include "market_data.h"
 
+namespace {
+// Latest close per symbol. The recursive CTE walks idx_daily_symbol_time one
+// symbol at a time instead of scanning the hypertable for DISTINCT symbols,
+// then LATERAL picks the newest row of each symbol from the same index.
+const char* const LATEST_PRICES_QUERY =
+    "WITH RECURSIVE symbols AS ("
+    "  (SELECT symbol FROM stock_prices_daily ORDER BY symbol LIMIT 1)"
+    "  UNION ALL"
+    "  SELECT (SELECT p.symbol FROM stock_prices_daily p WHERE p.symbol > s.symbol ORDER BY p.symbol LIMIT 1)"
+    "  FROM symbols s WHERE s.symbol IS NOT NULL"
+    ") "
+    "SELECT s.symbol, latest.time, latest.close::float8 AS close "
+    "FROM symbols s "
+    "CROSS JOIN LATERAL ("
+    "  SELECT time, close FROM stock_prices_daily"
+    "  WHERE symbol = s.symbol ORDER BY time DESC LIMIT 1"
+    ") latest "
+    "WHERE s.symbol IS NOT NULL AND latest.close IS NOT NULL "
+    "ORDER BY s.symbol COLLATE \"C\";";
+}
+
+void PriceSnapshot::sortBySymbol() {
+    // Bytewise order, whatever collation the rows arrived in
+    if (std::is_sorted(symbols.begin(), symbols.end())) {
+        return;
+    }
+    std::vector<size_t> order(symbols.size());
+    for (size_t i = 0; i < order.size(); ++i) {
+        order[i] = i;
+    }
+    std::sort(order.begin(), order.end(), [this](size_t a, size_t b) { return symbols[a] < symbols[b]; });
+    
+    std::vector<std::string> sorted_symbols;
+    std::vector<double> sorted_closes;
+    std::vector<int32_t> sorted_dates;
+    sorted_symbols.reserve(order.size());
+    sorted_closes.reserve(order.size());
+    sorted_dates.reserve(order.size());
+    for (size_t i : order) {
+        sorted_symbols.push_back(std::move(symbols[i]));
+        sorted_closes.push_back(closes[i]);
+        sorted_dates.push_back(dates[i]);
+    }
+    symbols = std::move(sorted_symbols);
+    closes = std::move(sorted_closes);
+    dates = std::move(sorted_dates);
+}
+
+int PriceSnapshot::indexOf(const std::string& symbol) const {
+    auto it = std::lower_bound(symbols.begin(), symbols.end(), symbol);
+    if (it == symbols.end() || *it != symbol) {
+        return -1;
+    }
+    return static_cast<int>(it - symbols.begin());
+}
+
 // MarketData implementation
 MarketData::MarketData() 
-    : cache_enabled_(true) {
-    // Create database connection using Result pattern
-    auto conn_result = DatabaseConnection::createFromEnvironment();
-    if (conn_result.isSuccess()) {
-        db_connection_ = std::make_unique<DatabaseConnection>(std::move(conn_result.getValue()));
-    } else {
-        // Log error but allow construction - connection will be attempted later
-        std::cerr << "Warning: Failed to create database connection during MarketData construction: " 
-                  << conn_result.getErrorMessage() << std::endl;
-        db_connection_ = nullptr;
-    }
+    : connect_from_environment_(true), cache_enabled_(true) {
+    // The connection is created from the environment on first database access
 }
 
 MarketData::MarketData(std::unique_ptr<DatabaseConnection> db_conn) 
@@ -29,31 +77,67 @@ MarketData::MarketData(std::unique_ptr<DatabaseConnection> db_conn)
 // Move constructor
 MarketData::MarketData(MarketData&& other) noexcept 
     : db_connection_(std::move(other.db_connection_)),
+      connect_from_environment_(other.connect_from_environment_),
       price_cache_(std::move(other.price_cache_)),
-      cache_enabled_(other.cache_enabled_) {
+      cache_enabled_(other.cache_enabled_),
+      snapshot_(std::atomic_load(&other.snapshot_)),
+      snapshot_version_(other.snapshot_version_),
+      snapshot_ttl_(other.snapshot_ttl_),
+      catalog_(std::atomic_load(&other.catalog_)),
+      catalog_epoch_(other.catalog_epoch_),
+      async_executor_(std::move(other.async_executor_)),
+      async_connection_limit_(other.async_connection_limit_),
+      capture_bundle_(std::move(other.capture_bundle_)),
+      replay_bundle_(std::move(other.replay_bundle_)) {
 }
 
 // Move assignment
 MarketData& MarketData::operator=(MarketData&& other) noexcept {
     if (this != &other) {
         db_connection_ = std::move(other.db_connection_);
+        connect_from_environment_ = other.connect_from_environment_;
         price_cache_ = std::move(other.price_cache_);
         cache_enabled_ = other.cache_enabled_;
+        std::atomic_store(&snapshot_, std::atomic_load(&other.snapshot_));
+        snapshot_version_ = other.snapshot_version_;
+        snapshot_ttl_ = other.snapshot_ttl_;
+        std::atomic_store(&catalog_, std::atomic_load(&other.catalog_));
+        catalog_epoch_ = other.catalog_epoch_;
+        async_executor_ = std::move(other.async_executor_);
+        async_connection_limit_ = other.async_connection_limit_;
+        capture_bundle_ = std::move(other.capture_bundle_);
+        replay_bundle_ = std::move(other.replay_bundle_);
     }
     return *this;
 }
 
 // Helper methods
+DatabaseConnection* MarketData::connection() const {
+    std::lock_guard<std::mutex> lock(connection_mutex_);
+    if (!db_connection_ && connect_from_environment_) {
+        // One attempt only; a failure leaves MarketData without a database
+        connect_from_environment_ = false;
+        auto conn_result = DatabaseConnection::createFromEnvironment();
+        if (conn_result.isSuccess()) {
+            db_connection_ = std::make_unique<DatabaseConnection>(std::move(conn_result.getValue()));
+        } else {
+            Logger::warning("Failed to create database connection: ", conn_result.getErrorMessage());
+        }
+    }
+    return db_connection_.get();
+}
+
 Result<void> MarketData::ensureConnection() const {
-    if (!db_connection_) {
+    DatabaseConnection* db = connection();
+    if (!db) {
         return Result<void>(ErrorCode::DATABASE_CONNECTION_FAILED, "No database connection available");
     }
     
-    if (db_connection_->isConnected()) {
+    if (db->isConnected()) {
         return Result<void>();
     }
     
-    return db_connection_->connect();
+    return db->connect();
 }
 
 void MarketData::cachePrice(const std::string& symbol, double price) const {
@@ -76,10 +160,34 @@ Result<double> MarketData::getCachedPrice(const std::string& symbol) const {
 
 // Configuration
 void MarketData::setDatabaseConnection(std::unique_ptr<DatabaseConnection> db_conn) {
-    db_connection_ = std::move(db_conn);
+    {
+        std::lock_guard<std::mutex> lock(executor_mutex_);
+        async_executor_.reset();
+    }
+    {
+        std::lock_guard<std::mutex> lock(connection_mutex_);
+        db_connection_ = std::move(db_conn);
+        connect_from_environment_ = false;
+    }
     clearCache();
 }
 
+void MarketData::setCaptureBundle(std::shared_ptr<SimulationBundle> bundle) {
+    capture_bundle_ = std::move(bundle);
+}
+
+void MarketData::setReplayBundle(std::shared_ptr<SimulationBundle> bundle) {
+    if (bundle) {
+        // Replay must be reproducible on machines without a database
+        setDatabaseConnection(nullptr);
+    }
+    replay_bundle_ = std::move(bundle);
+}
+
+bool MarketData::hasDataSource() const {
+    return replay_bundle_ != nullptr || connection() != nullptr;
+}
+
 void MarketData::enableCache(bool enable) {
     cache_enabled_ = enable;
     if (!enable) {
@@ -87,14 +195,28 @@ void MarketData::enableCache(bool enable) {
     }
 }
 
+void MarketData::setSnapshotTtl(std::chrono::milliseconds ttl) {
+    snapshot_ttl_ = ttl;
+}
+
 bool MarketData::isConnected() const {
+    std::lock_guard<std::mutex> lock(connection_mutex_);
     return db_connection_ && db_connection_->isConnected();
 }
 
 // Basic price access
 Result<double> MarketData::getLatestPrice(const std::string& symbol) const {
-    // Check cache first
+    // Check cache first: a fresh snapshot answers without a query, but a stale
+    // one is not reloaded for a single symbol
     if (cache_enabled_) {
+        auto snapshot = std::atomic_load(&snapshot_);
+        if (snapshot && snapshot->isFresh(snapshot_ttl_, std::chrono::steady_clock::now())) {
+            int index = snapshot->indexOf(symbol);
+            if (index >= 0) {
+                return Result<double>(snapshot->closes[index]);
+            }
+        }
+        
         auto cached = getCachedPrice(symbol);
         if (cached.isSuccess()) {
             return cached;
@@ -112,7 +234,7 @@ Result<double> MarketData::getLatestPrice(const std::string& symbol) const {
                        "ORDER BY time DESC LIMIT 1;";
     
     std::vector<std::string> params = {symbol};
-    auto results = db_connection_->executePreparedQuery(query, params);
+    auto results = connection()->executePreparedQuery(query, params);
     
     if (results.isError()) {
         return Result<double>(results.getError());
@@ -139,41 +261,127 @@ Result<double> MarketData::getLatestPrice(const std::string& symbol) const {
 Result<std::map<std::string, double>> MarketData::getCurrentPrices() const {
     Logger::debug("MarketData::getCurrentPrices called");
     
-    auto symbols_result = getAvailableSymbols();
-    if (symbols_result.isError()) {
-        Logger::error("Error in MarketData::getCurrentPrices: ", symbols_result.getErrorMessage());
-        return Result<std::map<std::string, double>>(symbols_result.getError());
+    auto snapshot_result = getPriceSnapshot();
+    if (snapshot_result.isError()) {
+        Logger::error("Error in MarketData::getCurrentPrices: ", snapshot_result.getErrorMessage());
+        return Result<std::map<std::string, double>>(snapshot_result.getError());
     }
     
-    auto result = getCurrentPrices(symbols_result.getValue());
-    if (result.isError()) {
-        Logger::error("Error in MarketData::getCurrentPrices: ", result.getErrorMessage());
+    const auto& snapshot = *snapshot_result.getValue();
+    std::map<std::string, double> prices;
+    for (size_t i = 0; i < snapshot.symbols.size(); ++i) {
+        prices.emplace_hint(prices.end(), snapshot.symbols[i], snapshot.closes[i]);
     }
-    return result;
+    return Result<std::map<std::string, double>>(std::move(prices));
 }
 
 Result<std::map<std::string, double>> MarketData::getCurrentPrices(const std::vector<std::string>& symbols) const {
     std::map<std::string, double> prices;
+    if (symbols.empty()) {
+        return Result<std::map<std::string, double>>(std::move(prices));
+    }
+    
+    auto snapshot_result = getPriceSnapshot();
+    if (snapshot_result.isError()) {
+        return Result<std::map<std::string, double>>(snapshot_result.getError());
+    }
     
+    const auto& snapshot = *snapshot_result.getValue();
     for (const auto& symbol : symbols) {
-        auto price_result = getLatestPrice(symbol);
-        if (price_result.isSuccess()) {
-            prices[symbol] = price_result.getValue();
+        int index = snapshot.indexOf(symbol);
+        if (index >= 0) {
+            prices[symbol] = snapshot.closes[index];
         } else {
-            // Check if it's a symbol not found error (continue) or database error (stop)
-            if (price_result.getErrorCode() == ErrorCode::DATA_SYMBOL_NOT_FOUND) {
-                // Log warning but continue with other symbols
-                std::cerr << "Warning: " << price_result.getErrorMessage() << std::endl;
-            } else {
-                // Database or other critical errors - return error
-                return Result<std::map<std::string, double>>(price_result.getError());
-            }
+            // Log warning but continue with other symbols
+            std::cerr << "Warning: Symbol not found: " << symbol << std::endl;
         }
     }
     
     return Result<std::map<std::string, double>>(std::move(prices));
 }
 
+Result<std::shared_ptr<const PriceSnapshot>> MarketData::getPriceSnapshot() const {
+    auto current = std::atomic_load(&snapshot_);
+    if (cache_enabled_ && current && current->isFresh(snapshot_ttl_, std::chrono::steady_clock::now())) {
+        return Result<std::shared_ptr<const PriceSnapshot>>(std::move(current));
+    }
+    
+    std::unique_lock<std::mutex> lock(snapshot_refresh_mutex_, std::try_to_lock);
+    if (!lock.owns_lock()) {
+        // Another caller is reloading: serve the stale snapshot rather than wait
+        if (cache_enabled_ && current) {
+            return Result<std::shared_ptr<const PriceSnapshot>>(std::move(current));
+        }
+        lock.lock();
+    }
+    
+    // The reload we waited on (or raced with) may already be fresh
+    current = std::atomic_load(&snapshot_);
+    if (cache_enabled_ && current && current->isFresh(snapshot_ttl_, std::chrono::steady_clock::now())) {
+        return Result<std::shared_ptr<const PriceSnapshot>>(std::move(current));
+    }
+    return loadPriceSnapshot();
+}
+
+Result<std::shared_ptr<const PriceSnapshot>> MarketData::refreshPriceSnapshot() const {
+    std::lock_guard<std::mutex> lock(snapshot_refresh_mutex_);
+    return loadPriceSnapshot();
+}
+
+// Caller holds snapshot_refresh_mutex_
+Result<std::shared_ptr<const PriceSnapshot>> MarketData::loadPriceSnapshot() const {
+    auto conn_result = ensureConnection();
+    if (conn_result.isError()) {
+        return Result<std::shared_ptr<const PriceSnapshot>>(conn_result.getError());
+    }
+    
+    auto cursor_result = connection()->openCursor(LATEST_PRICES_QUERY);
+    if (cursor_result.isError()) {
+        return Result<std::shared_ptr<const PriceSnapshot>>(cursor_result.getError());
+    }
+    QueryCursor& cursor = cursor_result.getValue();
+    
+    auto snapshot = std::make_shared<PriceSnapshot>();
+    QueryColumn symbol_column, time_column, close_column;
+    while (true) {
+        auto has_row = cursor.next();
+        if (has_row.isError()) {
+            return Result<std::shared_ptr<const PriceSnapshot>>(has_row.getError());
+        }
+        if (!has_row.getValue()) {
+            break;
+        }
+        
+        if (symbol_column.index < 0) {
+            auto symbol_result = cursor.column("symbol", QueryValueKind::TEXT);
+            auto time_result = cursor.column("time", QueryValueKind::DATE);
+            auto close_result = cursor.column("close", QueryValueKind::DOUBLE);
+            for (const auto* column : {&symbol_result, &time_result, &close_result}) {
+                if (column->isError()) {
+                    cursor.cancel();
+                    return Result<std::shared_ptr<const PriceSnapshot>>(column->getError());
+                }
+            }
+            symbol_column = symbol_result.getValue();
+            time_column = time_result.getValue();
+            close_column = close_result.getValue();
+        }
+        
+        snapshot->symbols.emplace_back(cursor.getText(symbol_column));
+        snapshot->dates.push_back(cursor.getDate(time_column));
+        snapshot->closes.push_back(cursor.getDouble(close_column));
+    }
+    
+    snapshot->sortBySymbol();
+    snapshot->loaded_at = std::chrono::steady_clock::now();
+    snapshot->version = ++snapshot_version_;
+    Logger::debug("Loaded price snapshot v", snapshot->version, " with ", snapshot->symbols.size(), " symbols");
+    
+    std::shared_ptr<const PriceSnapshot> published = std::move(snapshot);
+    std::atomic_store(&snapshot_, published);
+    return Result<std::shared_ptr<const PriceSnapshot>>(std::move(published));
+}
+
 // Historical data access
 Result<std::vector<std::map<std::string, std::string>>> MarketData::getHistoricalPrices(
     const std::string& symbol,
@@ -189,13 +397,109 @@ Result<std::vector<std::map<std::string, std::string>>> MarketData::getHistorica
         return Result<std::vector<std::map<std::string, std::string>>>(conn_result.getError());
     }
     
-    auto result = db_connection_->getStockPrices(symbol, start_date, end_date);
+    auto result = connection()->getStockPrices(symbol, start_date, end_date);
     if (result.isError()) {
         Logger::error("Error in MarketData::getHistoricalPrices: ", result.getErrorMessage());
     }
     return result;
 }
 
+Result<std::vector<PriceData>> MarketData::getHistoricalPriceData(
+    const std::string& symbol,
+    const std::string& start_date,
+    const std::string& end_date) const {
+    
+    if (replay_bundle_) {
+        std::vector<PriceData> data;
+        if (!replay_bundle_->lookupPriceData(symbol, start_date, end_date, data)) {
+            return Result<std::vector<PriceData>>(ErrorCode::ENGINE_NO_DATA_AVAILABLE,
+                "Price data for " + symbol + " from " + start_date + " to " + end_date + " was not captured");
+        }
+        return Result<std::vector<PriceData>>(std::move(data));
+    }
+    
+    auto conn_result = ensureConnection();
+    if (conn_result.isError()) {
+        Logger::error("Error in MarketData::getHistoricalPriceData: ", conn_result.getErrorMessage());
+        return Result<std::vector<PriceData>>(conn_result.getError());
+    }
+    
+    auto result = connection()->getStockPriceData(symbol, start_date, end_date);
+    if (result.isError()) {
+        Logger::error("Error in MarketData::getHistoricalPriceData: ", result.getErrorMessage());
+    } else if (capture_bundle_) {
+        capture_bundle_->recordPriceData(symbol, start_date, end_date, result.getValue());
+    }
+    return result;
+}
+
+std::future<Result<std::vector<PriceData>>> MarketData::requestHistoricalPriceData(
+    const std::string& symbol,
+    const std::string& start_date,
+    const std::string& end_date) const {
+    
+    AsyncQueryExecutor* executor = getAsyncExecutor();
+    if (!executor) {
+        return std::async(std::launch::deferred, [this, symbol, start_date, end_date]() {
+            return getHistoricalPriceData(symbol, start_date, end_date);
+        });
+    }
+    
+    auto query = executor->submit(DatabaseConnection::PRICE_DATA_QUERY, {symbol, start_date, end_date});
+    return std::async(std::launch::deferred, [symbol, start_date, end_date, capture = capture_bundle_,
+                                              query = std::move(query)]() mutable {
+        auto cursor_result = query.get();
+        if (cursor_result.isError()) {
+            Logger::error("Error in MarketData::requestHistoricalPriceData: ", cursor_result.getErrorMessage());
+            return Result<std::vector<PriceData>>(cursor_result.getError());
+        }
+        auto result = DatabaseConnection::readPriceData(cursor_result.getValue());
+        if (capture && result.isSuccess()) {
+            capture->recordPriceData(symbol, start_date, end_date, result.getValue());
+        }
+        return result;
+    });
+}
+
+AsyncQueryExecutor* MarketData::getAsyncExecutor() const {
+    std::lock_guard<std::mutex> lock(executor_mutex_);
+    DatabaseConnection* db = connection();
+    if (!async_executor_ && db && async_connection_limit_ > 0) {
+        async_executor_ = std::make_unique<AsyncQueryExecutor>(db->getConnectionString(), async_connection_limit_);
+    }
+    return async_executor_.get();
+}
+
+void MarketData::setAsyncConnectionLimit(size_t max_connections) {
+    std::lock_guard<std::mutex> lock(executor_mutex_);
+    async_connection_limit_ = max_connections;
+}
+
+void MarketData::reserveAsyncConnections(size_t query_count) const {
+    std::lock_guard<std::mutex> lock(executor_mutex_);
+    DatabaseConnection* db = connection();
+    size_t connections = std::min(async_connection_limit_, query_count);
+    if (!async_executor_ && db && connections > 0) {
+        async_executor_ = std::make_unique<AsyncQueryExecutor>(db->getConnectionString(), connections);
+    }
+}
+
+void MarketData::closeAsyncExecutor() const {
+    std::unique_ptr<AsyncQueryExecutor> executor;
+    {
+        std::lock_guard<std::mutex> lock(executor_mutex_);
+        executor = std::move(async_executor_);
+    }
+    if (executor) {
+        executor->shutdown();
+    }
+}
+
+bool MarketData::hasAsyncExecutor() const {
+    std::lock_guard<std::mutex> lock(executor_mutex_);
+    return async_executor_ != nullptr;
+}
+
 Result<std::map<std::string, std::vector<std::map<std::string, std::string>>>> MarketData::getHistoricalPrices(
     const std::vector<std::string>& symbols,
     const std::string& start_date,
@@ -241,21 +545,185 @@ Result<std::map<std::string, std::string>> MarketData::getPriceForDate(const std
 
 // Symbol validation and discovery
 Result<bool> MarketData::symbolExists(const std::string& symbol) const {
+    if (replay_bundle_) {
+        bool exists = false;
+        replay_bundle_->lookupSymbolExists(symbol, exists);
+        return Result<bool>(exists);
+    }
+    
+    // A loaded catalog answers from memory; otherwise one indexed lookup, never the full catalog
+    bool exists = false;
+    if (auto catalog = loadedCatalog()) {
+        exists = catalog->hasPrices(symbol);
+    } else {
+        auto conn_result = ensureConnection();
+        if (conn_result.isError()) {
+            return Result<bool>(conn_result.getError());
+        }
+        auto exists_result = connection()->checkSymbolExists(symbol);
+        if (exists_result.isError()) {
+            return exists_result;
+        }
+        exists = exists_result.getValue();
+    }
+    if (capture_bundle_) {
+        capture_bundle_->recordSymbolExists(symbol, exists);
+    }
+    return Result<bool>(exists);
+}
+
+Result<std::vector<std::string>> MarketData::getAvailableSymbols() const {
+    auto catalog_result = getCatalog();
+    if (catalog_result.isError()) {
+        return Result<std::vector<std::string>>(catalog_result.getError());
+    }
+    
+    return Result<std::vector<std::string>>(catalog_result.getValue()->getSymbolsWithPrices());
+}
+
+Result<std::map<std::string, std::string>> MarketData::getStockTemporalInfo(const std::string& symbol) const {
+    if (replay_bundle_) {
+        std::map<std::string, std::string> info;
+        if (!replay_bundle_->lookupTemporalInfo(symbol, info)) {
+            return Result<std::map<std::string, std::string>>(
+                ErrorCode::DATA_SYMBOL_NOT_FOUND, "No temporal info found for symbol: " + symbol);
+        }
+        return Result<std::map<std::string, std::string>>(std::move(info));
+    }
+    
+    if (auto catalog = loadedCatalog()) {
+        const SymbolCatalogEntry* entry = catalog->find(symbol);
+        if (!entry || !entry->listed) {
+            return Result<std::map<std::string, std::string>>(
+                ErrorCode::DATA_SYMBOL_NOT_FOUND, "No temporal info found for symbol: " + symbol);
+        }
+        if (capture_bundle_) {
+            capture_bundle_->recordTemporalInfo(symbol, entry->temporal_info);
+        }
+        return Result<std::map<std::string, std::string>>(entry->temporal_info);
+    }
+    
+    auto conn_result = ensureConnection();
+    if (conn_result.isError()) {
+        return Result<std::map<std::string, std::string>>(conn_result.getError());
+    }
+    auto info_result = connection()->getStockTemporalInfo(symbol);
+    if (info_result.isSuccess() && capture_bundle_) {
+        capture_bundle_->recordTemporalInfo(symbol, info_result.getValue());
+    }
+    return info_result;
+}
+
+Result<bool> MarketData::isStockTradeable(const std::string& symbol, const std::string& date) const {
+    if (replay_bundle_) {
+        bool tradeable = false;
+        if (!replay_bundle_->lookupTradeable(symbol, date, tradeable)) {
+            return Result<bool>(ErrorCode::DATA_SYMBOL_NOT_FOUND,
+                                "Tradability of " + symbol + " on " + date + " was not captured");
+        }
+        return Result<bool>(tradeable);
+    }
+    
     auto conn_result = ensureConnection();
     if (conn_result.isError()) {
         return Result<bool>(conn_result.getError());
     }
     
-    return db_connection_->checkSymbolExists(symbol);
+    auto result = connection()->checkStockTradeable(symbol, date);
+    if (result.isSuccess() && capture_bundle_) {
+        capture_bundle_->recordTradeable(symbol, date, result.getValue());
+    }
+    return result;
 }
 
-Result<std::vector<std::string>> MarketData::getAvailableSymbols() const {
+Result<void> MarketData::recordTradeableDays(const std::string& symbol, const std::vector<PriceData>& bars,
+                                             SimulationBundle& bundle) const {
+    if (replay_bundle_) {
+        for (const auto& bar : bars) {
+            bool tradeable = false;
+            if (replay_bundle_->lookupTradeable(symbol, bar.date, tradeable)) {
+                bundle.recordTradeable(symbol, bar.date, tradeable);
+            }
+        }
+        return Result<void>();
+    }
+    
+    // Same rule as is_stock_tradeable: an active listing between listing_date and delisting_date,
+    // both inclusive, where a missing date leaves that side open. Unlisted symbols never trade
+    auto info_result = getStockTemporalInfo(symbol);
+    if (info_result.isError() && info_result.getError().code != ErrorCode::DATA_SYMBOL_NOT_FOUND) {
+        return Result<void>(info_result.getError());
+    }
+    bool active = false;
+    int32_t first_day = std::numeric_limits<int32_t>::min();
+    int32_t last_day = std::numeric_limits<int32_t>::max();
+    if (info_result.isSuccess()) {
+        const auto& info = info_result.getValue();
+        auto field = [&info](const char* key) {
+            auto it = info.find(key);
+            return it != info.end() ? it->second : std::string();
+        };
+        active = field("trading_status") == "active";
+        const std::string listing = field("listing_date");
+        const std::string delisting = field("delisting_date");
+        if ((!listing.empty() && !DateTimeUtils::parseIsoDate(listing, first_day)) ||
+            (!delisting.empty() && !DateTimeUtils::parseIsoDate(delisting, last_day))) {
+            return Result<void>(ErrorCode::VALIDATION_INVALID_FORMAT,
+                                "Unreadable listing window for " + symbol + ": " + listing + " to " + delisting);
+        }
+    }
+    
+    for (const auto& bar : bars) {
+        int32_t day = 0;
+        if (!DateTimeUtils::parseIsoDate(bar.date, day)) {
+            continue;
+        }
+        const bool tradeable = active && day >= first_day && day <= last_day;
+        bundle.recordTradeable(symbol, bar.date, tradeable);
+        if (capture_bundle_) {
+            capture_bundle_->recordTradeable(symbol, bar.date, tradeable);
+        }
+    }
+    return Result<void>();
+}
+
+Result<std::shared_ptr<const MarketCatalog>> MarketData::getCatalog() const {
+    if (cache_enabled_) {
+        if (auto current = std::atomic_load(&catalog_)) {
+            return Result<std::shared_ptr<const MarketCatalog>>(std::move(current));
+        }
+    }
+    
+    std::lock_guard<std::mutex> lock(catalog_mutex_);
+    if (cache_enabled_) {
+        // Loaded by another caller while we waited
+        if (auto current = std::atomic_load(&catalog_)) {
+            return Result<std::shared_ptr<const MarketCatalog>>(std::move(current));
+        }
+    }
+    
     auto conn_result = ensureConnection();
     if (conn_result.isError()) {
-        return Result<std::vector<std::string>>(conn_result.getError());
+        return Result<std::shared_ptr<const MarketCatalog>>(conn_result.getError());
     }
     
-    return db_connection_->getAvailableSymbols();
+    auto catalog_result = MarketCatalog::load(*connection(), ++catalog_epoch_);
+    if (catalog_result.isSuccess() && cache_enabled_) {
+        std::atomic_store(&catalog_, catalog_result.getValue());
+    }
+    return catalog_result;
+}
+
+std::shared_ptr<const MarketCatalog> MarketData::loadedCatalog() const {
+    return cache_enabled_ ? std::atomic_load(&catalog_) : std::shared_ptr<const MarketCatalog>();
+}
+
+void MarketData::setCatalog(std::shared_ptr<const MarketCatalog> catalog) {
+    std::atomic_store(&catalog_, std::move(catalog));
+}
+
+void MarketData::invalidateCatalog() {
+    std::atomic_store(&catalog_, std::shared_ptr<const MarketCatalog>());
 }
 
 // Data validation and statistics
@@ -263,6 +731,14 @@ Result<int> MarketData::getDataPointCount(const std::string& symbol,
                                         const std::string& start_date, 
                                         const std::string& end_date) const {
     
+    // With a loaded catalog, ranges covering or missing the whole history are answered by the aggregates
+    if (auto catalog = loadedCatalog()) {
+        int64_t catalog_count = catalog->countInRange(symbol, start_date, end_date);
+        if (catalog_count >= 0) {
+            return Result<int>(static_cast<int>(catalog_count));
+        }
+    }
+    
     auto conn_result = ensureConnection();
     if (conn_result.isError()) {
         return Result<int>(conn_result.getError());
@@ -274,7 +750,7 @@ Result<int> MarketData::getDataPointCount(const std::string& symbol,
                        "AND time <= $3;";
     
     std::vector<std::string> params = {symbol, start_date, end_date};
-    auto results = db_connection_->executePreparedQuery(query, params);
+    auto results = connection()->executePreparedQuery(query, params);
     
     if (results.isError()) {
         return Result<int>(results.getError());
@@ -298,6 +774,15 @@ Result<int> MarketData::getDataPointCount(const std::string& symbol,
 }
 
 Result<std::pair<std::string, std::string>> MarketData::getDateRange(const std::string& symbol) const {
+    if (auto catalog = loadedCatalog()) {
+        const SymbolCatalogEntry* entry = catalog->find(symbol);
+        if (!entry || !entry->hasPrices()) {
+            return Result<std::pair<std::string, std::string>>(ErrorCode::DATA_SYMBOL_NOT_FOUND, 
+                                                               "No date range found for symbol: " + symbol);
+        }
+        return Result<std::pair<std::string, std::string>>(std::make_pair(entry->first_date, entry->last_date));
+    }
+    
     auto conn_result = ensureConnection();
     if (conn_result.isError()) {
         return Result<std::pair<std::string, std::string>>(conn_result.getError());
@@ -305,10 +790,7 @@ Result<std::pair<std::string, std::string>> MarketData::getDateRange(const std::
     
     std::string query = "SELECT MIN(time) as min_date, MAX(time) as max_date "
                        "FROM stock_prices_daily WHERE symbol = $1;";
-    
-    std::vector<std::string> params = {symbol};
-    auto results = db_connection_->executePreparedQuery(query, params);
-    
+    auto results = connection()->executePreparedQuery(query, {symbol});
     if (results.isError()) {
         return Result<std::pair<std::string, std::string>>(results.getError());
     }
@@ -317,16 +799,11 @@ Result<std::pair<std::string, std::string>> MarketData::getDateRange(const std::
     if (!result_data.empty()) {
         auto min_it = result_data[0].find("min_date");
         auto max_it = result_data[0].find("max_date");
-        
-        if (min_it != result_data[0].end() && max_it != result_data[0].end()) {
-            try {
-                std::string min_date = min_it->second.substr(0, 10);
-                std::string max_date = max_it->second.substr(0, 10);
-                return Result<std::pair<std::string, std::string>>(std::make_pair(min_date, max_date));
-            } catch (const std::exception& e) {
-                return Result<std::pair<std::string, std::string>>(ErrorCode::DATA_PARSING_FAILED, 
-                                                                  "Failed to parse date range: " + std::string(e.what()));
-            }
+        // MIN/MAX of no rows is NULL, which reads back as an empty string
+        if (min_it != result_data[0].end() && max_it != result_data[0].end() &&
+            min_it->second.size() >= 10 && max_it->second.size() >= 10) {
+            return Result<std::pair<std::string, std::string>>(
+                std::make_pair(min_it->second.substr(0, 10), max_it->second.substr(0, 10)));
         }
     }
     
@@ -336,8 +813,12 @@ Result<std::pair<std::string, std::string>> MarketData::getDateRange(const std::
 
 // Utility methods
 void MarketData::clearCache() {
-    std::lock_guard<std::mutex> lock(cache_mutex_);
-    price_cache_.clear();
+    {
+        std::lock_guard<std::mutex> lock(cache_mutex_);
+        price_cache_.clear();
+    }
+    std::atomic_store(&snapshot_, std::shared_ptr<const PriceSnapshot>());
+    invalidateCatalog();
 }
 
 Result<nlohmann::json> MarketData::getDataSummary(const std::string& symbol,
@@ -378,18 +859,20 @@ Result<nlohmann::json> MarketData::getDataSummary(const std::string& symbol,
 
 // Test methods
 Result<void> MarketData::testDatabaseConnection() const {
-    if (!db_connection_) {
+    DatabaseConnection* db = connection();
+    if (!db) {
         return Result<void>(ErrorCode::DATABASE_CONNECTION_FAILED, "No database connection available");
     }
-    return db_connection_->testConnection();
+    return db->testConnection();
 }
 
 Result<nlohmann::json> MarketData::getDatabaseInfo() const {
-    if (!db_connection_) {
+    DatabaseConnection* db = connection();
+    if (!db) {
         return Result<nlohmann::json>(ErrorCode::DATABASE_CONNECTION_FAILED, "No database connection available");
     }
     try {
-        auto info = db_connection_->getConnectionInfo();
+        auto info = db->getConnectionInfo();
         return Result<nlohmann::json>(std::move(info));
     } catch (const std::exception& e) {
         return Result<nlohmann::json>(ErrorCode::DATABASE_CONNECTION_FAILED, 
@@ -412,7 +895,7 @@ std::string MarketData::formatDate(const std::string& date) {
 
 // Database access for temporal validation
 DatabaseConnection* MarketData::getDatabaseConnection() const {
-    return db_connection_.get();
+    return connection();
 }
 
 // Memory optimization methods
@@ -422,6 +905,8 @@ void MarketData::optimizeMemory() {
         std::lock_guard<std::mutex> lock(cache_mutex_);
         price_cache_.clear();
     }
+    std::atomic_store(&snapshot_, std::shared_ptr<const PriceSnapshot>());
+    invalidateCatalog();
     
     // Note: Connection pool optimization would be handled by DatabaseConnection
     // if it implements IMemoryOptimizable interface
@@ -440,9 +925,25 @@ size_t MarketData::getMemoryUsage() const {
         }
     }
     
+    // Price snapshot arrays
+    if (auto snapshot = std::atomic_load(&snapshot_)) {
+        total += sizeof(PriceSnapshot) + snapshot->symbols.capacity() * sizeof(std::string) +
+                 snapshot->closes.capacity() * sizeof(double) + snapshot->dates.capacity() * sizeof(int32_t);
+        for (const auto& symbol : snapshot->symbols) {
+            total += symbol.capacity();
+        }
+    }
+    
+    if (auto catalog = std::atomic_load(&catalog_)) {
+        total += catalog->getMemoryUsage();
+    }
+    
     // Add database connection memory (if available)
-    if (db_connection_) {
-        total += sizeof(*db_connection_);
+    {
+        std::lock_guard<std::mutex> lock(connection_mutex_);
+        if (db_connection_) {
+            total += sizeof(*db_connection_);
+        }
     }
     
     return total;
@@ -459,8 +960,19 @@ std::string MarketData::getMemoryReport() const {
     }
     
     report << "  Price cache entries: " << cache_size << "\n";
+    auto snapshot = std::atomic_load(&snapshot_);
+    report << "  Price snapshot: " << (snapshot ? std::to_string(snapshot->symbols.size()) + " symbols (v" +
+                                                  std::to_string(snapshot->version) + ")" : "None") << "\n";
+    auto catalog = std::atomic_load(&catalog_);
+    report << "  Market catalog: " << (catalog ? std::to_string(catalog->size()) + " symbols (epoch " +
+                                                 std::to_string(catalog->getEpoch()) + ")" : "None") << "\n";
     report << "  Cache enabled: " << (cache_enabled_ ? "Yes" : "No") << "\n";
-    report << "  Database connection: " << (db_connection_ ? "Active" : "None") << "\n";
+    std::string connection_state;
+    {
+        std::lock_guard<std::mutex> lock(connection_mutex_);
+        connection_state = db_connection_ ? "Active" : (connect_from_environment_ ? "Deferred" : "None");
+    }
+    report << "  Database connection: " << connection_state << "\n";
     report << "  Estimated memory: " << getMemoryUsage() << " bytes\n";
     
     return report.str();
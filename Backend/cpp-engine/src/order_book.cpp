@@ -0,0 +1,115 @@
+#include <algorithm>
+#include <cmath>
+
+#include "order_book.h"
+
+Result<uint64_t> OrderBook::place(Signal side, OrderKind kind, double price, int shares, const std::string& date,
+                                  uint64_t id) {
+    if (side == Signal::HOLD) {
+        return Result<uint64_t>(ErrorCode::EXECUTION_INVALID_SIGNAL_TYPE, "Resting orders must be BUY or SELL");
+    }
+    if (kind == OrderKind::MARKET) {
+        return Result<uint64_t>(ErrorCode::EXECUTION_INVALID_SIGNAL_TYPE, "Market orders do not rest in the book");
+    }
+    if (!std::isfinite(price) || price <= 0.0) {
+        return Result<uint64_t>(ErrorCode::EXECUTION_INVALID_PRICE,
+                                "Invalid resting order price: " + std::to_string(price));
+    }
+    if (shares <= 0) {
+        return Result<uint64_t>(ErrorCode::EXECUTION_INVALID_SIGNAL,
+                                "Resting order needs a positive share count: " + std::to_string(shares));
+    }
+
+    if (id != 0 && index_.count(id) > 0) {
+        return Result<uint64_t>(ErrorCode::EXECUTION_INVALID_SIGNAL,
+                                "Resting order id already in the book: " + std::to_string(id));
+    }
+
+    RestingOrder order;
+    order.id = id != 0 ? id : next_id_;
+    next_id_ = std::max(next_id_, order.id + 1);
+    order.side = side;
+    order.kind = kind;
+    order.price = price;
+    order.shares = shares;
+    order.placed_date = date;
+
+    const Book book = bookFor(side, kind);
+    const Key key(crossedFromTop(book) ? -price : price, order.id);
+    books_[book].emplace(key, std::move(order));
+    index_.emplace(key.second, std::make_pair(book, key));
+    return Result<uint64_t>(key.second);
+}
+
+bool OrderBook::cancel(uint64_t id) {
+    auto it = index_.find(id);
+    if (it == index_.end()) {
+        return false;
+    }
+    books_[it->second.first].erase(it->second.second);
+    index_.erase(it);
+    return true;
+}
+
+void OrderBook::clear() {
+    for (auto& book : books_) {
+        book.clear();
+    }
+    index_.clear();
+}
+
+std::vector<OrderFill> OrderBook::cross(double open, double high, double low) {
+    std::vector<OrderFill> fills;
+    if (index_.empty()) {
+        return fills;
+    }
+    for (int book = 0; book < BOOK_COUNT; ++book) {
+        crossBook(static_cast<Book>(book), open, high, low, fills);
+    }
+    return fills;
+}
+
+void OrderBook::crossBook(Book book, double open, double high, double low, std::vector<OrderFill>& fills) {
+    // Orders the bar reaches form a prefix of the map: levels at or above the low for
+    // the maps crossed from the top, at or below the high for the others
+    auto& levels = books_[book];
+    const bool from_top = crossedFromTop(book);
+    const double reach = from_top ? -low : high;
+    auto it = levels.begin();
+    while (it != levels.end() && it->first.first <= reach) {
+        OrderFill fill;
+        fill.order = std::move(it->second);
+        // Buy limits and sell stops fill at the level or lower; the others at the level or higher
+        fill.fill_price = from_top ? std::min(fill.order.price, open) : std::max(fill.order.price, open);
+        index_.erase(fill.order.id);
+        fills.push_back(std::move(fill));
+        it = levels.erase(it);
+    }
+}
+
+const RestingOrder* OrderBook::find(uint64_t id) const {
+    auto it = index_.find(id);
+    if (it == index_.end()) {
+        return nullptr;
+    }
+    return &books_[it->second.first].at(it->second.second);
+}
+
+OrderBook::Book OrderBook::bookFor(Signal side, OrderKind kind) {
+    if (side == Signal::BUY) {
+        return kind == OrderKind::LIMIT ? BUY_LIMIT : BUY_STOP;
+    }
+    return kind == OrderKind::LIMIT ? SELL_LIMIT : SELL_STOP;
+}
+
+size_t OrderBook::getMemoryUsage() const {
+    // Approximate: one tree node per order plus its index entry
+    size_t usage = sizeof(*this);
+    for (const auto& book : books_) {
+        for (const auto& [key, order] : book) {
+            usage += sizeof(Key) + sizeof(RestingOrder) + 4 * sizeof(void*) + order.placed_date.capacity();
+        }
+    }
+    usage += index_.size() * (sizeof(uint64_t) + sizeof(std::pair<Book, Key>) + 2 * sizeof(void*));
+    return usage;
+}
@@ -91,6 +91,10 @@ Position Portfolio::getPosition(const std::string& symbol) const {
 }
 
 
+const std::map<std::string, Position>& Portfolio::getPositions() const {
+    return positions_;
+}
+
 std::vector<std::string> Portfolio::getSymbols() const {
     std::vector<std::string> symbols;
     for (const auto& pair : positions_) {
@@ -2,11 +2,18 @@
 #include <cmath>
 #include <numeric>
 
+#include "date_time_utils.h"
 #include "logger.h"
 #include "portfolio_allocator.h"
 #include "trading_exceptions.h"
 
-PortfolioAllocator::PortfolioAllocator(const AllocationConfig& config) : config_(config), initial_capital_(0.0) {
+namespace {
+constexpr double DEFAULT_ANNUAL_VOLATILITY = 0.15;
+constexpr double MIN_ANNUAL_VOLATILITY = 0.01;
+constexpr size_t MIN_CORRELATION_OBSERVATIONS = 20;
+}
+
+PortfolioAllocator::PortfolioAllocator(const AllocationConfig& config) : config_(config), days_since_rebalance_(0), rebalance_anchor_day_(TradingCalendar::NO_DAY), initial_capital_(0.0), has_rebalance_weights_(false), covariance_stale_(true) {
     Logger::debug("PortfolioAllocator initialized with strategy: ", static_cast<int>(config_.strategy));
 }
 
@@ -136,33 +143,28 @@ AllocationResult PortfolioAllocator::calculateVolatilityAdjustedAllocation(
     result.cash_reserved = total_capital * config_.cash_reserve_pct;
     result.total_allocated_capital = total_capital - result.cash_reserved;
     
-    // Calculate volatility for each symbol
-    std::map<std::string, double> volatilities;
+    // Per-symbol volatility from the covariance diagonal (one pass over all histories)
+    std::vector<bool> has_history;
+    CovarianceMatrix covariance = buildCovarianceMatrix(symbols, has_history);
+    
+    std::vector<double> volatilities(symbols.size());
     double total_inverse_vol = 0.0;
     
-    for (const auto& symbol : symbols) {
-        double volatility = 0.15; // Default volatility if no price history available
-        
-        auto price_hist_it = price_history_.find(symbol);
-        if (price_hist_it != price_history_.end() && price_hist_it->second.size() > 1) {
-            volatility = calculateVolatility(price_hist_it->second);
-            volatility = std::max(volatility, 0.01); // Minimum volatility to avoid division by zero
-        }
-        
-        volatilities[symbol] = volatility;
-        total_inverse_vol += 1.0 / volatility;
+    for (size_t i = 0; i < symbols.size(); ++i) {
+        volatilities[i] = covariance.annualizedVolatility(i);
+        total_inverse_vol += 1.0 / volatilities[i];
     }
     
     // Calculate weights inversely proportional to volatility
-    for (const auto& symbol : symbols) {
-        double inverse_vol = 1.0 / volatilities[symbol];
-        double weight = inverse_vol / total_inverse_vol;
+    for (size_t i = 0; i < symbols.size(); ++i) {
+        const auto& symbol = symbols[i];
+        double weight = (1.0 / volatilities[i]) / total_inverse_vol;
         double value = result.total_allocated_capital * weight;
         
         result.target_weights[symbol] = weight;
         result.target_values[symbol] = value;
         
-        Logger::debug("Symbol ", symbol, ": volatility=", volatilities[symbol] * 100, 
+        Logger::debug("Symbol ", symbol, ": volatility=", volatilities[i] * 100, 
                      "%, weight=", weight * 100, "%, value=$", value);
     }
     
@@ -226,35 +228,22 @@ AllocationResult PortfolioAllocator::calculateRiskParityAllocation(
     result.cash_reserved = total_capital * config_.cash_reserve_pct;
     result.total_allocated_capital = total_capital - result.cash_reserved;
     
-    // For simplicity, approximate risk parity using inverse volatility weighting
-    // A more sophisticated implementation would use optimisation to achieve equal risk contribution
-    
-    std::map<std::string, double> volatilities;
-    double total_inverse_vol = 0.0;
+    // Equal risk contribution over the full covariance matrix, so correlated
+    // symbols share their risk budget instead of being weighted independently
+    std::vector<bool> has_history;
+    CovarianceMatrix covariance = buildCovarianceMatrix(symbols, has_history);
+    std::vector<double> weights = covariance.equalRiskContributionWeights();
+    std::vector<double> contributions = covariance.riskContributions(weights);
     
-    for (const auto& symbol : symbols) {
-        double volatility = 0.15; // Default volatility
-        
-        auto price_hist_it = price_history_.find(symbol);
-        if (price_hist_it != price_history_.end() && price_hist_it->second.size() > 1) {
-            volatility = calculateVolatility(price_hist_it->second);
-            volatility = std::max(volatility, 0.01);
-        }
-        
-        volatilities[symbol] = volatility;
-        total_inverse_vol += 1.0 / volatility;
-    }
-    
-    // Calculate weights for approximately equal risk contribution
-    for (const auto& symbol : symbols) {
-        double inverse_vol = 1.0 / volatilities[symbol];
-        double weight = inverse_vol / total_inverse_vol;
-        double value = result.total_allocated_capital * weight;
+    for (size_t i = 0; i < symbols.size(); ++i) {
+        const auto& symbol = symbols[i];
+        double value = result.total_allocated_capital * weights[i];
         
-        result.target_weights[symbol] = weight;
+        result.target_weights[symbol] = weights[i];
         result.target_values[symbol] = value;
         
-        Logger::debug("Symbol ", symbol, ": risk-adjusted weight=", weight * 100, "%, value=$", value);
+        Logger::debug("Symbol ", symbol, ": risk-parity weight=", weights[i] * 100, "%, risk contribution=",
+                     contributions[i] * 100, "%, value=$", value);
     }
     
     return result;
@@ -265,13 +254,21 @@ bool PortfolioAllocator::shouldRebalance(
     const std::map<std::string, double>& current_prices,
     const std::string& current_date
 ) {
-    // Check if rebalancing frequency has passed
-    if (isRebalancingDue(current_date)) {
-        Logger::debug("Rebalancing due to time frequency");
-        return true;
+    int32_t current_day = TradingCalendar::NO_DAY;
+    DateTimeUtils::parseIsoDate(current_date, current_day);
+    return shouldRebalance(current_portfolio, current_prices, current_day);
+}
+
+bool PortfolioAllocator::shouldRebalance(
+    const Portfolio& current_portfolio,
+    const std::map<std::string, double>& current_prices,
+    int32_t current_day
+) {
+    // Rebalance at most once per frequency period, and only when drift leaves the threshold band
+    if (!isRebalancingDue(current_day)) {
+        return false;
     }
     
-    // Check if allocation drift exceeds threshold
     double allocation_drift = calculateAllocationDrift(current_portfolio, current_prices);
     if (allocation_drift > config_.rebalancing_threshold) {
         Logger::debug("Rebalancing due to allocation drift: ", allocation_drift * 100, "%");
@@ -307,13 +304,102 @@ Result<AllocationResult> PortfolioAllocator::calculateRebalancing(
     target_allocation.rebalancing_needed = true;
     
     // Store this as the new target allocation for drift calculation
-    last_rebalance_weights_ = target_allocation.target_weights;
+    assignWeights(target_allocation.target_weights, rebalance_weights_);
+    has_rebalance_weights_ = true;
     
     Logger::debug("Rebalancing calculation completed for ", current_symbols.size(), " symbols");
     
     return Result<AllocationResult>(target_allocation);
 }
 
+Result<RebalancePlan> PortfolioAllocator::calculateRebalanceOrders(
+    const Portfolio& current_portfolio,
+    const std::map<std::string, double>& current_prices,
+    const std::string& current_date
+) {
+    auto target_result = calculateRebalancing(current_portfolio, current_prices, 
+                                              current_portfolio.getTotalValue(current_prices));
+    if (target_result.isError()) {
+        return Result<RebalancePlan>(target_result.getError());
+    }
+    
+    // Compact the held, priced symbols with a target out of the dense arrays; symbols
+    // dropped by the risk filters keep their current holding rather than being liquidated
+    updateCurrentValues(current_portfolio, current_prices);
+    std::vector<std::string> symbols;
+    std::vector<double> shares, prices, weights;
+    
+    for (size_t i = 0; i < symbols_.size(); ++i) {
+        if (rebalance_weights_[i] > 0 && current_values_[i] > 0) {
+            symbols.push_back(symbols_[i]);
+            shares.push_back(current_shares_[i]);
+            prices.push_back(current_prices_[i]);
+            weights.push_back(rebalance_weights_[i]);
+        }
+    }
+    
+    RebalancePlan plan = buildRebalanceOrders(symbols, shares, prices, weights);
+    
+    last_rebalance_date_ = current_date;
+    days_since_rebalance_ = 0;
+    int32_t rebalance_day = 0;
+    if (DateTimeUtils::parseIsoDate(current_date, rebalance_day)) {
+        rebalance_anchor_day_ = rebalance_day;
+    }
+    
+    Logger::debug("Rebalance on ", current_date, ": ", plan.orders.size(), " orders, turnover ", 
+                 plan.turnover * 100, "% of $", plan.invested_value);
+    
+    return Result<RebalancePlan>(plan);
+}
+
+RebalancePlan PortfolioAllocator::buildRebalanceOrders(
+    const std::vector<std::string>& symbols,
+    const std::vector<double>& shares,
+    const std::vector<double>& prices,
+    const std::vector<double>& weights
+) const {
+    RebalancePlan plan;
+    const size_t n = symbols.size();
+    
+    // Rebalancing redistributes the invested sleeve; cash exposure stays with the strategy
+    double invested = 0.0;
+    double weight_total = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        invested += shares[i] * prices[i];
+        weight_total += weights[i];
+    }
+    plan.invested_value = invested;
+    if (invested <= 0 || weight_total <= 0) {
+        return plan;
+    }
+    
+    // Share deltas for all symbols in one pass; flooring targets keeps buys within sell proceeds
+    const double scale = invested / weight_total;
+    std::vector<double> deltas(n);
+    for (size_t i = 0; i < n; ++i) {
+        deltas[i] = std::floor(weights[i] * scale / prices[i]) - shares[i];
+    }
+    
+    double traded_value = 0.0;
+    plan.orders.reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+        if (deltas[i] <= -1.0) {
+            plan.orders.emplace_back(symbols[i], Signal::SELL, static_cast<int>(-deltas[i]), prices[i]);
+            traded_value -= deltas[i] * prices[i];
+        }
+    }
+    for (size_t i = 0; i < n; ++i) {
+        if (deltas[i] >= 1.0) {
+            plan.orders.emplace_back(symbols[i], Signal::BUY, static_cast<int>(deltas[i]), prices[i]);
+            traded_value += deltas[i] * prices[i];
+        }
+    }
+    
+    plan.turnover = traded_value / invested;
+    return plan;
+}
+
 Result<double> PortfolioAllocator::calculatePositionSize(
     const std::string& symbol,
     const Portfolio& portfolio,
@@ -328,7 +414,6 @@ Result<double> PortfolioAllocator::calculatePositionSize(
     }
     
     // Use provided target weights and initial capital, or fall back to stored values
-    std::map<std::string, double> weights = target_weights.empty() ? current_target_weights_ : target_weights;
     double capital = (initial_capital > 0) ? initial_capital : initial_capital_;
     
     // Calculate current position value
@@ -341,17 +426,28 @@ Result<double> PortfolioAllocator::calculatePositionSize(
     // For buy signals, use allocation-based position sizing
     if (signal_type == Signal::BUY) {
         // Find target weight for this symbol
-        auto weight_it = weights.find(symbol);
-        if (weight_it == weights.end()) {
+        double target_weight = 0.0;
+        bool has_target = false;
+        size_t target_count = 0;
+        if (!target_weights.empty()) {
+            auto weight_it = target_weights.find(symbol);
+            has_target = weight_it != target_weights.end();
+            target_weight = has_target ? weight_it->second : 0.0;
+            target_count = target_weights.size();
+        } else {
+            size_t index = findSymbol(symbol);
+            has_target = index != NO_SYMBOL && target_weights_[index] > 0;
+            target_weight = has_target ? target_weights_[index] : 0.0;
+            target_count = static_cast<size_t>(std::count_if(target_weights_.begin(), target_weights_.end(),
+                                                             [](double weight) { return weight > 0; }));
+        }
+        
+        if (!has_target) {
             Logger::debug("No target weight found for ", symbol, ", using equal weight fallback");
             // Fallback: assume equal weight allocation
-            double fallback_weight = 1.0 / std::max(1.0, static_cast<double>(weights.size()));
-            weights[symbol] = fallback_weight;
-            weight_it = weights.find(symbol);
+            target_weight = 1.0 / std::max(1.0, static_cast<double>(target_count));
         }
         
-        double target_weight = weight_it->second;
-        
         // INITIAL CAPITAL-RELATIVE POSITION SIZING: Scale with initial capital to prevent compounding trade sizes
         
         // Calculate maximum allowed position value as percentage of INITIAL portfolio value
@@ -429,7 +525,7 @@ Result<double> PortfolioAllocator::calculatePositionSize(
 }
 
 // Helper methods implementation
-double PortfolioAllocator::calculateVolatility(const std::vector<double>& prices) const {
+double PortfolioAllocator::calculateVolatility(const RingBuffer<double>& prices) const {
     if (prices.size() < 2) return 0.15; // Default volatility
     
     // Calculate daily returns
@@ -456,7 +552,7 @@ double PortfolioAllocator::calculateVolatility(const std::vector<double>& prices
     return volatility;
 }
 
-double PortfolioAllocator::calculateMomentum(const std::vector<double>& prices) const {
+double PortfolioAllocator::calculateMomentum(const RingBuffer<double>& prices) const {
     if (prices.size() < 2) return 0.0;
     
     // Simple momentum: total return over the period
@@ -464,6 +560,134 @@ double PortfolioAllocator::calculateMomentum(const std::vector<double>& prices)
     return momentum;
 }
 
+double PortfolioAllocator::calculateCorrelation(const std::vector<double>& prices1, const std::vector<double>& prices2) const {
+    size_t length = std::min(prices1.size(), prices2.size());
+    if (length < 3) return 0.0;
+    
+    // Align on the most recent common observations
+    size_t offset1 = prices1.size() - length;
+    size_t offset2 = prices2.size() - length;
+    std::vector<double> returns;
+    returns.reserve((length - 1) * 2);
+    for (size_t t = 1; t < length; ++t) {
+        double p1 = prices1[offset1 + t - 1];
+        double p2 = prices2[offset2 + t - 1];
+        returns.push_back(p1 > 0 ? prices1[offset1 + t] / p1 - 1.0 : 0.0);
+        returns.push_back(p2 > 0 ? prices2[offset2 + t] / p2 - 1.0 : 0.0);
+    }
+    
+    return CovarianceMatrix::fromReturns(returns, length - 1, 2).correlation(0, 1);
+}
+
+CovarianceMatrix PortfolioAllocator::buildCovarianceMatrix(const std::vector<std::string>& symbols,
+                                                           std::vector<bool>& has_history) const {
+    const size_t assets = symbols.size();
+    has_history.assign(assets, false);
+    
+    // Trailing window shared by every symbol that has at least two prices
+    std::vector<const RingBuffer<double>*> histories(assets, nullptr);
+    size_t common_length = 0;
+    for (size_t i = 0; i < assets; ++i) {
+        auto history_it = price_history_.find(symbols[i]);
+        if (history_it != price_history_.end() && history_it->second.size() > 1) {
+            histories[i] = &history_it->second;
+            has_history[i] = true;
+            size_t length = history_it->second.size();
+            common_length = (common_length == 0) ? length : std::min(common_length, length);
+        }
+    }
+    
+    CovarianceMatrix covariance(assets);
+    if (covariance_stale_) {
+        reseedRollingCovariance();
+    }
+    
+    // The rolling estimate serves any subset whose shared window is exactly the tracked one
+    bool from_rolling = common_length > 1 && rolling_covariance_.getObservationCount() == common_length - 1;
+    std::vector<size_t> rolling_indices(assets, 0);
+    for (size_t i = 0; i < assets && from_rolling; ++i) {
+        if (!has_history[i]) continue;
+        auto index_it = covariance_index_.find(symbols[i]);
+        if (index_it == covariance_index_.end()) {
+            from_rolling = false;
+        } else {
+            rolling_indices[i] = index_it->second;
+        }
+    }
+    
+    if (from_rolling) {
+        CovarianceMatrix tracked = rolling_covariance_.covariance();
+        for (size_t i = 0; i < assets; ++i) {
+            if (!has_history[i]) continue;
+            for (size_t j = 0; j < assets; ++j) {
+                if (has_history[j]) {
+                    covariance.at(i, j) = tracked(rolling_indices[i], rolling_indices[j]);
+                }
+            }
+        }
+        covariance.setObservationCount(common_length - 1);
+    } else if (common_length > 1) {
+        // Row-major returns matrix (observations x assets); symbols without history stay zero
+        const size_t observations = common_length - 1;
+        std::vector<double> returns(observations * assets, 0.0);
+        for (size_t i = 0; i < assets; ++i) {
+            if (!histories[i]) continue;
+            const auto& prices = *histories[i];
+            size_t offset = prices.size() - common_length;
+            for (size_t t = 0; t < observations; ++t) {
+                double previous = prices[offset + t];
+                if (previous > 0) {
+                    returns[t * assets + i] = (prices[offset + t + 1] - previous) / previous;
+                }
+            }
+        }
+        covariance = CovarianceMatrix::fromReturns(returns, observations, assets);
+    }
+    
+    // Default risk for symbols without history and a volatility floor for the rest
+    const double default_variance = (DEFAULT_ANNUAL_VOLATILITY * DEFAULT_ANNUAL_VOLATILITY) / 252.0;
+    const double min_variance = (MIN_ANNUAL_VOLATILITY * MIN_ANNUAL_VOLATILITY) / 252.0;
+    for (size_t i = 0; i < assets; ++i) {
+        if (!has_history[i]) {
+            for (size_t j = 0; j < assets; ++j) {
+                covariance.at(i, j) = 0.0;
+                covariance.at(j, i) = 0.0;
+            }
+            covariance.at(i, i) = default_variance;
+        } else if (covariance.variance(i) < min_variance) {
+            covariance.at(i, i) = min_variance;
+        }
+    }
+    
+    return covariance;
+}
+
+void PortfolioAllocator::reseedRollingCovariance() const {
+    covariance_symbols_.clear();
+    covariance_index_.clear();
+    size_t common_length = 0;
+    for (const auto& [symbol, history] : price_history_) {
+        if (history.empty()) continue;
+        covariance_index_.emplace(symbol, covariance_symbols_.size());
+        covariance_symbols_.push_back(symbol);
+        common_length = (common_length == 0) ? history.size() : std::min(common_length, history.size());
+    }
+    
+    const size_t assets = covariance_symbols_.size();
+    rolling_covariance_.reset(assets, historyCapacity() - 1);
+    std::vector<double> row(assets);
+    for (size_t t = 0; t + 1 < common_length; ++t) {
+        for (size_t i = 0; i < assets; ++i) {
+            const auto& prices = price_history_.at(covariance_symbols_[i]);
+            size_t offset = prices.size() - common_length;
+            double previous = prices[offset + t];
+            row[i] = previous > 0 ? (prices[offset + t + 1] - previous) / previous : 0.0;
+        }
+        rolling_covariance_.push(row);
+    }
+    covariance_stale_ = false;
+}
+
 std::vector<std::string> PortfolioAllocator::applyRiskFilters(
     const std::vector<std::string>& symbols, 
     const std::map<std::string, double>& current_prices
@@ -480,53 +704,113 @@ std::vector<std::string> PortfolioAllocator::applyRiskFilters(
         }
     }
     
-    return filtered_symbols;
-}
-
-void PortfolioAllocator::enforceConstraints(AllocationResult& result) const {
-    // Ensure no position exceeds maximum weight
-    for (auto& [symbol, weight] : result.target_weights) {
-        if (weight > config_.max_position_weight) {
-            Logger::debug("Constraining ", symbol, " weight from ", weight * 100, "% to ", 
-                         config_.max_position_weight * 100, "%");
-            weight = config_.max_position_weight;
+    // Correlation filter: greedily keep symbols (in input order) whose correlation with
+    // every kept symbol stays within the limit; needs enough shared history to be meaningful
+    if (config_.correlation_limit >= 1.0 || filtered_symbols.size() < 2) {
+        return filtered_symbols;
+    }
+    
+    std::vector<bool> has_history;
+    CovarianceMatrix covariance = buildCovarianceMatrix(filtered_symbols, has_history);
+    if (covariance.getObservationCount() < MIN_CORRELATION_OBSERVATIONS) {
+        return filtered_symbols;
+    }
+    
+    std::vector<size_t> kept;
+    std::vector<std::string> decorrelated_symbols;
+    for (size_t i = 0; i < filtered_symbols.size(); ++i) {
+        bool within_limit = true;
+        if (has_history[i]) {
+            for (size_t k : kept) {
+                if (has_history[k] && std::abs(covariance.correlation(i, k)) > config_.correlation_limit) {
+                    Logger::debug("Filtering out symbol ", filtered_symbols[i], " due to correlation ",
+                                 covariance.correlation(i, k), " with ", filtered_symbols[k]);
+                    within_limit = false;
+                    break;
+                }
+            }
         }
-        
-        if (weight < config_.min_position_weight && weight > 0) {
-            Logger::debug("Increasing ", symbol, " weight from ", weight * 100, "% to minimum ", 
-                         config_.min_position_weight * 100, "%");
-            weight = config_.min_position_weight;
+        if (within_limit) {
+            kept.push_back(i);
+            decorrelated_symbols.push_back(filtered_symbols[i]);
         }
     }
     
-    // Renormalise weights to sum to 1.0
-    double total_weight = 0.0;
+    return decorrelated_symbols;
+}
+
+void PortfolioAllocator::enforceConstraints(AllocationResult& result) const {
+    // Dense copy of the weights in map order
+    std::vector<double> weights;
+    weights.reserve(result.target_weights.size());
     for (const auto& [symbol, weight] : result.target_weights) {
-        total_weight += weight;
+        weights.push_back(weight);
+    }
+    
+    size_t clipped = clipWeights(weights, config_.min_position_weight, config_.max_position_weight);
+    if (clipped > 0) {
+        Logger::debug("Constrained ", clipped, " weights into [", config_.min_position_weight * 100, "%, ",
+                     config_.max_position_weight * 100, "%]");
     }
     
+    // Renormalise weights to sum to 1.0
+    double total_weight = std::accumulate(weights.begin(), weights.end(), 0.0);
     if (total_weight > 0 && std::abs(total_weight - 1.0) > 0.01) {
         Logger::debug("Renormalising weights from total: ", total_weight, " to 1.0");
-        for (auto& [symbol, weight] : result.target_weights) {
-            weight /= total_weight;
-            result.target_values[symbol] = result.total_allocated_capital * weight;
+        const double scale = 1.0 / total_weight;
+        for (double& weight : weights) {
+            weight *= scale;
         }
     }
+    
+    // Write back through the map adapter
+    size_t i = 0;
+    for (auto& [symbol, weight] : result.target_weights) {
+        weight = weights[i++];
+        result.target_values[symbol] = result.total_allocated_capital * weight;
+    }
+}
+
+size_t PortfolioAllocator::clipWeights(std::vector<double>& weights, double min_weight, double max_weight) {
+    size_t clipped = 0;
+    for (double& weight : weights) {
+        double bounded = weight > 0 ? std::min(std::max(weight, min_weight), max_weight) : weight;
+        clipped += (bounded != weight) ? 1 : 0;
+        weight = bounded;
+    }
+    return clipped;
 }
 
 double PortfolioAllocator::calculateAllocationDrift(
     const Portfolio& current_portfolio,
     const std::map<std::string, double>& current_prices
 ) {
-    auto current_weights = getCurrentWeights(current_portfolio, current_prices);
+    updateCurrentValues(current_portfolio, current_prices);
+    
+    // Drift is measured within the invested sleeve against the latest rebalance
+    // targets, or the initial allocation before that
+    const auto& targets = has_rebalance_weights_ ? rebalance_weights_ : target_weights_;
+    const size_t n = symbols_.size();
+    
+    double invested = 0.0;
+    double weight_total = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        bool in_sleeve = targets[i] > 0 && current_values_[i] > 0;
+        invested += in_sleeve ? current_values_[i] : 0.0;
+        weight_total += in_sleeve ? targets[i] : 0.0;
+    }
+    
+    if (invested <= 0 || weight_total <= 0) {
+        return 0.0;
+    }
     
+    const double value_scale = 1.0 / invested;
+    const double weight_scale = 1.0 / weight_total;
     double max_drift = 0.0;
-    for (const auto& [symbol, current_weight] : current_weights) {
-        auto target_it = last_rebalance_weights_.find(symbol);
-        if (target_it != last_rebalance_weights_.end()) {
-            double drift = std::abs(current_weight - target_it->second);
-            max_drift = std::max(max_drift, drift);
-        }
+    for (size_t i = 0; i < n; ++i) {
+        bool in_sleeve = targets[i] > 0 && current_values_[i] > 0;
+        double drift = std::abs(current_values_[i] * value_scale - targets[i] * weight_scale);
+        max_drift = std::max(max_drift, in_sleeve ? drift : 0.0);
     }
     
     return max_drift;
@@ -541,23 +825,74 @@ std::map<std::string, double> PortfolioAllocator::getCurrentWeights(
     
     if (total_value <= 0) return weights;
     
-    for (const auto& symbol : portfolio.getSymbols()) {
-        if (portfolio.hasPosition(symbol)) {
-            const Position& position = portfolio.getPosition(symbol);
-            auto price_it = current_prices.find(symbol);
-            if (price_it != current_prices.end()) {
-                double position_value = position.getShares() * price_it->second;
-                weights[symbol] = position_value / total_value;
-            }
+    updateCurrentValues(portfolio, current_prices);
+    for (size_t i = 0; i < symbols_.size(); ++i) {
+        if (current_shares_[i] > 0 && current_prices_[i] > 0) {
+            weights[symbols_[i]] = current_values_[i] / total_value;
         }
     }
     
     return weights;
 }
 
+void PortfolioAllocator::updateCurrentValues(const Portfolio& portfolio,
+                                             const std::map<std::string, double>& current_prices) {
+    std::fill(current_shares_.begin(), current_shares_.end(), 0.0);
+    std::fill(current_prices_.begin(), current_prices_.end(), 0.0);
+    
+    for (const auto& [symbol, position] : portfolio.getPositions()) {
+        if (position.isEmpty()) {
+            continue;
+        }
+        size_t index = registerSymbol(symbol);
+        current_shares_[index] = static_cast<double>(position.getShares());
+        auto price_it = current_prices.find(symbol);
+        if (price_it != current_prices.end()) {
+            current_prices_[index] = price_it->second;
+        }
+    }
+    
+    for (size_t i = 0; i < symbols_.size(); ++i) {
+        current_values_[i] = current_shares_[i] * current_prices_[i];
+    }
+}
+
+size_t PortfolioAllocator::registerSymbol(const std::string& symbol) {
+    auto index_it = symbol_index_.find(symbol);
+    if (index_it != symbol_index_.end()) {
+        return index_it->second;
+    }
+    
+    size_t index = symbols_.size();
+    symbol_index_.emplace(symbol, index);
+    symbols_.push_back(symbol);
+    target_weights_.push_back(0.0);
+    rebalance_weights_.push_back(0.0);
+    current_shares_.push_back(0.0);
+    current_prices_.push_back(0.0);
+    current_values_.push_back(0.0);
+    return index;
+}
+
+size_t PortfolioAllocator::findSymbol(const std::string& symbol) const {
+    auto index_it = symbol_index_.find(symbol);
+    return index_it == symbol_index_.end() ? NO_SYMBOL : index_it->second;
+}
+
+void PortfolioAllocator::assignWeights(const std::map<std::string, double>& weights, std::vector<double>& dense) {
+    for (const auto& [symbol, weight] : weights) {
+        registerSymbol(symbol);
+    }
+    std::fill(dense.begin(), dense.end(), 0.0);
+    for (const auto& [symbol, weight] : weights) {
+        dense[symbol_index_[symbol]] = weight;
+    }
+}
+
 void PortfolioAllocator::setTargetAllocation(const std::map<std::string, double>& target_weights, double initial_capital) {
-    current_target_weights_ = target_weights;
+    assignWeights(target_weights, target_weights_);
     initial_capital_ = initial_capital;
+    days_since_rebalance_ = 0;
     
     Logger::debug("Updated target allocation with ", target_weights.size(), " symbols and initial capital: $", initial_capital);
     for (const auto& [symbol, weight] : target_weights) {
@@ -565,40 +900,133 @@ void PortfolioAllocator::setTargetAllocation(const std::map<std::string, double>
     }
 }
 
-bool PortfolioAllocator::isRebalancingDue(const std::string& current_date) const {
-    // Simple date comparison - in production, would use proper date parsing
-    if (last_rebalance_date_.empty()) return true;
-    
-    // For now, assume rebalancing is due every time (simplification)
-    return false;
+void PortfolioAllocator::resetState() {
+    price_history_.clear();
+    covariance_stale_ = true;
+    last_rebalance_date_.clear();
+    days_since_rebalance_ = 0;
+    initial_capital_ = 0.0;
+    symbols_.clear();
+    symbol_index_.clear();
+    target_weights_.clear();
+    rebalance_weights_.clear();
+    has_rebalance_weights_ = false;
+    current_shares_.clear();
+    current_prices_.clear();
+    current_values_.clear();
+    calendar_.reset();
+    rebalance_anchor_day_ = TradingCalendar::NO_DAY;
+}
+
+void PortfolioAllocator::setTradingCalendar(std::shared_ptr<const TradingCalendar> calendar) {
+    calendar_ = std::move(calendar);
+    rebalance_anchor_day_ = calendar_ ? calendar_->firstDay() : TradingCalendar::NO_DAY;
+}
+
+int32_t PortfolioAllocator::getNextRebalanceDay() const {
+    if (!calendar_ || rebalance_anchor_day_ == TradingCalendar::NO_DAY) {
+        return TradingCalendar::NO_DAY;
+    }
+    return calendar_->nextRebalanceDay(rebalance_anchor_day_, config_.rebalancing_frequency_days);
+}
+
+bool PortfolioAllocator::isRebalancingDue(int32_t current_day) const {
+    // Frequency is counted in exchange sessions when a calendar is set, otherwise in
+    // trading days recorded through recordDailyPrices
+    size_t frequency = static_cast<size_t>(std::max(1, config_.rebalancing_frequency_days));
+    if (calendar_ && rebalance_anchor_day_ != TradingCalendar::NO_DAY) {
+        return current_day != TradingCalendar::NO_DAY &&
+               calendar_->businessDaysBetween(rebalance_anchor_day_, current_day) >= static_cast<int64_t>(frequency);
+    }
+    return days_since_rebalance_ >= frequency;
 }
 
 void PortfolioAllocator::updateConfig(const AllocationConfig& config) {
+    bool lookback_changed = config.lookback_days != config_.lookback_days;
     config_ = config;
+    
+    // Keep the most recent prices when the lookback window changes
+    if (lookback_changed) {
+        size_t capacity = historyCapacity();
+        for (auto& [symbol, history] : price_history_) {
+            RingBuffer<double> resized(capacity);
+            size_t start = history.size() > capacity ? history.size() - capacity : 0;
+            for (size_t i = start; i < history.size(); ++i) {
+                resized.push_overwrite(history[i]);
+            }
+            history = std::move(resized);
+        }
+        covariance_stale_ = true;
+    }
     Logger::debug("PortfolioAllocator configuration updated");
 }
 
 void PortfolioAllocator::updatePriceHistory(const std::string& symbol, const std::vector<double>& prices) {
-    price_history_[symbol] = prices;
-    Logger::debug("Updated price history for ", symbol, " with ", prices.size(), " data points");
+    // Only the trailing lookback window is retained
+    auto& history = price_history_[symbol];
+    size_t capacity = historyCapacity();
+    history.reset(capacity);
+    size_t start = prices.size() > capacity ? prices.size() - capacity : 0;
+    for (size_t i = start; i < prices.size(); ++i) {
+        history.push_overwrite(prices[i]);
+    }
+    covariance_stale_ = true;
+    Logger::debug("Updated price history for ", symbol, " with ", history.size(), " data points");
 }
 
 void PortfolioAllocator::updatePriceHistory(const std::map<std::string, std::vector<double>>& all_prices) {
     for (const auto& [symbol, prices] : all_prices) {
-        price_history_[symbol] = prices;
+        updatePriceHistory(symbol, prices);
     }
     Logger::debug("Updated price history for ", all_prices.size(), " symbols");
 }
 
-// Memory optimization methods
-void PortfolioAllocator::optimizeMemory() {
-    // Optimize price history storage by shrinking vectors to fit
-    for (auto& [symbol, history] : price_history_) {
-        history.shrink_to_fit();
+void PortfolioAllocator::recordDailyPrices(const std::map<std::string, double>& prices) {
+    // The day extends the rolling covariance only when it prices exactly the tracked symbols
+    bool in_step = !covariance_stale_;
+    if (in_step) {
+        size_t priced = 0;
+        covariance_row_.assign(covariance_symbols_.size(), 0.0);
+        for (const auto& [symbol, price] : prices) {
+            if (price <= 0) continue;
+            auto index_it = covariance_index_.find(symbol);
+            if (index_it == covariance_index_.end()) {
+                in_step = false;
+                break;
+            }
+            double previous = price_history_.at(symbol).back();
+            covariance_row_[index_it->second] = previous > 0 ? (price - previous) / previous : 0.0;
+            ++priced;
+        }
+        in_step = in_step && priced == covariance_symbols_.size() && priced > 0;
     }
     
-    // Clear old rebalancing data if it exists
-    last_rebalance_weights_.clear();
+    for (const auto& [symbol, price] : prices) {
+        if (price <= 0) {
+            continue;
+        }
+        auto history_it = price_history_.find(symbol);
+        if (history_it == price_history_.end()) {
+            history_it = price_history_.emplace(symbol, RingBuffer<double>(historyCapacity())).first;
+        }
+        history_it->second.push_overwrite(price);
+    }
+    if (in_step) {
+        rolling_covariance_.push(covariance_row_);
+    } else {
+        covariance_stale_ = true;
+    }
+    ++days_since_rebalance_;
+}
+
+size_t PortfolioAllocator::historyCapacity() const {
+    return static_cast<size_t>(std::max(2, config_.lookback_days));
+}
+
+// Memory optimization methods
+void PortfolioAllocator::optimizeMemory() {
+    // Price history is bounded by the lookback window and the rebalance
+    // targets are needed for drift checks, so there is nothing to release
 }
 
 size_t PortfolioAllocator::getMemoryUsage() const {
@@ -606,18 +1034,15 @@ size_t PortfolioAllocator::getMemoryUsage() const {
     
     // Calculate price history memory usage
     for (const auto& [symbol, history] : price_history_) {
-        total += symbol.capacity() + (history.capacity() * sizeof(double));
-    }
-    
-    // Calculate rebalancing weights memory usage
-    for (const auto& [symbol, weight] : last_rebalance_weights_) {
-        total += symbol.capacity() + sizeof(double);
+        total += symbol.capacity() + sizeof(history) + (history.capacity() * sizeof(double));
     }
     
-    // Calculate current target weights memory usage
-    for (const auto& [symbol, weight] : current_target_weights_) {
-        total += symbol.capacity() + sizeof(double);
+    // Symbol index and the dense per-symbol arrays
+    for (const auto& symbol : symbols_) {
+        total += symbol.capacity() * 2 + sizeof(std::string) + sizeof(size_t);
     }
+    total += (target_weights_.capacity() + rebalance_weights_.capacity() + current_shares_.capacity() +
+              current_prices_.capacity() + current_values_.capacity()) * sizeof(double);
     
     // Add string storage for last rebalance date
     total += last_rebalance_date_.capacity();
@@ -636,8 +1061,12 @@ std::string PortfolioAllocator::getMemoryReport() const {
     }
     
     report << "  Total price data points: " << total_price_data_points << "\n";
-    report << "  Last rebalance weights: " << last_rebalance_weights_.size() << "\n";
-    report << "  Current target weights: " << current_target_weights_.size() << "\n";
+    auto positive = [](const std::vector<double>& weights) {
+        return std::count_if(weights.begin(), weights.end(), [](double weight) { return weight > 0; });
+    };
+    report << "  Indexed symbols: " << symbols_.size() << "\n";
+    report << "  Last rebalance weights: " << positive(rebalance_weights_) << "\n";
+    report << "  Current target weights: " << positive(target_weights_) << "\n";
     report << "  Allocation strategy: " << static_cast<int>(config_.strategy) << "\n";
     report << "  Estimated memory: " << getMemoryUsage() << " bytes\n";
     
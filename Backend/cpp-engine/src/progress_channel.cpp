@@ -0,0 +1,202 @@
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <new>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+
+#include "logger.h"
+#include "progress_channel.h"
+
+namespace {
+constexpr int MAX_READ_ATTEMPTS = 1000;
+}
+
+ProgressChannel::~ProgressChannel() {
+    close();
+}
+
+ProgressChannel::ProgressChannel(ProgressChannel&& other) noexcept
+    : layout_(other.layout_), writable_(other.writable_), path_(std::move(other.path_)) {
+    other.layout_ = nullptr;
+    other.writable_ = false;
+}
+
+ProgressChannel& ProgressChannel::operator=(ProgressChannel&& other) noexcept {
+    if (this != &other) {
+        close();
+        layout_ = other.layout_;
+        writable_ = other.writable_;
+        path_ = std::move(other.path_);
+        other.layout_ = nullptr;
+        other.writable_ = false;
+    }
+    return *this;
+}
+
+Result<void> ProgressChannel::openForWriting(const std::string& path) {
+    auto map_result = mapFile(path, true);
+    if (map_result.isError()) {
+        return map_result;
+    }
+
+    // Fresh record: construct the atomics in place, then publish the header
+    new (layout_) ProgressChannelLayout();
+    layout_->magic = ProgressChannelLayout::MAGIC;
+    layout_->version = ProgressChannelLayout::VERSION;
+    layout_->sequence.store(0, std::memory_order_release);
+
+    Logger::debug("Progress channel opened for writing at ", path);
+    return Result<void>();
+}
+
+Result<void> ProgressChannel::openForReading(const std::string& path) {
+    auto map_result = mapFile(path, false);
+    if (map_result.isError()) {
+        return map_result;
+    }
+
+    if (layout_->magic != ProgressChannelLayout::MAGIC || layout_->version != ProgressChannelLayout::VERSION) {
+        close();
+        return Result<void>(ErrorCode::SYSTEM_CONFIGURATION_ERROR,
+                           "File is not a version " + std::to_string(ProgressChannelLayout::VERSION) +
+                           " progress channel: " + path);
+    }
+    return Result<void>();
+}
+
+Result<void> ProgressChannel::mapFile(const std::string& path, bool writable) {
+    close();
+
+    int fd = writable ? ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644) : ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return Result<void>(ErrorCode::SYSTEM_FILE_ACCESS_DENIED,
+                           "Cannot open progress channel " + path + ": " + std::strerror(errno));
+    }
+
+    if (writable) {
+        if (::ftruncate(fd, sizeof(ProgressChannelLayout)) != 0) {
+            int error = errno;
+            ::close(fd);
+            return Result<void>(ErrorCode::SYSTEM_FILE_ACCESS_DENIED,
+                               "Cannot size progress channel " + path + ": " + std::strerror(error));
+        }
+    } else {
+        struct stat file_stat;
+        if (::fstat(fd, &file_stat) != 0 || file_stat.st_size < static_cast<off_t>(sizeof(ProgressChannelLayout))) {
+            ::close(fd);
+            return Result<void>(ErrorCode::SYSTEM_CONFIGURATION_ERROR,
+                               "Progress channel is too small: " + path);
+        }
+    }
+
+    // Readers map read-only; loads of lock-free atomics do not write to memory
+    int protection = writable ? (PROT_READ | PROT_WRITE) : PROT_READ;
+    void* mapping = ::mmap(nullptr, sizeof(ProgressChannelLayout), protection, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        return Result<void>(ErrorCode::SYSTEM_MEMORY_ALLOCATION_FAILED,
+                           "Cannot map progress channel " + path + ": " + std::strerror(errno));
+    }
+
+    layout_ = static_cast<ProgressChannelLayout*>(mapping);
+    writable_ = writable;
+    path_ = path;
+    return Result<void>();
+}
+
+void ProgressChannel::close() {
+    if (layout_) {
+        ::munmap(layout_, sizeof(ProgressChannelLayout));
+        layout_ = nullptr;
+    }
+    writable_ = false;
+}
+
+void ProgressChannel::beginWrite() {
+    uint64_t sequence = layout_->sequence.load(std::memory_order_relaxed);
+    layout_->sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+}
+
+void ProgressChannel::endWrite() {
+    uint64_t sequence = layout_->sequence.load(std::memory_order_relaxed);
+    layout_->sequence.store(sequence + 1, std::memory_order_release);
+}
+
+void ProgressChannel::publish(uint64_t day_index, uint64_t total_days, const std::string& date,
+                              double equity, int64_t trades, ProgressState state) {
+    if (!layout_ || !writable_) {
+        return;
+    }
+
+    uint64_t equity_bits;
+    std::memcpy(&equity_bits, &equity, sizeof(equity_bits));
+
+    uint64_t date_words[ProgressChannelLayout::DATE_SIZE / sizeof(uint64_t)] = {};
+    std::memcpy(date_words, date.data(), std::min(date.size(), ProgressChannelLayout::DATE_SIZE - 1));
+
+    beginWrite();
+    layout_->day_index.store(day_index, std::memory_order_relaxed);
+    layout_->total_days.store(total_days, std::memory_order_relaxed);
+    layout_->equity_bits.store(equity_bits, std::memory_order_relaxed);
+    layout_->trades.store(trades, std::memory_order_relaxed);
+    layout_->state.store(static_cast<uint32_t>(state), std::memory_order_relaxed);
+    for (size_t i = 0; i < ProgressChannelLayout::DATE_SIZE / sizeof(uint64_t); ++i) {
+        layout_->date_words[i].store(date_words[i], std::memory_order_relaxed);
+    }
+    endWrite();
+}
+
+void ProgressChannel::setState(ProgressState state) {
+    if (!layout_ || !writable_) {
+        return;
+    }
+
+    beginWrite();
+    layout_->state.store(static_cast<uint32_t>(state), std::memory_order_relaxed);
+    endWrite();
+}
+
+Result<ProgressSnapshot> ProgressChannel::read() const {
+    if (!layout_) {
+        return Result<ProgressSnapshot>(ErrorCode::SYSTEM_CONFIGURATION_ERROR, "Progress channel is not open");
+    }
+
+    for (int attempt = 0; attempt < MAX_READ_ATTEMPTS; ++attempt) {
+        uint64_t before = layout_->sequence.load(std::memory_order_acquire);
+        if (before & 1) {
+            std::this_thread::yield();
+            continue;
+        }
+
+        ProgressSnapshot snapshot;
+        snapshot.day_index = layout_->day_index.load(std::memory_order_relaxed);
+        snapshot.total_days = layout_->total_days.load(std::memory_order_relaxed);
+        uint64_t equity_bits = layout_->equity_bits.load(std::memory_order_relaxed);
+        snapshot.trades = layout_->trades.load(std::memory_order_relaxed);
+        snapshot.state = static_cast<ProgressState>(layout_->state.load(std::memory_order_relaxed));
+        uint64_t date_words[ProgressChannelLayout::DATE_SIZE / sizeof(uint64_t)];
+        for (size_t i = 0; i < ProgressChannelLayout::DATE_SIZE / sizeof(uint64_t); ++i) {
+            date_words[i] = layout_->date_words[i].load(std::memory_order_relaxed);
+        }
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        uint64_t after = layout_->sequence.load(std::memory_order_relaxed);
+        if (before != after) {
+            continue;
+        }
+
+        std::memcpy(&snapshot.equity, &equity_bits, sizeof(snapshot.equity));
+        const char* date_chars = reinterpret_cast<const char*>(date_words);
+        snapshot.date.assign(date_chars, strnlen(date_chars, ProgressChannelLayout::DATE_SIZE));
+        snapshot.sequence = after;
+        return Result<ProgressSnapshot>(snapshot);
+    }
+
+    return Result<ProgressSnapshot>(ErrorCode::SYSTEM_UNEXPECTED_ERROR,
+                                    "Progress channel did not settle after " + std::to_string(MAX_READ_ATTEMPTS) + " attempts");
+}
@@ -23,6 +23,19 @@ Result<void> ProgressService::setProgressInterval(int interval) {
     return Result<void>();
 }
 
+Result<void> ProgressService::openProgressChannel(const std::string& path) {
+    return progress_channel_.openForWriting(path);
+}
+
+void ProgressService::closeProgressChannel() {
+    progress_channel_.close();
+}
+
+void ProgressService::publishProgress(size_t current_step, size_t total_steps, const std::string& date,
+                                      double portfolio_value, int total_trades) {
+    progress_channel_.publish(current_step, total_steps, date, portfolio_value, total_trades);
+}
+
 Result<void> ProgressService::reportProgress(size_t current_step, 
                                            size_t total_steps, 
                                            const PriceData& data_point, 
@@ -50,7 +63,8 @@ Result<void> ProgressService::reportProgress(size_t current_step,
                            "Data point date cannot be empty for progress reporting");
     }
     
-    if (!enable_progress_reporting_ || !shouldReportProgress(current_step, total_steps)) {
+    // The shared-memory channel carries progress when open
+    if (!enable_progress_reporting_ || progress_channel_.isOpen() || !shouldReportProgress(current_step, total_steps)) {
         return Result<void>(); // Success but no action needed
     }
     
@@ -154,12 +168,17 @@ Result<void> ProgressService::reportSimulationEnd(const std::string& symbol,
 
 void ProgressService::reportError(const std::string& error_message) {
     Logger::error("ProgressService: ", error_message);
+    progress_channel_.setState(ProgressState::FAILED);
     
     if (progress_callback_) {
         progress_callback_("Error: " + error_message);
     }
 }
 
+void ProgressService::reportCompletion(bool truncated) {
+    progress_channel_.setState(truncated ? ProgressState::TRUNCATED : ProgressState::FINISHED);
+}
+
 double ProgressService::calculateProgressPercentage(size_t current, size_t total) const {
     if (total == 0) {
         return 0.0;
@@ -0,0 +1,408 @@
+// Python.h must be included before any standard header
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+
+#include <algorithm>
+#include <exception>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "argument_parser.h"
+#include "cancellation_token.h"
+#include "logger.h"
+#include "trading_engine.h"
+
+/**
+ * In-process CPython binding for the engine (module trading_engine_native).
+ *
+ *   result = trading_engine_native.run_backtest(config, progress=None)
+ *
+ * config is a dict (or JSON string) with the same keys as the
+ * `--simulate --config` file. The simulation runs with the GIL released.
+ * The returned dict matches the CLI JSON, except that "equity_curve" is an
+ * EquityCurve object exposing the portfolio values through the buffer
+ * protocol (numpy.asarray() wraps it without copying) and the matching dates
+ * are in "equity_dates". progress, if given, is called with each progress
+ * message as a dict; if it raises, the run is cancelled and the exception
+ * propagates.
+ */
+
+namespace {
+
+PyObject* engine_error = nullptr;
+PyObject* json_dumps = nullptr;
+
+// EquityCurve: read-only 1-D float64 buffer owning the engine's vector
+
+struct EquityCurveObject {
+    PyObject_HEAD
+    std::vector<double>* values;
+    Py_ssize_t shape[1];
+    Py_ssize_t strides[1];
+};
+
+void equityCurveDealloc(PyObject* self) {
+    auto* curve = reinterpret_cast<EquityCurveObject*>(self);
+    delete curve->values;
+    // Instances of a heap type hold a reference to it
+    PyTypeObject* type = Py_TYPE(self);
+    PyObject_Free(self);
+    Py_DECREF(type);
+}
+
+int equityCurveGetBuffer(PyObject* self, Py_buffer* view, int flags) {
+    auto* curve = reinterpret_cast<EquityCurveObject*>(self);
+    if ((flags & PyBUF_WRITABLE) == PyBUF_WRITABLE) {
+        PyErr_SetString(PyExc_BufferError, "EquityCurve is read-only");
+        view->obj = nullptr;
+        return -1;
+    }
+
+    view->obj = self;
+    Py_INCREF(self);
+    view->buf = curve->values->data();
+    view->len = curve->shape[0] * static_cast<Py_ssize_t>(sizeof(double));
+    view->itemsize = sizeof(double);
+    view->readonly = 1;
+    view->ndim = 1;
+    view->format = (flags & PyBUF_FORMAT) ? const_cast<char*>("d") : nullptr;
+    view->shape = (flags & PyBUF_ND) ? curve->shape : nullptr;
+    view->strides = ((flags & PyBUF_STRIDES) == PyBUF_STRIDES) ? curve->strides : nullptr;
+    view->suboffsets = nullptr;
+    view->internal = nullptr;
+    return 0;
+}
+
+Py_ssize_t equityCurveLength(PyObject* self) {
+    return reinterpret_cast<EquityCurveObject*>(self)->shape[0];
+}
+
+PyObject* equityCurveItem(PyObject* self, Py_ssize_t index) {
+    auto* curve = reinterpret_cast<EquityCurveObject*>(self);
+    if (index < 0 || index >= curve->shape[0]) {
+        PyErr_SetString(PyExc_IndexError, "EquityCurve index out of range");
+        return nullptr;
+    }
+    return PyFloat_FromDouble((*curve->values)[static_cast<size_t>(index)]);
+}
+
+PyType_Slot equity_curve_slots[] = {
+    {Py_tp_dealloc, reinterpret_cast<void*>(equityCurveDealloc)},
+    {Py_bf_getbuffer, reinterpret_cast<void*>(equityCurveGetBuffer)},
+    {Py_sq_length, reinterpret_cast<void*>(equityCurveLength)},
+    {Py_sq_item, reinterpret_cast<void*>(equityCurveItem)},
+    {Py_tp_doc, const_cast<char*>("Read-only float64 equity curve supporting the buffer protocol.")},
+    {0, nullptr}
+};
+
+PyType_Spec equity_curve_spec = {
+    "trading_engine_native.EquityCurve",
+    static_cast<int>(sizeof(EquityCurveObject)),
+    0,
+    Py_TPFLAGS_DEFAULT,
+    equity_curve_slots
+};
+
+// Heap type created from equity_curve_spec at module init
+PyTypeObject* equity_curve_type = nullptr;
+
+PyObject* makeEquityCurve(std::vector<double>&& values) {
+    auto* curve = PyObject_New(EquityCurveObject, equity_curve_type);
+    if (!curve) {
+        return nullptr;
+    }
+    curve->values = new std::vector<double>(std::move(values));
+    curve->shape[0] = static_cast<Py_ssize_t>(curve->values->size());
+    curve->strides[0] = sizeof(double);
+    return reinterpret_cast<PyObject*>(curve);
+}
+
+// JSON -> Python objects without a text round trip
+
+PyObject* toPython(const nlohmann::json& value) {
+    switch (value.type()) {
+        case nlohmann::json::value_t::null:
+            Py_RETURN_NONE;
+        case nlohmann::json::value_t::boolean:
+            return PyBool_FromLong(value.get<bool>());
+        case nlohmann::json::value_t::number_integer:
+            return PyLong_FromLongLong(value.get<long long>());
+        case nlohmann::json::value_t::number_unsigned:
+            return PyLong_FromUnsignedLongLong(value.get<unsigned long long>());
+        case nlohmann::json::value_t::number_float:
+            return PyFloat_FromDouble(value.get<double>());
+        case nlohmann::json::value_t::string: {
+            const auto& text = value.get_ref<const std::string&>();
+            return PyUnicode_FromStringAndSize(text.data(), static_cast<Py_ssize_t>(text.size()));
+        }
+        case nlohmann::json::value_t::array: {
+            PyObject* list = PyList_New(static_cast<Py_ssize_t>(value.size()));
+            if (!list) return nullptr;
+            Py_ssize_t index = 0;
+            for (const auto& element : value) {
+                PyObject* item = toPython(element);
+                if (!item) {
+                    Py_DECREF(list);
+                    return nullptr;
+                }
+                PyList_SET_ITEM(list, index++, item);
+            }
+            return list;
+        }
+        case nlohmann::json::value_t::object: {
+            PyObject* dict = PyDict_New();
+            if (!dict) return nullptr;
+            for (const auto& entry : value.items()) {
+                PyObject* item = toPython(entry.value());
+                if (!item || PyDict_SetItemString(dict, entry.key().c_str(), item) != 0) {
+                    Py_XDECREF(item);
+                    Py_DECREF(dict);
+                    return nullptr;
+                }
+                Py_DECREF(item);
+            }
+            return dict;
+        }
+        default:
+            Py_RETURN_NONE;
+    }
+}
+
+// Progress messages arrive on the simulation thread without the GIL
+struct ProgressForwarder {
+    PyObject* callback = nullptr;
+    CancellationToken* cancellation = nullptr;
+    PyObject* error_type = nullptr;
+    PyObject* error_value = nullptr;
+    PyObject* error_traceback = nullptr;
+
+    void operator()(const std::string& message) {
+        PyGILState_STATE gil = PyGILState_Ensure();
+        if (!error_type) {
+            auto parsed = nlohmann::json::parse(message, nullptr, false);
+            PyObject* argument = parsed.is_discarded()
+                ? PyUnicode_FromStringAndSize(message.data(), static_cast<Py_ssize_t>(message.size()))
+                : toPython(parsed);
+            PyObject* returned = argument ? PyObject_CallFunctionObjArgs(callback, argument, nullptr) : nullptr;
+            Py_XDECREF(argument);
+            if (returned) {
+                Py_DECREF(returned);
+            } else {
+                // Keep the first exception and stop the run at the next poll
+                PyErr_Fetch(&error_type, &error_value, &error_traceback);
+                cancellation->cancel();
+            }
+        }
+        PyGILState_Release(gil);
+    }
+};
+
+struct NativeRunOutcome {
+    bool ok = false;
+    std::string error_code;
+    std::string error_message;
+    nlohmann::json result;
+    std::vector<double> equity_curve;
+};
+
+// Runs without the GIL: everything here is plain C++
+NativeRunOutcome runNative(const TradingConfig& config, ProgressForwarder* forwarder) {
+    NativeRunOutcome outcome;
+    try {
+        TradingEngine engine(config.starting_capital);
+        auto strategy = engine.getStrategyManager()->createStrategyFromConfig(config);
+        if (strategy.isError()) {
+            outcome.error_code = errorCodeToString(strategy.getErrorCode());
+            outcome.error_message = strategy.getErrorMessage();
+            return outcome;
+        }
+        engine.getStrategyManager()->setCurrentStrategy(std::move(strategy.getValue()));
+
+        auto* orchestrator = engine.getTradingOrchestrator();
+        if (forwarder) {
+            forwarder->cancellation = &orchestrator->getCancellationToken();
+            engine.getProgressService()->setProgressCallback([forwarder](const std::string& message) {
+                (*forwarder)(message);
+            });
+        }
+
+        auto backtest = orchestrator->runBacktest(config, engine.getPortfolio(), engine.getMarketData(),
+                                                  engine.getExecutionService(), engine.getProgressService(),
+                                                  engine.getPortfolioAllocator(), engine.getDataProcessor(),
+                                                  engine.getStrategyManager(), engine.getResultCalculator());
+        if (backtest.isError()) {
+            outcome.error_code = errorCodeToString(backtest.getErrorCode());
+            outcome.error_message = backtest.getErrorMessage();
+            return outcome;
+        }
+
+        auto json_result = orchestrator->getBacktestResultsAsJson(backtest.getValue(), engine.getMarketData());
+        if (json_result.isError()) {
+            outcome.error_code = errorCodeToString(json_result.getErrorCode());
+            outcome.error_message = json_result.getErrorMessage();
+            return outcome;
+        }
+
+        outcome.result = std::move(json_result.getValue());
+        outcome.equity_curve = std::move(backtest.getValue().equity_curve);
+        outcome.ok = true;
+    } catch (const std::exception& e) {
+        outcome.error_code = errorCodeToString(ErrorCode::SYSTEM_UNEXPECTED_ERROR);
+        outcome.error_message = e.what();
+    }
+    return outcome;
+}
+
+PyObject* runBacktest(PyObject*, PyObject* args, PyObject* kwargs) {
+    static const char* keywords[] = {"config", "progress", nullptr};
+    PyObject* config_object = nullptr;
+    PyObject* progress = Py_None;
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O|O:run_backtest", const_cast<char**>(keywords),
+                                     &config_object, &progress)) {
+        return nullptr;
+    }
+    if (progress != Py_None && !PyCallable_Check(progress)) {
+        PyErr_SetString(PyExc_TypeError, "progress must be callable or None");
+        return nullptr;
+    }
+
+    // Accept a JSON string or anything json.dumps() understands
+    PyObject* config_text = PyUnicode_Check(config_object)
+        ? (Py_INCREF(config_object), config_object)
+        : PyObject_CallFunctionObjArgs(json_dumps, config_object, nullptr);
+    if (!config_text) {
+        return nullptr;
+    }
+    Py_ssize_t text_size = 0;
+    const char* text = PyUnicode_AsUTF8AndSize(config_text, &text_size);
+    if (!text) {
+        Py_DECREF(config_text);
+        return nullptr;
+    }
+
+    TradingConfig config;
+    try {
+        auto parsed = nlohmann::json::parse(text, text + text_size);
+        Py_DECREF(config_text);
+        if (!parsed.is_object()) {
+            PyErr_SetString(PyExc_TypeError, "config must be a JSON object");
+            return nullptr;
+        }
+        config = ArgumentParser().parseConfigJson(parsed);
+    } catch (const std::exception& e) {
+        Py_XDECREF(config_text);
+        PyErr_Format(PyExc_ValueError, "Invalid config: %s", e.what());
+        return nullptr;
+    }
+
+    ProgressForwarder forwarder;
+    forwarder.callback = progress;
+
+    NativeRunOutcome outcome;
+    Py_BEGIN_ALLOW_THREADS
+    outcome = runNative(config, progress != Py_None ? &forwarder : nullptr);
+    Py_END_ALLOW_THREADS
+
+    if (forwarder.error_type) {
+        PyErr_Restore(forwarder.error_type, forwarder.error_value, forwarder.error_traceback);
+        return nullptr;
+    }
+    if (!outcome.ok) {
+        PyObject* error_args = Py_BuildValue("(ss)", outcome.error_message.c_str(), outcome.error_code.c_str());
+        if (error_args) {
+            PyErr_SetObject(engine_error, error_args);
+            Py_DECREF(error_args);
+        }
+        return nullptr;
+    }
+
+    // Dates stay with the dated JSON points; values move into the zero-copy buffer
+    PyObject* dates = PyList_New(0);
+    if (!dates) {
+        return nullptr;
+    }
+    auto equity_points = outcome.result.find("equity_curve");
+    if (equity_points != outcome.result.end() && equity_points->is_array()) {
+        for (const auto& point : *equity_points) {
+            PyObject* date = toPython(point.value("date", ""));
+            if (!date || PyList_Append(dates, date) != 0) {
+                Py_XDECREF(date);
+                Py_DECREF(dates);
+                return nullptr;
+            }
+            Py_DECREF(date);
+        }
+        outcome.result.erase(equity_points);
+        outcome.equity_curve.resize(std::min(outcome.equity_curve.size(), static_cast<size_t>(PyList_GET_SIZE(dates))));
+    }
+
+    PyObject* result = toPython(outcome.result);
+    PyObject* equity_curve = result ? makeEquityCurve(std::move(outcome.equity_curve)) : nullptr;
+    if (!equity_curve ||
+        PyDict_SetItemString(result, "equity_curve", equity_curve) != 0 ||
+        PyDict_SetItemString(result, "equity_dates", dates) != 0) {
+        Py_XDECREF(equity_curve);
+        Py_XDECREF(result);
+        Py_DECREF(dates);
+        return nullptr;
+    }
+    Py_DECREF(equity_curve);
+    Py_DECREF(dates);
+    return result;
+}
+
+PyMethodDef module_methods[] = {
+    {"run_backtest", reinterpret_cast<PyCFunction>(reinterpret_cast<void (*)(void)>(runBacktest)),
+     METH_VARARGS | METH_KEYWORDS,
+     "run_backtest(config, progress=None) -> dict\n\n"
+     "Run a simulation in-process with the GIL released. config uses the --config file keys."},
+    {nullptr, nullptr, 0, nullptr}
+};
+
+PyModuleDef engine_module = {
+    PyModuleDef_HEAD_INIT,
+    "trading_engine_native",
+    "In-process bindings for the C++ trading engine.",
+    -1,
+    module_methods,
+    nullptr, nullptr, nullptr, nullptr
+};
+
+}  // namespace
+
+PyMODINIT_FUNC PyInit_trading_engine_native(void) {
+    equity_curve_type = reinterpret_cast<PyTypeObject*>(PyType_FromSpec(&equity_curve_spec));
+    if (!equity_curve_type) {
+        return nullptr;
+    }
+
+    PyObject* module = PyModule_Create(&engine_module);
+    if (!module) {
+        return nullptr;
+    }
+
+    PyObject* json_module = PyImport_ImportModule("json");
+    json_dumps = json_module ? PyObject_GetAttrString(json_module, "dumps") : nullptr;
+    Py_XDECREF(json_module);
+    engine_error = PyErr_NewException("trading_engine_native.EngineError", PyExc_RuntimeError, nullptr);
+    if (!json_dumps || !engine_error) {
+        Py_DECREF(module);
+        return nullptr;
+    }
+
+    Py_INCREF(engine_error);
+    Py_INCREF(equity_curve_type);
+    if (PyModule_AddObject(module, "EngineError", engine_error) < 0 ||
+        PyModule_AddObject(module, "EquityCurve", reinterpret_cast<PyObject*>(equity_curve_type)) < 0) {
+        Py_DECREF(module);
+        return nullptr;
+    }
+
+    // The host process owns stderr; keep engine chatter to warnings and errors
+    Logger::setLevel(LogLevel::WARNING);
+    return module;
+}
@@ -0,0 +1,326 @@
+#include <cstdio>
+#include <cstring>
+
+#include "logger.h"
+#include "query_cursor.h"
+
+namespace {
+// Rows per network chunk when libpq supports chunked mode (PostgreSQL 17+)
+constexpr int CHUNK_ROWS = 1024;
+
+// PostgreSQL epochs are 2000-01-01
+constexpr int32_t POSTGRES_EPOCH_DAYS = 10957;
+constexpr int64_t POSTGRES_EPOCH_MICROS = 946684800000000LL;
+constexpr int64_t MICROS_PER_DAY = 86400000000LL;
+constexpr int64_t MICROS_PER_SECOND = 1000000LL;
+
+uint64_t readBigEndian(const char* value, int bytes) {
+    const auto* data = reinterpret_cast<const unsigned char*>(value);
+    uint64_t result = 0;
+    for (int i = 0; i < bytes; ++i) {
+        result = (result << 8) | data[i];
+    }
+    return result;
+}
+
+int64_t floorDivide(int64_t value, int64_t divisor) {
+    int64_t quotient = value / divisor;
+    return (value % divisor != 0 && (value < 0) != (divisor < 0)) ? quotient - 1 : quotient;
+}
+}
+
+namespace PgBinary {
+
+bool isCompatible(Oid type, QueryValueKind kind) {
+    switch (kind) {
+        case QueryValueKind::BOOL:
+            return type == BOOL_OID;
+        case QueryValueKind::INT64:
+            return type == INT2_OID || type == INT4_OID || type == INT8_OID;
+        case QueryValueKind::DOUBLE:
+            return type == FLOAT4_OID || type == FLOAT8_OID || isCompatible(type, QueryValueKind::INT64);
+        case QueryValueKind::DATE:
+            return type == DATE_OID || type == TIMESTAMP_OID || type == TIMESTAMPTZ_OID;
+        case QueryValueKind::TEXT:
+            return type == TEXT_OID || type == VARCHAR_OID || type == BPCHAR_OID || type == NAME_OID;
+    }
+    return false;
+}
+
+int64_t decodeInt64(Oid type, const char* value) {
+    switch (type) {
+        case INT2_OID: return static_cast<int16_t>(readBigEndian(value, 2));
+        case INT4_OID: return static_cast<int32_t>(readBigEndian(value, 4));
+        default:       return static_cast<int64_t>(readBigEndian(value, 8));
+    }
+}
+
+double decodeDouble(Oid type, const char* value) {
+    if (type == FLOAT8_OID) {
+        uint64_t bits = readBigEndian(value, 8);
+        double result;
+        std::memcpy(&result, &bits, sizeof(result));
+        return result;
+    }
+    if (type == FLOAT4_OID) {
+        uint32_t bits = static_cast<uint32_t>(readBigEndian(value, 4));
+        float result;
+        std::memcpy(&result, &bits, sizeof(result));
+        return result;
+    }
+    return static_cast<double>(decodeInt64(type, value));
+}
+
+int32_t decodeDate(Oid type, const char* value) {
+    if (type == DATE_OID) {
+        return static_cast<int32_t>(readBigEndian(value, 4)) + POSTGRES_EPOCH_DAYS;
+    }
+    return static_cast<int32_t>(floorDivide(decodeTimestamp(type, value), MICROS_PER_DAY));
+}
+
+int64_t decodeTimestamp(Oid type, const char* value) {
+    if (type == DATE_OID) {
+        return static_cast<int64_t>(decodeDate(type, value)) * MICROS_PER_DAY;
+    }
+    return static_cast<int64_t>(readBigEndian(value, 8)) + POSTGRES_EPOCH_MICROS;
+}
+
+std::string formatDate(int32_t days_since_epoch) {
+    // Civil date from day count (proleptic Gregorian calendar)
+    int64_t z = static_cast<int64_t>(days_since_epoch) + 719468;
+    int64_t era = floorDivide(z, 146097);
+    int64_t day_of_era = z - era * 146097;
+    int64_t year_of_era = (day_of_era - day_of_era / 1460 + day_of_era / 36524 - day_of_era / 146096) / 365;
+    int64_t day_of_year = day_of_era - (365 * year_of_era + year_of_era / 4 - year_of_era / 100);
+    int64_t month_index = (5 * day_of_year + 2) / 153;
+    int day = static_cast<int>(day_of_year - (153 * month_index + 2) / 5 + 1);
+    int month = static_cast<int>(month_index < 10 ? month_index + 3 : month_index - 9);
+    int64_t year = year_of_era + era * 400 + (month <= 2 ? 1 : 0);
+
+    char buffer[16];
+    std::snprintf(buffer, sizeof(buffer), "%04lld-%02d-%02d", static_cast<long long>(year), month, day);
+    return buffer;
+}
+
+std::string formatTimestamp(int64_t micros_since_epoch) {
+    int64_t days = floorDivide(micros_since_epoch, MICROS_PER_DAY);
+    int64_t seconds_of_day = (micros_since_epoch - days * MICROS_PER_DAY) / MICROS_PER_SECOND;
+
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%sT%02d:%02d:%02d+00:00", formatDate(static_cast<int32_t>(days)).c_str(),
+                  static_cast<int>(seconds_of_day / 3600), static_cast<int>(seconds_of_day / 60 % 60),
+                  static_cast<int>(seconds_of_day % 60));
+    return buffer;
+}
+
+}  // namespace PgBinary
+
+QueryCursor::QueryCursor(PGconn* connection) : connection_(connection) {}
+
+QueryCursor QueryCursor::fromResult(PGresult* result, QueryResultFormat format) {
+    QueryCursor cursor(nullptr);
+    cursor.current_ = result;
+    cursor.started_ = true;
+    cursor.finished_ = true;
+    cursor.format_ = format;
+    return cursor;
+}
+
+QueryCursor::~QueryCursor() {
+    cancel();
+    clearCurrent();
+}
+
+QueryCursor::QueryCursor(QueryCursor&& other) noexcept
+    : connection_(other.connection_), current_(other.current_), row_(other.row_), started_(other.started_),
+      finished_(other.finished_), format_(other.format_), rows_read_(other.rows_read_) {
+    other.current_ = nullptr;
+    other.started_ = false;
+    other.finished_ = true;
+}
+
+QueryCursor& QueryCursor::operator=(QueryCursor&& other) noexcept {
+    if (this != &other) {
+        cancel();
+        clearCurrent();
+        connection_ = other.connection_;
+        current_ = other.current_;
+        row_ = other.row_;
+        started_ = other.started_;
+        finished_ = other.finished_;
+        format_ = other.format_;
+        rows_read_ = other.rows_read_;
+        other.current_ = nullptr;
+        other.started_ = false;
+        other.finished_ = true;
+    }
+    return *this;
+}
+
+Result<void> QueryCursor::start(const std::string& query, const std::vector<std::string>& params,
+                                QueryResultFormat format) {
+    if (!connection_) {
+        return Result<void>(ErrorCode::DATABASE_CONNECTION_FAILED, "Query cursor has no database connection");
+    }
+
+    // A previous scan on this cursor must not leave results on the connection
+    cancel();
+    clearCurrent();
+
+    std::vector<const char*> param_values;
+    param_values.reserve(params.size());
+    for (const auto& param : params) {
+        param_values.push_back(param.c_str());
+    }
+
+    if (!PQsendQueryParams(connection_, query.c_str(), static_cast<int>(params.size()), nullptr,
+                           param_values.data(), nullptr, nullptr, static_cast<int>(format))) {
+        return Result<void>(ErrorCode::DATABASE_QUERY_FAILED,
+                           "Query dispatch failed: " + std::string(PQerrorMessage(connection_)));
+    }
+
+#ifdef LIBPQ_HAS_CHUNK_MODE
+    bool streaming = PQsetChunkedRowsMode(connection_, CHUNK_ROWS) == 1;
+#else
+    bool streaming = PQsetSingleRowMode(connection_) == 1;
+#endif
+    if (!streaming) {
+        // Still correct, just materialized in one result
+        Logger::debug("Row streaming unavailable; query result will be buffered");
+    }
+
+    format_ = format;
+    started_ = true;
+    finished_ = false;
+    row_ = -1;
+    rows_read_ = 0;
+    return Result<void>();
+}
+
+Result<bool> QueryCursor::next() {
+    if (!started_) {
+        return Result<bool>(ErrorCode::DATABASE_QUERY_FAILED, "Query cursor was not started");
+    }
+
+    while (true) {
+        if (current_ && row_ + 1 < PQntuples(current_)) {
+            ++row_;
+            ++rows_read_;
+            return Result<bool>(true);
+        }
+        if (finished_) {
+            return Result<bool>(false);
+        }
+
+        PGresult* result = PQgetResult(connection_);
+        if (!result) {
+            // Keep the last result so column metadata stays available
+            finished_ = true;
+            return Result<bool>(false);
+        }
+
+        ExecStatusType status = PQresultStatus(result);
+#ifdef LIBPQ_HAS_CHUNK_MODE
+        bool rows = status == PGRES_SINGLE_TUPLE || status == PGRES_TUPLES_CHUNK || status == PGRES_TUPLES_OK;
+#else
+        bool rows = status == PGRES_SINGLE_TUPLE || status == PGRES_TUPLES_OK;
+#endif
+        if (!rows && status != PGRES_COMMAND_OK) {
+            std::string error_msg = "Query execution failed: " + std::string(PQresultErrorMessage(result));
+            PQclear(result);
+            drain();
+            finished_ = true;
+            return Result<bool>(ErrorCode::DATABASE_QUERY_FAILED, error_msg);
+        }
+
+        clearCurrent();
+        current_ = result;
+        row_ = -1;
+    }
+}
+
+void QueryCursor::cancel() {
+    if (!started_ || finished_ || !connection_) {
+        return;
+    }
+
+    if (PGcancel* request = PQgetCancel(connection_)) {
+        char error_buffer[256];
+        PQcancel(request, error_buffer, sizeof(error_buffer));
+        PQfreeCancel(request);
+    }
+    drain();
+    finished_ = true;
+}
+
+void QueryCursor::drain() {
+    while (PGresult* result = PQgetResult(connection_)) {
+        PQclear(result);
+    }
+}
+
+void QueryCursor::clearCurrent() {
+    if (current_) {
+        PQclear(current_);
+        current_ = nullptr;
+    }
+}
+
+Result<QueryColumn> QueryCursor::column(const std::string& name, QueryValueKind kind) const {
+    if (!current_) {
+        return Result<QueryColumn>(ErrorCode::DATABASE_QUERY_FAILED, "Query cursor has no result metadata yet");
+    }
+
+    QueryColumn handle;
+    handle.index = PQfnumber(current_, name.c_str());
+    if (handle.index < 0) {
+        return Result<QueryColumn>(ErrorCode::DATA_PARSING_FAILED, "Query result has no column " + name);
+    }
+    handle.type = PQftype(current_, handle.index);
+
+    // Text-format results can only be read as text
+    bool compatible = format_ == QueryResultFormat::TEXT ? kind == QueryValueKind::TEXT
+                                                         : PgBinary::isCompatible(handle.type, kind);
+    if (!compatible) {
+        return Result<QueryColumn>(ErrorCode::DATA_PARSING_FAILED,
+                                   "Column " + name + " (type oid " + std::to_string(handle.type) +
+                                   ") cannot be read as the requested kind");
+    }
+    return Result<QueryColumn>(handle);
+}
+
+int QueryCursor::columnCount() const {
+    return current_ ? PQnfields(current_) : 0;
+}
+
+std::string QueryCursor::columnName(int index) const {
+    return current_ ? PQfname(current_, index) : "";
+}
+
+bool QueryCursor::isNull(const QueryColumn& column) const {
+    return PQgetisnull(current_, row_, column.index) == 1;
+}
+
+bool QueryCursor::getBool(const QueryColumn& column) const {
+    return value(column)[0] != 0;
+}
+
+int64_t QueryCursor::getInt64(const QueryColumn& column) const {
+    return PgBinary::decodeInt64(column.type, value(column));
+}
+
+double QueryCursor::getDouble(const QueryColumn& column) const {
+    return PgBinary::decodeDouble(column.type, value(column));
+}
+
+int32_t QueryCursor::getDate(const QueryColumn& column) const {
+    return PgBinary::decodeDate(column.type, value(column));
+}
+
+int64_t QueryCursor::getTimestamp(const QueryColumn& column) const {
+    return PgBinary::decodeTimestamp(column.type, value(column));
+}
+
+std::string_view QueryCursor::getText(const QueryColumn& column) const {
+    return std::string_view(value(column), static_cast<size_t>(PQgetlength(current_, row_, column.index)));
+}
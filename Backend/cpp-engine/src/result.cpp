@@ -67,6 +67,7 @@ std::string errorCodeToString(ErrorCode code) {
         {ErrorCode::ENGINE_MULTI_SYMBOL_FAILED, "ENGINE_MULTI_SYMBOL_FAILED"},
         {ErrorCode::ENGINE_PORTFOLIO_ACCESS_FAILED, "ENGINE_PORTFOLIO_ACCESS_FAILED"},
         {ErrorCode::ENGINE_RESULTS_GENERATION_FAILED, "ENGINE_RESULTS_GENERATION_FAILED"},
+        {ErrorCode::ENGINE_CANCELLED, "ENGINE_CANCELLED"},
         
         // System errors
         {ErrorCode::SYSTEM_MEMORY_ALLOCATION_FAILED, "SYSTEM_MEMORY_ALLOCATION_FAILED"},
@@ -7,27 +7,27 @@
 #include "result_calculator.h"
 
 void ResultCalculator::calculateTradeMetrics(BacktestResult& result) {
-    std::vector<double> buy_prices;
-    
-    for (const auto& signal : result.signals_generated) {
-        if (signal.signal == Signal::BUY) {
-            buy_prices.push_back(signal.price);
-        } else if (signal.signal == Signal::SELL && !buy_prices.empty()) {
-            double buy_price = buy_prices.back();
-            buy_prices.pop_back();
-            
-            if (signal.price > buy_price) {
-                result.winning_trades++;
-            } else {
-                result.losing_trades++;
-            }
-        }
+    TradeStatistics statistics;
+    for (const auto& trip : result.round_trips) {
+        statistics.addRoundTrip(trip);
     }
+    calculateTradeMetrics(result, statistics);
+}
+
+void ResultCalculator::calculateTradeMetrics(BacktestResult& result, const TradeStatistics& statistics) const {
+    result.winning_trades = statistics.winning_trades;
+    result.losing_trades = statistics.losing_trades;
 }
 
 void ResultCalculator::calculatePortfolioMetrics(BacktestResult& result, const Portfolio& portfolio) {
-    if (!result.equity_curve.empty()) {
-        result.ending_value = result.equity_curve.back();
+    StreamingMetrics replayed;
+    calculatePortfolioMetrics(result, portfolio, selectMetrics(result, replayed));
+}
+
+void ResultCalculator::calculatePortfolioMetrics(BacktestResult& result, const Portfolio& portfolio,
+                                                 const StreamingMetrics& metrics) const {
+    if (metrics.hasData()) {
+        result.ending_value = metrics.getLastValue();
         result.cash_remaining = portfolio.getCashBalance();
         result.total_return_pct = ((result.ending_value - result.starting_capital) / result.starting_capital) * 100.0;
         
@@ -40,53 +40,36 @@ void ResultCalculator::calculatePortfolioMetrics(BacktestResult& result, const P
         Logger::debug("Empty equity curve, using starting capital as ending value");
     }
     
-    auto daily_returns = calculateDailyReturns(result.equity_curve);
-    result.sharpe_ratio = calculateSharpeRatio(daily_returns);
-    result.max_drawdown = calculateMaxDrawdown(result.equity_curve);
+    result.sharpe_ratio = metrics.getSharpeRatio();
+    result.sortino_ratio = metrics.getSortinoRatio();
+    result.max_drawdown = metrics.getMaxDrawdownPct();
 }
 
 void ResultCalculator::calculatePerSymbolMetrics(BacktestResult& result, const Portfolio& portfolio) {
-    Logger::debug("Calculating per-symbol performance metrics for ", result.symbols.size(), " symbols");
-    
-    // Map to track trades per symbol
-    std::map<std::string, std::vector<double>> symbol_trade_returns;
-    std::map<std::string, double> symbol_buy_values;
-    std::map<std::string, double> symbol_sell_values;
-    
-    // Process all signals to calculate per-symbol metrics
-    for (const auto& signal : result.signals_generated) {
-        // TODO: TradingSignal needs symbol field, using date as placeholder
-        const std::string& symbol = signal.date;
-        auto& symbol_perf = result.symbol_performance[symbol];
-        
-        // Add signal to symbol-specific list
-        symbol_perf.symbol_signals.push_back(signal);
-        
-        if (signal.signal == Signal::BUY) {
-            symbol_buy_values[symbol] += signal.price;
-        } else if (signal.signal == Signal::SELL) {
-            symbol_sell_values[symbol] += signal.price;
-            
-            // Calculate trade return if we have a previous buy
-            if (symbol_buy_values[symbol] > 0) {
-                double trade_return = (signal.price - symbol_buy_values[symbol]) / symbol_buy_values[symbol];
-                symbol_trade_returns[symbol].push_back(trade_return);
-                
-                if (trade_return > 0) {
-                    symbol_perf.winning_trades++;
-                } else {
-                    symbol_perf.losing_trades++;
-                }
-                symbol_perf.trades_count++;
-            }
-        }
+    std::map<std::string, TradeStatistics> symbol_statistics;
+    for (const auto& trip : result.round_trips) {
+        symbol_statistics[trip.symbol].addRoundTrip(trip);
     }
+    calculatePerSymbolMetrics(result, portfolio, symbol_statistics);
+}
+
+void ResultCalculator::calculatePerSymbolMetrics(BacktestResult& result, const Portfolio& portfolio,
+                                                 const std::map<std::string, TradeStatistics>& symbol_statistics) const {
+    Logger::debug("Calculating per-symbol performance metrics for ", result.symbols.size(), " symbols");
     
-    // Calculate final metrics for each symbol
     for (auto& [symbol, symbol_perf] : result.symbol_performance) {
-        // Calculate win rate for this symbol
-        if (symbol_perf.trades_count > 0) {
-            symbol_perf.win_rate = (static_cast<double>(symbol_perf.winning_trades) / symbol_perf.trades_count) * 100.0;
+        // Win rate and return over this symbol's closed round trips
+        auto stats_it = symbol_statistics.find(symbol);
+        if (stats_it != symbol_statistics.end()) {
+            const auto& statistics = stats_it->second;
+            symbol_perf.winning_trades = statistics.winning_trades;
+            symbol_perf.losing_trades = statistics.losing_trades;
+            if (statistics.closedTrades() > 0) {
+                symbol_perf.win_rate = (static_cast<double>(statistics.winning_trades) / statistics.closedTrades()) * 100.0;
+            }
+            if (statistics.cost_basis > 0) {
+                symbol_perf.total_return_pct = (statistics.netProfit() / statistics.cost_basis) * 100.0;
+            }
         }
         
         // Calculate allocation percentage
@@ -96,33 +79,34 @@ void ResultCalculator::calculatePerSymbolMetrics(BacktestResult& result, const P
             symbol_perf.symbol_allocation_pct = (symbol_perf.final_position_value / result.ending_value) * 100.0;
         }
         
-        // Calculate symbol return if we have trade data
-        if (!symbol_trade_returns[symbol].empty()) {
-            double total_return = 0.0;
-            for (double ret : symbol_trade_returns[symbol]) {
-                total_return += ret;
-            }
-            symbol_perf.total_return_pct = (total_return / symbol_trade_returns[symbol].size()) * 100.0;
-        }
-        
         Logger::debug("Symbol ", symbol, " metrics: trades=", symbol_perf.trades_count, 
                      ", win_rate=", symbol_perf.win_rate, "%, allocation=", symbol_perf.symbol_allocation_pct, "%");
     }
 }
 
 void ResultCalculator::calculateComprehensiveMetrics(BacktestResult& result) {
+    StreamingMetrics replayed;
+    TradeStatistics statistics;
+    for (const auto& trip : result.round_trips) {
+        statistics.addRoundTrip(trip);
+    }
+    calculateComprehensiveMetrics(result, selectMetrics(result, replayed), statistics);
+}
+
+void ResultCalculator::calculateComprehensiveMetrics(BacktestResult& result, const StreamingMetrics& metrics,
+                                                     const TradeStatistics& statistics) const {
     // Calculate signals generated count
     result.signals_generated_count = result.signals_generated.size();
     
     // Calculate annualized return
-    calculateAnnualizedReturn(result);
+    calculateAnnualizedReturn(result, metrics);
     
     // Calculate volatility
-    calculateVolatility(result);
+    calculateVolatility(result, metrics);
     
-    // Calculate profit factor and win/loss metrics
-    calculateProfitFactor(result);
-    calculateWinLossMetrics(result);
+    // Calculate profit factor and win/loss metrics from closed round trips
+    calculateProfitFactor(result, statistics);
+    calculateWinLossMetrics(result, statistics);
     
     Logger::debug("Metrics calculated: annualized_return=", result.annualized_return, 
                  "%, volatility=", result.volatility, "%, profit_factor=", result.profit_factor);
@@ -212,35 +196,28 @@ std::vector<double> ResultCalculator::calculateDailyReturns(const std::vector<do
 
 PerformanceMetrics ResultCalculator::calculateMetrics(const std::vector<TradingSignal>& trades, double initialCapital) const {
     PerformanceMetrics metrics;
-    
-    // Calculate basic metrics from trades
     metrics.total_trades = trades.size();
     
-    // Calculate win rate and returns
-    int winning_trades = 0;
-    double total_profit = 0.0;
-    double total_loss = 0.0;
-    
+    // Signals carry no share count, so each fill is matched as a single share
+    TradeLedger ledger;
     for (const auto& trade : trades) {
-        if (trade.signal == Signal::SELL) {
-            // TODO: Simplified calculation - would need buy/sell pairs in real implementation
-            double profit = trade.price - initialCapital / trades.size();
-            if (profit > 0) {
-                winning_trades++;
-                total_profit += profit;
-            } else {
-                total_loss += std::abs(profit);
-            }
+        if (trade.signal == Signal::BUY) {
+            ledger.recordBuy(trade.symbol, 1, trade.price, trade.date);
+        } else if (trade.signal == Signal::SELL) {
+            ledger.recordSell(trade.symbol, 1, trade.price, trade.date);
         }
     }
     
-    metrics.win_rate = (metrics.total_trades > 0) ? 
-        (static_cast<double>(winning_trades) / metrics.total_trades) * 100.0 : 0.0;
+    const auto& statistics = ledger.getStatistics();
+    int closed_trades = statistics.closedTrades();
     
-    metrics.profit_factor = (total_loss > 0) ? total_profit / total_loss : 0.0;
-    metrics.average_win = (winning_trades > 0) ? total_profit / winning_trades : 0.0;
-    metrics.average_loss = (metrics.total_trades - winning_trades > 0) ? 
-        total_loss / (metrics.total_trades - winning_trades) : 0.0;
+    metrics.win_rate = closed_trades > 0 ?
+        (static_cast<double>(statistics.winning_trades) / closed_trades) * 100.0 : 0.0;
+    metrics.profit_factor = statistics.gross_loss > 0 ? statistics.gross_profit / statistics.gross_loss : 0.0;
+    metrics.average_win = statistics.winning_trades > 0 ? statistics.gross_profit / statistics.winning_trades : 0.0;
+    metrics.average_loss = statistics.losing_trades > 0 ? statistics.gross_loss / statistics.losing_trades : 0.0;
+    metrics.final_balance = initialCapital + statistics.netProfit();
+    metrics.total_return_pct = initialCapital > 0 ? (statistics.netProfit() / initialCapital) * 100.0 : 0.0;
     
     return metrics;
 }
@@ -277,36 +254,133 @@ RiskMetrics ResultCalculator::calculateRiskMetrics(const std::vector<double>& re
     return risk_metrics;
 }
 
-void ResultCalculator::finalizeResults(BacktestResult& result, const Portfolio& portfolio) {
+void ResultCalculator::configureRollingMetrics(const std::vector<int>& windows, bool underwater_curve) {
+    rolling_metrics_.configure(windows, underwater_curve);
+}
+
+void ResultCalculator::beginStreaming(double starting_capital) {
+    streaming_metrics_.reset(starting_capital);
+    rolling_metrics_.reset(starting_capital);
+    first_day_ = TradingCalendar::NO_DAY;
+    last_day_ = TradingCalendar::NO_DAY;
+}
+
+void ResultCalculator::recordEquity(double portfolio_value) {
+    streaming_metrics_.update(portfolio_value);
+    rolling_metrics_.update(portfolio_value);
+}
+
+void ResultCalculator::recordEquity(double portfolio_value, int32_t day) {
+    recordEquity(portfolio_value);
+    if (first_day_ == TradingCalendar::NO_DAY) {
+        first_day_ = day;
+    }
+    last_day_ = day;
+}
+
+void ResultCalculator::setTradingCalendar(std::shared_ptr<const TradingCalendar> calendar) {
+    calendar_ = std::move(calendar);
+}
+
+const StreamingMetrics& ResultCalculator::getStreamingMetrics() const {
+    return streaming_metrics_;
+}
+
+const RollingMetrics& ResultCalculator::getRollingMetrics() const {
+    return rolling_metrics_;
+}
+
+const StreamingMetrics& ResultCalculator::selectMetrics(const BacktestResult& result, StreamingMetrics& replayed) const {
+    // The loop accumulator is authoritative when the equity curve was not retained
+    // or when it covers the same observations as the retained curve
+    if (streaming_metrics_.hasData() &&
+        (result.equity_curve.empty() || result.equity_curve.size() == streaming_metrics_.getObservationCount())) {
+        return streaming_metrics_;
+    }
+    
+    replayed.clear();
+    for (double value : result.equity_curve) {
+        replayed.update(value);
+    }
+    return replayed;
+}
+
+void ResultCalculator::finalizeResults(BacktestResult& result, const Portfolio& portfolio, const TradeLedger* trade_ledger) {
+    StreamingMetrics replayed;
+    const StreamingMetrics& metrics = selectMetrics(result, replayed);
+    
+    // Trade statistics are maintained by the ledger as round trips close; scan only without one
+    TradeStatistics scanned_statistics;
+    std::map<std::string, TradeStatistics> scanned_symbol_statistics;
+    if (!trade_ledger) {
+        for (const auto& trip : result.round_trips) {
+            scanned_statistics.addRoundTrip(trip);
+            scanned_symbol_statistics[trip.symbol].addRoundTrip(trip);
+        }
+    }
+    const TradeStatistics& statistics = trade_ledger ? trade_ledger->getStatistics() : scanned_statistics;
+    const auto& symbol_statistics = trade_ledger ? trade_ledger->getSymbolStatistics() : scanned_symbol_statistics;
+    
     // Calculate portfolio performance metrics
-    calculatePortfolioMetrics(result, portfolio);
+    calculatePortfolioMetrics(result, portfolio, metrics);
     
     // Calculate trade performance metrics
-    calculateTradeMetrics(result);
+    calculateTradeMetrics(result, statistics);
     
     // Calculate per-symbol performance metrics
-    calculatePerSymbolMetrics(result, portfolio);
+    calculatePerSymbolMetrics(result, portfolio, symbol_statistics);
     
-    // Calculate overall win rate
-    result.win_rate = result.total_trades > 0 ? 
-        (static_cast<double>(result.winning_trades) / result.total_trades) * 100.0 : 0.0;
+    // Calculate overall win rate over closed round trips
+    result.win_rate = statistics.closedTrades() > 0 ? 
+        (static_cast<double>(statistics.winning_trades) / statistics.closedTrades()) * 100.0 : 0.0;
     
     // Calculate additional metrics
-    calculateComprehensiveMetrics(result);
+    calculateComprehensiveMetrics(result, metrics, statistics);
     
     // Calculate portfolio diversification ratio
     calculateDiversificationMetrics(result);
     
+    // Attach optional rolling risk series
+    calculateRollingMetrics(result, metrics);
+    
     Logger::debug("Finalized backtest results for ", result.symbols.size(), " symbols");
     Logger::debug("Total trades: ", result.total_trades, ", Win rate: ", result.win_rate, "%");
     Logger::debug("Total return: ", result.total_return_pct, "%, Sharpe ratio: ", result.sharpe_ratio);
 }
 
-void ResultCalculator::calculateAnnualizedReturn(BacktestResult& result) const {
+void ResultCalculator::calculateRollingMetrics(BacktestResult& result, const StreamingMetrics& metrics) {
+    if (!rolling_metrics_.isEnabled()) {
+        return;
+    }
+    
+    // Series streamed by the loop are used directly; otherwise replay the retained curve
+    if (&metrics == &streaming_metrics_ && rolling_metrics_.getObservationCount() == metrics.getObservationCount()) {
+        rolling_metrics_.moveInto(result);
+        return;
+    }
+    
+    if (result.equity_curve.empty()) {
+        return;
+    }
+    
+    rolling_metrics_.reset(result.equity_curve[0]);
+    for (size_t i = 1; i < result.equity_curve.size(); ++i) {
+        rolling_metrics_.update(result.equity_curve[i]);
+    }
+    rolling_metrics_.moveInto(result);
+}
+
+void ResultCalculator::calculateAnnualizedReturn(BacktestResult& result, const StreamingMetrics& metrics) const {
     if (!result.start_date.empty() && !result.end_date.empty()) {
-        // Simple approximation: assume 252 trading days per year
-        int trading_days = result.equity_curve.size();
-        double years = trading_days / 252.0;
+        double years = 0.0;
+        if (calendar_ && &metrics == &streaming_metrics_ && first_day_ != TradingCalendar::NO_DAY) {
+            // Sessions from the open of the first recorded session to the last one
+            years = calendar_->yearFraction(first_day_ - 1, last_day_);
+        } else {
+            // Simple approximation: assume 252 trading days per year
+            int trading_days = static_cast<int>(metrics.getObservationCount());
+            years = trading_days / 252.0;
+        }
         
         if (years > 0) {
             result.annualized_return = (std::pow((result.ending_value / result.starting_capital), (1.0 / years)) - 1.0) * 100.0;
@@ -314,54 +388,17 @@ void ResultCalculator::calculateAnnualizedReturn(BacktestResult& result) const {
     }
 }
 
-void ResultCalculator::calculateVolatility(BacktestResult& result) const {
-    auto daily_returns = calculateDailyReturns(result.equity_curve);
-    
-    if (!daily_returns.empty()) {
-        double mean_return = std::accumulate(daily_returns.begin(), daily_returns.end(), 0.0) / daily_returns.size();
-        double variance = 0.0;
-        
-        for (double ret : daily_returns) {
-            variance += (ret - mean_return) * (ret - mean_return);
-        }
-        variance /= daily_returns.size();
-        result.volatility = std::sqrt(variance) * std::sqrt(252) * 100.0; // Annualized volatility as percentage
+void ResultCalculator::calculateVolatility(BacktestResult& result, const StreamingMetrics& metrics) const {
+    if (metrics.getReturnCount() > 0) {
+        result.volatility = metrics.getAnnualizedVolatilityPct(); // Annualized volatility as percentage
     }
 }
 
-void ResultCalculator::calculateProfitFactor(BacktestResult& result) const {
-    double total_wins = 0.0;
-    double total_losses = 0.0;
-    
-    auto daily_returns = calculateDailyReturns(result.equity_curve);
-    for (double daily_return : daily_returns) {
-        if (daily_return > 0) {
-            total_wins += daily_return;
-        } else if (daily_return < 0) {
-            total_losses += std::abs(daily_return);
-        }
-    }
-    
-    result.profit_factor = total_losses > 0 ? total_wins / total_losses : 0.0;
+void ResultCalculator::calculateProfitFactor(BacktestResult& result, const TradeStatistics& statistics) const {
+    result.profit_factor = statistics.gross_loss > 0 ? statistics.gross_profit / statistics.gross_loss : 0.0;
 }
 
-void ResultCalculator::calculateWinLossMetrics(BacktestResult& result) const {
-    double total_wins = 0.0;
-    double total_losses = 0.0;
-    int win_count = 0;
-    int loss_count = 0;
-    
-    auto daily_returns = calculateDailyReturns(result.equity_curve);
-    for (double daily_return : daily_returns) {
-        if (daily_return > 0) {
-            total_wins += daily_return;
-            win_count++;
-        } else if (daily_return < 0) {
-            total_losses += std::abs(daily_return);
-            loss_count++;
-        }
-    }
-    
-    result.average_win = win_count > 0 ? (total_wins / win_count) * result.starting_capital : 0.0;
-    result.average_loss = loss_count > 0 ? (total_losses / loss_count) * result.starting_capital : 0.0;
-}
\ No newline at end of file
+void ResultCalculator::calculateWinLossMetrics(BacktestResult& result, const TradeStatistics& statistics) const {
+    result.average_win = statistics.winning_trades > 0 ? statistics.gross_profit / statistics.winning_trades : 0.0;
+    result.average_loss = statistics.losing_trades > 0 ? statistics.gross_loss / statistics.losing_trades : 0.0;
+}
@@ -0,0 +1,295 @@
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <map>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <nlohmann/json.hpp>
+
+#include "date_time_utils.h"
+#include "logger.h"
+#include "result_file.h"
+#include "trading_strategy.h"
+
+namespace {
+constexpr uint64_t COLUMN_ALIGNMENT = 64;
+
+uint64_t alignUp(uint64_t value) {
+    return (value + COLUMN_ALIGNMENT - 1) & ~(COLUMN_ALIGNMENT - 1);
+}
+
+uint32_t elementSize(ResultColumnType type) {
+    return type == ResultColumnType::INT32 ? 4 : 8;
+}
+
+// Interns repeated strings (symbols, signal reasons) as int32 indexes
+class StringTable {
+public:
+    int32_t indexOf(const std::string& value) {
+        auto it = indexes_.find(value);
+        if (it != indexes_.end()) {
+            return it->second;
+        }
+        int32_t index = static_cast<int32_t>(values_.size());
+        indexes_.emplace(value, index);
+        values_.push_back(value);
+        return index;
+    }
+    const std::vector<std::string>& values() const { return values_; }
+
+private:
+    std::map<std::string, int32_t> indexes_;
+    std::vector<std::string> values_;
+};
+}
+
+ResultFile::~ResultFile() {
+    close();
+}
+
+Result<uint64_t> ResultFile::write(const std::string& path, const std::string& metadata,
+                                   const std::vector<ResultColumn>& columns) {
+    for (const auto& column : columns) {
+        if (column.name.size() >= ResultColumnEntry::NAME_SIZE) {
+            return Result<uint64_t>(ErrorCode::VALIDATION_INVALID_INPUT, "Result column name too long: " + column.name);
+        }
+    }
+
+    // Header, directory, aligned columns, then metadata
+    const uint64_t directory_offset = sizeof(ResultFileHeader);
+    uint64_t offset = alignUp(directory_offset + columns.size() * sizeof(ResultColumnEntry));
+    std::vector<ResultColumnEntry> entries(columns.size());
+    for (size_t i = 0; i < columns.size(); ++i) {
+        std::memset(&entries[i], 0, sizeof(ResultColumnEntry));
+        std::memcpy(entries[i].name, columns[i].name.data(), columns[i].name.size());
+        entries[i].type = static_cast<uint32_t>(columns[i].type);
+        entries[i].element_size = elementSize(columns[i].type);
+        entries[i].offset = offset;
+        entries[i].length = columns[i].length;
+        offset = alignUp(offset + columns[i].length * entries[i].element_size);
+    }
+    const uint64_t metadata_offset = offset;
+    const uint64_t file_size = metadata_offset + metadata.size();
+
+    // Readers only ever see a complete file
+    const std::string temp_path = path + ".tmp";
+    int fd = ::open(temp_path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        return Result<uint64_t>(ErrorCode::SYSTEM_FILE_ACCESS_DENIED,
+                               "Cannot create result file " + temp_path + ": " + std::strerror(errno));
+    }
+    if (::ftruncate(fd, static_cast<off_t>(file_size)) != 0) {
+        int error = errno;
+        ::close(fd);
+        ::unlink(temp_path.c_str());
+        return Result<uint64_t>(ErrorCode::SYSTEM_FILE_ACCESS_DENIED,
+                               "Cannot size result file " + temp_path + ": " + std::strerror(error));
+    }
+    void* mapping = ::mmap(nullptr, file_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        int error = errno;
+        ::unlink(temp_path.c_str());
+        return Result<uint64_t>(ErrorCode::SYSTEM_MEMORY_ALLOCATION_FAILED,
+                               "Cannot map result file " + temp_path + ": " + std::strerror(error));
+    }
+
+    auto* base = static_cast<uint8_t*>(mapping);
+    ResultFileHeader header = {};
+    header.magic = ResultFileHeader::MAGIC;
+    header.version = ResultFileHeader::VERSION;
+    header.file_size = file_size;
+    header.metadata_offset = metadata_offset;
+    header.metadata_size = metadata.size();
+    header.directory_offset = directory_offset;
+    header.column_count = static_cast<uint32_t>(columns.size());
+    std::memcpy(base, &header, sizeof(header));
+    if (!entries.empty()) {
+        std::memcpy(base + directory_offset, entries.data(), entries.size() * sizeof(ResultColumnEntry));
+    }
+    for (size_t i = 0; i < columns.size(); ++i) {
+        if (columns[i].length > 0) {
+            std::memcpy(base + entries[i].offset, columns[i].data, columns[i].length * entries[i].element_size);
+        }
+    }
+    std::memcpy(base + metadata_offset, metadata.data(), metadata.size());
+    ::munmap(mapping, file_size);
+
+    if (std::rename(temp_path.c_str(), path.c_str()) != 0) {
+        int error = errno;
+        ::unlink(temp_path.c_str());
+        return Result<uint64_t>(ErrorCode::SYSTEM_FILE_ACCESS_DENIED,
+                               "Cannot move result file into place at " + path + ": " + std::strerror(error));
+    }
+
+    Logger::debug("Wrote result file ", path, " (", file_size, " bytes, ", columns.size(), " columns)");
+    return Result<uint64_t>(file_size);
+}
+
+Result<uint64_t> ResultFile::writeBacktest(const std::string& path, const BacktestResult& result,
+                                           const nlohmann::json& result_json) {
+    StringTable symbols;
+    StringTable reasons;
+    for (const auto& symbol : result.symbols) {
+        symbols.indexOf(symbol);
+    }
+
+    // Equity: dated points when the JSON has them, raw curve otherwise
+    std::vector<double> equity_values;
+    std::vector<int32_t> equity_dates;
+    auto equity_points = result_json.find("equity_curve");
+    if (equity_points != result_json.end() && equity_points->is_array()) {
+        equity_values.reserve(equity_points->size());
+        equity_dates.reserve(equity_points->size());
+        for (const auto& point : *equity_points) {
+            equity_values.push_back(point.value("value", 0.0));
+            equity_dates.push_back(DateTimeUtils::dateToYyyymmdd(point.value("date", "")));
+        }
+    } else {
+        equity_values = result.equity_curve;
+    }
+
+    const size_t trip_count = result.round_trips.size();
+    std::vector<int32_t> trip_symbol(trip_count), trip_shares(trip_count), trip_entry_date(trip_count),
+                         trip_exit_date(trip_count), trip_holding_bars(trip_count);
+    std::vector<double> trip_entry_price(trip_count), trip_exit_price(trip_count), trip_pnl(trip_count),
+                        trip_return_pct(trip_count), trip_mae_pct(trip_count), trip_mfe_pct(trip_count);
+    for (size_t i = 0; i < trip_count; ++i) {
+        const auto& trip = result.round_trips[i];
+        trip_symbol[i] = symbols.indexOf(trip.symbol);
+        trip_shares[i] = trip.shares;
+        trip_entry_date[i] = DateTimeUtils::dateToYyyymmdd(trip.entry_date);
+        trip_exit_date[i] = DateTimeUtils::dateToYyyymmdd(trip.exit_date);
+        trip_holding_bars[i] = trip.holding_bars;
+        trip_entry_price[i] = trip.entry_price;
+        trip_exit_price[i] = trip.exit_price;
+        trip_pnl[i] = trip.pnl;
+        trip_return_pct[i] = trip.return_pct;
+        trip_mae_pct[i] = trip.mae_pct;
+        trip_mfe_pct[i] = trip.mfe_pct;
+    }
+
+    const size_t signal_count = result.signals_generated.size();
+    std::vector<int32_t> signal_side(signal_count), signal_symbol(signal_count), signal_date(signal_count),
+                         signal_reason(signal_count);
+    std::vector<double> signal_price(signal_count), signal_confidence(signal_count);
+    for (size_t i = 0; i < signal_count; ++i) {
+        const auto& signal = result.signals_generated[i];
+        signal_side[i] = signal.signal == Signal::BUY ? 1 : -1;
+        signal_symbol[i] = signal.symbol.empty() ? -1 : symbols.indexOf(signal.symbol);
+        signal_date[i] = DateTimeUtils::dateToYyyymmdd(signal.date);
+        signal_reason[i] = reasons.indexOf(signal.reason);
+        signal_price[i] = signal.price;
+        signal_confidence[i] = signal.confidence;
+    }
+
+    // Everything that is not columnar stays in the metadata blob
+    nlohmann::json metadata = result_json;
+    metadata.erase("equity_curve");
+    metadata.erase("round_trips");
+    metadata.erase("signals");
+    metadata["symbols"] = symbols.values();
+    metadata["signal_reasons"] = reasons.values();
+
+    const std::vector<ResultColumn> columns = {
+        {"equity.value", ResultColumnType::FLOAT64, equity_values.data(), equity_values.size()},
+        {"equity.date", ResultColumnType::INT32, equity_dates.data(), equity_dates.size()},
+        {"trade.symbol", ResultColumnType::INT32, trip_symbol.data(), trip_count},
+        {"trade.shares", ResultColumnType::INT32, trip_shares.data(), trip_count},
+        {"trade.entry_date", ResultColumnType::INT32, trip_entry_date.data(), trip_count},
+        {"trade.exit_date", ResultColumnType::INT32, trip_exit_date.data(), trip_count},
+        {"trade.holding_bars", ResultColumnType::INT32, trip_holding_bars.data(), trip_count},
+        {"trade.entry_price", ResultColumnType::FLOAT64, trip_entry_price.data(), trip_count},
+        {"trade.exit_price", ResultColumnType::FLOAT64, trip_exit_price.data(), trip_count},
+        {"trade.pnl", ResultColumnType::FLOAT64, trip_pnl.data(), trip_count},
+        {"trade.return_pct", ResultColumnType::FLOAT64, trip_return_pct.data(), trip_count},
+        {"trade.mae_pct", ResultColumnType::FLOAT64, trip_mae_pct.data(), trip_count},
+        {"trade.mfe_pct", ResultColumnType::FLOAT64, trip_mfe_pct.data(), trip_count},
+        {"signal.side", ResultColumnType::INT32, signal_side.data(), signal_count},
+        {"signal.symbol", ResultColumnType::INT32, signal_symbol.data(), signal_count},
+        {"signal.date", ResultColumnType::INT32, signal_date.data(), signal_count},
+        {"signal.reason", ResultColumnType::INT32, signal_reason.data(), signal_count},
+        {"signal.price", ResultColumnType::FLOAT64, signal_price.data(), signal_count},
+        {"signal.confidence", ResultColumnType::FLOAT64, signal_confidence.data(), signal_count},
+    };
+    return write(path, metadata.dump(), columns);
+}
+
+Result<void> ResultFile::open(const std::string& path) {
+    close();
+
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return Result<void>(ErrorCode::SYSTEM_FILE_ACCESS_DENIED,
+                           "Cannot open result file " + path + ": " + std::strerror(errno));
+    }
+    struct stat file_stat;
+    if (::fstat(fd, &file_stat) != 0 || file_stat.st_size < static_cast<off_t>(sizeof(ResultFileHeader))) {
+        ::close(fd);
+        return Result<void>(ErrorCode::SYSTEM_CONFIGURATION_ERROR, "Result file is too small: " + path);
+    }
+
+    size_t size = static_cast<size_t>(file_stat.st_size);
+    void* mapping = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        return Result<void>(ErrorCode::SYSTEM_MEMORY_ALLOCATION_FAILED,
+                           "Cannot map result file " + path + ": " + std::strerror(errno));
+    }
+    data_ = static_cast<const uint8_t*>(mapping);
+    size_ = size;
+
+    // Every offset is checked once here so column() can trust the directory
+    const ResultFileHeader& file_header = header();
+    bool valid = file_header.magic == ResultFileHeader::MAGIC &&
+                 file_header.version == ResultFileHeader::VERSION &&
+                 file_header.file_size <= size_ &&
+                 file_header.metadata_offset + file_header.metadata_size <= file_header.file_size &&
+                 file_header.directory_offset + file_header.column_count * sizeof(ResultColumnEntry) <= file_header.file_size;
+    for (uint32_t i = 0; valid && i < file_header.column_count; ++i) {
+        const auto* entry = reinterpret_cast<const ResultColumnEntry*>(data_ + file_header.directory_offset) + i;
+        valid = entry->name[ResultColumnEntry::NAME_SIZE - 1] == '\0' &&
+                (entry->element_size == 4 || entry->element_size == 8) &&
+                entry->offset % COLUMN_ALIGNMENT == 0 &&
+                entry->length <= file_header.file_size / entry->element_size &&
+                entry->offset + entry->length * entry->element_size <= file_header.file_size;
+    }
+    if (!valid) {
+        close();
+        return Result<void>(ErrorCode::SYSTEM_CONFIGURATION_ERROR,
+                           "File is not a valid version " + std::to_string(ResultFileHeader::VERSION) +
+                           " result file: " + path);
+    }
+    return Result<void>();
+}
+
+void ResultFile::close() {
+    if (data_) {
+        ::munmap(const_cast<uint8_t*>(data_), size_);
+        data_ = nullptr;
+        size_ = 0;
+    }
+}
+
+std::string ResultFile::metadata() const {
+    if (!data_) {
+        return "";
+    }
+    return std::string(reinterpret_cast<const char*>(data_ + header().metadata_offset), header().metadata_size);
+}
+
+const ResultColumnEntry* ResultFile::findColumn(const std::string& name) const {
+    if (!data_) {
+        return nullptr;
+    }
+    const auto* entries = reinterpret_cast<const ResultColumnEntry*>(data_ + header().directory_offset);
+    for (uint32_t i = 0; i < header().column_count; ++i) {
+        if (name == entries[i].name) {
+            return &entries[i];
+        }
+    }
+    return nullptr;
+}
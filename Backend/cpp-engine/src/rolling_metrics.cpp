@@ -0,0 +1,141 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "rolling_metrics.h"
+
+namespace {
+constexpr double TRADING_DAYS_PER_YEAR = 252.0;
+constexpr double RISK_FREE_RATE = 0.02;
+}
+
+void RollingMetrics::configure(const std::vector<int>& windows, bool track_underwater) {
+    windows_.clear();
+    for (int window : windows) {
+        if (window > 1 && std::find(windows_.begin(), windows_.end(), window) == windows_.end()) {
+            windows_.push_back(window);
+        }
+    }
+    track_underwater_ = track_underwater;
+
+    states_.clear();
+    series_.clear();
+    underwater_.clear();
+    observation_count_ = 0;
+}
+
+void RollingMetrics::reset(double initial_value) {
+    states_.clear();
+    series_.clear();
+    underwater_.clear();
+    observation_count_ = 0;
+
+    if (!isEnabled()) {
+        return;
+    }
+
+    states_.resize(windows_.size());
+    for (size_t i = 0; i < windows_.size(); ++i) {
+        states_[i].window = static_cast<size_t>(windows_[i]);
+        states_[i].returns.reset(states_[i].window);
+        series_.emplace_back(windows_[i]);
+    }
+
+    last_value_ = initial_value;
+    peak_value_ = initial_value;
+    appendPoint(initial_value, false, 0.0);
+}
+
+void RollingMetrics::update(double equity_value) {
+    if (!isEnabled()) {
+        return;
+    }
+
+    // Daily returns are only defined against a positive previous value
+    bool has_return = last_value_ > 0;
+    double daily_return = has_return ? (equity_value - last_value_) / last_value_ : 0.0;
+
+    appendPoint(equity_value, has_return, daily_return);
+    last_value_ = equity_value;
+}
+
+void RollingMetrics::moveInto(BacktestResult& result) {
+    result.rolling_metrics = std::move(series_);
+    if (track_underwater_) {
+        result.underwater_curve = std::move(underwater_);
+    }
+    series_.clear();
+    underwater_.clear();
+}
+
+void RollingMetrics::appendPoint(double equity_value, bool has_return, double daily_return) {
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    const size_t index = observation_count_++;
+
+    if (equity_value > peak_value_) {
+        peak_value_ = equity_value;
+    }
+    if (track_underwater_) {
+        underwater_.push_back(peak_value_ > 0 ? (equity_value / peak_value_ - 1.0) * 100.0 : 0.0);
+    }
+
+    for (size_t i = 0; i < states_.size(); ++i) {
+        WindowState& state = states_[i];
+        RollingMetricSeries& series = series_[i];
+
+        if (has_return) {
+            if (state.returns.full()) {
+                double evicted = state.returns.front();
+                state.sum -= evicted;
+                state.sum_sq -= evicted * evicted;
+            }
+            state.returns.push_overwrite(daily_return);
+            state.sum += daily_return;
+            state.sum_sq += daily_return * daily_return;
+
+            // Periodically recompute the sums so floating point drift stays bounded
+            if (++state.updates_since_resum >= state.window) {
+                resum(state);
+            }
+        }
+
+        // Monotonic deque holds candidates for the trailing window high
+        while (!state.max_deque.empty() && state.max_deque.back().second <= equity_value) {
+            state.max_deque.pop_back();
+        }
+        state.max_deque.emplace_back(index, equity_value);
+        while (state.max_deque.front().first + state.window < index) {
+            state.max_deque.pop_front();
+        }
+
+        if (!state.returns.full()) {
+            series.sharpe_ratio.push_back(nan);
+            series.volatility.push_back(nan);
+            series.drawdown_pct.push_back(nan);
+            continue;
+        }
+
+        double n = static_cast<double>(state.window);
+        double mean = state.sum / n;
+        double variance = std::max(0.0, state.sum_sq / n - mean * mean);
+        double annualized_std = std::sqrt(variance) * std::sqrt(TRADING_DAYS_PER_YEAR);
+
+        series.volatility.push_back(annualized_std * 100.0);
+        series.sharpe_ratio.push_back(annualized_std > 0.0 ?
+            (mean * TRADING_DAYS_PER_YEAR - RISK_FREE_RATE) / annualized_std : 0.0);
+
+        double window_high = state.max_deque.front().second;
+        series.drawdown_pct.push_back(window_high > 0 ? (equity_value / window_high - 1.0) * 100.0 : 0.0);
+    }
+}
+
+void RollingMetrics::resum(WindowState& state) {
+    state.sum = 0.0;
+    state.sum_sq = 0.0;
+    for (size_t i = 0; i < state.returns.size(); ++i) {
+        double value = state.returns[i];
+        state.sum += value;
+        state.sum_sq += value * value;
+    }
+    state.updates_since_resum = 0;
+}
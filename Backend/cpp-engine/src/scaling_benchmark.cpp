@@ -0,0 +1,190 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <random>
+#include <sys/resource.h>
+
+#include <nlohmann/json.hpp>
+
+#include "allocation_counter.h"
+#include "date_time_utils.h"
+#include "logger.h"
+#include "query_cursor.h"
+#include "scaling_benchmark.h"
+#include "simulation_bundle.h"
+#include "trading_engine.h"
+
+namespace {
+constexpr int TRADING_DAYS_PER_YEAR = 252;
+constexpr double STARTING_CAPITAL = 1000000.0;
+
+// 0 = Monday; day 0 (1970-01-01) was a Thursday
+bool isWeekday(int32_t day) {
+    return ((day % 7) + 7 + 3) % 7 < 5;
+}
+}  // namespace
+
+std::shared_ptr<SimulationBundle> ScalingBenchmark::generateUniverse(int symbol_count, int years, uint64_t seed,
+                                                                     TradingConfig& config) {
+    // Business days counted back from the last session of 2023
+    const size_t day_count = static_cast<size_t>(years) * TRADING_DAYS_PER_YEAR;
+    std::vector<std::string> dates(day_count);
+    int32_t day = DateTimeUtils::daysFromCivil(2023, 12, 29);
+    for (size_t i = day_count; i > 0; --day) {
+        if (isWeekday(day)) {
+            dates[--i] = PgBinary::formatDate(day);
+        }
+    }
+
+    config.symbols.clear();
+    config.start_date = dates.front();
+    config.end_date = dates.back();
+
+    auto bundle = std::make_shared<SimulationBundle>();
+    std::vector<PriceData> bars;
+    bars.reserve(day_count);
+    for (int s = 0; s < symbol_count; ++s) {
+        const std::string symbol = "BENCH" + std::to_string(s);
+        config.symbols.push_back(symbol);
+
+        // Geometric random walk; each symbol has its own stream so cases share prefixes
+        std::mt19937_64 rng(seed + static_cast<uint64_t>(s));
+        std::normal_distribution<double> normal(0.0, 1.0);
+        double close = 20.0 + static_cast<double>(rng() % 480);
+        const double drift = 0.0002 * normal(rng);
+        const double volatility = 0.01 + 0.02 * static_cast<double>(rng() % 1000) / 1000.0;
+
+        bars.clear();
+        for (size_t i = 0; i < day_count; ++i) {
+            double open = close;
+            close = std::max(1.0, close * std::exp(drift + volatility * normal(rng)));
+            double spread = volatility * std::max(open, close) * 0.5;
+            bars.emplace_back(open, std::max(open, close) + spread, std::min(open, close) - spread, close,
+                              static_cast<long>(100000 + rng() % 900000), dates[i]);
+        }
+
+        bundle->recordSymbolExists(symbol, true);
+        bundle->recordTemporalInfo(symbol, {{"symbol", symbol}, {"ipo_date", dates.front()}, {"delisting_date", ""}});
+        bundle->recordPriceData(symbol, config.start_date, config.end_date, bars);
+        // Listed for the whole range, so every session is tradeable and the cases place orders
+        for (const auto& date : dates) {
+            bundle->recordTradeable(symbol, date, true);
+        }
+    }
+    return bundle;
+}
+
+Result<nlohmann::json> ScalingBenchmark::run(const Options& options) const {
+    if (options.symbol_counts.empty() || options.years.empty() || options.strategies.empty()) {
+        return Result<nlohmann::json>(ErrorCode::VALIDATION_INVALID_INPUT,
+                                      "Benchmark needs at least one symbol count, year count and strategy");
+    }
+    for (int value : options.symbol_counts) {
+        if (value <= 0) {
+            return Result<nlohmann::json>(ErrorCode::VALIDATION_INVALID_INPUT,
+                                          "Benchmark symbol counts must be positive: " + std::to_string(value));
+        }
+    }
+    for (int value : options.years) {
+        if (value <= 0) {
+            return Result<nlohmann::json>(ErrorCode::VALIDATION_INVALID_INPUT,
+                                          "Benchmark year counts must be positive: " + std::to_string(value));
+        }
+    }
+
+    nlohmann::json report;
+    report["type"] = "benchmark";
+    report["engine_version"] = TRADING_ENGINE_VERSION;
+    report["seed"] = options.seed;
+    AllocationCounter::enable();
+    report["allocation_counting"] = AllocationCounter::isInstalled();
+    // Without clear_refs the kernel only keeps a process-wide peak, which never goes down between cases
+    report["peak_rss_scope"] = resetPeakRss() ? "case" : "process";
+    report["cases"] = nlohmann::json::array();
+
+    for (const auto& strategy : options.strategies) {
+        for (int years : options.years) {
+            for (int symbol_count : options.symbol_counts) {
+                Logger::info("Benchmark: ", strategy, ", ", symbol_count, " symbols x ", years, " years");
+                report["cases"].push_back(runCase(strategy, symbol_count, years, options.seed));
+            }
+        }
+    }
+    return Result<nlohmann::json>(std::move(report));
+}
+
+nlohmann::json ScalingBenchmark::runCase(const std::string& strategy, int symbol_count, int years,
+                                         uint64_t seed) const {
+    nlohmann::json entry;
+    entry["strategy"] = strategy;
+    entry["symbols"] = symbol_count;
+    entry["years"] = years;
+
+    TradingConfig config;
+    config.strategy_name = strategy;
+    config.starting_capital = STARTING_CAPITAL;
+    auto bundle = generateUniverse(symbol_count, years, seed, config);
+    const size_t bars = bundle->getPriceRowCount();
+    entry["trading_days"] = bars / static_cast<size_t>(symbol_count);
+    entry["bars"] = bars;
+
+    TradingEngine engine(config.starting_capital);
+    auto strategy_result = engine.getStrategyManager()->createStrategyFromConfig(config);
+    if (strategy_result.isError()) {
+        entry["error"] = strategy_result.getErrorMessage();
+        return entry;
+    }
+    engine.getStrategyManager()->setCurrentStrategy(std::move(strategy_result.getValue()));
+    engine.getMarketData()->setReplayBundle(bundle);
+    engine.getProgressService()->setProgressReporting(false);
+
+    // Measured: data loading from the bundle, the simulation loop and result finalization
+    resetPeakRss();
+    const uint64_t allocations_before = AllocationCounter::allocations();
+    const auto start = std::chrono::steady_clock::now();
+    auto result = engine.getTradingOrchestrator()->runBacktest(
+        config, engine.getPortfolio(), engine.getMarketData(), engine.getExecutionService(),
+        engine.getProgressService(), engine.getPortfolioAllocator(), engine.getDataProcessor(),
+        engine.getStrategyManager(), engine.getResultCalculator());
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    const uint64_t allocations = AllocationCounter::allocations() - allocations_before;
+
+    if (result.isError()) {
+        entry["error"] = result.getErrorMessage();
+        return entry;
+    }
+
+    entry["wall_time_ms"] = seconds * 1000.0;
+    entry["bars_per_second"] = seconds > 0.0 ? static_cast<double>(bars) / seconds : 0.0;
+    entry["peak_rss_kb"] = readPeakRssKb();
+    if (AllocationCounter::isInstalled()) {
+        entry["allocations"] = allocations;
+        entry["allocations_per_bar"] = bars ? static_cast<double>(allocations) / static_cast<double>(bars) : 0.0;
+    } else {
+        entry["allocations"] = nullptr;
+        entry["allocations_per_bar"] = nullptr;
+    }
+    entry["total_trades"] = result.getValue().total_trades;
+    return entry;
+}
+
+bool ScalingBenchmark::resetPeakRss() {
+    // Writing 5 resets VmHWM to the current RSS (Linux 4.0+)
+    std::ofstream clear_refs("/proc/self/clear_refs");
+    return clear_refs && (clear_refs << "5").flush();
+}
+
+long ScalingBenchmark::readPeakRssKb() {
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.compare(0, 6, "VmHWM:") == 0) {
+            return std::strtol(line.c_str() + 6, nullptr, 10);
+        }
+    }
+    struct rusage usage {};
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
@@ -0,0 +1,450 @@
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+#include "date_time_utils.h"
+#include "logger.h"
+#include "query_cursor.h"
+#include "simulation_bundle.h"
+
+namespace {
+enum class DateEncoding : uint8_t {
+    TEXT = 0,
+    DAYS = 1,           // Every date is a plain YYYY-MM-DD
+    MIDNIGHT_UTC = 2    // Every date is YYYY-MM-DDT00:00:00+00:00, as timestamp columns are read
+};
+
+constexpr const char* MIDNIGHT_UTC_SUFFIX = "T00:00:00+00:00";
+
+// The encoding that reproduces `date` from day number `days`, or TEXT
+DateEncoding dateEncoding(const std::string& date, int32_t days) {
+    const std::string plain = PgBinary::formatDate(days);
+    if (date == plain) {
+        return DateEncoding::DAYS;
+    }
+    if (date.size() == plain.size() + std::strlen(MIDNIGHT_UTC_SUFFIX) && date.compare(0, plain.size(), plain) == 0 &&
+        date.compare(plain.size(), std::string::npos, MIDNIGHT_UTC_SUFFIX) == 0) {
+        return DateEncoding::MIDNIGHT_UTC;
+    }
+    return DateEncoding::TEXT;
+}
+
+class BundleWriter {
+public:
+    template<typename T>
+    void put(T value) {
+        buffer_.append(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    void putString(const std::string& value) {
+        put(static_cast<uint32_t>(value.size()));
+        buffer_.append(value);
+    }
+
+    // Plain dates and midnight-UTC timestamps become day numbers when a whole column shares one
+    // of those forms; anything else stays text so replay sees identical strings
+    void putDates(const std::vector<const std::string*>& dates) {
+        std::vector<int32_t> days(dates.size());
+        DateEncoding encoding = DateEncoding::DAYS;
+        for (size_t i = 0; i < dates.size() && encoding != DateEncoding::TEXT; ++i) {
+            DateEncoding date_encoding = DateTimeUtils::parseIsoDate(*dates[i], days[i])
+                ? dateEncoding(*dates[i], days[i]) : DateEncoding::TEXT;
+            encoding = (i == 0 || date_encoding == encoding) ? date_encoding : DateEncoding::TEXT;
+        }
+        const bool as_days = encoding != DateEncoding::TEXT;
+        put(static_cast<uint8_t>(encoding));
+        for (size_t i = 0; i < dates.size(); ++i) {
+            if (as_days) {
+                put(days[i]);
+            } else {
+                putString(*dates[i]);
+            }
+        }
+    }
+
+    const std::string& data() const { return buffer_; }
+
+private:
+    std::string buffer_;
+};
+
+class BundleReader {
+public:
+    explicit BundleReader(const std::string& data) : data_(data) {}
+
+    template<typename T>
+    bool get(T& value) {
+        if (data_.size() - offset_ < sizeof(T)) {
+            return false;
+        }
+        std::memcpy(&value, data_.data() + offset_, sizeof(T));
+        offset_ += sizeof(T);
+        return true;
+    }
+
+    bool getString(std::string& value) {
+        uint32_t length = 0;
+        if (!get(length) || data_.size() - offset_ < length) {
+            return false;
+        }
+        value.assign(data_.data() + offset_, length);
+        offset_ += length;
+        return true;
+    }
+
+    // Element counts are bounded by the bytes left, so a corrupt count cannot trigger a huge allocation
+    bool getCount(uint32_t& count, size_t min_element_size) {
+        return get(count) && static_cast<uint64_t>(count) * min_element_size <= data_.size() - offset_;
+    }
+
+    bool getDates(uint32_t count, std::vector<std::string>& dates) {
+        uint8_t encoding = 0;
+        if (!get(encoding)) {
+            return false;
+        }
+        dates.resize(count);
+        for (auto& date : dates) {
+            if (encoding == static_cast<uint8_t>(DateEncoding::DAYS) ||
+                encoding == static_cast<uint8_t>(DateEncoding::MIDNIGHT_UTC)) {
+                int32_t days = 0;
+                if (!get(days)) {
+                    return false;
+                }
+                date = PgBinary::formatDate(days);
+                if (encoding == static_cast<uint8_t>(DateEncoding::MIDNIGHT_UTC)) {
+                    date += MIDNIGHT_UTC_SUFFIX;
+                }
+            } else if (encoding == static_cast<uint8_t>(DateEncoding::TEXT)) {
+                if (!getString(date)) {
+                    return false;
+                }
+            } else {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool atEnd() const { return offset_ == data_.size(); }
+
+private:
+    const std::string& data_;
+    size_t offset_ = 0;
+};
+}
+
+void SimulationBundle::setConfigJson(std::string config_json) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    config_json_ = std::move(config_json);
+}
+
+std::string SimulationBundle::getConfigJson() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return config_json_;
+}
+
+void SimulationBundle::setEngineVersion(std::string version) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    engine_version_ = std::move(version);
+}
+
+std::string SimulationBundle::getEngineVersion() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return engine_version_;
+}
+
+std::string SimulationBundle::seriesKey(const std::string& symbol, const std::string& start_date,
+                                        const std::string& end_date) {
+    return symbol + '\n' + start_date + '\n' + end_date;
+}
+
+void SimulationBundle::recordSymbolExists(const std::string& symbol, bool exists) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    symbol_exists_[symbol] = exists;
+}
+
+void SimulationBundle::recordTemporalInfo(const std::string& symbol, const std::map<std::string, std::string>& info) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    temporal_info_[symbol] = info;
+}
+
+void SimulationBundle::recordPriceData(const std::string& symbol, const std::string& start_date,
+                                       const std::string& end_date, const std::vector<PriceData>& data) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    price_data_[seriesKey(symbol, start_date, end_date)] = data;
+}
+
+void SimulationBundle::recordTradeable(const std::string& symbol, const std::string& date, bool tradeable) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    tradeable_[symbol][date] = tradeable;
+}
+
+bool SimulationBundle::lookupSymbolExists(const std::string& symbol, bool& exists) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = symbol_exists_.find(symbol);
+    if (it == symbol_exists_.end()) {
+        return false;
+    }
+    exists = it->second;
+    return true;
+}
+
+bool SimulationBundle::lookupTemporalInfo(const std::string& symbol, std::map<std::string, std::string>& info) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = temporal_info_.find(symbol);
+    if (it == temporal_info_.end()) {
+        return false;
+    }
+    info = it->second;
+    return true;
+}
+
+bool SimulationBundle::lookupPriceData(const std::string& symbol, const std::string& start_date,
+                                       const std::string& end_date, std::vector<PriceData>& data) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = price_data_.find(seriesKey(symbol, start_date, end_date));
+    if (it == price_data_.end()) {
+        return false;
+    }
+    data = it->second;
+    return true;
+}
+
+bool SimulationBundle::lookupTradeable(const std::string& symbol, const std::string& date, bool& tradeable) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto symbol_it = tradeable_.find(symbol);
+    if (symbol_it == tradeable_.end()) {
+        return false;
+    }
+    auto date_it = symbol_it->second.find(date);
+    if (date_it == symbol_it->second.end()) {
+        return false;
+    }
+    tradeable = date_it->second;
+    return true;
+}
+
+size_t SimulationBundle::getPriceSeriesCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return price_data_.size();
+}
+
+size_t SimulationBundle::getPriceRowCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t rows = 0;
+    for (const auto& series : price_data_) {
+        rows += series.second.size();
+    }
+    return rows;
+}
+
+Result<uint64_t> SimulationBundle::save(const std::string& path) const {
+    BundleWriter writer;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        writer.put(MAGIC);
+        writer.put(VERSION);
+        writer.putString(engine_version_);
+        writer.putString(config_json_);
+
+        writer.put(static_cast<uint32_t>(symbol_exists_.size()));
+        for (const auto& entry : symbol_exists_) {
+            writer.putString(entry.first);
+            writer.put(static_cast<uint8_t>(entry.second ? 1 : 0));
+        }
+
+        writer.put(static_cast<uint32_t>(temporal_info_.size()));
+        for (const auto& entry : temporal_info_) {
+            writer.putString(entry.first);
+            writer.put(static_cast<uint32_t>(entry.second.size()));
+            for (const auto& field : entry.second) {
+                writer.putString(field.first);
+                writer.putString(field.second);
+            }
+        }
+
+        // Series: key, row count, dates, then one column per field
+        writer.put(static_cast<uint32_t>(price_data_.size()));
+        for (const auto& series : price_data_) {
+            const auto& rows = series.second;
+            writer.putString(series.first);
+            writer.put(static_cast<uint32_t>(rows.size()));
+            std::vector<const std::string*> dates;
+            dates.reserve(rows.size());
+            for (const auto& row : rows) {
+                dates.push_back(&row.date);
+            }
+            writer.putDates(dates);
+            for (const auto& row : rows) writer.put(row.open);
+            for (const auto& row : rows) writer.put(row.high);
+            for (const auto& row : rows) writer.put(row.low);
+            for (const auto& row : rows) writer.put(row.close);
+            for (const auto& row : rows) writer.put(static_cast<int64_t>(row.volume));
+        }
+
+        // Tradability: dates, then a bitmap with one bit per date
+        writer.put(static_cast<uint32_t>(tradeable_.size()));
+        for (const auto& entry : tradeable_) {
+            writer.putString(entry.first);
+            writer.put(static_cast<uint32_t>(entry.second.size()));
+            std::vector<const std::string*> dates;
+            std::vector<uint8_t> bitmap((entry.second.size() + 7) / 8, 0);
+            dates.reserve(entry.second.size());
+            for (const auto& day : entry.second) {
+                if (day.second) {
+                    bitmap[dates.size() / 8] |= static_cast<uint8_t>(1u << (dates.size() % 8));
+                }
+                dates.push_back(&day.first);
+            }
+            writer.putDates(dates);
+            for (uint8_t bits : bitmap) {
+                writer.put(bits);
+            }
+        }
+    }
+
+    // Readers only ever see a complete file
+    const std::string temp_path = path + ".tmp";
+    {
+        std::ofstream file(temp_path, std::ios::binary | std::ios::trunc);
+        if (!file) {
+            return Result<uint64_t>(ErrorCode::SYSTEM_FILE_ACCESS_DENIED,
+                                   "Cannot create simulation bundle " + temp_path + ": " + std::strerror(errno));
+        }
+        file.write(writer.data().data(), static_cast<std::streamsize>(writer.data().size()));
+        if (!file) {
+            std::remove(temp_path.c_str());
+            return Result<uint64_t>(ErrorCode::SYSTEM_FILE_ACCESS_DENIED, "Cannot write simulation bundle " + temp_path);
+        }
+    }
+    if (std::rename(temp_path.c_str(), path.c_str()) != 0) {
+        int error = errno;
+        std::remove(temp_path.c_str());
+        return Result<uint64_t>(ErrorCode::SYSTEM_FILE_ACCESS_DENIED,
+                               "Cannot move simulation bundle into place at " + path + ": " + std::strerror(error));
+    }
+
+    Logger::debug("Wrote simulation bundle ", path, " (", writer.data().size(), " bytes)");
+    return Result<uint64_t>(static_cast<uint64_t>(writer.data().size()));
+}
+
+Result<std::shared_ptr<SimulationBundle>> SimulationBundle::load(const std::string& path) {
+    using LoadResult = Result<std::shared_ptr<SimulationBundle>>;
+
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        return LoadResult(ErrorCode::SYSTEM_FILE_ACCESS_DENIED,
+                          "Cannot open simulation bundle " + path + ": " + std::strerror(errno));
+    }
+    const std::string data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    const LoadResult corrupt(ErrorCode::VALIDATION_INVALID_FORMAT, "Simulation bundle is truncated or corrupt: " + path);
+
+    BundleReader reader(data);
+    uint32_t magic = 0;
+    uint32_t version = 0;
+    if (!reader.get(magic) || magic != MAGIC) {
+        return LoadResult(ErrorCode::VALIDATION_INVALID_FORMAT, "Not a simulation bundle: " + path);
+    }
+    // Version 1 files lack only the midnight-UTC date encoding and read unchanged
+    if (!reader.get(version) || version < 1 || version > VERSION) {
+        return LoadResult(ErrorCode::VALIDATION_INVALID_FORMAT,
+                          "Unsupported simulation bundle version " + std::to_string(version) + " in " + path);
+    }
+
+    auto bundle = std::make_shared<SimulationBundle>();
+    if (!reader.getString(bundle->engine_version_) || !reader.getString(bundle->config_json_)) {
+        return corrupt;
+    }
+
+    uint32_t count = 0;
+    if (!reader.getCount(count, sizeof(uint32_t) + 1)) {
+        return corrupt;
+    }
+    for (uint32_t i = 0; i < count; ++i) {
+        std::string symbol;
+        uint8_t exists = 0;
+        if (!reader.getString(symbol) || !reader.get(exists)) {
+            return corrupt;
+        }
+        bundle->symbol_exists_[symbol] = exists != 0;
+    }
+
+    if (!reader.getCount(count, 2 * sizeof(uint32_t))) {
+        return corrupt;
+    }
+    for (uint32_t i = 0; i < count; ++i) {
+        std::string symbol;
+        uint32_t fields = 0;
+        if (!reader.getString(symbol) || !reader.getCount(fields, 2 * sizeof(uint32_t))) {
+            return corrupt;
+        }
+        auto& info = bundle->temporal_info_[symbol];
+        for (uint32_t f = 0; f < fields; ++f) {
+            std::string key, value;
+            if (!reader.getString(key) || !reader.getString(value)) {
+                return corrupt;
+            }
+            info.emplace(std::move(key), std::move(value));
+        }
+    }
+
+    if (!reader.getCount(count, 2 * sizeof(uint32_t))) {
+        return corrupt;
+    }
+    for (uint32_t i = 0; i < count; ++i) {
+        std::string key;
+        uint32_t rows = 0;
+        std::vector<std::string> dates;
+        if (!reader.getString(key) || !reader.getCount(rows, 5 * sizeof(double)) || !reader.getDates(rows, dates)) {
+            return corrupt;
+        }
+        std::vector<PriceData> series(rows);
+        for (uint32_t r = 0; r < rows; ++r) {
+            series[r].date = std::move(dates[r]);
+        }
+        bool complete = true;
+        for (auto& row : series) complete = complete && reader.get(row.open);
+        for (auto& row : series) complete = complete && reader.get(row.high);
+        for (auto& row : series) complete = complete && reader.get(row.low);
+        for (auto& row : series) complete = complete && reader.get(row.close);
+        for (auto& row : series) {
+            int64_t volume = 0;
+            complete = complete && reader.get(volume);
+            row.volume = static_cast<long>(volume);
+        }
+        if (!complete) {
+            return corrupt;
+        }
+        bundle->price_data_.emplace(std::move(key), std::move(series));
+    }
+
+    if (!reader.getCount(count, 2 * sizeof(uint32_t))) {
+        return corrupt;
+    }
+    for (uint32_t i = 0; i < count; ++i) {
+        std::string symbol;
+        uint32_t days = 0;
+        std::vector<std::string> dates;
+        if (!reader.getString(symbol) || !reader.getCount(days, 1) || !reader.getDates(days, dates)) {
+            return corrupt;
+        }
+        auto& by_date = bundle->tradeable_[symbol];
+        uint8_t bits = 0;
+        for (uint32_t d = 0; d < days; ++d) {
+            if (d % 8 == 0 && !reader.get(bits)) {
+                return corrupt;
+            }
+            by_date[dates[d]] = (bits >> (d % 8)) & 1u;
+        }
+    }
+
+    if (!reader.atEnd()) {
+        return corrupt;
+    }
+
+    Logger::debug("Loaded simulation bundle ", path, " (engine ", bundle->engine_version_, ", ",
+                  bundle->price_data_.size(), " price series)");
+    return LoadResult(std::move(bundle));
+}
@@ -0,0 +1,113 @@
+#include <algorithm>
+#include <cmath>
+
+#include "streaming_metrics.h"
+
+namespace {
+constexpr double TRADING_DAYS_PER_YEAR = 252.0;
+}
+
+void StreamingMetrics::reset(double initial_value) {
+    clear();
+    update(initial_value);
+}
+
+void StreamingMetrics::clear() {
+    *this = StreamingMetrics();
+}
+
+void StreamingMetrics::update(double equity_value) {
+    if (observation_count_ == 0) {
+        first_value_ = equity_value;
+        last_value_ = equity_value;
+        peak_value_ = equity_value;
+        observation_count_ = 1;
+        return;
+    }
+
+    // Daily returns are only defined against a positive previous value
+    if (last_value_ > 0) {
+        double ret = (equity_value - last_value_) / last_value_;
+
+        ++return_count_;
+        double delta = ret - mean_return_;
+        mean_return_ += delta / static_cast<double>(return_count_);
+        m2_ += delta * (ret - mean_return_);
+
+        if (ret > 0) {
+            gain_sum_ += ret;
+            ++gain_count_;
+        } else if (ret < 0) {
+            loss_sum_ -= ret;
+            downside_sq_sum_ += ret * ret;
+            ++loss_count_;
+        }
+    }
+
+    if (equity_value > peak_value_) {
+        peak_value_ = equity_value;
+    }
+    if (peak_value_ > 0) {
+        max_drawdown_ = std::max(max_drawdown_, (peak_value_ - equity_value) / peak_value_);
+    }
+
+    last_value_ = equity_value;
+    ++observation_count_;
+}
+
+double StreamingMetrics::getReturnVariance() const {
+    return return_count_ > 0 ? m2_ / static_cast<double>(return_count_) : 0.0;
+}
+
+double StreamingMetrics::getReturnStdDev() const {
+    return std::sqrt(getReturnVariance());
+}
+
+double StreamingMetrics::getDownsideDeviation() const {
+    return return_count_ > 0 ? std::sqrt(downside_sq_sum_ / static_cast<double>(return_count_)) : 0.0;
+}
+
+double StreamingMetrics::getProfitFactor() const {
+    return loss_sum_ > 0 ? gain_sum_ / loss_sum_ : 0.0;
+}
+
+double StreamingMetrics::getAverageGain() const {
+    return gain_count_ > 0 ? gain_sum_ / static_cast<double>(gain_count_) : 0.0;
+}
+
+double StreamingMetrics::getAverageLoss() const {
+    return loss_count_ > 0 ? loss_sum_ / static_cast<double>(loss_count_) : 0.0;
+}
+
+double StreamingMetrics::getCurrentDrawdownPct() const {
+    if (peak_value_ <= 0) return 0.0;
+    return ((peak_value_ - last_value_) / peak_value_) * 100.0;
+}
+
+double StreamingMetrics::getAnnualizedVolatilityPct() const {
+    return getReturnStdDev() * std::sqrt(TRADING_DAYS_PER_YEAR) * 100.0;
+}
+
+double StreamingMetrics::getSharpeRatio(double risk_free_rate) const {
+    if (return_count_ == 0) return 0.0;
+
+    double std_dev = getReturnStdDev();
+    if (std_dev == 0.0) return 0.0;
+
+    double annualized_return = mean_return_ * TRADING_DAYS_PER_YEAR;
+    double annualized_std = std_dev * std::sqrt(TRADING_DAYS_PER_YEAR);
+
+    return (annualized_return - risk_free_rate) / annualized_std;
+}
+
+double StreamingMetrics::getSortinoRatio(double risk_free_rate) const {
+    if (return_count_ == 0) return 0.0;
+
+    double downside = getDownsideDeviation();
+    if (downside == 0.0) return 0.0;
+
+    double annualized_return = mean_return_ * TRADING_DAYS_PER_YEAR;
+    double annualized_downside = downside * std::sqrt(TRADING_DAYS_PER_YEAR);
+
+    return (annualized_return - risk_free_rate) / annualized_downside;
+}
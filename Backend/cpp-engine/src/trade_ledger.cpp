@@ -0,0 +1,114 @@
+#include <algorithm>
+
+#include "logger.h"
+#include "trade_ledger.h"
+
+void TradeLedger::recordBuy(const std::string& symbol, int shares, double price, const std::string& date) {
+    if (shares <= 0 || price <= 0) {
+        return;
+    }
+
+    auto& book = books_[symbol];
+    Lot lot;
+    lot.shares = shares;
+    lot.entry_price = price;
+    lot.entry_date = date;
+    lot.entry_bar = book.bars;
+    lot.lowest_price = price;
+    lot.highest_price = price;
+    book.lots.push_back(std::move(lot));
+}
+
+void TradeLedger::recordSell(const std::string& symbol, int shares, double price, const std::string& date) {
+    auto book_it = books_.find(symbol);
+    if (book_it == books_.end() || shares <= 0) {
+        return;
+    }
+
+    auto& book = book_it->second;
+    int remaining = shares;
+
+    while (remaining > 0 && !book.lots.empty()) {
+        Lot& lot = book.lots.front();
+        int matched = std::min(remaining, lot.shares);
+
+        RoundTrip trip;
+        trip.symbol = symbol;
+        trip.shares = matched;
+        trip.entry_price = lot.entry_price;
+        trip.exit_price = price;
+        trip.entry_date = lot.entry_date;
+        trip.exit_date = date;
+        trip.holding_bars = static_cast<int>(book.bars - lot.entry_bar);
+        trip.pnl = (price - lot.entry_price) * matched;
+        trip.return_pct = (price / lot.entry_price - 1.0) * 100.0;
+        trip.mae_pct = (std::min(lot.lowest_price, price) / lot.entry_price - 1.0) * 100.0;
+        trip.mfe_pct = (std::max(lot.highest_price, price) / lot.entry_price - 1.0) * 100.0;
+
+        statistics_.addRoundTrip(trip);
+        symbol_statistics_[symbol].addRoundTrip(trip);
+        round_trips_.push_back(std::move(trip));
+
+        lot.shares -= matched;
+        remaining -= matched;
+        if (lot.shares == 0) {
+            book.lots.pop_front();
+        }
+    }
+
+    if (remaining > 0) {
+        Logger::debug("TradeLedger: sell of ", shares, " ", symbol, " exceeded open lots by ", remaining, " shares");
+    }
+}
+
+void TradeLedger::markBar(const std::string& symbol, double high, double low) {
+    auto book_it = books_.find(symbol);
+    if (book_it == books_.end()) {
+        return;
+    }
+
+    auto& book = book_it->second;
+    ++book.bars;
+    for (size_t i = 0; i < book.lots.size(); ++i) {
+        Lot& lot = book.lots[i];
+        if (low > 0) {
+            lot.lowest_price = std::min(lot.lowest_price, low);
+        }
+        lot.highest_price = std::max(lot.highest_price, high);
+    }
+}
+
+int TradeLedger::getOpenShares(const std::string& symbol) const {
+    auto book_it = books_.find(symbol);
+    if (book_it == books_.end()) {
+        return 0;
+    }
+
+    int shares = 0;
+    for (size_t i = 0; i < book_it->second.lots.size(); ++i) {
+        shares += book_it->second.lots[i].shares;
+    }
+    return shares;
+}
+
+size_t TradeLedger::getOpenLotCount(const std::string& symbol) const {
+    auto book_it = books_.find(symbol);
+    return book_it == books_.end() ? 0 : book_it->second.lots.size();
+}
+
+void TradeLedger::clear() {
+    books_.clear();
+    round_trips_.clear();
+    statistics_ = TradeStatistics();
+    symbol_statistics_.clear();
+}
+
+size_t TradeLedger::getMemoryUsage() const {
+    size_t total = sizeof(*this);
+    total += round_trips_.capacity() * sizeof(RoundTrip);
+    for (const auto& [symbol, book] : books_) {
+        total += symbol.capacity() + sizeof(SymbolBook) + book.lots.capacity() * sizeof(Lot);
+    }
+    total += symbol_statistics_.size() * sizeof(TradeStatistics);
+    return total;
+}
@@ -0,0 +1,107 @@
+#include <algorithm>
+
+#include "date_time_utils.h"
+#include "trading_calendar.h"
+
+Result<TradingCalendar> TradingCalendar::fromTimeline(const std::vector<std::string>& timeline) {
+    std::vector<int32_t> days;
+    days.reserve(timeline.size());
+    for (const auto& date : timeline) {
+        int32_t day = 0;
+        if (!DateTimeUtils::parseIsoDate(date, day)) {
+            return Result<TradingCalendar>(ErrorCode::VALIDATION_INVALID_FORMAT,
+                                           "Timeline date is not YYYY-MM-DD: " + date);
+        }
+        days.push_back(day);
+    }
+    return Result<TradingCalendar>(fromDays(std::move(days)));
+}
+
+TradingCalendar TradingCalendar::fromDays(std::vector<int32_t> days) {
+    TradingCalendar calendar;
+    std::sort(days.begin(), days.end());
+    days.erase(std::unique(days.begin(), days.end()), days.end());
+    if (days.empty()) {
+        return calendar;
+    }
+    calendar.sessions_ = std::move(days);
+
+    const int32_t first = calendar.sessions_.front();
+    const size_t span = static_cast<size_t>(calendar.sessions_.back() - first) + 1;
+    calendar.bits_.assign((span + 63) / 64, 0);
+    for (int32_t day : calendar.sessions_) {
+        size_t offset = static_cast<size_t>(day - first);
+        calendar.bits_[offset / 64] |= uint64_t{1} << (offset % 64);
+    }
+    calendar.ranks_.resize(calendar.bits_.size());
+    uint32_t rank = 0;
+    for (size_t word = 0; word < calendar.bits_.size(); ++word) {
+        calendar.ranks_[word] = rank;
+        rank += static_cast<uint32_t>(__builtin_popcountll(calendar.bits_[word]));
+    }
+    return calendar;
+}
+
+bool TradingCalendar::isWeekday(int32_t day) {
+    // 1970-01-01 was a Thursday; 0 = Monday
+    return ((day % 7) + 7 + 3) % 7 < 5;
+}
+
+bool TradingCalendar::isSession(int32_t day) const {
+    if (sessions_.empty() || day < firstDay() || day > lastDay()) {
+        return false;
+    }
+    size_t offset = static_cast<size_t>(day - firstDay());
+    return (bits_[offset / 64] >> (offset % 64)) & 1;
+}
+
+bool TradingCalendar::isHoliday(int32_t day) const {
+    return !sessions_.empty() && day > firstDay() && day < lastDay() && isWeekday(day) && !isSession(day);
+}
+
+size_t TradingCalendar::holidayCount() const {
+    size_t holidays = 0;
+    for (size_t i = 1; i < sessions_.size(); ++i) {
+        for (int32_t day = sessions_[i - 1] + 1; day < sessions_[i]; ++day) {
+            holidays += isWeekday(day) ? 1 : 0;
+        }
+    }
+    return holidays;
+}
+
+size_t TradingCalendar::sessionsThrough(int32_t day) const {
+    if (sessions_.empty() || day < firstDay()) {
+        return 0;
+    }
+    if (day >= lastDay()) {
+        return sessions_.size();
+    }
+    size_t offset = static_cast<size_t>(day - firstDay());
+    size_t word = offset / 64;
+    uint64_t through = bits_[word] & (~uint64_t{0} >> (63 - offset % 64));
+    return ranks_[word] + static_cast<size_t>(__builtin_popcountll(through));
+}
+
+int64_t TradingCalendar::businessDaysBetween(int32_t from, int32_t to) const {
+    return static_cast<int64_t>(sessionsThrough(to)) - static_cast<int64_t>(sessionsThrough(from));
+}
+
+int32_t TradingCalendar::addBusinessDays(int32_t day, int count) const {
+    if (count < 1) {
+        return day;
+    }
+    return sessionAt(sessionsThrough(day) + static_cast<size_t>(count) - 1);
+}
+
+int32_t TradingCalendar::nextRebalanceDay(int32_t last_rebalance_day, int frequency_days) const {
+    return addBusinessDays(last_rebalance_day, std::max(1, frequency_days));
+}
+
+double TradingCalendar::yearFraction(int32_t from, int32_t to) const {
+    return static_cast<double>(businessDaysBetween(from, to)) / SESSIONS_PER_YEAR;
+}
+
+size_t TradingCalendar::getMemoryUsage() const {
+    return sizeof(*this) + sessions_.capacity() * sizeof(int32_t) + bits_.capacity() * sizeof(uint64_t) +
+           ranks_.capacity() * sizeof(uint32_t);
+}
@@ -14,15 +14,9 @@
 #include "trading_exceptions.h"
 
 // Constructors
-TradingEngine::TradingEngine() : portfolio_(10000.0), cache_enabled_(false) {
-    initializeServices();
-    strategy_manager_->initializeDefaultStrategy();
-}
+TradingEngine::TradingEngine() : portfolio_(10000.0), cache_enabled_(false) {}
 
-TradingEngine::TradingEngine(double initial_capital) : portfolio_(initial_capital), cache_enabled_(false) {
-    initializeServices();
-    strategy_manager_->initializeDefaultStrategy();
-}
+TradingEngine::TradingEngine(double initial_capital) : portfolio_(initial_capital), cache_enabled_(false) {}
 
 // Move constructor
 TradingEngine::TradingEngine(TradingEngine&& other) noexcept
@@ -58,12 +52,12 @@ TradingEngine& TradingEngine::operator=(TradingEngine&& other) noexcept {
 
 // Strategy manager access
 StrategyManager* TradingEngine::getStrategyManager() const {
-    return strategy_manager_.get();
+    return getOrCreate(strategy_manager_, &TradingEngine::createStrategyManager);
 }
 
 // Trading orchestrator access
 TradingOrchestrator* TradingEngine::getTradingOrchestrator() const {
-    return trading_orchestrator_.get();
+    return getOrCreate(trading_orchestrator_, []() { return std::make_unique<TradingOrchestrator>(); });
 }
 
 Portfolio& TradingEngine::getPortfolio() {
@@ -75,48 +69,46 @@ const Portfolio& TradingEngine::getPortfolio() const {
 }
 
 // Service initialization
-void TradingEngine::initializeServices() {
-    market_data_ = std::make_unique<MarketData>();
-    execution_service_ = std::make_unique<ExecutionService>();
-    progress_service_ = std::make_unique<ProgressService>();
-    result_calculator_ = std::make_unique<ResultCalculator>();
-    data_processor_ = std::make_unique<DataProcessor>();
-    strategy_manager_ = std::make_unique<StrategyManager>();
-    trading_orchestrator_ = std::make_unique<TradingOrchestrator>();
-    
-    // Initialize portfolio allocator with default equal weight strategy
+std::unique_ptr<PortfolioAllocator> TradingEngine::createPortfolioAllocator() {
+    // Default equal weight strategy
     AllocationConfig default_config;
     default_config.strategy = AllocationStrategy::EQUAL_WEIGHT;
     default_config.max_position_weight = 0.08; // Max 8% per position for better diversification
     default_config.min_position_weight = 0.02; // Min 2% per position
     default_config.enable_rebalancing = true;  // Allow portfolio rebalancing
     default_config.cash_reserve_pct = 0.05;    // Keep 5% cash reserve
-    portfolio_allocator_ = std::make_unique<PortfolioAllocator>(default_config);
+    return std::make_unique<PortfolioAllocator>(default_config);
+}
+
+std::unique_ptr<StrategyManager> TradingEngine::createStrategyManager() {
+    auto strategy_manager = std::make_unique<StrategyManager>();
+    strategy_manager->initializeDefaultStrategy();
+    return strategy_manager;
 }
 
 // Service accessors
 MarketData* TradingEngine::getMarketData() const {
-    return market_data_.get();
+    return getOrCreate(market_data_, []() { return std::make_unique<MarketData>(); });
 }
 
 ExecutionService* TradingEngine::getExecutionService() const {
-    return execution_service_.get();
+    return getOrCreate(execution_service_, []() { return std::make_unique<ExecutionService>(); });
 }
 
 ProgressService* TradingEngine::getProgressService() const {
-    return progress_service_.get();
+    return getOrCreate(progress_service_, []() { return std::make_unique<ProgressService>(); });
 }
 
 DataProcessor* TradingEngine::getDataProcessor() const {
-    return data_processor_.get();
+    return getOrCreate(data_processor_, []() { return std::make_unique<DataProcessor>(); });
 }
 
 ResultCalculator* TradingEngine::getResultCalculator() const {
-    return result_calculator_.get();
+    return getOrCreate(result_calculator_, []() { return std::make_unique<ResultCalculator>(); });
 }
 
 PortfolioAllocator* TradingEngine::getPortfolioAllocator() const {
-    return portfolio_allocator_.get();
+    return getOrCreate(portfolio_allocator_, &TradingEngine::createPortfolioAllocator);
 }
 
 // Memory optimization methods
@@ -1,4 +1,5 @@
 #include <algorithm>
+#include <atomic>
 #include <chrono>
 #include <cmath>
 #include <iostream>
@@ -7,12 +8,40 @@
 #include <thread>
 
 #include "data_conversion.h"
+#include "date_time_utils.h"
 #include "error_utils.h"
 #include "json_helpers.h"
 #include "logger.h"
+#include "order_book.h"
+#include "result_file.h"
+#include "simulation_bundle.h"
+#include "trading_calendar.h"
 #include "trading_engine.h"
 #include "trading_exceptions.h"
 #include "trading_orchestrator.h"
+#include "transaction_cost_model.h"
+
+namespace {
+// Adds one costed fill to the run totals
+void addFillCosts(TransactionCostSummary& summary, const FillEstimate& fill, int requested_shares) {
+    summary.commission += fill.commission;
+    summary.slippage += fill.slippage;
+    if (fill.shares < requested_shares) {
+        summary.capped_orders++;
+        summary.capped_shares += requested_shares - fill.shares;
+    }
+}
+
+// One symbol's slice of a sleeve-parallel run
+struct Sleeve {
+    std::map<std::string, std::vector<PriceData>> data;   // Just this symbol's bars
+    double capital = 0.0;                                 // 0 when the allocator gave the symbol no target
+    std::shared_ptr<SimulationBundle> tradeability;       // Per-day tradability read up front, or null
+    BacktestResult result;
+    Portfolio portfolio;
+    Result<void> status;
+};
+}  // namespace
 
 // Main orchestration methods
 Result<std::string> TradingOrchestrator::runSimulation(const TradingConfig& config,
@@ -57,11 +86,25 @@ Result<std::string> TradingOrchestrator::runSimulation(const TradingConfig& conf
     logOrchestrationEnd(result);
     
     // Convert to JSON for API response
-    auto json_result = getBacktestResultsAsJson(result, market_data, data_processor);
+    auto json_result = getBacktestResultsAsJson(result, market_data);
     if (json_result.isError()) {
         return Result<std::string>(json_result.getError());
     }
     
+    // Large results go through the mapped file; stdout only says where to find it
+    if (!config.result_mmap_path.empty()) {
+        auto write_result = ResultFile::writeBacktest(config.result_mmap_path, result, json_result.getValue());
+        if (write_result.isError()) {
+            return Result<std::string>(write_result.getError());
+        }
+        nlohmann::json location;
+        location["result_file"] = config.result_mmap_path;
+        location["format_version"] = ResultFileHeader::VERSION;
+        location["bytes"] = write_result.getValue();
+        location["truncated"] = result.truncated;
+        return Result<std::string>(location.dump());
+    }
+    
     return Result<std::string>(json_result.getValue().dump(2));
 }
 
@@ -91,19 +134,55 @@ Result<BacktestResult> TradingOrchestrator::runBacktest(const TradingConfig& con
         return Result<BacktestResult>(init_result.getError());
     }
     
-    auto market_data_result = data_processor->loadMultiSymbolData(config.symbols, config.start_date, config.end_date, market_data);
+    // The time budget covers data loading and the simulation loop
+    cancellation_token_->reset();
+    if (config.deadline_ms > 0) {
+        cancellation_token_->setDeadline(std::chrono::milliseconds(config.deadline_ms));
+    }
+    
+    // Optional binary progress channel for the API, open from the load on so a poller also
+    // sees a run that fails before its first simulated day
+    if (!config.progress_shm_path.empty()) {
+        auto channel_result = progress_service->openProgressChannel(config.progress_shm_path);
+        if (channel_result.isError()) {
+            Logger::warning("Progress channel unavailable, falling back to stderr: ", channel_result.getErrorMessage());
+        }
+    }
+    
+    if (market_data) {
+        market_data->setAsyncConnectionLimit(static_cast<size_t>(config.db_async_connections));
+    }
+    auto market_data_result = data_processor->loadMultiSymbolData(config.symbols, config.start_date, config.end_date,
+                                                                  market_data, cancellation_token_.get());
     if (market_data_result.isError()) {
+        progress_service->reportError(market_data_result.getErrorMessage());
+        progress_service->closeProgressChannel();
+        CancellationToken::clearPendingSignal();
         return Result<BacktestResult>(market_data_result.getError());
     }
     
-    auto simulation_result = runSimulationLoop(market_data_result.getValue(), config, result, portfolio,
-                                              execution_service, progress_service, portfolio_allocator,
-                                              data_processor, strategy_manager, market_data);
+    auto simulation_result = config.sleeve_parallel
+        ? runSleeveParallel(std::move(market_data_result.getValue()), config, result, portfolio,
+                            portfolio_allocator, data_processor, strategy_manager, market_data, result_calculator)
+        : runSimulationLoop(market_data_result.getValue(), config, result, portfolio,
+                            execution_service, progress_service, portfolio_allocator,
+                            data_processor, strategy_manager, market_data, result_calculator);
+    // Publish the final state, then close: a reused engine must not keep the mapping open.
+    // A signal that stopped this run is consumed by it rather than cancelling the next one
+    if (simulation_result.isError()) {
+        progress_service->reportError(simulation_result.getErrorMessage());
+    } else {
+        progress_service->reportCompletion(result.truncated);
+    }
+    progress_service->closeProgressChannel();
+    CancellationToken::clearPendingSignal();
     if (simulation_result.isError()) {
         return Result<BacktestResult>(simulation_result.getError());
     }
     
-    auto finalize_result = finalizeBacktestResults(result, portfolio, result_calculator);
+    // Sleeves keep their own ledgers; their round trips are already merged into the result
+    auto finalize_result = finalizeBacktestResults(result, portfolio, result_calculator,
+                                                   config.sleeve_parallel ? nullptr : &execution_service->getTradeLedger());
     if (finalize_result.isError()) {
         return Result<BacktestResult>(finalize_result.getError());
     }
@@ -138,6 +217,22 @@ Result<void> TradingOrchestrator::validateTradingConfig(const TradingConfig& con
                            "Provided capital: " + std::to_string(config.starting_capital));
     }
     
+    auto cost_validation = config.transaction_costs.validate();
+    if (cost_validation.isError()) {
+        Logger::error(cost_validation.getErrorMessage());
+        return cost_validation;
+    }
+    
+    if (config.sleeve_threads < 0) {
+        Logger::error("Sleeve thread count cannot be negative");
+        return Result<void>(ErrorCode::VALIDATION_INVALID_INPUT, "Sleeve thread count cannot be negative");
+    }
+    
+    if (config.db_async_connections < 0) {
+        Logger::error("Async database connection count cannot be negative");
+        return Result<void>(ErrorCode::VALIDATION_INVALID_INPUT, "Async database connection count cannot be negative");
+    }
+    
     return Result<void>(); // Success
 }
 
@@ -167,19 +262,18 @@ Result<void> TradingOrchestrator::validateSimulationParameters(const TradingConf
     if (market_data) {
         Logger::info("Performing temporal validation");
         
-        // Get database connection from market data service
-        auto db_connection = market_data->getDatabaseConnection();
-        if (!db_connection) {
+        // Database connection or replay bundle from market data service
+        if (!market_data->hasDataSource()) {
             Logger::warning("No database connection available for temporal validation");
             return Result<void>(); // Continue without temporal validation
         }
         
         // Dynamic temporal validation - allow all symbols but track their availability
         // This enables backtesting where stocks are traded only when actually available to trade
-        // Check which symbols exist in the database
+        // Check which symbols exist in the database (one indexed lookup per symbol)
         std::vector<std::string> missing_symbols;
         for (const auto& symbol : config.symbols) {
-            auto exists_result = db_connection->checkSymbolExists(symbol);
+            auto exists_result = market_data->symbolExists(symbol);
             if (exists_result.isError() || !exists_result.getValue()) {
                 missing_symbols.push_back(symbol);
             }
@@ -203,7 +297,7 @@ Result<void> TradingOrchestrator::validateSimulationParameters(const TradingConf
         
         // Get temporal info for each symbol for informational logging
         for (const auto& symbol : config.symbols) {
-            auto temporal_info = db_connection->getStockTemporalInfo(symbol);
+            auto temporal_info = market_data->getStockTemporalInfo(symbol);
             if (temporal_info.isSuccess()) {
                 const auto& info = temporal_info.getValue();
                 auto ipo_it = info.find("ipo_date");
@@ -254,17 +348,17 @@ Result<void> TradingOrchestrator::initializeBacktest(const TradingConfig& config
 
 Result<void> TradingOrchestrator::finalizeBacktestResults(BacktestResult& result,
                                                          Portfolio& portfolio,
-                                                         ResultCalculator* result_calculator) const {
+                                                         ResultCalculator* result_calculator,
+                                                         const TradeLedger* trade_ledger) const {
     // Use ResultCalculator to handle all performance calculations
-    result_calculator->finalizeResults(result, portfolio);
+    result_calculator->finalizeResults(result, portfolio, trade_ledger);
     
     return Result<void>(); // Success
 }
 
 // Results processing
 Result<nlohmann::json> TradingOrchestrator::getBacktestResultsAsJson(const BacktestResult& result,
-                                                                    MarketData* market_data,
-                                                                    DataProcessor* data_processor) const {
+                                                                    MarketData* market_data) const {
     try {
         nlohmann::json json_result = JsonHelpers::backTestResultToJson(result);
         
@@ -272,9 +366,8 @@ Result<nlohmann::json> TradingOrchestrator::getBacktestResultsAsJson(const Backt
         const std::string& reference_symbol = result.symbols.empty() ? "AAPL" : result.symbols[0];
         
         // Add equity curve with actual dates from market data
-        return ErrorUtils::chain(market_data->getHistoricalPrices(reference_symbol, result.start_date, result.end_date), 
-            [data_processor, &json_result, &result](const std::vector<std::map<std::string, std::string>>& price_data_raw) {
-                auto price_data = data_processor->convertToTechnicalData(price_data_raw);
+        return ErrorUtils::chain(market_data->getHistoricalPriceData(reference_symbol, result.start_date, result.end_date), 
+            [&json_result, &result](const std::vector<PriceData>& price_data) {
                 json_result["equity_curve"] = JsonHelpers::createEquityCurveJson(result.equity_curve, price_data, result.start_date);
                 return Result<nlohmann::json>(json_result);
             });
@@ -331,6 +424,152 @@ Result<void> TradingOrchestrator::prepareSimulationEnvironment(const TradingConf
 }
 
 // Orchestration utilities
+void TradingOrchestrator::executeRebalanceOrders(const RebalancePlan& plan,
+                                                 const std::string& current_date,
+                                                 size_t session,
+                                                 int32_t day,
+                                                 const TransactionCostModel& costs,
+                                                 BacktestResult& result,
+                                                 Portfolio& portfolio,
+                                                 TradeLedger& trade_ledger,
+                                                 ExecutionJournal& journal,
+                                                 uint64_t& next_order_id) const {
+    for (const auto& order : plan.orders) {
+        const int symbol_index = costs.symbolIndex(order.symbol);
+        const FillEstimate fill = symbol_index < 0 ? FillEstimate{order.shares, order.price, 0.0, 0.0}
+                                                   : costs.estimate(static_cast<size_t>(symbol_index), session,
+                                                                    order.side, order.shares, order.price);
+        const double price = fill.netPrice(order.side);
+        const uint64_t order_id = next_order_id++;
+        const uint32_t symbol_id = static_cast<uint32_t>(std::max(0, symbol_index));
+        journal.append(order_id, symbol_id, day, order.side, OrderKind::MARKET, OrderStatus::PENDING,
+                       order.shares, order.price, JournalReason::REBALANCE);
+        bool executed = false;
+        if (fill.shares <= 0) {
+            executed = false;
+        } else if (order.side == Signal::SELL) {
+            executed = portfolio.sellStock(order.symbol, fill.shares, price);
+            if (executed) {
+                trade_ledger.recordSell(order.symbol, fill.shares, price, current_date);
+            }
+        } else if (order.side == Signal::BUY) {
+            executed = portfolio.buyStock(order.symbol, fill.shares, price);
+            if (executed) {
+                trade_ledger.recordBuy(order.symbol, fill.shares, price, current_date);
+            }
+        }
+        
+        if (!executed) {
+            journal.append(order_id, symbol_id, day, order.side, OrderKind::MARKET, OrderStatus::REJECTED,
+                           fill.shares, price,
+                           fill.shares <= 0 ? JournalReason::PARTICIPATION_CAP : JournalReason::EXECUTION_FAILED);
+            Logger::debug("Rebalance order REJECTED for ", order.symbol, ": ", fill.shares, " shares at $", price);
+            continue;
+        }
+        journal.append(order_id, symbol_id, day, order.side, OrderKind::MARKET, OrderStatus::FILLED,
+                       fill.shares, price, JournalReason::REBALANCE);
+        addFillCosts(result.transaction_costs, fill, order.shares);
+        
+        TradingSignal signal(order.side, price, current_date, "Portfolio rebalance");
+        signal.symbol = order.symbol;
+        result.signals_generated.push_back(signal);
+        result.total_trades++;
+        
+        auto& symbol_perf = result.symbol_performance[order.symbol];
+        symbol_perf.trades_count++;
+        symbol_perf.symbol_signals.push_back(signal);
+        
+        Logger::debug("Rebalance ", (order.side == Signal::BUY ? "BUY" : "SELL"), " executed for ", 
+                     order.symbol, ": ", fill.shares, " shares at $", price);
+    }
+}
+
+void TradingOrchestrator::executeOrderFills(const std::string& symbol,
+                                            size_t symbol_index,
+                                            const std::vector<OrderFill>& fills,
+                                            const std::string& current_date,
+                                            size_t session,
+                                            int32_t day,
+                                            const TransactionCostModel& costs,
+                                            OrderBook& book,
+                                            BacktestResult& result,
+                                            Portfolio& portfolio,
+                                            TradeLedger& trade_ledger,
+                                            ExecutionJournal& journal) const {
+    const uint32_t symbol_id = static_cast<uint32_t>(symbol_index);
+    for (const auto& order_fill : fills) {
+        const RestingOrder& order = order_fill.order;
+        int shares = order.shares;
+        if (order.side == Signal::SELL) {
+            // Sell no more than is held when the order fills
+            shares = std::min(shares, portfolio.hasPosition(symbol) ? portfolio.getPosition(symbol).getShares() : 0);
+        }
+        const FillEstimate fill = costs.estimate(symbol_index, session, order.side, shares, order_fill.fill_price);
+        const double price = fill.netPrice(order.side);
+        const char* kind = order.kind == OrderKind::LIMIT ? "Limit" : "Stop";
+        if (shares > 0 && fill.shares <= 0) {
+            // The participation cap leaves nothing today: the whole order keeps resting under its id
+            book.place(order.side, order.kind, order.price, order.shares, order.placed_date, order.id);
+            journal.append(order.id, symbol_id, day, order.side, order.kind, OrderStatus::PENDING, order.shares,
+                           order.price, JournalReason::PARTICIPATION_CAP);
+            Logger::debug(kind, " order ", order.id, " for ", symbol, " deferred by the participation cap");
+            continue;
+        }
+        // Shares sold since the order was placed: the part no longer held is dropped, not kept resting
+        if (shares < order.shares) {
+            journal.append(order.id, symbol_id, day, order.side, order.kind, OrderStatus::CANCELLED,
+                           order.shares - shares, order.price, JournalReason::INSUFFICIENT_POSITION);
+            if (shares <= 0) {
+                Logger::debug(kind, " order ", order.id, " for ", symbol, " cancelled: no shares held");
+                continue;
+            }
+        }
+        bool executed = false;
+        if (fill.shares <= 0) {
+            executed = false;
+        } else if (order.side == Signal::SELL) {
+            executed = portfolio.sellStock(symbol, fill.shares, price);
+            if (executed) {
+                trade_ledger.recordSell(symbol, fill.shares, price, current_date);
+            }
+        } else {
+            executed = portfolio.buyStock(symbol, fill.shares, price);
+            if (executed) {
+                trade_ledger.recordBuy(symbol, fill.shares, price, current_date);
+            }
+        }
+        
+        if (!executed) {
+            journal.append(order.id, symbol_id, day, order.side, order.kind, OrderStatus::REJECTED, fill.shares,
+                           price, JournalReason::EXECUTION_FAILED);
+            Logger::debug(kind, " order ", order.id, " REJECTED for ", symbol, ": ", fill.shares, " shares at $", price);
+            continue;
+        }
+        journal.append(order.id, symbol_id, day, order.side, order.kind, OrderStatus::FILLED, fill.shares, price,
+                       JournalReason::RESTING_ORDER);
+        addFillCosts(result.transaction_costs, fill, shares);
+        
+        // The part the participation cap held back keeps resting at the same level, under the same id
+        if (fill.shares < shares) {
+            book.place(order.side, order.kind, order.price, shares - fill.shares, order.placed_date, order.id);
+        }
+        
+        TradingSignal signal(order.side, price, current_date, std::string(kind) + " order fill");
+        signal.symbol = symbol;
+        signal.order_kind = order.kind;
+        signal.order_price = order.price;
+        result.signals_generated.push_back(signal);
+        result.total_trades++;
+        
+        auto& symbol_perf = result.symbol_performance[symbol];
+        symbol_perf.trades_count++;
+        symbol_perf.symbol_signals.push_back(signal);
+        
+        Logger::debug(kind, " ", (order.side == Signal::BUY ? "BUY" : "SELL"), " filled for ", symbol, ": ",
+                     fill.shares, " shares at $", price, " (level $", order.price, ", placed ", order.placed_date, ")");
+    }
+}
+
 std::string TradingOrchestrator::createSimulationSummary(const TradingConfig& config,
                                                         const BacktestResult& result) const {
     std::stringstream summary;
@@ -383,12 +622,13 @@ Result<void> TradingOrchestrator::runSimulationLoop(const std::map<std::string,
                                                    PortfolioAllocator* portfolio_allocator,
                                                    DataProcessor* data_processor,
                                                    StrategyManager* strategy_manager,
-                                                   MarketData* market_data) const {
+                                                   MarketData* market_data,
+                                                   ResultCalculator* result_calculator) const {
     Logger::debug("Starting multi-symbol simulation loop with ", multi_symbol_data.size(), " symbols");
     
     // Multi-Symbol Simulation Architecture:
     // 1. Create unified timeline across all symbols (handles different trading calendars)
-    // 2. Build efficient date-to-index mappings for fast data lookups
+    // 2. Build the session calendar and session-to-bar tables for integer-day lookups
     // 3. Process each trading day chronologically across all symbols
     // 4. Evaluate strategy for each symbol individually
     // 5. Execute signals with portfolio-wide risk management
@@ -404,7 +644,36 @@ Result<void> TradingOrchestrator::runSimulationLoop(const std::map<std::string,
         return Result<void>(ErrorCode::ENGINE_NO_DATA_AVAILABLE, "No price data available for any symbol");
     }
     
-    auto symbol_date_indices = data_processor->createDateIndices(multi_symbol_data);
+    // Sessions as integer days; the loop, allocator and metrics work on these instead of date strings
+    auto calendar_result = TradingCalendar::fromTimeline(timeline);
+    if (calendar_result.isError()) {
+        return Result<void>(calendar_result.getError());
+    }
+    if (calendar_result.getValue().sessionCount() != timeline.size()) {
+        return Result<void>(ErrorCode::VALIDATION_INVALID_FORMAT,
+                            "Price data has more than one bar per day; the simulation loop needs daily bars");
+    }
+    auto calendar = std::make_shared<const TradingCalendar>(std::move(calendar_result.getValue()));
+    auto session_indices = data_processor->createSessionIndices(multi_symbol_data, *calendar);
+    
+    // Trailing ADV and volatility arrays for costing fills (empty when fills are free)
+    TransactionCostModel cost_model(config.transaction_costs);
+    cost_model.prepare(multi_symbol_data, session_indices);
+    result.transaction_costs.enabled = cost_model.isEnabled();
+    
+    // Optional order lifecycle journal; symbol ids are positions in multi_symbol_data
+    ExecutionJournal journal;
+    if (!config.journal_path.empty()) {
+        std::vector<std::string> journal_symbols;
+        journal_symbols.reserve(multi_symbol_data.size());
+        for (const auto& entry : multi_symbol_data) {
+            journal_symbols.push_back(entry.first);
+        }
+        auto journal_result = journal.open(config.journal_path, journal_symbols);
+        if (journal_result.isError()) {
+            return journal_result;
+        }
+    }
     
     // Initialize portfolio allocation
     std::vector<std::string> available_symbols;
@@ -417,7 +686,10 @@ Result<void> TradingOrchestrator::runSimulationLoop(const std::map<std::string,
         }
     }
     
-    // Calculate initial portfolio allocation
+    // Calculate initial portfolio allocation; nothing from an earlier run on this engine may carry over
+    portfolio_allocator->resetState();
+    portfolio_allocator->setTradingCalendar(calendar);
+    result_calculator->setTradingCalendar(calendar);
     auto allocation_result = portfolio_allocator->calculateAllocation(
         available_symbols, config.starting_capital, portfolio, initial_prices, config.start_date);
     
@@ -449,9 +721,19 @@ Result<void> TradingOrchestrator::runSimulationLoop(const std::map<std::string,
         portfolio_allocator->setTargetAllocation(allocation.target_weights, config.starting_capital);
     }
     
+    // Sells are sized against the whole portfolio's value. A sleeve's portfolio starts with only
+    // its share of the starting capital, so its value is scaled up by the inverse of that share
+    const double sizing_scale = portfolio.getInitialCapital() > 0.0
+        ? config.starting_capital / portfolio.getInitialCapital() : 1.0;
+    
     // Initialize tracking structures
-    result.equity_curve.reserve(timeline.size());
-    result.equity_curve.push_back(config.starting_capital);
+    // Performance metrics are accumulated per day; the equity curve itself is optional
+    result_calculator->configureRollingMetrics(config.rolling_windows, config.underwater_curve);
+    result_calculator->beginStreaming(config.starting_capital);
+    if (config.retain_equity_curve) {
+        result.equity_curve.reserve(timeline.size() + 1);
+        result.equity_curve.push_back(config.starting_capital);
+    }
     
     std::map<std::string, std::vector<PriceData>> historical_windows;
     std::map<std::string, double> current_prices;
@@ -465,6 +747,9 @@ Result<void> TradingOrchestrator::runSimulationLoop(const std::map<std::string,
     Logger::info("Starting multi-symbol backtest loop with ", timeline.size(), " trading days");
     Logger::debug("Initial portfolio value: $", config.starting_capital);
     
+    // First record of the channel runBacktest opened (no-op without one)
+    progress_service->publishProgress(0, timeline.size(), config.start_date, config.starting_capital, 0);
+    
     // Report simulation start using first symbol for reference
     const auto& first_symbol = config.symbols[0];
     auto simulation_start_result = progress_service->reportSimulationStart(
@@ -473,15 +758,35 @@ Result<void> TradingOrchestrator::runSimulationLoop(const std::map<std::string,
         Logger::debug("Failed to report simulation start: ", simulation_start_result.getErrorMessage());
     }
     
+    // Fills are matched FIFO into round trips as they happen
+    TradeLedger& trade_ledger = execution_service->getTradeLedger();
+    
+    // Resting limit/stop orders, one book per symbol in multi_symbol_data order; market,
+    // resting and rebalance orders share one id sequence so journal events can be joined
+    std::vector<OrderBook> order_books(multi_symbol_data.size());
+    uint64_t next_order_id = 1;
+    
     // Main simulation loop - process each trading day chronologically
+    std::string last_processed_date;
     for (size_t day_idx = 0; day_idx < timeline.size(); ++day_idx) {
         const std::string& current_date = timeline[day_idx];
+        const int32_t current_day = calendar->sessionAt(day_idx);
+        
+        // Stop cleanly between days; everything up to the previous day is kept
+        if (cancellation_token_->isCancelled()) {
+            result.truncated = true;
+            result.truncation_reason = cancellation_token_->getReasonString();
+            result.end_date = last_processed_date.empty() ? config.start_date : last_processed_date;
+            Logger::warning("Simulation truncated (", result.truncation_reason, ") after ", day_idx, " of ",
+                           timeline.size(), " days; last processed date ", result.end_date);
+            break;
+        }
         
         // Progress reporting using ProgressService's internal logic (use first symbol for reference)
         const auto& first_symbol = multi_symbol_data.begin()->first;
-        auto first_symbol_it = symbol_date_indices[first_symbol].find(current_date);
-        if (first_symbol_it != symbol_date_indices[first_symbol].end()) {
-            const auto& reference_data = multi_symbol_data.at(first_symbol)[first_symbol_it->second];
+        const int32_t first_symbol_bar = session_indices[0][day_idx];
+        if (first_symbol_bar >= 0) {
+            const auto& reference_data = multi_symbol_data.begin()->second[first_symbol_bar];
             auto progress_result = progress_service->reportProgress(day_idx, timeline.size(), reference_data, first_symbol, portfolio);
             if (progress_result.isError()) {
                 Logger::debug("Progress reporting failed: ", progress_result.getErrorMessage());
@@ -489,7 +794,7 @@ Result<void> TradingOrchestrator::runSimulationLoop(const std::map<std::string,
         }
         
         // Update current prices and historical data for each symbol using DataProcessor
-        data_processor->updateHistoricalWindows(multi_symbol_data, current_date, symbol_date_indices, 
+        data_processor->updateHistoricalWindows(multi_symbol_data, day_idx, session_indices, 
                                                historical_windows, current_prices);
         
         // Check if we have data today
@@ -506,45 +811,80 @@ Result<void> TradingOrchestrator::runSimulationLoop(const std::map<std::string,
             continue;
         }
         
-        // Evaluate trading strategy for each symbol
-        std::map<std::string, TradingSignal> daily_signals;
+        // One price per symbol per trading day into the allocator's lookback window
+        portfolio_allocator->recordDailyPrices(current_prices);
+        
+        // Evaluate trading strategy for each symbol; signals keep their symbol's index
+        std::vector<std::pair<size_t, TradingSignal>> daily_signals;
         
+        size_t symbol_index = 0;
         for (const auto& [symbol, data] : multi_symbol_data) {
+            const size_t index = symbol_index++;
+            const int32_t bar_index = session_indices[index][day_idx];
             if (historical_windows[symbol].empty()) {
                 continue; // No data yet for this symbol
             }
             
+            // Widen MAE/MFE ranges of open lots with today's bar
+            if (bar_index >= 0) {
+                const auto& bar = data[bar_index];
+                trade_ledger.markBar(symbol, bar.high, bar.low);
+            }
+            
             // Dynamic temporal validation - check if stock is tradeable on current date
             bool is_tradeable_today = true;
-            if (market_data) {
-                auto db_connection = market_data->getDatabaseConnection();
-                if (db_connection) {
-                    auto tradeable_result = db_connection->checkStockTradeable(symbol, current_date);
-                    if (tradeable_result.isSuccess()) {
-                        is_tradeable_today = tradeable_result.getValue();
-                    }
+            if (market_data && market_data->hasDataSource()) {
+                auto tradeable_result = market_data->isStockTradeable(symbol, current_date);
+                if (tradeable_result.isSuccess()) {
+                    is_tradeable_today = tradeable_result.getValue();
                 }
             }
             
             // Handle stocks that are not tradeable today
             if (!is_tradeable_today) {
+                const uint32_t symbol_id = static_cast<uint32_t>(index);
+                order_books[index].forEachOrder([&](const RestingOrder& order) {
+                    journal.append(order.id, symbol_id, current_day, order.side, order.kind, OrderStatus::CANCELLED,
+                                   order.shares, order.price, JournalReason::DELISTING);
+                });
+                order_books[index].clear();
                 // If we have a position in a delisted stock, force sell it
                 if (portfolio.hasPosition(symbol)) {
                     Logger::info("Force selling position in ", symbol, " on ", current_date, " - stock no longer tradeable (delisting)");
                     // Use current market price if available, otherwise use a reasonable default
                     double sell_price = current_prices.count(symbol) ? current_prices[symbol] : 0.01;
-                    portfolio.sellAllStock(symbol, sell_price);
+                    int shares_held = portfolio.getPosition(symbol).getShares();
+                    const uint64_t order_id = next_order_id++;
+                    journal.append(order_id, symbol_id, current_day, Signal::SELL, OrderKind::MARKET,
+                                   OrderStatus::PENDING, shares_held, sell_price, JournalReason::DELISTING);
+                    if (portfolio.sellAllStock(symbol, sell_price)) {
+                        trade_ledger.recordSell(symbol, shares_held, sell_price, current_date);
+                        journal.append(order_id, symbol_id, current_day, Signal::SELL, OrderKind::MARKET,
+                                       OrderStatus::FILLED, shares_held, sell_price, JournalReason::DELISTING);
+                    } else {
+                        journal.append(order_id, symbol_id, current_day, Signal::SELL, OrderKind::MARKET,
+                                       OrderStatus::REJECTED, shares_held, sell_price, JournalReason::EXECUTION_FAILED);
+                    }
                 }
                 // Skip strategy evaluation for non-tradeable stocks
                 Logger::debug("Skipping ", symbol, " on ", current_date, " - not tradeable (before IPO or after delisting)");
                 continue;
             }
             
+            // Orders resting from earlier days fill against today's range before the strategy runs
+            if (bar_index >= 0 && !order_books[index].empty()) {
+                const auto& bar = data[bar_index];
+                executeOrderFills(symbol, index, order_books[index].cross(bar.open, bar.high, bar.low), current_date,
+                                  day_idx, current_day, cost_model, order_books[index], result, portfolio,
+                                  trade_ledger, journal);
+            }
+            
             // Evaluate strategy for this specific symbol
             TradingSignal signal = strategy_manager->getCurrentStrategy()->evaluateSignal(historical_windows[symbol], portfolio, symbol);
+            signal.symbol = symbol;
             
             if (signal.signal != Signal::HOLD) {
-                daily_signals[symbol] = signal;
+                daily_signals.emplace_back(index, signal);
                 Logger::debug("Day ", day_idx, " (", current_date, "): ", symbol, " signal: ", 
                             (signal.signal == Signal::BUY ? "BUY" : "SELL"), 
                             " at $", signal.price, " (confidence: ", signal.confidence, ")");
@@ -552,12 +892,15 @@ Result<void> TradingOrchestrator::runSimulationLoop(const std::map<std::string,
         }
         
         // Execute signals with portfolio allocation and risk management
-        double current_portfolio_value = portfolio.getTotalValue(current_prices);
+        double current_portfolio_value = portfolio.getTotalValue(current_prices) * sizing_scale;
         
-        for (const auto& [symbol, signal] : daily_signals) {
-            // Use portfolio allocator for position sizing
+        for (const auto& [index, signal] : daily_signals) {
+            const std::string& symbol = signal.symbol;
+            const bool resting = signal.order_kind != OrderKind::MARKET;
+            
+            // Use portfolio allocator for position sizing; resting orders are sized at their own price
             auto position_size_result = portfolio_allocator->calculatePositionSize(
-                symbol, portfolio, signal.price, current_portfolio_value, signal.signal);
+                symbol, portfolio, resting ? signal.order_price : signal.price, current_portfolio_value, signal.signal);
             
             if (position_size_result.isError()) {
                 Logger::debug("Position sizing failed for ", symbol, ": ", position_size_result.getErrorMessage());
@@ -571,22 +914,63 @@ Result<void> TradingOrchestrator::runSimulationLoop(const std::map<std::string,
                 continue;
             }
             
+            const uint64_t order_id = next_order_id++;
+            const uint32_t symbol_id = static_cast<uint32_t>(index);
+            const int requested_shares = static_cast<int>(suggested_shares);
+            
+            // Limit and stop orders rest until a later bar reaches them
+            if (resting) {
+                auto place_result = order_books[index].place(signal.signal, signal.order_kind, signal.order_price,
+                                                             requested_shares, current_date, order_id);
+                journal.append(order_id, symbol_id, current_day, signal.signal, signal.order_kind,
+                               place_result.isError() ? OrderStatus::REJECTED : OrderStatus::PENDING,
+                               requested_shares, signal.order_price,
+                               place_result.isError() ? JournalReason::INVALID_ORDER : JournalReason::STRATEGY_SIGNAL);
+                if (place_result.isError()) {
+                    Logger::debug("Order REJECTED for ", symbol, ": ", place_result.getErrorMessage());
+                }
+                continue;
+            }
+            
+            // Cap at the ADV participation limit and price in spread, impact and commission
+            journal.append(order_id, symbol_id, current_day, signal.signal, OrderKind::MARKET, OrderStatus::PENDING,
+                           requested_shares, signal.price, JournalReason::STRATEGY_SIGNAL);
+            const FillEstimate fill = cost_model.estimate(index, day_idx, signal.signal, requested_shares, signal.price);
+            const double fill_price = fill.netPrice(signal.signal);
+            if (fill.shares <= 0) {
+                journal.append(order_id, symbol_id, current_day, signal.signal, OrderKind::MARKET,
+                               OrderStatus::REJECTED, 0, signal.price, JournalReason::PARTICIPATION_CAP);
+                Logger::debug("Participation cap leaves no shares to trade for ", symbol);
+                continue;
+            }
+            
             // Execute the signal with portfolio allocator guidance
             bool execution_success = false;
             
             if (signal.signal == Signal::BUY) {
-                execution_success = portfolio.buyStock(symbol, static_cast<int>(suggested_shares), signal.price);
+                execution_success = portfolio.buyStock(symbol, fill.shares, fill_price);
                 if (execution_success) {
-                    Logger::debug("BUY executed for ", symbol, ": ", suggested_shares, " shares at $", signal.price);
+                    trade_ledger.recordBuy(symbol, fill.shares, fill_price, current_date);
+                    Logger::debug("BUY executed for ", symbol, ": ", fill.shares, " shares at $", fill_price);
                 }
             } else if (signal.signal == Signal::SELL) {
-                execution_success = portfolio.sellStock(symbol, static_cast<int>(suggested_shares), signal.price);
+                execution_success = portfolio.sellStock(symbol, fill.shares, fill_price);
                 if (execution_success) {
-                    Logger::debug("SELL executed for ", symbol, ": ", suggested_shares, " shares at $", signal.price);
+                    trade_ledger.recordSell(symbol, fill.shares, fill_price, current_date);
+                    Logger::debug("SELL executed for ", symbol, ": ", fill.shares, " shares at $", fill_price);
                 }
             }
             
             if (execution_success) {
+                journal.append(order_id, symbol_id, current_day, signal.signal, OrderKind::MARKET,
+                               OrderStatus::FILLED, fill.shares, fill_price, JournalReason::STRATEGY_SIGNAL);
+                // A market order does not rest: whatever the participation cap held back is dropped
+                if (fill.shares < requested_shares) {
+                    journal.append(order_id, symbol_id, current_day, signal.signal, OrderKind::MARKET,
+                                   OrderStatus::CANCELLED, requested_shares - fill.shares, signal.price,
+                                   JournalReason::PARTICIPATION_CAP);
+                }
+                addFillCosts(result.transaction_costs, fill, requested_shares);
                 result.signals_generated.push_back(signal);
                 result.total_trades++;
                 
@@ -597,30 +981,36 @@ Result<void> TradingOrchestrator::runSimulationLoop(const std::map<std::string,
                 
                 Logger::debug("Signal EXECUTED for ", symbol, " with allocation-aware position sizing");
             } else {
+                journal.append(order_id, symbol_id, current_day, signal.signal, OrderKind::MARKET,
+                               OrderStatus::REJECTED, fill.shares, fill_price, JournalReason::EXECUTION_FAILED);
                 Logger::debug("Signal REJECTED for ", symbol, " during execution");
             }
         }
         
-        // Check for rebalancing opportunities
-        if (day_idx % 50 == 0 && portfolio_allocator->shouldRebalance(portfolio, current_prices, current_date)) {
+        // Rebalance held positions towards their targets as a single batch of orders
+        if (portfolio_allocator->getConfig().enable_rebalancing &&
+            portfolio_allocator->shouldRebalance(portfolio, current_prices, current_day)) {
             Logger::debug("Portfolio rebalancing triggered on day ", day_idx);
             
-            auto rebalance_result = portfolio_allocator->calculateRebalancing(
-                portfolio, current_prices, current_portfolio_value);
+            auto rebalance_result = portfolio_allocator->calculateRebalanceOrders(
+                portfolio, current_prices, current_date);
             
             if (rebalance_result.isSuccess()) {
-                const auto& rebalance_allocation = rebalance_result.getValue();
-                Logger::debug("Rebalancing recommendation generated:");
-                for (const auto& [symbol, target_weight] : rebalance_allocation.target_weights) {
-                    Logger::debug("  ", symbol, " target weight: ", target_weight * 100, "%");
-                }
-                // TODO: Actual rebalancing execution would go here
+                executeRebalanceOrders(rebalance_result.getValue(), current_date, day_idx, current_day, cost_model,
+                                       result, portfolio, trade_ledger, journal, next_order_id);
+            } else {
+                Logger::debug("Rebalancing skipped: ", rebalance_result.getErrorMessage());
             }
         }
         
         // Calculate and record portfolio value
         double portfolio_value = portfolio.getTotalValue(current_prices);
-        result.equity_curve.push_back(portfolio_value);
+        result_calculator->recordEquity(portfolio_value, current_day);
+        last_processed_date = current_date;
+        progress_service->publishProgress(day_idx, timeline.size(), current_date, portfolio_value, result.total_trades);
+        if (config.retain_equity_curve) {
+            result.equity_curve.push_back(portfolio_value);
+        }
         
         // Log progress periodically (every 50 days)
         if (day_idx % 50 == 0) {
@@ -630,16 +1020,28 @@ Result<void> TradingOrchestrator::runSimulationLoop(const std::map<std::string,
         }
     }
     
+    result.round_trips = trade_ledger.getRoundTrips();
+    
+    size_t resting_orders = 0;
+    for (const auto& book : order_books) {
+        resting_orders += book.size();
+    }
+    
     Logger::info("Multi-symbol backtest loop completed");
     Logger::info("Total trading days processed: ", timeline.size());
     Logger::info("Total signals generated: ", result.signals_generated.size());
     Logger::info("Total trades executed: ", result.total_trades);
+    Logger::info("Orders still resting at end: ", resting_orders);
+    if (journal.isOpen()) {
+        Logger::info("Execution journal events: ", journal.getRecordCount(), " in ", config.journal_path);
+    }
     Logger::info("Final portfolio positions: ", portfolio.getPositionCount());
     Logger::info("Final cash balance: $", portfolio.getCashBalance());
     
     // Report simulation end
-    if (!result.equity_curve.empty()) {
-        double final_value = result.equity_curve.back();
+    const auto& streaming_metrics = result_calculator->getStreamingMetrics();
+    if (streaming_metrics.hasData()) {
+        double final_value = streaming_metrics.getLastValue();
         double return_pct = ((final_value - config.starting_capital) / config.starting_capital) * 100.0;
         auto simulation_end_result = progress_service->reportSimulationEnd(
             first_symbol, final_value, return_pct, result.total_trades);
@@ -649,4 +1051,262 @@ Result<void> TradingOrchestrator::runSimulationLoop(const std::map<std::string,
     }
     
     return Result<void>(); // Success
-}
\ No newline at end of file
+}
+
+Result<void> TradingOrchestrator::runSleeveParallel(std::map<std::string, std::vector<PriceData>>&& multi_symbol_data,
+                                                   const TradingConfig& config,
+                                                   BacktestResult& result,
+                                                   Portfolio& portfolio,
+                                                   PortfolioAllocator* portfolio_allocator,
+                                                   DataProcessor* data_processor,
+                                                   StrategyManager* strategy_manager,
+                                                   MarketData* market_data,
+                                                   ResultCalculator* result_calculator) const {
+    // Sleeves are only independent when no allocation, journal or progress channel couples the symbols
+    const AllocationConfig allocation_config = portfolio_allocator->getConfig();
+    if (allocation_config.strategy != AllocationStrategy::EQUAL_WEIGHT &&
+        allocation_config.strategy != AllocationStrategy::CUSTOM) {
+        return Result<void>(ErrorCode::VALIDATION_INVALID_INPUT,
+                            "Sleeve-parallel runs need fixed equal or custom allocation weights");
+    }
+    if (!config.journal_path.empty()) {
+        return Result<void>(ErrorCode::VALIDATION_INVALID_INPUT,
+                            "Sleeve-parallel runs cannot write an execution journal");
+    }
+    if (!config.progress_shm_path.empty()) {
+        return Result<void>(ErrorCode::VALIDATION_INVALID_INPUT,
+                            "Sleeve-parallel runs cannot publish to a progress channel");
+    }
+    const std::unique_ptr<TradingStrategy> prototype = strategy_manager->getCurrentStrategy()->clone();
+    if (!prototype) {
+        return Result<void>(ErrorCode::ENGINE_NO_STRATEGY_CONFIGURED,
+                            "Strategy '" + strategy_manager->getCurrentStrategy()->getName() +
+                            "' cannot be copied for a sleeve-parallel run");
+    }
+    if (multi_symbol_data.empty()) {
+        return Result<void>(ErrorCode::ENGINE_NO_DATA_AVAILABLE, "No market data available");
+    }
+    
+    // Sleeve equity curves are merged on the union calendar
+    auto timeline = data_processor->createUnifiedTimeline(multi_symbol_data);
+    if (timeline.empty()) {
+        return Result<void>(ErrorCode::ENGINE_NO_DATA_AVAILABLE, "No price data available for any symbol");
+    }
+    auto calendar_result = TradingCalendar::fromTimeline(timeline);
+    if (calendar_result.isError()) {
+        return Result<void>(calendar_result.getError());
+    }
+    if (calendar_result.getValue().sessionCount() != timeline.size()) {
+        return Result<void>(ErrorCode::VALIDATION_INVALID_FORMAT,
+                            "Price data has more than one bar per day; the simulation loop needs daily bars");
+    }
+    auto calendar = std::make_shared<const TradingCalendar>(std::move(calendar_result.getValue()));
+    
+    // Each symbol's sleeve is its target value at the first prices; the rest stays in cash
+    std::vector<std::string> available_symbols;
+    std::map<std::string, double> initial_prices;
+    for (const auto& [symbol, data] : multi_symbol_data) {
+        if (!data.empty()) {
+            available_symbols.push_back(symbol);
+            initial_prices[symbol] = data[0].close;
+        }
+    }
+    portfolio_allocator->resetState();
+    auto allocation_result = portfolio_allocator->calculateAllocation(
+        available_symbols, config.starting_capital, portfolio, initial_prices, config.start_date);
+    if (allocation_result.isError()) {
+        return Result<void>(allocation_result.getError());
+    }
+    const auto& target_values = allocation_result.getValue().target_values;
+    
+    // Bars move into their sleeves rather than being copied
+    std::vector<Sleeve> sleeves;
+    sleeves.reserve(multi_symbol_data.size());
+    std::vector<size_t> active_sleeves;
+    double idle_cash = config.starting_capital;
+    while (!multi_symbol_data.empty()) {
+        auto node = multi_symbol_data.extract(multi_symbol_data.begin());
+        Sleeve sleeve;
+        auto target_it = target_values.find(node.key());
+        if (target_it != target_values.end() && target_it->second > 0.0 && !node.mapped().empty()) {
+            sleeve.capital = target_it->second;
+            idle_cash -= sleeve.capital;
+            active_sleeves.push_back(sleeves.size());
+        }
+        sleeve.data.insert(std::move(node));
+        sleeves.push_back(std::move(sleeve));
+    }
+    
+    // Worker threads must not share the database connection, so tradability is read here
+    // into one small replay bundle per sleeve, from one listing-window lookup per symbol
+    if (market_data && market_data->hasDataSource()) {
+        for (size_t index : active_sleeves) {
+            auto& sleeve = sleeves[index];
+            const auto& [symbol, bars] = *sleeve.data.begin();
+            auto tradeability = std::make_shared<SimulationBundle>();
+            auto tradeable_result = market_data->recordTradeableDays(symbol, bars, *tradeability);
+            if (tradeable_result.isError()) {
+                // As in the shared loop, a failed check leaves the symbol tradeable
+                Logger::warning("Tradability of ", symbol, " unavailable: ", tradeable_result.getErrorMessage());
+                continue;
+            }
+            sleeve.tradeability = std::move(tradeability);
+        }
+    }
+    
+    auto run_sleeve = [&](Sleeve& sleeve) {
+        const std::string& symbol = sleeve.data.begin()->first;
+        try {
+            // Trades are sized against the whole starting capital, as in the shared loop, while
+            // the sleeve's portfolio holds only its target cash
+            TradingConfig sleeve_config = config;
+            sleeve_config.symbols = {symbol};
+            sleeve_config.retain_equity_curve = true;   // The merge reads every sleeve's curve
+            sleeve_config.rolling_windows.clear();
+            sleeve_config.underwater_curve = false;
+            sleeve_config.sleeve_parallel = false;
+            
+            ExecutionService execution_service;
+            ProgressService progress_service;
+            progress_service.setProgressReporting(false);
+            PortfolioAllocator allocator(allocation_config);
+            DataProcessor sleeve_data_processor;
+            StrategyManager sleeve_strategy_manager;
+            sleeve_strategy_manager.setCurrentStrategy(prototype->clone());
+            ResultCalculator calculator;
+            std::unique_ptr<MarketData> sleeve_market_data;
+            if (sleeve.tradeability) {
+                sleeve_market_data = std::make_unique<MarketData>();
+                sleeve_market_data->setReplayBundle(sleeve.tradeability);
+            }
+            
+            sleeve.status = initializeBacktest(sleeve_config, sleeve.result, sleeve.portfolio, &execution_service);
+            if (sleeve.status.isSuccess()) {
+                sleeve.portfolio = Portfolio(sleeve.capital);
+                sleeve.status = runSimulationLoop(sleeve.data, sleeve_config, sleeve.result, sleeve.portfolio,
+                                                  &execution_service, &progress_service, &allocator,
+                                                  &sleeve_data_processor, &sleeve_strategy_manager,
+                                                  sleeve_market_data.get(), &calculator);
+            }
+        } catch (const std::exception& e) {
+            sleeve.status = Result<void>(ErrorCode::ENGINE_BACKTEST_FAILED, "Sleeve " + symbol + " failed", e.what());
+        }
+    };
+    
+    // Sleeves are claimed one at a time, so a few long histories do not leave threads idle
+    const size_t thread_budget = config.sleeve_threads > 0
+        ? static_cast<size_t>(config.sleeve_threads)
+        : std::max(1u, std::thread::hardware_concurrency());
+    const size_t worker_count = std::min(thread_budget, active_sleeves.size());
+    std::atomic<size_t> next_sleeve{0};
+    auto worker = [&]() {
+        for (size_t i = next_sleeve.fetch_add(1); i < active_sleeves.size(); i = next_sleeve.fetch_add(1)) {
+            run_sleeve(sleeves[active_sleeves[i]]);
+        }
+    };
+    std::vector<std::thread> workers;
+    for (size_t i = 1; i < worker_count; ++i) {
+        workers.emplace_back(worker);
+    }
+    worker();
+    for (auto& thread : workers) {
+        thread.join();
+    }
+    Logger::info("Simulated ", active_sleeves.size(), " sleeves on ", std::max<size_t>(1, worker_count), " threads");
+    
+    for (size_t index : active_sleeves) {
+        if (sleeves[index].status.isError()) {
+            return sleeves[index].status;
+        }
+    }
+    
+    // Merge: each sleeve adds its value changes on the sessions of its bars, so the combined
+    // curve is the idle cash plus every sleeve's last value, carried across days it has no bar
+    const size_t session_count = calendar->sessionCount();
+    std::vector<double> value_change(session_count, 0.0);
+    size_t processed_sessions = session_count;   // Shortened when a sleeve was cut short
+    Portfolio merged_portfolio(std::max(0.0, idle_cash));
+    for (size_t index : active_sleeves) {
+        auto& sleeve = sleeves[index];
+        const auto& [symbol, bars] = *sleeve.data.begin();
+        auto& sleeve_result = sleeve.result;
+        
+        // Equity point k follows the k-th bar with a price; the loop skips bars without one
+        const auto& curve = sleeve_result.equity_curve;
+        size_t point = 1;
+        double previous = sleeve.capital;
+        // A sleeve cut short before recording a point stops the merge before its first bar
+        size_t first_session = session_count;
+        int32_t first_day = 0;
+        if (!bars.empty() && DateTimeUtils::parseIsoDate(bars.front().date, first_day)) {
+            first_session = calendar->sessionsThrough(first_day) - 1;
+        }
+        size_t last_session = 0;
+        for (const auto& bar : bars) {
+            int32_t day = 0;
+            if (point >= curve.size() || bar.close <= 0.0 || !DateTimeUtils::parseIsoDate(bar.date, day)) {
+                continue;
+            }
+            const size_t session = calendar->sessionsThrough(day) - 1;
+            last_session = session;
+            value_change[session] += curve[point] - previous;
+            previous = curve[point++];
+        }
+        if (sleeve_result.truncated) {
+            processed_sessions = std::min(processed_sessions, point > 1 ? last_session + 1 : first_session);
+            result.truncated = true;
+            result.truncation_reason = sleeve_result.truncation_reason;
+        }
+        
+        result.total_trades += sleeve_result.total_trades;
+        result.symbol_performance[symbol] = std::move(sleeve_result.symbol_performance[symbol]);
+        std::move(sleeve_result.signals_generated.begin(), sleeve_result.signals_generated.end(),
+                  std::back_inserter(result.signals_generated));
+        std::move(sleeve_result.round_trips.begin(), sleeve_result.round_trips.end(),
+                  std::back_inserter(result.round_trips));
+        const auto& costs = sleeve_result.transaction_costs;
+        result.transaction_costs.enabled = result.transaction_costs.enabled || costs.enabled;
+        result.transaction_costs.commission += costs.commission;
+        result.transaction_costs.slippage += costs.slippage;
+        result.transaction_costs.capped_orders += costs.capped_orders;
+        result.transaction_costs.capped_shares += costs.capped_shares;
+        
+        merged_portfolio.addCash(sleeve.portfolio.getCashBalance());
+        for (const auto& [held_symbol, position] : sleeve.portfolio.getPositions()) {
+            merged_portfolio.addCash(position.getShares() * position.getAveragePrice());
+            merged_portfolio.buyStock(held_symbol, position.getShares(), position.getAveragePrice());
+        }
+    }
+    
+    // Sleeves finish in any order; the merged history reads in date order
+    std::stable_sort(result.signals_generated.begin(), result.signals_generated.end(),
+                     [](const TradingSignal& a, const TradingSignal& b) { return a.date < b.date; });
+    std::stable_sort(result.round_trips.begin(), result.round_trips.end(),
+                     [](const RoundTrip& a, const RoundTrip& b) { return a.exit_date < b.exit_date; });
+    
+    result_calculator->setTradingCalendar(calendar);
+    result_calculator->configureRollingMetrics(config.rolling_windows, config.underwater_curve);
+    result_calculator->beginStreaming(config.starting_capital);
+    if (config.retain_equity_curve) {
+        result.equity_curve.reserve(processed_sessions + 1);
+        result.equity_curve.push_back(config.starting_capital);
+    }
+    double portfolio_value = config.starting_capital;
+    for (size_t session = 0; session < processed_sessions; ++session) {
+        portfolio_value += value_change[session];
+        result_calculator->recordEquity(portfolio_value, calendar->sessionAt(session));
+        if (config.retain_equity_curve) {
+            result.equity_curve.push_back(portfolio_value);
+        }
+    }
+    if (result.truncated) {
+        result.end_date = processed_sessions > 0 ? timeline[processed_sessions - 1] : config.start_date;
+        Logger::warning("Sleeve-parallel run truncated (", result.truncation_reason, "); merged through ",
+                        result.end_date);
+    }
+    
+    portfolio = std::move(merged_portfolio);
+    Logger::info("Sleeve-parallel backtest merged: ", result.total_trades, " trades, ",
+                 result.round_trips.size(), " round trips");
+    return Result<void>();
+}
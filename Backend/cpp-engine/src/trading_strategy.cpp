@@ -196,6 +196,14 @@ std::string MovingAverageCrossoverStrategy::getDescription() const {
            std::to_string(long_period_) + " day periods";
 }
 
+std::unique_ptr<TradingStrategy> MovingAverageCrossoverStrategy::clone() const {
+    // Indicator caches are not copied; the copy rebuilds them from the bars it is given
+    auto copy = std::make_unique<MovingAverageCrossoverStrategy>(short_period_, long_period_);
+    copy->config_ = config_;
+    copy->strategy_name_ = strategy_name_;
+    return copy;
+}
+
 void MovingAverageCrossoverStrategy::setMovingAveragePeriods(int short_period, int long_period) {
     if (short_period >= long_period || short_period <= 0 || long_period <= 0) {
         throw std::invalid_argument("Invalid moving average periods");
@@ -296,6 +304,13 @@ std::string RSIStrategy::getDescription() const {
            ", overbought=" + std::to_string(overbought_threshold_);
 }
 
+std::unique_ptr<TradingStrategy> RSIStrategy::clone() const {
+    auto copy = std::make_unique<RSIStrategy>(rsi_period_, oversold_threshold_, overbought_threshold_);
+    copy->config_ = config_;
+    copy->strategy_name_ = strategy_name_;
+    return copy;
+}
+
 void RSIStrategy::setRSIParameters(int period, double oversold, double overbought) {
     if (period <= 0 || oversold >= overbought || oversold < 0 || overbought > 100) {
         throw std::invalid_argument("Invalid RSI parameters");
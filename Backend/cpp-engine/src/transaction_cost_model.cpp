@@ -0,0 +1,186 @@
+#include <algorithm>
+#include <cmath>
+
+#include "transaction_cost_model.h"
+
+bool TransactionCostConfig::isEnabled() const {
+    return commission_per_share > 0.0 || commission_pct > 0.0 || min_commission > 0.0 || spread_bps > 0.0 ||
+           impact_coefficient > 0.0 || max_participation_pct > 0.0;
+}
+
+Result<void> TransactionCostConfig::validate() const {
+    const std::pair<const char*, double> non_negative[] = {
+        {"commission_per_share", commission_per_share},
+        {"commission_pct", commission_pct},
+        {"min_commission", min_commission},
+        {"spread_bps", spread_bps},
+        {"impact_coefficient", impact_coefficient},
+        {"max_participation_pct", max_participation_pct},
+    };
+    for (const auto& [name, value] : non_negative) {
+        if (!std::isfinite(value) || value < 0.0) {
+            return Result<void>(ErrorCode::VALIDATION_INVALID_INPUT,
+                                std::string("Transaction cost ") + name + " must be a non-negative number");
+        }
+    }
+    if (max_participation_pct > 100.0) {
+        return Result<void>(ErrorCode::VALIDATION_INVALID_INPUT,
+                            "Transaction cost max_participation_pct cannot exceed 100");
+    }
+    if (adv_window < 1 || volatility_window < 2) {
+        return Result<void>(ErrorCode::VALIDATION_INVALID_INPUT,
+                            "Transaction cost adv_window must be at least 1 and volatility_window at least 2");
+    }
+    return Result<void>();
+}
+
+double FillEstimate::netPrice(Signal side) const {
+    if (shares <= 0) {
+        return price;
+    }
+    const double per_share = commission / shares;
+    return side == Signal::BUY ? price + per_share : price - per_share;
+}
+
+void TransactionCostModel::prepare(const std::map<std::string, std::vector<PriceData>>& multi_symbol_data,
+                                   const std::vector<std::vector<int32_t>>& session_indices) {
+    adv_.clear();
+    volatility_.clear();
+    symbol_indices_.clear();
+    size_t symbol_index = 0;
+    for (const auto& entry : multi_symbol_data) {
+        symbol_indices_[entry.first] = symbol_index++;
+    }
+    if (!isEnabled()) {
+        return;
+    }
+
+    const size_t adv_window = static_cast<size_t>(config_.adv_window);
+    const size_t volatility_window = static_cast<size_t>(config_.volatility_window);
+    adv_.resize(multi_symbol_data.size());
+    volatility_.resize(multi_symbol_data.size());
+
+    // Prefix sums per symbol give every bar's trailing window in O(1)
+    std::vector<double> volume_sum, return_sum, return_square_sum;
+    std::vector<double> bar_adv, bar_volatility;
+    for (const auto& [symbol, data] : multi_symbol_data) {
+        const size_t index = symbol_indices_.at(symbol);
+
+        const size_t bars = data.size();
+        volume_sum.assign(bars + 1, 0.0);
+        return_sum.assign(bars + 1, 0.0);
+        return_square_sum.assign(bars + 1, 0.0);
+        for (size_t i = 0; i < bars; ++i) {
+            // Log return of bar i against bar i - 1 (none for the first bar)
+            double log_return = 0.0;
+            if (i > 0 && data[i].close > 0.0 && data[i - 1].close > 0.0) {
+                log_return = std::log(data[i].close / data[i - 1].close);
+            }
+            volume_sum[i + 1] = volume_sum[i] + static_cast<double>(std::max(0L, data[i].volume));
+            return_sum[i + 1] = return_sum[i] + log_return;
+            return_square_sum[i + 1] = return_square_sum[i] + log_return * log_return;
+        }
+
+        bar_adv.assign(bars, 0.0);
+        bar_volatility.assign(bars, 0.0);
+        for (size_t i = 0; i < bars; ++i) {
+            if (i == 0) {
+                bar_adv[i] = static_cast<double>(std::max(0L, data[0].volume));
+            } else {
+                size_t from = i > adv_window ? i - adv_window : 0;
+                bar_adv[i] = (volume_sum[i] - volume_sum[from]) / static_cast<double>(i - from);
+            }
+
+            // Returns of bars [from, i - 1]; the first bar has none
+            size_t from = std::max<size_t>(1, i > volatility_window ? i - volatility_window : 0);
+            if (i > from + 1) {
+                const double count = static_cast<double>(i - from);
+                const double sum = return_sum[i] - return_sum[from];
+                const double variance = (return_square_sum[i] - return_square_sum[from] - sum * sum / count) / (count - 1.0);
+                bar_volatility[i] = std::sqrt(std::max(0.0, variance));
+            }
+        }
+
+        // Spread over sessions; a session without a bar keeps the symbol's last values
+        const auto& sessions = session_indices[index];
+        auto& adv = adv_[index];
+        auto& volatility = volatility_[index];
+        adv.assign(sessions.size(), 0.0);
+        volatility.assign(sessions.size(), 0.0);
+        int32_t last_bar = -1;
+        for (size_t session = 0; session < sessions.size(); ++session) {
+            if (sessions[session] >= 0) {
+                last_bar = sessions[session];
+            }
+            if (last_bar >= 0) {
+                adv[session] = bar_adv[static_cast<size_t>(last_bar)];
+                volatility[session] = bar_volatility[static_cast<size_t>(last_bar)];
+            }
+        }
+    }
+}
+
+int TransactionCostModel::symbolIndex(const std::string& symbol) const {
+    auto it = symbol_indices_.find(symbol);
+    return it == symbol_indices_.end() ? -1 : static_cast<int>(it->second);
+}
+
+double TransactionCostModel::getAverageDailyVolume(size_t symbol_index, size_t session) const {
+    if (symbol_index >= adv_.size() || session >= adv_[symbol_index].size()) {
+        return 0.0;
+    }
+    return adv_[symbol_index][session];
+}
+
+double TransactionCostModel::getDailyVolatility(size_t symbol_index, size_t session) const {
+    if (symbol_index >= volatility_.size() || session >= volatility_[symbol_index].size()) {
+        return 0.0;
+    }
+    return volatility_[symbol_index][session];
+}
+
+FillEstimate TransactionCostModel::estimate(size_t symbol_index, size_t session, Signal side, int shares,
+                                            double reference_price) const {
+    FillEstimate fill;
+    fill.shares = shares;
+    fill.price = reference_price;
+    if (!isEnabled() || shares <= 0) {
+        return fill;
+    }
+
+    // Without volume history (or with zero volume) the cap and the impact term do not apply
+    const double adv = getAverageDailyVolume(symbol_index, session);
+    if (config_.max_participation_pct > 0.0 && adv > 0.0) {
+        const double cap = std::floor(adv * config_.max_participation_pct / 100.0);
+        fill.shares = static_cast<int>(std::min(static_cast<double>(shares), cap));
+        if (fill.shares <= 0) {
+            fill.shares = 0;
+            return fill;
+        }
+    }
+
+    double cost_fraction = config_.spread_bps / 2.0 / 10000.0;
+    if (config_.impact_coefficient > 0.0 && adv > 0.0) {
+        cost_fraction += config_.impact_coefficient * getDailyVolatility(symbol_index, session) *
+                         std::sqrt(static_cast<double>(fill.shares) / adv);
+    }
+    fill.price = side == Signal::BUY ? reference_price * (1.0 + cost_fraction)
+                                     : reference_price * std::max(0.0, 1.0 - cost_fraction);
+    fill.slippage = std::abs(fill.price - reference_price) * fill.shares;
+
+    const double commission = fill.shares * config_.commission_per_share +
+                              fill.price * fill.shares * config_.commission_pct / 100.0;
+    fill.commission = std::max(config_.min_commission, commission);
+    return fill;
+}
+
+size_t TransactionCostModel::getMemoryUsage() const {
+    size_t usage = sizeof(*this);
+    for (size_t i = 0; i < adv_.size(); ++i) {
+        usage += (adv_[i].capacity() + volatility_[i].capacity()) * sizeof(double);
+    }
+    for (const auto& [symbol, index] : symbol_indices_) {
+        usage += symbol.capacity() + sizeof(index) + 2 * sizeof(void*);
+    }
+    return usage;
+}
@@ -0,0 +1,202 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "data_conversion.h"
+#include "date_time_utils.h"
+#include "technical_indicators.h"
+#include "trading_engine.h"
+
+// Micro-benchmarks for hot conversion paths. Not part of the test run;
+// build with -DBUILD_BENCHMARKS=ON and run ./benchmark_suite [rows].
+
+namespace {
+
+using Row = std::map<std::string, std::string>;
+
+const size_t DEFAULT_ROWS = 10000000;
+const size_t CHUNK_ROWS = 100000;
+const size_t STARTUP_ITERATIONS = 2000;
+
+// Sink so the optimizer cannot drop the measured work
+volatile double g_sink = 0.0;
+
+std::vector<Row> makeRows(size_t count) {
+    std::vector<Row> rows;
+    rows.reserve(count);
+    char buffer[32];
+    for (size_t i = 0; i < count; ++i) {
+        double base = 100.0 + static_cast<double>(i % 997) * 0.25;
+        Row row;
+        std::snprintf(buffer, sizeof(buffer), "%04d-%02d-%02dT00:00:00+00:00",
+                      2000 + static_cast<int>(i % 24), 1 + static_cast<int>(i % 12), 1 + static_cast<int>(i % 28));
+        row["time"] = buffer;
+        row["symbol"] = "AAPL";
+        std::snprintf(buffer, sizeof(buffer), "%.4f", base);
+        row["open"] = buffer;
+        std::snprintf(buffer, sizeof(buffer), "%.4f", base + 1.5);
+        row["high"] = buffer;
+        std::snprintf(buffer, sizeof(buffer), "%.4f", base - 1.25);
+        row["low"] = buffer;
+        std::snprintf(buffer, sizeof(buffer), "%.4f", base + 0.5);
+        row["close"] = buffer;
+        row["volume"] = std::to_string(1000000 + i % 50000);
+        rows.push_back(std::move(row));
+    }
+    return rows;
+}
+
+// The conversion as it was before the from_chars layer: two lookups per field, stod/stol with exceptions
+std::string legacyField(const Row& row, const std::string& field, const std::string& fallback) {
+    auto it = row.find(field);
+    return it != row.end() ? it->second : fallback;
+}
+
+std::vector<PriceData> legacyConvert(const std::vector<Row>& rows) {
+    std::vector<PriceData> data;
+    data.reserve(rows.size());
+    for (const auto& row : rows) {
+        try {
+            PriceData bar;
+            bar.date = legacyField(row, "time", legacyField(row, "date", ""));
+            bar.open = std::stod(legacyField(row, "open", legacyField(row, "open_price", "0")));
+            bar.high = std::stod(legacyField(row, "high", legacyField(row, "high_price", "0")));
+            bar.low = std::stod(legacyField(row, "low", legacyField(row, "low_price", "0")));
+            bar.close = std::stod(legacyField(row, "close", legacyField(row, "close_price", "0")));
+            bar.volume = std::stol(legacyField(row, "volume", "0"));
+            data.push_back(std::move(bar));
+        } catch (const std::exception&) {
+            continue;
+        }
+    }
+    return data;
+}
+
+int32_t legacyDateDays(const std::string& date) {
+    std::tm tm = {};
+    std::stringstream ss(date);
+    ss >> std::get_time(&tm, "%Y-%m-%d");
+    return static_cast<int32_t>(tm.tm_year * 372 + tm.tm_mon * 31 + tm.tm_mday);
+}
+
+template<typename Fn>
+void measure(const std::string& name, size_t rows, Fn&& fn) {
+    auto start = std::chrono::steady_clock::now();
+    fn();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "  " << std::left << std::setw(38) << name << std::right << std::fixed << std::setprecision(3)
+              << std::setw(9) << seconds << " s  " << std::setprecision(1) << std::setw(8)
+              << (static_cast<double>(rows) / seconds / 1e6) << " M rows/s" << std::endl;
+}
+
+// Per-operation latency, for cold-start paths that run once per process
+template<typename Fn>
+void measureLatency(const std::string& name, size_t iterations, Fn&& fn) {
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; ++i) {
+        fn();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "  " << std::left << std::setw(38) << name << std::right << std::fixed << std::setprecision(2)
+              << std::setw(9) << (seconds / static_cast<double>(iterations) * 1e6) << " us/op" << std::endl;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    size_t total_rows = argc > 1 ? static_cast<size_t>(std::strtoull(argv[1], nullptr, 10)) : DEFAULT_ROWS;
+    size_t chunk_rows = std::min(total_rows, CHUNK_ROWS);
+    size_t passes = chunk_rows ? total_rows / chunk_rows : 0;
+    size_t measured_rows = passes * chunk_rows;
+
+    std::cout << "Trading Engine Benchmark Suite" << std::endl;
+
+    // Engine startup: what a `--memory-report` or `--status` process pays
+    // before doing any work, against building every service up front
+    std::cout << "\nEngine startup (" << STARTUP_ITERATIONS << " engines):" << std::endl;
+    measureLatency("TradingEngine + memory report", STARTUP_ITERATIONS, [&]() {
+        TradingEngine engine(10000.0);
+        g_sink = g_sink + static_cast<double>(engine.getMemoryReport().size());
+    });
+    measureLatency("TradingEngine + all services", STARTUP_ITERATIONS, [&]() {
+        TradingEngine engine(10000.0);
+        engine.getMarketData();
+        engine.getExecutionService();
+        engine.getProgressService();
+        engine.getDataProcessor();
+        engine.getResultCalculator();
+        engine.getPortfolioAllocator();
+        engine.getStrategyManager();
+        engine.getTradingOrchestrator();
+        g_sink = g_sink + static_cast<double>(engine.getMemoryReport().size());
+    });
+    measureLatency("TradingEngine + market data query path", STARTUP_ITERATIONS, [&]() {
+        TradingEngine engine(10000.0);
+        g_sink = g_sink + (engine.getMarketData()->getDatabaseConnection() ? 1.0 : 0.0);
+    });
+
+    std::cout << "\nRows: " << measured_rows << " (" << passes << " passes over " << chunk_rows << " rows)" << std::endl;
+    if (measured_rows == 0) {
+        return 0;
+    }
+
+    // One chunk of database-format rows, converted repeatedly to reach the row count
+    const std::vector<Row> rows = makeRows(chunk_rows);
+
+    std::cout << "\nRow conversion (std::map rows to PriceData):" << std::endl;
+    measure("legacy (stod, two lookups per field)", measured_rows, [&]() {
+        for (size_t pass = 0; pass < passes; ++pass) {
+            g_sink = g_sink + legacyConvert(rows).back().close;
+        }
+    });
+    measure("convertToTechnicalData (from_chars)", measured_rows, [&]() {
+        for (size_t pass = 0; pass < passes; ++pass) {
+            g_sink = g_sink + DataConversion::convertToTechnicalData(rows).back().close;
+        }
+    });
+
+    std::cout << "\nNumeric parsing (close column):" << std::endl;
+    measure("std::stod", measured_rows, [&]() {
+        for (size_t pass = 0; pass < passes; ++pass) {
+            for (const auto& row : rows) {
+                g_sink = g_sink + std::stod(row.at("close"));
+            }
+        }
+    });
+    measure("DataConversion::parseDouble", measured_rows, [&]() {
+        double value = 0.0;
+        for (size_t pass = 0; pass < passes; ++pass) {
+            for (const auto& row : rows) {
+                DataConversion::parseDouble(row.at("close"), value);
+                g_sink = g_sink + value;
+            }
+        }
+    });
+
+    std::cout << "\nDate parsing (timestamp column):" << std::endl;
+    measure("std::get_time via stringstream", measured_rows, [&]() {
+        for (size_t pass = 0; pass < passes; ++pass) {
+            for (const auto& row : rows) {
+                g_sink = g_sink + legacyDateDays(row.at("time"));
+            }
+        }
+    });
+    measure("DateTimeUtils::parseIsoDate", measured_rows, [&]() {
+        int32_t days = 0;
+        for (size_t pass = 0; pass < passes; ++pass) {
+            for (const auto& row : rows) {
+                DateTimeUtils::parseIsoDate(row.at("time"), days);
+                g_sink = g_sink + days;
+            }
+        }
+    });
+
+    return 0;
+}
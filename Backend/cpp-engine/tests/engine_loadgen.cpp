@@ -0,0 +1,498 @@
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <dirent.h>
+#include <fcntl.h>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <poll.h>
+#include <signal.h>
+#include <spawn.h>
+#include <string>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+// Load generator: concurrent streams of `trading_engine --simulate --config FILE`
+// processes over a set of template configs, reporting latency percentiles,
+// throughput, failure rates and child peak RSS as JSON. Single-run timings
+// hide database contention, CPU oversubscription and memory pressure; this
+// reproduces them. Compare the JSON of two builds run with the same options.
+//
+//   ./engine_loadgen [options] TEMPLATE...   (files or directories of *.json)
+
+extern char** environ;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+using json = nlohmann::json;
+
+// After SIGTERM the engine prints its partial result; give it this long before SIGKILL
+const int KILL_GRACE_MS = 2000;
+
+struct Options {
+    std::string engine = "./trading_engine";
+    int concurrency = 4;
+    int runs_per_stream = 10;
+    double duration_s = 0.0;   // > 0: streams keep going until the time is up instead of counting runs
+    int64_t timeout_ms = 0;    // 0 = no per-run timeout
+    std::string label;
+    std::string output;        // empty = stdout
+    std::vector<std::string> templates;
+};
+
+struct Template {
+    std::string name;
+    std::string path;
+    std::string contents;
+};
+
+enum class Outcome { SUCCESS, EXIT_CODE, SIGNAL, TIMEOUT, INVALID_OUTPUT, SPAWN_FAILED };
+
+const char* outcomeName(Outcome outcome) {
+    switch (outcome) {
+        case Outcome::SUCCESS: return "success";
+        case Outcome::EXIT_CODE: return "exit_code";
+        case Outcome::SIGNAL: return "signal";
+        case Outcome::TIMEOUT: return "timeout";
+        case Outcome::INVALID_OUTPUT: return "invalid_output";
+        case Outcome::SPAWN_FAILED: return "spawn_failed";
+    }
+    return "unknown";
+}
+
+struct RunRecord {
+    size_t template_index = 0;
+    double latency_ms = 0.0;
+    Outcome outcome = Outcome::SUCCESS;
+    long peak_rss_kb = 0;
+    std::string error;  // Last "Error" line the engine wrote to stderr
+};
+
+void printUsage(const char* program) {
+    std::cerr << "Usage: " << program << " [options] TEMPLATE...\n"
+              << "  TEMPLATE           Config file, or directory whose *.json configs are all used\n"
+              << "  --engine PATH      trading_engine binary (default: ./trading_engine)\n"
+              << "  --concurrency N    Simultaneous streams (default: 4)\n"
+              << "  --runs N           Runs per stream (default: 10)\n"
+              << "  --duration S       Run for S seconds instead of a fixed run count\n"
+              << "  --timeout-ms MS    Stop a run after MS milliseconds and count it as a timeout\n"
+              << "  --label NAME       Recorded in the report, e.g. the build being measured\n"
+              << "  --output FILE      Write the JSON report to FILE instead of stdout" << std::endl;
+}
+
+bool parseOptions(int argc, char** argv, Options& options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--help" || arg == "-h") {
+            return false;
+        }
+        if (arg.compare(0, 2, "--") != 0) {
+            options.templates.push_back(arg);
+            continue;
+        }
+        if (i + 1 >= argc) {
+            std::cerr << "Error: Missing value for " << arg << std::endl;
+            return false;
+        }
+        std::string value = argv[++i];
+        char* end = nullptr;
+        if (arg == "--engine") {
+            options.engine = value;
+        } else if (arg == "--concurrency") {
+            options.concurrency = static_cast<int>(std::strtol(value.c_str(), &end, 10));
+        } else if (arg == "--runs") {
+            options.runs_per_stream = static_cast<int>(std::strtol(value.c_str(), &end, 10));
+        } else if (arg == "--duration") {
+            options.duration_s = std::strtod(value.c_str(), &end);
+        } else if (arg == "--timeout-ms") {
+            options.timeout_ms = std::strtoll(value.c_str(), &end, 10);
+        } else if (arg == "--label") {
+            options.label = value;
+        } else if (arg == "--output") {
+            options.output = value;
+        } else {
+            std::cerr << "Error: Unknown option " << arg << std::endl;
+            return false;
+        }
+        if (end && *end != '\0') {
+            std::cerr << "Error: Invalid value for " << arg << ": " << value << std::endl;
+            return false;
+        }
+    }
+    if (options.templates.empty()) {
+        std::cerr << "Error: No template configs given" << std::endl;
+        return false;
+    }
+    if (options.concurrency < 1 || (options.duration_s <= 0.0 && options.runs_per_stream < 1) ||
+        options.timeout_ms < 0) {
+        std::cerr << "Error: --concurrency and --runs must be positive, --timeout-ms non-negative" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// A template is a single simulation config; files such as invalid_configs.json
+// that bundle several test cases are skipped
+bool loadSimulationConfig(const std::string& path, std::string& contents) {
+    std::ifstream file(path);
+    contents.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    json config = json::parse(contents, nullptr, false);
+    return config.is_object() && (config.contains("symbols") || config.contains("symbol"));
+}
+
+std::vector<Template> collectTemplates(const std::vector<std::string>& paths) {
+    std::vector<Template> templates;
+    for (const auto& path : paths) {
+        struct stat info {};
+        if (::stat(path.c_str(), &info) != 0) {
+            std::cerr << "Warning: Cannot read " << path << std::endl;
+            continue;
+        }
+        std::vector<std::string> files;
+        if (S_ISDIR(info.st_mode)) {
+            if (DIR* dir = ::opendir(path.c_str())) {
+                while (dirent* entry = ::readdir(dir)) {
+                    std::string name = entry->d_name;
+                    if (name.size() > 5 && name.compare(name.size() - 5, 5, ".json") == 0) {
+                        files.push_back(path + "/" + name);
+                    }
+                }
+                ::closedir(dir);
+            }
+            std::sort(files.begin(), files.end());
+        } else {
+            files.push_back(path);
+        }
+        for (const auto& file : files) {
+            std::string contents;
+            if (!loadSimulationConfig(file, contents)) {
+                std::cerr << "Skipping " << file << ": not a single simulation config" << std::endl;
+                continue;
+            }
+            std::string name = file.substr(file.find_last_of('/') + 1);
+            if (name.size() > 5 && name.compare(name.size() - 5, 5, ".json") == 0) {
+                name.resize(name.size() - 5);
+            }
+            templates.push_back({name, file, contents});
+        }
+    }
+    return templates;
+}
+
+double millisecondsSince(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+RunRecord runEngine(const Options& options, const std::string& config_path) {
+    RunRecord record;
+    const auto start = Clock::now();
+
+    // Close-on-exec, so concurrently spawned children never hold each other's pipes open
+    int out_pipe[2];
+    int err_pipe[2];
+    if (::pipe2(out_pipe, O_CLOEXEC) != 0) {
+        record.outcome = Outcome::SPAWN_FAILED;
+        record.error = std::strerror(errno);
+        return record;
+    }
+    if (::pipe2(err_pipe, O_CLOEXEC) != 0) {
+        record.outcome = Outcome::SPAWN_FAILED;
+        record.error = std::strerror(errno);
+        ::close(out_pipe[0]);
+        ::close(out_pipe[1]);
+        return record;
+    }
+
+    posix_spawn_file_actions_t actions;
+    posix_spawn_file_actions_init(&actions);
+    posix_spawn_file_actions_adddup2(&actions, out_pipe[1], STDOUT_FILENO);
+    posix_spawn_file_actions_adddup2(&actions, err_pipe[1], STDERR_FILENO);
+
+    std::vector<std::string> args = {options.engine, "--simulate", "--config", config_path};
+    std::vector<char*> argv;
+    for (auto& arg : args) {
+        argv.push_back(&arg[0]);
+    }
+    argv.push_back(nullptr);
+
+    pid_t pid = 0;
+    int spawn_error = ::posix_spawn(&pid, options.engine.c_str(), &actions, nullptr, argv.data(), environ);
+    posix_spawn_file_actions_destroy(&actions);
+    ::close(out_pipe[1]);
+    ::close(err_pipe[1]);
+    if (spawn_error != 0) {
+        ::close(out_pipe[0]);
+        ::close(err_pipe[0]);
+        record.outcome = Outcome::SPAWN_FAILED;
+        record.error = std::strerror(spawn_error);
+        return record;
+    }
+
+    // Drain both pipes until the child closes them; stderr carries progress lines we only scan for errors
+    std::string output;
+    std::string error_line;
+    std::string pending_error;
+    bool timed_out = false;
+    bool killed = false;
+    pollfd fds[2] = {{out_pipe[0], POLLIN, 0}, {err_pipe[0], POLLIN, 0}};
+    int open_fds = 2;
+    char buffer[65536];
+    while (open_fds > 0) {
+        int wait_ms = -1;
+        if (options.timeout_ms > 0) {
+            double limit = static_cast<double>(options.timeout_ms) + (timed_out ? KILL_GRACE_MS : 0);
+            wait_ms = std::max(0, static_cast<int>(limit - millisecondsSince(start)));
+        }
+        int ready = ::poll(fds, 2, wait_ms);
+        if (ready < 0 && errno == EINTR) {
+            continue;
+        }
+        if (ready == 0) {
+            if (!timed_out) {
+                timed_out = true;
+                ::kill(pid, SIGTERM);
+            } else if (!killed) {
+                killed = true;
+                ::kill(pid, SIGKILL);
+            }
+            continue;
+        }
+        for (auto& fd : fds) {
+            if (fd.fd < 0 || !(fd.revents & (POLLIN | POLLHUP | POLLERR))) {
+                continue;
+            }
+            ssize_t count = ::read(fd.fd, buffer, sizeof(buffer));
+            if (count <= 0) {
+                ::close(fd.fd);
+                fd.fd = -1;
+                --open_fds;
+                continue;
+            }
+            if (fd.fd == out_pipe[0]) {
+                output.append(buffer, static_cast<size_t>(count));
+                continue;
+            }
+            pending_error.append(buffer, static_cast<size_t>(count));
+            size_t newline;
+            while ((newline = pending_error.find('\n')) != std::string::npos) {
+                if (pending_error.compare(0, 5, "Error") == 0 || pending_error.compare(0, 10, "Unexpected") == 0) {
+                    error_line = pending_error.substr(0, newline);
+                }
+                pending_error.erase(0, newline + 1);
+            }
+        }
+    }
+
+    int status = 0;
+    rusage usage {};
+    while (::wait4(pid, &status, 0, &usage) < 0 && errno == EINTR) {
+    }
+    record.latency_ms = millisecondsSince(start);
+    record.peak_rss_kb = usage.ru_maxrss;
+    record.error = error_line;
+
+    if (timed_out) {
+        record.outcome = Outcome::TIMEOUT;
+    } else if (WIFSIGNALED(status)) {
+        record.outcome = Outcome::SIGNAL;
+        record.error = "signal " + std::to_string(WTERMSIG(status));
+    } else if (WEXITSTATUS(status) != 0) {
+        record.outcome = Outcome::EXIT_CODE;
+        if (record.error.empty()) {
+            record.error = "exit code " + std::to_string(WEXITSTATUS(status));
+        }
+    } else if (!json::accept(output)) {
+        record.outcome = Outcome::INVALID_OUTPUT;
+        record.error = "stdout is not a JSON result";
+    }
+    return record;
+}
+
+RunRecord runOnce(const Options& options, const Template& config, size_t template_index) {
+    RunRecord record;
+    record.template_index = template_index;
+    // The engine deletes its config file after the run (unless "cleanup" is false),
+    // so every run gets its own copy, as the API does with its temporary configs
+    char config_path[] = "/tmp/engine_loadgen_XXXXXX.json";
+    int config_fd = ::mkstemps(config_path, 5);
+    if (config_fd < 0 ||
+        ::write(config_fd, config.contents.data(), config.contents.size()) != static_cast<ssize_t>(config.contents.size())) {
+        record.outcome = Outcome::SPAWN_FAILED;
+        record.error = std::string("cannot write config copy: ") + std::strerror(errno);
+        if (config_fd >= 0) {
+            ::close(config_fd);
+            ::unlink(config_path);
+        }
+        return record;
+    }
+    ::close(config_fd);
+    record = runEngine(options, config_path);
+    record.template_index = template_index;
+    ::unlink(config_path);
+    return record;
+}
+
+// Nearest-rank percentile of an ascending series
+double percentile(const std::vector<double>& sorted, double pct) {
+    if (sorted.empty()) {
+        return 0.0;
+    }
+    size_t rank = static_cast<size_t>(std::ceil(pct / 100.0 * static_cast<double>(sorted.size())));
+    return sorted[std::min(sorted.size(), std::max<size_t>(rank, 1)) - 1];
+}
+
+json latencySummary(std::vector<double> values) {
+    std::sort(values.begin(), values.end());
+    json summary;
+    summary["count"] = values.size();
+    if (values.empty()) {
+        return summary;
+    }
+    double total = 0.0;
+    for (double value : values) {
+        total += value;
+    }
+    summary["min"] = values.front();
+    summary["mean"] = total / static_cast<double>(values.size());
+    summary["p50"] = percentile(values, 50.0);
+    summary["p95"] = percentile(values, 95.0);
+    summary["p99"] = percentile(values, 99.0);
+    summary["max"] = values.back();
+    return summary;
+}
+
+json buildReport(const Options& options, const std::vector<Template>& templates,
+                 const std::vector<RunRecord>& records, double wall_s) {
+    std::vector<double> latencies;
+    std::vector<double> rss;
+    std::map<std::string, size_t> failures;
+    std::map<std::string, size_t> errors;
+    std::vector<std::vector<double>> template_latencies(templates.size());
+    std::vector<size_t> template_runs(templates.size(), 0);
+    std::vector<size_t> template_failures(templates.size(), 0);
+
+    for (const auto& record : records) {
+        ++template_runs[record.template_index];
+        if (record.outcome == Outcome::SUCCESS) {
+            latencies.push_back(record.latency_ms);
+            template_latencies[record.template_index].push_back(record.latency_ms);
+        } else {
+            ++failures[outcomeName(record.outcome)];
+            ++template_failures[record.template_index];
+            if (!record.error.empty()) {
+                ++errors[record.error];
+            }
+        }
+        if (record.peak_rss_kb > 0) {
+            rss.push_back(static_cast<double>(record.peak_rss_kb));
+        }
+    }
+
+    const size_t succeeded = latencies.size();
+    json report;
+    report["type"] = "loadgen";
+    report["label"] = options.label;
+    report["engine"] = options.engine;
+    report["concurrency"] = options.concurrency;
+    report["runs_per_stream"] = options.duration_s > 0.0 ? json(nullptr) : json(options.runs_per_stream);
+    report["duration_s"] = options.duration_s > 0.0 ? json(options.duration_s) : json(nullptr);
+    report["timeout_ms"] = options.timeout_ms;
+    report["hardware_threads"] = std::thread::hardware_concurrency();
+    report["wall_time_s"] = wall_s;
+    report["runs"] = records.size();
+    report["succeeded"] = succeeded;
+    report["failed"] = records.size() - succeeded;
+    report["failure_rate"] = records.empty() ? 0.0 : static_cast<double>(records.size() - succeeded) / records.size();
+    report["throughput_runs_per_s"] = wall_s > 0.0 ? static_cast<double>(records.size()) / wall_s : 0.0;
+    report["goodput_runs_per_s"] = wall_s > 0.0 ? static_cast<double>(succeeded) / wall_s : 0.0;
+    // Latency percentiles cover successful runs only; failures are usually fast and would flatter them
+    report["latency_ms"] = latencySummary(latencies);
+    json rss_summary = latencySummary(rss);
+    rss_summary.erase("mean");
+    report["child_peak_rss_kb"] = rss_summary;
+    report["failures"] = failures;
+    report["errors"] = errors;
+
+    report["templates"] = json::array();
+    for (size_t i = 0; i < templates.size(); ++i) {
+        json entry;
+        entry["name"] = templates[i].name;
+        entry["path"] = templates[i].path;
+        entry["runs"] = template_runs[i];
+        entry["failed"] = template_failures[i];
+        entry["latency_ms"] = latencySummary(template_latencies[i]);
+        report["templates"].push_back(entry);
+    }
+    return report;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        printUsage(argv[0]);
+        return 2;
+    }
+    if (::access(options.engine.c_str(), X_OK) != 0) {
+        std::cerr << "Error: Engine binary not executable: " << options.engine << std::endl;
+        return 2;
+    }
+    const std::vector<Template> templates = collectTemplates(options.templates);
+    if (templates.empty()) {
+        std::cerr << "Error: No usable template configs" << std::endl;
+        return 2;
+    }
+
+    // Each stream runs its engine processes back to back, starting at a different template
+    std::vector<std::vector<RunRecord>> stream_records(static_cast<size_t>(options.concurrency));
+    const auto epoch = Clock::now();
+    std::vector<std::thread> streams;
+    for (int s = 0; s < options.concurrency; ++s) {
+        streams.emplace_back([&, s]() {
+            auto& records = stream_records[static_cast<size_t>(s)];
+            for (size_t i = 0;; ++i) {
+                if (options.duration_s > 0.0 ? millisecondsSince(epoch) >= options.duration_s * 1000.0
+                                             : i >= static_cast<size_t>(options.runs_per_stream)) {
+                    break;
+                }
+                size_t index = (static_cast<size_t>(s) + i) % templates.size();
+                records.push_back(runOnce(options, templates[index], index));
+            }
+        });
+    }
+    for (auto& stream : streams) {
+        stream.join();
+    }
+    const double wall_s = millisecondsSince(epoch) / 1000.0;
+
+    std::vector<RunRecord> records;
+    for (auto& stream : stream_records) {
+        records.insert(records.end(), stream.begin(), stream.end());
+    }
+    const std::string report = buildReport(options, templates, records, wall_s).dump(2);
+
+    if (options.output.empty()) {
+        std::cout << report << std::endl;
+    } else {
+        std::ofstream file(options.output);
+        if (!(file << report << std::endl)) {
+            std::cerr << "Error: Cannot write " << options.output << std::endl;
+            return 1;
+        }
+        std::cerr << "Wrote " << records.size() << " runs to " << options.output << std::endl;
+    }
+    return 0;
+}
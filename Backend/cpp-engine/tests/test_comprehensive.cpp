@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <iostream>
 #include <cmath>
 #include <vector>
@@ -7,8 +8,14 @@
 #include <atomic>
 #include <chrono>
 #include <map>
+#include <tuple>
 #include <sstream>
+#include <fstream>
+#include <iterator>
 #include <streambuf>
+#include <csignal>
+#include <cstdio>
+#include <unistd.h>
 
 // Core infrastructure includes
 #include "position.h"
@@ -17,18 +24,42 @@
 #include "result.h"
 #include "trading_exceptions.h"
 #include "error_utils.h"
+#include "date_time_utils.h"
 
 // Database layer includes
+#include "async_query_executor.h"
 #include "database_connection.h"
+#include "market_catalog.h"
 #include "market_data.h"
+#include "order_book.h"
 
 // Business logic layer includes
 #include "technical_indicators.h"
 #include "trading_strategy.h"
+#include "cancellation_token.h"
+#include "covariance_matrix.h"
+#include "data_conversion.h"
+#include "data_processor.h"
+#include "execution_journal.h"
 #include "execution_service.h"
+#include "json_helpers.h"
+#include "portfolio_allocator.h"
+#include "progress_channel.h"
 #include "progress_service.h"
+#include "query_cursor.h"
+#include "result_calculator.h"
+#include "result_file.h"
+#include "ring_buffer.h"
+#include "scaling_benchmark.h"
+#include "simulation_bundle.h"
+#include "rolling_metrics.h"
+#include "streaming_metrics.h"
+#include "trade_ledger.h"
+#include "trading_calendar.h"
+#include "transaction_cost_model.h"
 
 // Application layer includes
+#include "argument_parser.h"
 #include "trading_engine.h"
 #include "command_dispatcher.h"
 
@@ -1323,8 +1354,2251 @@ void test_multi_symbol_strategy_evaluation() {
     std::cout << "[COMPLETE]" << std::endl;
 }
 
+void test_streaming_metrics() {
+    std::cout << "Testing StreamingMetrics Against Batch Calculations - " << std::flush;
+    
+    ResultCalculator calculator;
+    std::vector<double> equity_curve = {10000.0, 10150.0, 9980.0, 10020.0, 10400.0,
+                                        10100.0, 9800.0, 10250.0, 10250.0, 10610.0};
+    
+    StreamingMetrics metrics;
+    metrics.reset(equity_curve[0]);
+    for (size_t i = 1; i < equity_curve.size(); ++i) {
+        metrics.update(equity_curve[i]);
+    }
+    
+    auto daily_returns = calculator.calculateDailyReturns(equity_curve);
+    ASSERT_EQ(equity_curve.size(), metrics.getObservationCount());
+    ASSERT_EQ(daily_returns.size(), metrics.getReturnCount());
+    ASSERT_NEAR(calculator.calculateSharpeRatio(daily_returns), metrics.getSharpeRatio(), 1e-9);
+    ASSERT_NEAR(calculator.calculateMaxDrawdown(equity_curve), metrics.getMaxDrawdownPct(), 1e-9);
+    
+    auto risk = calculator.calculateRiskMetrics(daily_returns);
+    ASSERT_NEAR(risk.volatility, metrics.getAnnualizedVolatilityPct(), 1e-9);
+    
+    double gains = 0.0, losses = 0.0, downside_sq = 0.0;
+    for (double ret : daily_returns) {
+        if (ret > 0) gains += ret;
+        if (ret < 0) { losses -= ret; downside_sq += ret * ret; }
+    }
+    ASSERT_NEAR(gains / losses, metrics.getProfitFactor(), 1e-12);
+    ASSERT_NEAR(std::sqrt(downside_sq / daily_returns.size()), metrics.getDownsideDeviation(), 1e-12);
+    ASSERT_EQ(10610.0, metrics.getLastValue());
+    ASSERT_NEAR(0.0, metrics.getCurrentDrawdownPct(), 1e-12);
+    
+    // Finalizing without a retained equity curve uses the streamed values
+    calculator.beginStreaming(equity_curve[0]);
+    for (size_t i = 1; i < equity_curve.size(); ++i) {
+        calculator.recordEquity(equity_curve[i]);
+    }
+    
+    BacktestResult streamed;
+    streamed.starting_capital = 10000.0;
+    streamed.start_date = "2023-01-01";
+    streamed.end_date = "2023-01-31";
+    Portfolio portfolio(10000.0);
+    calculator.finalizeResults(streamed, portfolio);
+    
+    BacktestResult batch;
+    batch.starting_capital = 10000.0;
+    batch.start_date = "2023-01-01";
+    batch.end_date = "2023-01-31";
+    batch.equity_curve = {10000.0, 10100.0};
+    ResultCalculator batch_calculator;
+    batch_calculator.finalizeResults(batch, portfolio);
+    
+    ASSERT_EQ(10610.0, streamed.ending_value);
+    ASSERT_NEAR(6.1, streamed.total_return_pct, 1e-9);
+    ASSERT_NEAR(metrics.getSharpeRatio(), streamed.sharpe_ratio, 1e-12);
+    ASSERT_NEAR(metrics.getMaxDrawdownPct(), streamed.max_drawdown, 1e-12);
+    ASSERT_TRUE(streamed.equity_curve.empty());
+    
+    // A retained curve that does not match the stream is replayed instead
+    ASSERT_EQ(10100.0, batch.ending_value);
+    ASSERT_NEAR(0.0, batch.max_drawdown, 1e-12);
+    
+    // Empty accumulator reports neutral values
+    StreamingMetrics empty;
+    ASSERT_FALSE(empty.hasData());
+    ASSERT_EQ(0.0, empty.getSharpeRatio());
+    ASSERT_EQ(0.0, empty.getProfitFactor());
+    
+    std::cout << "[PASS]" << std::endl;
+}
+
+void test_rolling_metrics() {
+    std::cout << "Testing RollingMetrics Against Brute-Force Windows - " << std::flush;
+    
+    // Ring buffer window semantics
+    RingBuffer<int> ring(3);
+    for (int i = 1; i <= 5; ++i) {
+        ring.push_overwrite(i);
+    }
+    ASSERT_EQ(3, ring.size());
+    ASSERT_EQ(3, ring.front());
+    ASSERT_EQ(5, ring.back());
+    RingBuffer<int> growable;
+    for (int i = 0; i < 20; ++i) {
+        growable.push_back(i);
+    }
+    growable.pop_front();
+    ASSERT_EQ(19, growable.size());
+    ASSERT_EQ(1, growable.front());
+    ASSERT_EQ(10, growable[9]);
+    
+    // Deterministic equity path with drawdowns and recoveries
+    std::vector<double> equity_curve;
+    double value = 10000.0;
+    equity_curve.push_back(value);
+    for (int i = 1; i < 300; ++i) {
+        value *= 1.0 + 0.01 * std::sin(i * 0.37) + 0.004 * std::cos(i * 1.3);
+        equity_curve.push_back(value);
+    }
+    
+    const int window = 21;
+    RollingMetrics rolling;
+    rolling.configure({window, 63}, true);
+    rolling.reset(equity_curve[0]);
+    for (size_t i = 1; i < equity_curve.size(); ++i) {
+        rolling.update(equity_curve[i]);
+    }
+    
+    const auto& series = rolling.getSeries();
+    ASSERT_EQ(2, series.size());
+    ASSERT_EQ(equity_curve.size(), series[0].sharpe_ratio.size());
+    ASSERT_EQ(equity_curve.size(), rolling.getUnderwaterCurve().size());
+    ASSERT_TRUE(std::isnan(series[0].volatility[window - 1]));
+    ASSERT_FALSE(std::isnan(series[0].volatility[window]));
+    
+    ResultCalculator calculator;
+    bool all_match = true;
+    double peak = equity_curve[0];
+    for (size_t i = 0; i < equity_curve.size(); ++i) {
+        peak = std::max(peak, equity_curve[i]);
+        if (std::abs((equity_curve[i] / peak - 1.0) * 100.0 - rolling.getUnderwaterCurve()[i]) > 1e-9) {
+            all_match = false;
+        }
+        if (i < static_cast<size_t>(window)) {
+            continue;
+        }
+        std::vector<double> slice(equity_curve.begin() + (i - window), equity_curve.begin() + i + 1);
+        auto returns = calculator.calculateDailyReturns(slice);
+        auto risk = calculator.calculateRiskMetrics(returns);
+        double window_high = *std::max_element(slice.begin(), slice.end());
+        if (std::abs(risk.volatility - series[0].volatility[i]) > 1e-6 ||
+            std::abs(risk.sharpe_ratio - series[0].sharpe_ratio[i]) > 1e-6 ||
+            std::abs((equity_curve[i] / window_high - 1.0) * 100.0 - series[0].drawdown_pct[i]) > 1e-9) {
+            all_match = false;
+        }
+    }
+    ASSERT_TRUE(all_match);
+    
+    // Disabled by default: no series are produced
+    RollingMetrics disabled;
+    disabled.reset(10000.0);
+    disabled.update(10100.0);
+    ASSERT_FALSE(disabled.isEnabled());
+    ASSERT_TRUE(disabled.getSeries().empty());
+    
+    std::cout << "[PASS]" << std::endl;
+}
+
+void test_trade_ledger() {
+    std::cout << "Testing TradeLedger FIFO Round Trips - " << std::flush;
+    
+    TradeLedger ledger;
+    ledger.recordBuy("AAPL", 10, 100.0, "2023-01-02");
+    ledger.markBar("AAPL", 104.0, 97.0);
+    ledger.recordBuy("AAPL", 5, 110.0, "2023-01-03");
+    ledger.markBar("AAPL", 120.0, 108.0);
+    
+    // Sell spans both lots: 10 from the first lot, 2 from the second
+    ledger.recordSell("AAPL", 12, 115.0, "2023-01-04");
+    const auto& trips = ledger.getRoundTrips();
+    ASSERT_EQ(2, trips.size());
+    ASSERT_EQ(10, trips[0].shares);
+    ASSERT_NEAR(150.0, trips[0].pnl, 1e-9);
+    ASSERT_EQ(2, trips[0].holding_bars);
+    ASSERT_EQ(std::string("2023-01-02"), trips[0].entry_date);
+    ASSERT_NEAR(-3.0, trips[0].mae_pct, 1e-9);
+    ASSERT_NEAR(20.0, trips[0].mfe_pct, 1e-9);
+    ASSERT_EQ(2, trips[1].shares);
+    ASSERT_NEAR(10.0, trips[1].pnl, 1e-9);
+    ASSERT_EQ(1, trips[1].holding_bars);
+    ASSERT_EQ(3, ledger.getOpenShares("AAPL"));
+    ASSERT_EQ(1, ledger.getOpenLotCount("AAPL"));
+    
+    // Losing exit on the remaining lot and an unrelated symbol
+    ledger.recordBuy("MSFT", 4, 250.0, "2023-01-03");
+    ledger.recordSell("AAPL", 3, 100.0, "2023-01-05");
+    ledger.recordSell("MSFT", 4, 260.0, "2023-01-05");
+    
+    const auto& stats = ledger.getStatistics();
+    ASSERT_EQ(3, stats.winning_trades);
+    ASSERT_EQ(1, stats.losing_trades);
+    ASSERT_NEAR(200.0, stats.gross_profit, 1e-9);
+    ASSERT_NEAR(30.0, stats.gross_loss, 1e-9);
+    ASSERT_EQ(0, ledger.getOpenShares("AAPL"));
+    ASSERT_EQ(2, ledger.getSymbolStatistics().size());
+    
+    // Selling more than is open only closes what exists
+    ledger.recordSell("AAPL", 5, 120.0, "2023-01-06");
+    ASSERT_EQ(4, ledger.getRoundTrips().size());
+    
+    // Result finalization uses closed round trips for trade statistics
+    BacktestResult result;
+    result.starting_capital = 10000.0;
+    result.addSymbol("AAPL");
+    result.addSymbol("MSFT");
+    result.total_trades = 6;
+    result.equity_curve = {10000.0, 10050.0, 10170.0};
+    result.round_trips = ledger.getRoundTrips();
+    Portfolio portfolio(10000.0);
+    ResultCalculator calculator;
+    calculator.finalizeResults(result, portfolio);
+    
+    ASSERT_EQ(3, result.winning_trades);
+    ASSERT_EQ(1, result.losing_trades);
+    ASSERT_NEAR(75.0, result.win_rate, 1e-9);
+    ASSERT_NEAR(200.0 / 30.0, result.profit_factor, 1e-9);
+    ASSERT_NEAR(200.0 / 3.0, result.average_win, 1e-9);
+    ASSERT_NEAR(30.0, result.average_loss, 1e-9);
+    ASSERT_NEAR(100.0, result.symbol_performance["MSFT"].win_rate, 1e-9);
+    ASSERT_NEAR(4.0, result.symbol_performance["MSFT"].total_return_pct, 1e-9);
+    ASSERT_EQ(2, result.symbol_performance.size());
+    
+    // The ledger path yields the same statistics without scanning
+    BacktestResult ledger_result;
+    ledger_result.starting_capital = 10000.0;
+    ledger_result.equity_curve = result.equity_curve;
+    ResultCalculator ledger_calculator;
+    ledger_calculator.finalizeResults(ledger_result, portfolio, &ledger);
+    ASSERT_NEAR(result.profit_factor, ledger_result.profit_factor, 1e-12);
+    ASSERT_EQ(result.winning_trades, ledger_result.winning_trades);
+    
+    // Signal-only metrics pair fills FIFO per symbol
+    std::vector<TradingSignal> signals = {
+        TradingSignal(Signal::BUY, 100.0, "2023-01-02", "buy"),
+        TradingSignal(Signal::BUY, 120.0, "2023-01-03", "buy"),
+        TradingSignal(Signal::SELL, 110.0, "2023-01-04", "sell"),
+        TradingSignal(Signal::SELL, 115.0, "2023-01-05", "sell")
+    };
+    auto metrics = calculator.calculateMetrics(signals, 1000.0);
+    ASSERT_EQ(4, metrics.total_trades);
+    ASSERT_NEAR(50.0, metrics.win_rate, 1e-9);
+    ASSERT_NEAR(2.0, metrics.profit_factor, 1e-9);
+    ASSERT_NEAR(1005.0, metrics.final_balance, 1e-9);
+    
+    std::cout << "[PASS]" << std::endl;
+}
+
+void test_covariance_matrix() {
+    std::cout << "Testing Covariance Matrix and Risk Parity - " << std::flush;
+    
+    // Deterministic returns for 5 assets; asset 4 is a scaled copy of asset 0
+    const size_t assets = 5;
+    const size_t observations = 90;
+    std::vector<double> returns(observations * assets);
+    for (size_t t = 0; t < observations; ++t) {
+        for (size_t i = 0; i < 4; ++i) {
+            returns[t * assets + i] = 0.01 * (i + 1) * std::sin(0.7 * t + 1.3 * i) + 0.002 * std::cos(0.31 * t * (i + 2));
+        }
+        returns[t * assets + 4] = 2.0 * returns[t * assets + 0];
+    }
+    
+    // Blocked kernel matches the naive two-pass estimator
+    CovarianceMatrix batch = CovarianceMatrix::fromReturns(returns, observations, assets);
+    ASSERT_EQ(assets, batch.size());
+    ASSERT_EQ(observations, batch.getObservationCount());
+    for (size_t i = 0; i < assets; ++i) {
+        for (size_t j = 0; j < assets; ++j) {
+            double mean_i = 0.0, mean_j = 0.0;
+            for (size_t t = 0; t < observations; ++t) {
+                mean_i += returns[t * assets + i];
+                mean_j += returns[t * assets + j];
+            }
+            mean_i /= observations;
+            mean_j /= observations;
+            double expected = 0.0;
+            for (size_t t = 0; t < observations; ++t) {
+                expected += (returns[t * assets + i] - mean_i) * (returns[t * assets + j] - mean_j);
+            }
+            ASSERT_NEAR(expected / observations, batch(i, j), 1e-14);
+        }
+    }
+    ASSERT_NEAR(1.0, batch.correlation(0, 4), 1e-12);
+    ASSERT_NEAR(std::sqrt(batch.variance(1) * 252.0), batch.annualizedVolatility(1), 1e-12);
+    
+    // Rolling window equals the batch estimate over the trailing window
+    const size_t window = 30;
+    RollingCovariance rolling(assets, window);
+    ASSERT_FALSE(rolling.isReady());
+    for (size_t t = 0; t < observations; ++t) {
+        rolling.push(std::vector<double>(returns.begin() + t * assets, returns.begin() + (t + 1) * assets));
+    }
+    ASSERT_TRUE(rolling.isReady());
+    ASSERT_EQ(window, rolling.getObservationCount());
+    std::vector<double> tail(returns.end() - window * assets, returns.end());
+    CovarianceMatrix trailing = CovarianceMatrix::fromReturns(tail, window, assets);
+    CovarianceMatrix incremental = rolling.covariance();
+    for (size_t i = 0; i < assets; ++i) {
+        for (size_t j = 0; j < assets; ++j) {
+            ASSERT_NEAR(trailing(i, j), incremental(i, j), 1e-12);
+        }
+    }
+    
+    // Equal risk contribution: every asset carries the same share of portfolio variance
+    std::vector<double> erc_returns(returns.size() / assets * 4);
+    for (size_t t = 0; t < observations; ++t) {
+        for (size_t i = 0; i < 4; ++i) {
+            erc_returns[t * 4 + i] = returns[t * assets + i];
+        }
+    }
+    CovarianceMatrix erc_matrix = CovarianceMatrix::fromReturns(erc_returns, observations, 4);
+    auto weights = erc_matrix.equalRiskContributionWeights();
+    auto contributions = erc_matrix.riskContributions(weights);
+    double weight_sum = 0.0;
+    for (size_t i = 0; i < 4; ++i) {
+        weight_sum += weights[i];
+        ASSERT_TRUE(weights[i] > 0.0);
+        ASSERT_NEAR(0.25, contributions[i], 1e-6);
+    }
+    ASSERT_NEAR(1.0, weight_sum, 1e-12);
+    ASSERT_TRUE(weights[0] > weights[3]); // Lower volatility receives more weight
+    
+    // Allocator: correlation limit drops the duplicate, risk parity equalizes contributions
+    AllocationConfig config;
+    config.strategy = AllocationStrategy::RISK_PARITY;
+    config.max_position_weight = 1.0;
+    config.min_position_weight = 0.0;
+    config.cash_reserve_pct = 0.0;
+    config.enable_rebalancing = false;
+    config.correlation_limit = 0.95;
+    config.lookback_days = 120;
+    PortfolioAllocator allocator(config);
+    
+    std::vector<std::string> symbols = {"AAA", "BBB", "CCC", "DDD", "EEE"};
+    std::map<std::string, double> prices;
+    for (size_t i = 0; i < assets; ++i) {
+        std::vector<double> history = {100.0};
+        for (size_t t = 0; t < observations; ++t) {
+            history.push_back(history.back() * (1.0 + returns[t * assets + i]));
+        }
+        prices[symbols[i]] = history.back();
+        allocator.updatePriceHistory(symbols[i], history);
+    }
+    
+    Portfolio portfolio(100000.0);
+    auto allocation = allocator.calculateAllocation(symbols, 100000.0, portfolio, prices, "");
+    ASSERT_TRUE(allocation.isSuccess());
+    ASSERT_EQ(1, allocation.getValue().excluded_symbols.size());
+    ASSERT_EQ(std::string("EEE"), allocation.getValue().excluded_symbols[0]);
+    ASSERT_EQ(4, allocation.getValue().target_weights.size());
+    for (size_t i = 0; i < 4; ++i) {
+        ASSERT_NEAR(weights[i], allocation.getValue().target_weights.at(symbols[i]), 1e-6);
+    }
+    
+    // Without enough shared history the correlation filter stays out of the way
+    PortfolioAllocator short_allocator(config);
+    short_allocator.updatePriceHistory("AAA", {100.0, 101.0, 102.0});
+    short_allocator.updatePriceHistory("EEE", {100.0, 101.0, 102.0});
+    auto short_allocation = short_allocator.calculateAllocation({"AAA", "EEE"}, 100000.0, portfolio, prices, "");
+    ASSERT_TRUE(short_allocation.isSuccess());
+    ASSERT_TRUE(short_allocation.getValue().excluded_symbols.empty());
+
+    // Daily recording keeps the rolling covariance in step with a full rebuild, across
+    // window eviction and a day that leaves one symbol unpriced
+    config.lookback_days = 40;
+    PortfolioAllocator daily_allocator(config);
+    PortfolioAllocator rebuilt_allocator(config);
+    std::map<std::string, std::vector<double>> histories;
+    std::map<std::string, double> day_prices;
+    for (size_t i = 0; i < assets; ++i) {
+        day_prices[symbols[i]] = 100.0;
+        histories[symbols[i]].push_back(100.0);
+    }
+    daily_allocator.recordDailyPrices(day_prices);
+    for (size_t t = 0; t < observations; ++t) {
+        for (size_t i = 0; i < assets; ++i) {
+            day_prices[symbols[i]] *= 1.0 + returns[t * assets + i];
+        }
+        std::map<std::string, double> recorded = day_prices;
+        if (t == 70) {
+            recorded["CCC"] = 0.0;
+        }
+        for (const auto& [symbol, price] : recorded) {
+            if (price > 0) histories[symbol].push_back(price);
+        }
+        daily_allocator.recordDailyPrices(recorded);
+        if (t == 30 || t == 60 || t + 1 == observations) {
+            rebuilt_allocator.updatePriceHistory(histories);
+            auto daily = daily_allocator.calculateAllocation(symbols, 100000.0, portfolio, day_prices, "");
+            auto rebuilt = rebuilt_allocator.calculateAllocation(symbols, 100000.0, portfolio, day_prices, "");
+            ASSERT_TRUE(daily.isSuccess());
+            ASSERT_TRUE(rebuilt.isSuccess());
+            ASSERT_EQ(rebuilt.getValue().excluded_symbols.size(), daily.getValue().excluded_symbols.size());
+            for (const auto& [symbol, weight] : rebuilt.getValue().target_weights) {
+                ASSERT_NEAR(weight, daily.getValue().target_weights.at(symbol), 1e-9);
+            }
+        }
+    }
+
+    std::cout << "[PASS]" << std::endl;
+}
+
+void test_batched_rebalancing() {
+    std::cout << "Testing Batched Rebalancing and Price History Window - " << std::flush;
+    
+    AllocationConfig config;
+    config.rebalancing_frequency_days = 30;
+    config.lookback_days = 60;
+    PortfolioAllocator allocator(config);
+    allocator.setTargetAllocation({{"AAA", 0.5}, {"BBB", 0.5}}, 10000.0);
+    
+    Portfolio portfolio(10000.0);
+    ASSERT_TRUE(portfolio.buyStock("AAA", 30, 100.0));
+    ASSERT_TRUE(portfolio.buyStock("BBB", 10, 100.0));
+    std::map<std::string, double> prices = {{"AAA", 100.0}, {"BBB", 100.0}};
+    
+    // Drift is measured within the invested sleeve, but only acted on once per period
+    ASSERT_NEAR(0.25, allocator.calculateAllocationDrift(portfolio, prices), 1e-12);
+    for (int day = 0; day < 29; ++day) {
+        allocator.recordDailyPrices(prices);
+    }
+    ASSERT_FALSE(allocator.shouldRebalance(portfolio, prices, "2023-02-10"));
+    allocator.recordDailyPrices(prices);
+    ASSERT_TRUE(allocator.shouldRebalance(portfolio, prices, "2023-02-13"));
+    
+    // One batch: sells first, then buys, sized to the sleeve targets
+    auto plan_result = allocator.calculateRebalanceOrders(portfolio, prices, "2023-02-13");
+    ASSERT_TRUE(plan_result.isSuccess());
+    const auto& plan = plan_result.getValue();
+    ASSERT_EQ(2, plan.orders.size());
+    ASSERT_EQ(std::string("AAA"), plan.orders[0].symbol);
+    ASSERT_TRUE(plan.orders[0].side == Signal::SELL);
+    ASSERT_EQ(10, plan.orders[0].shares);
+    ASSERT_EQ(std::string("BBB"), plan.orders[1].symbol);
+    ASSERT_TRUE(plan.orders[1].side == Signal::BUY);
+    ASSERT_EQ(10, plan.orders[1].shares);
+    ASSERT_NEAR(4000.0, plan.invested_value, 1e-9);
+    ASSERT_NEAR(0.5, plan.turnover, 1e-12);
+    ASSERT_EQ(std::string("2023-02-13"), allocator.getLastRebalanceDate());
+    
+    for (const auto& order : plan.orders) {
+        bool executed = order.side == Signal::SELL ? portfolio.sellStock(order.symbol, order.shares, order.price)
+                                                   : portfolio.buyStock(order.symbol, order.shares, order.price);
+        ASSERT_TRUE(executed);
+    }
+    ASSERT_EQ(20, portfolio.getPosition("AAA").getShares());
+    ASSERT_EQ(20, portfolio.getPosition("BBB").getShares());
+    ASSERT_NEAR(0.0, allocator.calculateAllocationDrift(portfolio, prices), 1e-12);
+    
+    // The period restarts after a rebalance
+    allocator.recordDailyPrices(prices);
+    ASSERT_FALSE(allocator.shouldRebalance(portfolio, prices, "2023-02-14"));
+    
+    // Daily history is capped at the lookback window; non-positive prices are not recorded
+    for (int day = 0; day < 100; ++day) {
+        allocator.recordDailyPrices({{"AAA", 100.0 + day}, {"BBB", 0.0}});
+    }
+    std::string report = allocator.getMemoryReport();
+    ASSERT_TRUE(report.find("Price history symbols: 2") != std::string::npos);
+    ASSERT_TRUE(report.find("Total price data points: 91") != std::string::npos); // 60 AAA + 31 BBB
+    
+    std::cout << "[PASS]" << std::endl;
+}
+
+void test_allocator_dense_weights() {
+    std::cout << "Testing PortfolioAllocator Dense Weight Adapters - " << std::flush;
+    
+    AllocationConfig config;
+    config.max_position_weight = 0.15;
+    config.cash_reserve_pct = 0.0;
+    PortfolioAllocator allocator(config);
+    
+    // Clipping and renormalisation keep weights and target values consistent
+    std::vector<std::string> symbols = {"AAA", "BBB", "CCC", "DDD", "EEE"};
+    std::map<std::string, double> prices = {{"AAA", 10.0}, {"BBB", 20.0}, {"CCC", 40.0}, {"DDD", 50.0}, {"EEE", 100.0}};
+    Portfolio portfolio(10000.0);
+    auto allocation = allocator.calculateAllocation(symbols, 10000.0, portfolio, prices, "");
+    ASSERT_TRUE(allocation.isSuccess());
+    for (const auto& symbol : symbols) {
+        ASSERT_NEAR(0.2, allocation.getValue().target_weights.at(symbol), 1e-12);
+        ASSERT_NEAR(2000.0, allocation.getValue().target_values.at(symbol), 1e-9);
+    }
+    
+    // Current weights are taken over total value (cash included); empty positions are skipped
+    allocator.setTargetAllocation({{"AAA", 0.5}, {"BBB", 0.5}}, 10000.0);
+    ASSERT_TRUE(portfolio.buyStock("AAA", 100, 10.0));
+    ASSERT_TRUE(portfolio.buyStock("BBB", 50, 20.0));
+    ASSERT_TRUE(portfolio.buyStock("CCC", 10, 40.0));
+    ASSERT_TRUE(portfolio.sellAllStock("CCC", 40.0));
+    auto weights = allocator.getCurrentWeights(portfolio, prices);
+    ASSERT_EQ(2, weights.size());
+    ASSERT_NEAR(0.1, weights.at("AAA"), 1e-12);
+    ASSERT_NEAR(0.1, weights.at("BBB"), 1e-12);
+    ASSERT_NEAR(0.0, allocator.calculateAllocationDrift(portfolio, prices), 1e-12);
+    
+    // Price moves shift the sleeve: AAA 2000 vs BBB 1000
+    prices["AAA"] = 20.0;
+    ASSERT_NEAR(1.0 / 6.0, allocator.calculateAllocationDrift(portfolio, prices), 1e-12);
+    
+    // Position sizing reads the dense targets; unknown symbols fall back to equal weight
+    auto size = allocator.calculatePositionSize("EEE", portfolio, 100.0, 10000.0, Signal::BUY);
+    ASSERT_TRUE(size.isSuccess());
+    ASSERT_NEAR(1.0, size.getValue(), 1e-12);
+    
+    std::cout << "[PASS]" << std::endl;
+}
+
+// Sends SIGUSR1 to its own process on the given bar, as an operator stopping the run would
+class SignallingStrategy : public TradingStrategy {
+public:
+    explicit SignallingStrategy(size_t bar) : TradingStrategy("signalling"), bar_(bar) {}
+    
+    TradingSignal evaluateSignal(const std::vector<PriceData>& price_data, const Portfolio& /*portfolio*/,
+                                 const std::string& /*symbol*/ = "") override {
+        if (price_data.size() == bar_) {
+            std::raise(SIGUSR1);
+        }
+        return TradingSignal();
+    }
+    bool validateConfig() const override { return true; }
+    std::string getDescription() const override { return "Signalling test strategy"; }
+
+private:
+    size_t bar_;
+};
+
+void test_progress_channel() {
+    std::cout << "Testing Shared Memory Progress Channel - " << std::flush;
+    
+    std::string path = "/tmp/test_progress_channel_" + std::to_string(::getpid()) + ".bin";
+    ProgressChannel writer;
+    ASSERT_TRUE(writer.openForWriting(path).isSuccess());
+    writer.publish(3, 250, "2023-01-05", 10123.5, 2);
+    
+    ProgressChannel reader;
+    ASSERT_TRUE(reader.openForReading(path).isSuccess());
+    auto snapshot = reader.read();
+    ASSERT_TRUE(snapshot.isSuccess());
+    ASSERT_EQ(3, snapshot.getValue().day_index);
+    ASSERT_EQ(250, snapshot.getValue().total_days);
+    ASSERT_NEAR(10123.5, snapshot.getValue().equity, 1e-12);
+    ASSERT_EQ(2, snapshot.getValue().trades);
+    ASSERT_EQ(std::string("2023-01-05"), snapshot.getValue().date);
+    ASSERT_TRUE(snapshot.getValue().state == ProgressState::RUNNING);
+    ASSERT_EQ(0, snapshot.getValue().sequence % 2);
+    
+    // Concurrent reader never observes a torn record
+    std::atomic<bool> done{false};
+    std::thread publisher([&]() {
+        for (uint64_t day = 0; day < 20000; ++day) {
+            writer.publish(day, 20000, day % 2 ? "2023-01-02" : "2024-12-31", day * 2.0, static_cast<int64_t>(day));
+        }
+        done = true;
+    });
+    bool consistent = true;
+    while (!done) {
+        auto current = reader.read();
+        if (current.isSuccess()) {
+            const auto& record = current.getValue();
+            const char* expected_date = record.day_index % 2 ? "2023-01-02" : "2024-12-31";
+            if (record.day_index > 3 && (record.equity != record.day_index * 2.0 ||
+                                         record.trades != static_cast<int64_t>(record.day_index) ||
+                                         record.date != expected_date)) {
+                consistent = false;
+            }
+        }
+    }
+    publisher.join();
+    ASSERT_TRUE(consistent);
+    
+    writer.setState(ProgressState::FINISHED);
+    ASSERT_TRUE(reader.read().getValue().state == ProgressState::FINISHED);
+    ASSERT_EQ(19999, reader.read().getValue().day_index);
+    
+    // Files that are not channels are rejected
+    ProgressChannel invalid;
+    ASSERT_TRUE(invalid.openForReading("/nonexistent/progress.bin").isError());
+    
+    // While a channel is open, ProgressService stops emitting JSON lines
+    ProgressService progress_service;
+    int messages = 0;
+    progress_service.setProgressCallback([&messages](const std::string&) { ++messages; });
+    PriceData bar(100.0, 101.0, 99.0, 100.5, 1000, "2023-01-03");
+    Portfolio portfolio(10000.0);
+    ASSERT_TRUE(progress_service.reportProgress(0, 10, bar, "AAPL", portfolio).isSuccess());
+    ASSERT_EQ(1, messages);
+    ASSERT_TRUE(progress_service.openProgressChannel(path).isSuccess());
+    ASSERT_TRUE(progress_service.hasProgressChannel());
+    ASSERT_TRUE(progress_service.reportProgress(1, 10, bar, "AAPL", portfolio).isSuccess());
+    ASSERT_EQ(1, messages);
+    progress_service.publishProgress(1, 10, "2023-01-03", 10050.0, 1);
+    ASSERT_TRUE(reader.read().getValue().trades == 1);
+    progress_service.reportError("boom");
+    ASSERT_TRUE(reader.read().getValue().state == ProgressState::FAILED);
+    progress_service.closeProgressChannel();
+    ASSERT_FALSE(progress_service.hasProgressChannel());
+
+    // A backtest leaves its final state in the channel and closes it on the way out
+    TradingConfig config;
+    config.strategy_name = "ma_crossover";
+    auto bundle = ScalingBenchmark::generateUniverse(2, 1, 7, config);
+    config.progress_shm_path = path;
+    TradingEngine engine(config.starting_capital);
+    engine.getStrategyManager()->setCurrentStrategy(
+        std::move(engine.getStrategyManager()->createStrategyFromConfig(config).getValue()));
+    engine.getMarketData()->setReplayBundle(bundle);
+    auto backtest = engine.getTradingOrchestrator()->runBacktest(
+        config, engine.getPortfolio(), engine.getMarketData(), engine.getExecutionService(),
+        engine.getProgressService(), engine.getPortfolioAllocator(), engine.getDataProcessor(),
+        engine.getStrategyManager(), engine.getResultCalculator());
+    ASSERT_TRUE(backtest.isSuccess());
+    ASSERT_FALSE(engine.getProgressService()->hasProgressChannel());
+    reader.close();
+    ASSERT_TRUE(reader.openForReading(path).isSuccess());
+    ASSERT_TRUE(reader.read().getValue().state == ProgressState::FINISHED);
+    ASSERT_EQ(252, reader.read().getValue().total_days);
+    reader.close();
+    
+    // A run cut short says so, rather than looking finished
+    auto run_backtest = [&](const TradingConfig& run_config) {
+        return engine.getTradingOrchestrator()->runBacktest(
+            run_config, engine.getPortfolio(), engine.getMarketData(), engine.getExecutionService(),
+            engine.getProgressService(), engine.getPortfolioAllocator(), engine.getDataProcessor(),
+            engine.getStrategyManager(), engine.getResultCalculator());
+    };
+    engine.getStrategyManager()->setCurrentStrategy(std::make_unique<SignallingStrategy>(100));
+    CancellationToken::installSignalHandlers();
+    auto cut_short = run_backtest(config);
+    CancellationToken::restoreSignalHandlers();
+    ASSERT_TRUE(cut_short.isSuccess());
+    ASSERT_TRUE(cut_short.getValue().truncated);
+    ASSERT_TRUE(reader.openForReading(path).isSuccess());
+    ASSERT_TRUE(reader.read().getValue().state == ProgressState::TRUNCATED);
+    ASSERT_TRUE(reader.read().getValue().day_index < 252);
+    reader.close();
+    
+    // A run that fails while loading leaves FAILED, not a RUNNING record nobody will update
+    bundle->recordSymbolExists("NOBARS", true);
+    bundle->recordTemporalInfo("NOBARS", {{"symbol", "NOBARS"}, {"ipo_date", config.start_date}, {"delisting_date", ""}});
+    TradingConfig failing = config;
+    failing.symbols = {"NOBARS"};
+    auto failed = run_backtest(failing);
+    ASSERT_TRUE(failed.isError());
+    ASSERT_FALSE(engine.getProgressService()->hasProgressChannel());
+    ASSERT_TRUE(reader.openForReading(path).isSuccess());
+    ASSERT_TRUE(reader.read().getValue().state == ProgressState::FAILED);
+
+    reader.close();
+    writer.close();
+    std::remove(path.c_str());
+    
+    std::cout << "[PASS]" << std::endl;
+}
+
+void test_cancellation_token() {
+    std::cout << "Testing Cancellation Token - " << std::flush;
+    
+    CancellationToken token;
+    ASSERT_FALSE(token.isCancelled());
+    ASSERT_FALSE(token.hasDeadline());
+    ASSERT_EQ(std::string("none"), token.getReasonString());
+    
+    // First reason wins
+    token.cancel();
+    token.cancel(CancellationReason::DEADLINE);
+    ASSERT_TRUE(token.isCancelled());
+    ASSERT_EQ(std::string("cancelled"), token.getReasonString());
+    token.reset();
+    ASSERT_FALSE(token.isCancelled());
+    
+    // Deadline budget expires on the steady clock
+    token.setDeadline(std::chrono::milliseconds(1));
+    ASSERT_TRUE(token.hasDeadline());
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    ASSERT_TRUE(token.isCancelled());
+    ASSERT_TRUE(token.getReason() == CancellationReason::DEADLINE);
+    token.reset();
+    token.setDeadline(std::chrono::milliseconds(60000));
+    ASSERT_FALSE(token.isCancelled());
+    token.setDeadline(std::chrono::milliseconds(0));
+    ASSERT_FALSE(token.hasDeadline());
+    
+    // Signals are picked up by the next poll
+    CancellationToken::installSignalHandlers();
+    std::raise(SIGUSR1);
+    ASSERT_TRUE(token.isCancelled());
+    ASSERT_EQ(std::string("sigusr1"), token.getReasonString());
+    CancellationToken::clearPendingSignal();
+    CancellationToken::restoreSignalHandlers();
+    token.reset();
+    ASSERT_FALSE(token.isCancelled());
+    
+    // A signal stops the run it arrives in, not the next one in the same process
+    TradingConfig config;
+    config.strategy_name = "ma_crossover";
+    auto bundle = ScalingBenchmark::generateUniverse(2, 1, 11, config);
+    TradingEngine engine(config.starting_capital);
+    engine.getStrategyManager()->setCurrentStrategy(
+        std::move(engine.getStrategyManager()->createStrategyFromConfig(config).getValue()));
+    engine.getMarketData()->setReplayBundle(bundle);
+    engine.getProgressService()->setProgressReporting(false);
+    auto run = [&]() {
+        return engine.getTradingOrchestrator()->runBacktest(
+            config, engine.getPortfolio(), engine.getMarketData(), engine.getExecutionService(),
+            engine.getProgressService(), engine.getPortfolioAllocator(), engine.getDataProcessor(),
+            engine.getStrategyManager(), engine.getResultCalculator());
+    };
+    CancellationToken::installSignalHandlers();
+    std::raise(SIGUSR1);
+    auto signalled = run();
+    CancellationToken::restoreSignalHandlers();
+    ASSERT_TRUE(signalled.getErrorCode() == ErrorCode::ENGINE_CANCELLED);
+    auto next = run();
+    ASSERT_TRUE(next.isSuccess());
+    ASSERT_FALSE(next.getValue().truncated);
+    
+    // Loader refuses to start once cancelled
+    DataProcessor processor;
+    token.cancel();
+    auto loaded = processor.loadMultiSymbolData({"AAPL", "MSFT"}, "2023-01-01", "2023-12-31", nullptr, &token);
+    ASSERT_TRUE(loaded.isError());
+    ASSERT_TRUE(loaded.getErrorCode() == ErrorCode::ENGINE_CANCELLED);
+    
+    // Truncated results say so in their JSON
+    BacktestResult result;
+    ASSERT_FALSE(JsonHelpers::backTestResultToJson(result)["truncated"].get<bool>());
+    ASSERT_FALSE(JsonHelpers::backTestResultToJson(result).contains("truncation_reason"));
+    result.truncated = true;
+    result.truncation_reason = CancellationToken::reasonToString(CancellationReason::DEADLINE);
+    auto json = JsonHelpers::backTestResultToJson(result);
+    ASSERT_TRUE(json["truncated"].get<bool>());
+    ASSERT_EQ(std::string("deadline"), json["truncation_reason"].get<std::string>());
+    
+    std::cout << "[PASS]" << std::endl;
+}
+
+void test_parse_config_json() {
+    std::cout << "Testing Config JSON Parsing - " << std::flush;
+    
+    ArgumentParser parser;
+    auto config = parser.parseConfigJson(nlohmann::json{
+        {"symbols", {"MSFT", "GOOG"}},
+        {"start_date", "2022-01-03"},
+        {"starting_capital", 25000.0},
+        {"strategy", "rsi"},
+        {"deadline_ms", 1500},
+        {"strategy_parameters", {{"rsi_period", 10}}}
+    });
+    ASSERT_EQ(2, config.symbols.size());
+    ASSERT_EQ(std::string("MSFT"), config.symbols[0]);
+    ASSERT_EQ(std::string("2022-01-03"), config.start_date);
+    ASSERT_EQ(std::string("2023-12-31"), config.end_date);
+    ASSERT_NEAR(25000.0, config.starting_capital, 1e-12);
+    ASSERT_EQ(std::string("rsi"), config.strategy_name);
+    ASSERT_EQ(1500, config.deadline_ms);
+    ASSERT_EQ(10, config.getIntParameter("rsi_period"));
+    
+    // Single "symbol" key and top-level strategy keys stay supported
+    auto legacy = parser.parseConfigJson(nlohmann::json{{"symbol", "TSLA"}, {"short_ma", 5}});
+    ASSERT_EQ(1, legacy.symbols.size());
+    ASSERT_EQ(std::string("TSLA"), legacy.symbols[0]);
+    ASSERT_EQ(5, legacy.getIntParameter("short_ma"));
+    
+    std::cout << "[PASS]" << std::endl;
+}
+
+void test_result_file() {
+    std::cout << "Testing Memory-Mapped Result File - " << std::flush;
+    
+    BacktestResult result;
+    result.addSymbol("AAPL");
+    result.addSymbol("MSFT");
+    result.starting_capital = 10000.0;
+    result.ending_value = 10250.0;
+    result.equity_curve = {10000.0, 10100.0, 10250.0};
+    RoundTrip trip;
+    trip.symbol = "MSFT";
+    trip.shares = 7;
+    trip.entry_date = "2023-01-03";
+    trip.exit_date = "2023-01-05";
+    trip.entry_price = 240.0;
+    trip.exit_price = 250.0;
+    trip.pnl = 70.0;
+    result.round_trips.push_back(trip);
+    TradingSignal buy(Signal::BUY, 240.0, "2023-01-03", "MA crossover", 0.8);
+    buy.symbol = "MSFT";
+    TradingSignal sell(Signal::SELL, 250.0, "2023-01-05", "MA crossover");
+    sell.symbol = "MSFT";
+    result.signals_generated = {buy, sell};
+    
+    auto json = JsonHelpers::backTestResultToJson(result);
+    json["equity_curve"] = nlohmann::json::array({
+        {{"date", "2023-01-03"}, {"value", 10000.0}},
+        {{"date", "2023-01-04"}, {"value", 10100.0}},
+        {{"date", "2023-01-05"}, {"value", 10250.0}}
+    });
+    
+    std::string path = "/tmp/test_result_file_" + std::to_string(::getpid()) + ".bin";
+    auto written = ResultFile::writeBacktest(path, result, json);
+    ASSERT_TRUE(written.isSuccess());
+    
+    ResultFile file;
+    ASSERT_TRUE(file.open(path).isSuccess());
+    ASSERT_EQ(written.getValue(), file.header().file_size);
+    
+    size_t length = 0;
+    const double* equity = file.column<double>("equity.value", length);
+    ASSERT_TRUE(equity != nullptr);
+    ASSERT_EQ(3, length);
+    ASSERT_NEAR(10250.0, equity[2], 1e-12);
+    ASSERT_EQ(0, reinterpret_cast<uintptr_t>(equity) % 64);
+    const int32_t* dates = file.column<int32_t>("equity.date", length);
+    ASSERT_EQ(20230104, dates[1]);
+    
+    const int32_t* trade_symbol = file.column<int32_t>("trade.symbol", length);
+    ASSERT_EQ(1, length);
+    ASSERT_EQ(1, trade_symbol[0]);
+    ASSERT_EQ(7, file.column<int32_t>("trade.shares", length)[0]);
+    ASSERT_NEAR(70.0, file.column<double>("trade.pnl", length)[0], 1e-12);
+    ASSERT_EQ(20230105, file.column<int32_t>("trade.exit_date", length)[0]);
+    
+    const int32_t* sides = file.column<int32_t>("signal.side", length);
+    ASSERT_EQ(2, length);
+    ASSERT_EQ(1, sides[0]);
+    ASSERT_EQ(-1, sides[1]);
+    ASSERT_EQ(0, file.column<int32_t>("signal.reason", length)[1]);
+    
+    // Wrong type or unknown name gives no view
+    ASSERT_TRUE(file.column<double>("equity.date", length) == nullptr);
+    ASSERT_TRUE(file.column<double>("missing", length) == nullptr);
+    
+    auto metadata = nlohmann::json::parse(file.metadata());
+    ASSERT_NEAR(10250.0, metadata["ending_value"].get<double>(), 1e-12);
+    ASSERT_FALSE(metadata.contains("equity_curve"));
+    ASSERT_FALSE(metadata.contains("round_trips"));
+    ASSERT_EQ(std::string("MSFT"), metadata["symbols"][1].get<std::string>());
+    ASSERT_EQ(std::string("MA crossover"), metadata["signal_reasons"][0].get<std::string>());
+    file.close();
+    
+    // Truncated or foreign files are rejected
+    ASSERT_EQ(0, ::truncate(path.c_str(), 100));
+    ASSERT_TRUE(file.open(path).isError());
+    ASSERT_TRUE(file.open("/nonexistent/result.bin").isError());
+    std::remove(path.c_str());
+    
+    ASSERT_EQ(20231231, DateTimeUtils::dateToYyyymmdd("2023-12-31"));
+    ASSERT_EQ(20231231, DateTimeUtils::dateToYyyymmdd("2023-12-31T00:00:00+00:00"));
+    ASSERT_EQ(0, DateTimeUtils::dateToYyyymmdd("not-a-date"));
+    ASSERT_EQ(0, DateTimeUtils::dateToYyyymmdd("2023-02-30"));
+    
+    // Database runs carry timestamp-format bar dates into every dated column
+    BacktestResult timestamped = result;
+    timestamped.round_trips[0].entry_date = "2023-01-03T00:00:00+00:00";
+    timestamped.round_trips[0].exit_date = "2023-01-05T00:00:00+00:00";
+    timestamped.signals_generated[0].date = "2023-01-03T00:00:00+00:00";
+    timestamped.signals_generated[1].date = "2023-01-05T00:00:00+00:00";
+    auto timestamped_json = JsonHelpers::backTestResultToJson(timestamped);
+    timestamped_json["equity_curve"] = nlohmann::json::array({
+        {{"date", "2023-01-03T00:00:00+00:00"}, {"value", 10000.0}},
+        {{"date", "2023-01-04T00:00:00+00:00"}, {"value", 10100.0}}
+    });
+    ASSERT_TRUE(ResultFile::writeBacktest(path, timestamped, timestamped_json).isSuccess());
+    ASSERT_TRUE(file.open(path).isSuccess());
+    dates = file.column<int32_t>("equity.date", length);
+    ASSERT_EQ(2, length);
+    ASSERT_EQ(20230103, dates[0]);
+    ASSERT_EQ(20230104, dates[1]);
+    ASSERT_EQ(20230103, file.column<int32_t>("trade.entry_date", length)[0]);
+    ASSERT_EQ(20230105, file.column<int32_t>("trade.exit_date", length)[0]);
+    const int32_t* signal_dates = file.column<int32_t>("signal.date", length);
+    ASSERT_EQ(2, length);
+    ASSERT_EQ(20230103, signal_dates[0]);
+    ASSERT_EQ(20230105, signal_dates[1]);
+    file.close();
+    std::remove(path.c_str());
+    
+    std::cout << "[PASS]" << std::endl;
+}
+
+void test_query_cursor() {
+    std::cout << "Testing Typed Query Cursor - " << std::flush;
+    
+    // Binary wire values are big-endian
+    const char int2_value[] = {'\xFF', '\xFE'};
+    const char int4_value[] = {0, 0, 1, 0};
+    const char int8_value[] = {0, 0, 0, 0, 0, 0, 0x30, 0x39};
+    ASSERT_EQ(-2, PgBinary::decodeInt64(PgBinary::INT2_OID, int2_value));
+    ASSERT_EQ(256, PgBinary::decodeInt64(PgBinary::INT4_OID, int4_value));
+    ASSERT_EQ(12345, PgBinary::decodeInt64(PgBinary::INT8_OID, int8_value));
+    
+    const char float8_value[] = {0x3F, '\xF8', 0, 0, 0, 0, 0, 0};
+    const char float4_value[] = {0x3F, '\xC0', 0, 0};
+    ASSERT_NEAR(1.5, PgBinary::decodeDouble(PgBinary::FLOAT8_OID, float8_value), 1e-12);
+    ASSERT_NEAR(1.5, PgBinary::decodeDouble(PgBinary::FLOAT4_OID, float4_value), 1e-12);
+    ASSERT_NEAR(256.0, PgBinary::decodeDouble(PgBinary::INT4_OID, int4_value), 1e-12);
+    
+    // Dates count from 2000-01-01 on the wire, 1970-01-01 once decoded
+    const char date_value[] = {0, 0, 0x20, '\xD1'};
+    ASSERT_EQ(19358, PgBinary::decodeDate(PgBinary::DATE_OID, date_value));
+    const char timestamp_value[] = {0, 0x02, '\x94', 0x33, 0x70, 0x7E, 0x75, 0x40};
+    ASSERT_EQ(1672583405000000LL, PgBinary::decodeTimestamp(PgBinary::TIMESTAMPTZ_OID, timestamp_value));
+    ASSERT_EQ(19358, PgBinary::decodeDate(PgBinary::TIMESTAMPTZ_OID, timestamp_value));
+    
+    ASSERT_EQ(std::string("1970-01-01"), PgBinary::formatDate(0));
+    ASSERT_EQ(std::string("2023-01-01"), PgBinary::formatDate(19358));
+    ASSERT_EQ(std::string("2024-02-29"), PgBinary::formatDate(19782));
+    ASSERT_EQ(std::string("2023-01-01T14:30:05+00:00"), PgBinary::formatTimestamp(1672583405000000LL));
+    ASSERT_EQ(std::string("1969-12-31T23:59:59+00:00"), PgBinary::formatTimestamp(-1000000LL));
+    
+    ASSERT_TRUE(PgBinary::isCompatible(PgBinary::FLOAT8_OID, QueryValueKind::DOUBLE));
+    ASSERT_TRUE(PgBinary::isCompatible(PgBinary::INT8_OID, QueryValueKind::DOUBLE));
+    ASSERT_TRUE(PgBinary::isCompatible(PgBinary::TIMESTAMPTZ_OID, QueryValueKind::DATE));
+    ASSERT_FALSE(PgBinary::isCompatible(PgBinary::FLOAT8_OID, QueryValueKind::INT64));
+    ASSERT_FALSE(PgBinary::isCompatible(PgBinary::TEXT_OID, QueryValueKind::DOUBLE));
+    
+    // Without a connection the cursor fails cleanly instead of touching libpq
+    QueryCursor cursor(nullptr);
+    auto next_result = cursor.next();
+    ASSERT_TRUE(next_result.isError());
+    auto start_result = cursor.start("SELECT 1;", {});
+    ASSERT_TRUE(start_result.isError());
+    ASSERT_TRUE(start_result.getError().code == ErrorCode::DATABASE_CONNECTION_FAILED);
+    ASSERT_TRUE(cursor.column("x", QueryValueKind::TEXT).isError());
+    ASSERT_EQ(0, cursor.columnCount());
+    
+    std::cout << "[PASS]" << std::endl;
+}
+
+void test_price_snapshot() {
+    std::cout << "Testing Latest Price Snapshot - " << std::flush;
+    
+    PriceSnapshot snapshot;
+    snapshot.symbols = {"AAPL", "GOOGL", "MSFT"};
+    snapshot.closes = {190.5, 140.25, 370.0};
+    snapshot.dates = {19722, 19722, 19721};
+    ASSERT_EQ(0, snapshot.indexOf("AAPL"));
+    ASSERT_EQ(2, snapshot.indexOf("MSFT"));
+    ASSERT_EQ(-1, snapshot.indexOf("AMZN"));
+    ASSERT_EQ(-1, snapshot.indexOf("ZZZ"));
+    ASSERT_EQ(-1, snapshot.indexOf(""));
+    
+    // Rows in a locale collation (punctuation ignored, case folded) are put into bytewise order
+    PriceSnapshot collated;
+    collated.symbols = {"BF-A", "BF.B", "BFB", "brk", "BRK-A", "BRK.B"};
+    collated.closes = {1.0, 2.0, 3.0, 4.0, 5.0, 6.0};
+    collated.dates = {1, 2, 3, 4, 5, 6};
+    collated.sortBySymbol();
+    ASSERT_TRUE(std::is_sorted(collated.symbols.begin(), collated.symbols.end()));
+    for (size_t i = 0; i < 6; ++i) {
+        const std::string symbol = std::vector<std::string>{"BF-A", "BF.B", "BFB", "brk", "BRK-A", "BRK.B"}[i];
+        int index = collated.indexOf(symbol);
+        ASSERT_TRUE(index >= 0);
+        ASSERT_TRUE(collated.closes[index] == static_cast<double>(i + 1));
+        ASSERT_EQ(static_cast<int32_t>(i + 1), collated.dates[index]);
+    }
+    ASSERT_EQ(-1, collated.indexOf("BRK"));
+    
+    auto now = std::chrono::steady_clock::now();
+    snapshot.loaded_at = now - std::chrono::milliseconds(100);
+    ASSERT_TRUE(snapshot.isFresh(std::chrono::milliseconds(1000), now));
+    ASSERT_FALSE(snapshot.isFresh(std::chrono::milliseconds(50), now));
+    
+    // Without a database the snapshot fails to load, but an empty request needs no query
+    MarketData market_data(std::unique_ptr<DatabaseConnection>(nullptr));
+    market_data.setSnapshotTtl(std::chrono::milliseconds(10));
+    auto snapshot_result = market_data.getPriceSnapshot();
+    ASSERT_TRUE(snapshot_result.isError());
+    ASSERT_TRUE(snapshot_result.getError().code == ErrorCode::DATABASE_CONNECTION_FAILED);
+    ASSERT_TRUE(market_data.refreshPriceSnapshot().isError());
+    ASSERT_TRUE(market_data.getCurrentPrices().isError());
+    auto empty_result = market_data.getCurrentPrices(std::vector<std::string>{});
+    ASSERT_TRUE(empty_result.isSuccess());
+    ASSERT_TRUE(empty_result.getValue().empty());
+    ASSERT_TRUE(market_data.getCurrentPrices(std::vector<std::string>{"AAPL"}).isError());
+    
+    std::cout << "[PASS]" << std::endl;
+}
+
+void test_market_catalog() {
+    std::cout << "Testing Market Metadata Catalog - " << std::flush;
+    
+    std::vector<SymbolCatalogEntry> entries(3);
+    entries[0].symbol = "MSFT";
+    entries[0].first_date = "2020-01-02";
+    entries[0].last_date = "2023-12-29";
+    entries[0].row_count = 1006;
+    entries[1].symbol = "AAPL";
+    entries[1].first_date = "2021-01-04";
+    entries[1].last_date = "2023-12-29";
+    entries[1].row_count = 753;
+    entries[1].listed = true;
+    entries[1].temporal_info = {{"symbol", "AAPL"}, {"ipo_date", "1980-12-12"}};
+    entries[2].symbol = "LISTEDONLY";
+    entries[2].listed = true;
+    
+    MarketCatalog catalog(std::move(entries), 7);
+    ASSERT_EQ(3u, catalog.size());
+    ASSERT_EQ(7u, catalog.getEpoch());
+    ASSERT_TRUE(catalog.getMemoryUsage() > 0);
+    
+    // Sorted, and only symbols with bars count as available
+    const auto& symbols = catalog.getSymbolsWithPrices();
+    ASSERT_EQ(2u, symbols.size());
+    ASSERT_EQ(std::string("AAPL"), symbols[0]);
+    ASSERT_EQ(std::string("MSFT"), symbols[1]);
+    ASSERT_TRUE(catalog.hasPrices("AAPL"));
+    ASSERT_FALSE(catalog.hasPrices("LISTEDONLY"));
+    ASSERT_FALSE(catalog.hasPrices("NOPE"));
+    ASSERT_TRUE(catalog.find("LISTEDONLY") != nullptr);
+    ASSERT_TRUE(catalog.find("NOPE") == nullptr);
+    ASSERT_EQ(std::string("1980-12-12"), catalog.find("AAPL")->temporal_info.at("ipo_date"));
+    
+    // Covering ranges and disjoint ranges come from the aggregates, partial overlaps do not
+    ASSERT_EQ(753, catalog.countInRange("AAPL", "2021-01-01", "2023-12-31"));
+    ASSERT_EQ(753, catalog.countInRange("AAPL", "2021-01-04", "2023-12-29"));
+    ASSERT_EQ(0, catalog.countInRange("AAPL", "2024-01-01", "2024-06-30"));
+    ASSERT_EQ(0, catalog.countInRange("AAPL", "2019-01-01", "2020-12-31"));
+    ASSERT_EQ(0, catalog.countInRange("NOPE", "2021-01-01", "2023-12-31"));
+    ASSERT_EQ(0, catalog.countInRange("AAPL", "2023-12-31", "2021-01-01"));
+    ASSERT_EQ(-1, catalog.countInRange("AAPL", "2022-01-01", "2022-12-31"));
+    ASSERT_EQ(-1, catalog.countInRange("AAPL", "2021-01-01", "not-a-date"));
+    
+    // Catalog lookups surface the connection error instead of guessing
+    MarketData market_data(std::unique_ptr<DatabaseConnection>(nullptr));
+    ASSERT_TRUE(market_data.getCatalog().isError());
+    ASSERT_TRUE(market_data.symbolExists("AAPL").isError());
+    ASSERT_TRUE(market_data.getAvailableSymbols().isError());
+    ASSERT_TRUE(market_data.getDateRange("AAPL").isError());
+    ASSERT_TRUE(market_data.getStockTemporalInfo("AAPL").isError());
+    market_data.invalidateCatalog();
+    ASSERT_TRUE(market_data.getMemoryReport().find("Market catalog: None") != std::string::npos);
+    
+    // Per-symbol checks never load the catalog, but use one that is already loaded
+    market_data.setCatalog(std::make_shared<const MarketCatalog>(std::move(catalog)));
+    ASSERT_TRUE(market_data.symbolExists("AAPL").getValue());
+    ASSERT_FALSE(market_data.symbolExists("LISTEDONLY").getValue());
+    ASSERT_EQ(std::string("2020-01-02"), market_data.getDateRange("MSFT").getValue().first);
+    ASSERT_EQ(std::string("1980-12-12"), market_data.getStockTemporalInfo("AAPL").getValue().at("ipo_date"));
+    ASSERT_TRUE(market_data.getStockTemporalInfo("MSFT").isError());
+    ASSERT_EQ(753, market_data.getDataPointCount("AAPL", "2021-01-01", "2023-12-31").getValue());
+    ASSERT_TRUE(market_data.getDataPointCount("AAPL", "2022-01-01", "2022-12-31").isError());
+    market_data.invalidateCatalog();
+    ASSERT_TRUE(market_data.symbolExists("AAPL").isError());
+    
+    // Per-day tradability comes from one listing window, with is_stock_tradeable's inclusive bounds
+    std::vector<SymbolCatalogEntry> listings(3);
+    listings[0].symbol = "LATE";
+    listings[0].listed = true;
+    listings[0].temporal_info = {{"symbol", "LATE"}, {"trading_status", "active"},
+                                 {"listing_date", "2024-01-03"}, {"delisting_date", "2024-01-05"}};
+    listings[1].symbol = "HALTED";
+    listings[1].listed = true;
+    listings[1].temporal_info = {{"symbol", "HALTED"}, {"trading_status", "suspended"},
+                                 {"listing_date", ""}, {"delisting_date", ""}};
+    listings[2].symbol = "OPEN";
+    listings[2].listed = true;
+    listings[2].temporal_info = {{"symbol", "OPEN"}, {"trading_status", "active"},
+                                 {"listing_date", ""}, {"delisting_date", ""}};
+    MarketData listed_data(std::unique_ptr<DatabaseConnection>(nullptr));
+    listed_data.setCatalog(std::make_shared<const MarketCatalog>(std::move(listings)));
+    auto capture = std::make_shared<SimulationBundle>();
+    listed_data.setCaptureBundle(capture);
+    std::vector<PriceData> week;
+    for (const char* date : {"2024-01-02", "2024-01-03", "2024-01-04", "2024-01-05T00:00:00+00:00", "2024-01-08"}) {
+        week.emplace_back(10.0, 10.0, 10.0, 10.0, 100, date);
+    }
+    SimulationBundle days;
+    for (const char* symbol : {"LATE", "HALTED", "OPEN", "UNLISTED"}) {
+        ASSERT_TRUE(listed_data.recordTradeableDays(symbol, week, days).isSuccess());
+    }
+    auto tradeable_on = [&](const SimulationBundle& bundle, const char* symbol, size_t bar) {
+        bool tradeable = false;
+        ASSERT_TRUE(bundle.lookupTradeable(symbol, week[bar].date, tradeable));
+        return tradeable;
+    };
+    const bool late_expected[] = {false, true, true, true, false};
+    for (size_t bar = 0; bar < week.size(); ++bar) {
+        ASSERT_EQ(late_expected[bar], tradeable_on(days, "LATE", bar));
+        ASSERT_EQ(late_expected[bar], tradeable_on(*capture, "LATE", bar));
+        ASSERT_FALSE(tradeable_on(days, "HALTED", bar));
+        ASSERT_TRUE(tradeable_on(days, "OPEN", bar));
+        ASSERT_FALSE(tradeable_on(days, "UNLISTED", bar));
+    }
+    
+    // A replay answers with the captured days
+    MarketData replayed;
+    replayed.setReplayBundle(capture);
+    SimulationBundle replayed_days;
+    ASSERT_TRUE(replayed.recordTradeableDays("LATE", week, replayed_days).isSuccess());
+    ASSERT_TRUE(tradeable_on(replayed_days, "LATE", 2));
+    ASSERT_FALSE(tradeable_on(replayed_days, "LATE", 4));
+    
+    std::cout << "[PASS]" << std::endl;
+}
+
+void test_async_query_executor() {
+    std::cout << "Testing Async Query Executor - " << std::flush;
+    
+    // A completed result can be walked like a streamed one
+    QueryCursor empty = QueryCursor::fromResult(PQmakeEmptyPGresult(nullptr, PGRES_TUPLES_OK), QueryResultFormat::BINARY);
+    auto empty_next = empty.next();
+    ASSERT_TRUE(empty_next.isSuccess());
+    ASSERT_FALSE(empty_next.getValue());
+    ASSERT_EQ(0u, empty.getRowsRead());
+    
+    // Nothing listens on port 1: every queued query fails with the connection error, none hangs
+    AsyncQueryExecutor executor("host=127.0.0.1 port=1 dbname=none user=none connect_timeout=2", 2);
+    ASSERT_EQ(2u, executor.getMaxConnections());
+    std::vector<std::future<Result<QueryCursor>>> queries;
+    for (int i = 0; i < 5; ++i) {
+        queries.push_back(executor.submit("SELECT $1::int AS value", {std::to_string(i)}));
+    }
+    for (auto& query : queries) {
+        ASSERT_TRUE(query.wait_for(std::chrono::seconds(10)) == std::future_status::ready);
+        auto result = query.get();
+        ASSERT_TRUE(result.isError());
+        ASSERT_TRUE(result.getError().code == ErrorCode::DATABASE_CONNECTION_FAILED);
+    }
+    ASSERT_EQ(5u, executor.getCompletedCount());
+    
+    // The executor recovers for later submissions, and refuses work after shutdown
+    auto retry = executor.submit("SELECT 1");
+    ASSERT_TRUE(retry.get().isError());
+    executor.shutdown();
+    executor.shutdown();
+    auto refused = executor.submit("SELECT 1");
+    ASSERT_TRUE(refused.wait_for(std::chrono::seconds(0)) == std::future_status::ready);
+    ASSERT_TRUE(refused.get().getError().code == ErrorCode::DATABASE_QUERY_FAILED);
+    
+    // Without a database the market data path stays synchronous and reports the error on get()
+    MarketData market_data(std::unique_ptr<DatabaseConnection>(nullptr));
+    ASSERT_TRUE(market_data.getAsyncExecutor() == nullptr);
+    auto request = market_data.requestHistoricalPriceData("AAPL", "2023-01-01", "2023-01-31");
+    ASSERT_TRUE(request.get().isError());
+    
+    // The pool is sized to the batch under the configured limit, and a limit of 0 keeps loads sequential
+    MarketData unreachable(std::make_unique<DatabaseConnection>("127.0.0.1", "1", "none", "none", "none"));
+    unreachable.reserveAsyncConnections(2);
+    ASSERT_TRUE(unreachable.hasAsyncExecutor());
+    ASSERT_EQ(2u, unreachable.getAsyncExecutor()->getMaxConnections());
+    unreachable.closeAsyncExecutor();
+    ASSERT_FALSE(unreachable.hasAsyncExecutor());
+    unreachable.setAsyncConnectionLimit(3);
+    unreachable.reserveAsyncConnections(100);
+    ASSERT_EQ(3u, unreachable.getAsyncExecutor()->getMaxConnections());
+    unreachable.closeAsyncExecutor();
+    unreachable.setAsyncConnectionLimit(0);
+    ASSERT_TRUE(unreachable.getAsyncExecutor() == nullptr);
+    
+    // The loader closes the pool once every symbol's query has been collected
+    unreachable.setAsyncConnectionLimit(AsyncQueryExecutor::DEFAULT_CONNECTIONS);
+    DataProcessor data_processor;
+    auto load = data_processor.loadMultiSymbolData({"AAPL", "MSFT", "GOOGL"}, "2023-01-01", "2023-01-31", &unreachable);
+    ASSERT_TRUE(load.isError());
+    ASSERT_FALSE(unreachable.hasAsyncExecutor());
+    
+    std::cout << "[PASS]" << std::endl;
+}
+
+void test_fast_parsing() {
+    std::cout << "Testing Allocation-Free Parsing - " << std::flush;
+    
+    double value = 0.0;
+    ASSERT_TRUE(DataConversion::parseDouble("123.4567", value));
+    ASSERT_NEAR(123.4567, value, 1e-12);
+    ASSERT_TRUE(DataConversion::parseDouble("-0.5", value));
+    ASSERT_NEAR(-0.5, value, 1e-12);
+    ASSERT_TRUE(DataConversion::parseDouble("+2", value));
+    ASSERT_NEAR(2.0, value, 1e-12);
+    ASSERT_TRUE(DataConversion::parseDouble("1e3", value));
+    ASSERT_NEAR(1000.0, value, 1e-12);
+    ASSERT_FALSE(DataConversion::parseDouble("", value));
+    ASSERT_FALSE(DataConversion::parseDouble("12.5abc", value));
+    ASSERT_FALSE(DataConversion::parseDouble("abc", value));
+    
+    long volume = 0;
+    ASSERT_TRUE(DataConversion::parseLong("1234567890", volume));
+    ASSERT_EQ(1234567890L, volume);
+    ASSERT_FALSE(DataConversion::parseLong("12.5", volume));
+    ASSERT_FALSE(DataConversion::parseLong("99999999999999999999999", volume));
+    
+    // The throwing wrappers keep their exception types
+    ASSERT_NEAR(42.25, DataConversion::safeStringToDouble("42.25", "close"), 1e-12);
+    try {
+        DataConversion::safeStringToDouble("4x", "close");
+        ASSERT_FALSE(true); // Should not reach here
+    } catch (const std::invalid_argument&) {
+        ASSERT_TRUE(true);
+    }
+    try {
+        DataConversion::safeStringToDouble("", "close");
+        ASSERT_FALSE(true); // Should not reach here
+    } catch (const std::invalid_argument&) {
+        ASSERT_TRUE(true);
+    }
+    try {
+        DataConversion::safeStringToLong("99999999999999999999999", "volume");
+        ASSERT_FALSE(true); // Should not reach here
+    } catch (const std::out_of_range&) {
+        ASSERT_TRUE(true);
+    }
+    
+    // Field names are resolved once; alternative names and bad rows still work row by row
+    std::vector<std::map<std::string, std::string>> rows = {
+        {{"time", "2023-01-03T00:00:00+00:00"}, {"open", "10"}, {"high", "11"}, {"low", "9"}, {"close", "10.5"}, {"volume", "100"}},
+        {{"time", "2023-01-04T00:00:00+00:00"}, {"open", "bad"}, {"high", "11"}, {"low", "9"}, {"close", "10.5"}, {"volume", "100"}},
+        {{"date", "2023-01-05"}, {"open_price", "12"}, {"high_price", "13"}, {"low_price", "11"}, {"close_price", "12.5"}, {"volume", "200"}},
+        {{"time", "2023-01-06T00:00:00+00:00"}, {"open", "10"}},
+        {{"time", "2023-01-09T00:00:00+00:00"}, {"open", "14"}, {"high", "15"}, {"low", "13"}, {"close", "14.5"}, {"volume", "300"}}
+    };
+    auto converted = DataConversion::convertToTechnicalData(rows);
+    ASSERT_EQ(3u, converted.size());
+    ASSERT_EQ(std::string("2023-01-03T00:00:00+00:00"), converted[0].date);
+    ASSERT_NEAR(12.5, converted[1].close, 1e-12);
+    ASSERT_EQ(std::string("2023-01-05"), converted[1].date);
+    ASSERT_EQ(300L, converted[2].volume);
+    
+    int32_t days = -1;
+    ASSERT_TRUE(DateTimeUtils::parseIsoDate("1970-01-01", days));
+    ASSERT_EQ(0, days);
+    ASSERT_TRUE(DateTimeUtils::parseIsoDate("2023-01-01T00:00:00+00:00", days));
+    ASSERT_EQ(19358, days);
+    ASSERT_TRUE(DateTimeUtils::parseIsoDate("2024-02-29", days));
+    ASSERT_EQ(19782, days);
+    ASSERT_TRUE(DateTimeUtils::parseIsoDate("1969-12-31", days));
+    ASSERT_EQ(-1, days);
+    ASSERT_FALSE(DateTimeUtils::parseIsoDate("2023-02-29", days));
+    ASSERT_FALSE(DateTimeUtils::parseIsoDate("2023-13-01", days));
+    ASSERT_FALSE(DateTimeUtils::parseIsoDate("2023-1a-01", days));
+    ASSERT_FALSE(DateTimeUtils::parseIsoDate("2023-01-01X", days));
+    ASSERT_FALSE(DateTimeUtils::parseIsoDate("2023-01", days));
+    ASSERT_EQ(-1, days);
+    ASSERT_EQ(DateTimeUtils::daysFromCivil(2000, 3, 1), DateTimeUtils::daysFromCivil(2000, 2, 29) + 1);
+    
+    ASSERT_TRUE(DateTimeUtils::isValidDateFormat("2023-06-15"));
+    ASSERT_FALSE(DateTimeUtils::isValidDateFormat("2023-1a-15"));
+    ASSERT_EQ(20230615, DateTimeUtils::dateToYyyymmdd("2023-06-15"));
+    auto first = DateTimeUtils::stringToTimePoint("2023-01-01");
+    auto second = DateTimeUtils::stringToTimePoint("2023-01-31");
+    ASSERT_EQ(30, std::chrono::duration_cast<std::chrono::hours>(second - first).count() / 24);
+    ASSERT_EQ(std::string("2023-01-31"), DateTimeUtils::timePointToString(second));
+    try {
+        DateTimeUtils::stringToTimePoint("01/31/2023");
+        ASSERT_FALSE(true); // Should not reach here
+    } catch (const std::invalid_argument&) {
+        ASSERT_TRUE(true);
+    }
+    
+    std::cout << "[PASS]" << std::endl;
+}
+
+void test_lazy_services() {
+    std::cout << "Testing Lazy Service Construction - " << std::flush;
+    
+    // Nothing beyond the portfolio exists until a service is asked for
+    TradingEngine engine(10000.0);
+    std::string report = engine.getMemoryReport();
+    ASSERT_TRUE(report.find("MarketData Memory Usage") == std::string::npos);
+    ASSERT_TRUE(report.find("Total Engine Memory") != std::string::npos);
+    
+    MarketData* market_data = engine.getMarketData();
+    ASSERT_TRUE(market_data != nullptr);
+    ASSERT_TRUE(market_data == engine.getMarketData());
+    ASSERT_FALSE(market_data->isConnected());
+    report = engine.getMemoryReport();
+    ASSERT_TRUE(report.find("MarketData Memory Usage") != std::string::npos);
+    ASSERT_TRUE(report.find("Database connection: Deferred") != std::string::npos);
+    
+    // The connection object is created on first database access, not by the constructor
+    ASSERT_TRUE(market_data->getDatabaseConnection() != nullptr);
+    ASSERT_TRUE(market_data->getMemoryReport().find("Database connection: Active") != std::string::npos);
+    
+    // A lazily built strategy manager still starts with the default strategy
+    ASSERT_TRUE(engine.getStrategyManager()->hasStrategy());
+    ASSERT_TRUE(engine.getTradingOrchestrator() == engine.getTradingOrchestrator());
+    
+    // Services survive a move of the engine
+    TradingEngine moved(std::move(engine));
+    ASSERT_TRUE(moved.getMarketData() == market_data);
+    
+    std::cout << "[PASS]" << std::endl;
+}
+
+void test_simulation_bundle() {
+    std::cout << "Testing Simulation Capture and Replay - " << std::flush;
+    
+    // Synthetic oscillating series so the MA crossover trades
+    std::vector<PriceData> bars;
+    int32_t first_day = DateTimeUtils::daysFromCivil(2023, 1, 2);
+    for (int i = 0; i < 150; ++i) {
+        double close = 100.0 + 10.0 * std::sin(i / 8.0) + i * 0.05;
+        bars.emplace_back(close - 0.5, close + 1.0, close - 1.0, close, 100000 + i, PgBinary::formatDate(first_day + i));
+    }
+    // Database captures carry midnight-UTC timestamps; one off-midnight bar keeps a series as text
+    std::vector<PriceData> stamped = bars;
+    for (auto& bar : stamped) {
+        bar.date += "T00:00:00+00:00";
+    }
+    std::vector<PriceData> mixed = {PriceData(1.0, 2.0, 0.5, 1.5, 7, "2023-01-02T00:00:00+00:00"),
+                                    PriceData(1.0, 2.0, 0.5, 1.5, 8, "2023-01-03T14:30:00+00:00")};
+    
+    ArgumentParser parser;
+    TradingConfig config;
+    config.symbols = {"TEST"};
+    config.start_date = "2023-01-01";
+    config.end_date = "2023-06-30";
+    config.setParameter("short_ma", 5);
+    config.setParameter("long_ma", 20);
+    config.rolling_windows = {20};
+    config.capture_path = "/tmp/unused.bundle";
+    
+    // The stored config parses back to the same run
+    TradingConfig parsed = parser.parseConfigJson(parser.configToJson(config));
+    ASSERT_TRUE(parsed.symbols == config.symbols);
+    ASSERT_EQ(config.end_date, parsed.end_date);
+    ASSERT_TRUE(parsed.strategy_parameters == config.strategy_parameters);
+    ASSERT_TRUE(parsed.rolling_windows == config.rolling_windows);
+    ASSERT_EQ(config.capture_path, parsed.capture_path);
+    
+    SimulationBundle bundle;
+    bundle.setConfigJson(parser.configToJson(config).dump());
+    bundle.recordSymbolExists("TEST", true);
+    bundle.recordSymbolExists("GONE", false);
+    bundle.recordTemporalInfo("TEST", {{"ipo_date", "1990-01-01"}, {"delisting_date", ""}});
+    bundle.recordPriceData("TEST", config.start_date, config.end_date, bars);
+    bundle.recordPriceData("STAMP", config.start_date, config.end_date, stamped);
+    bundle.recordPriceData("MIXED", "2023-01-01", "2023-01-31", mixed);
+    bundle.recordTradeable("TEST", "2023-01-03", true);
+    bundle.recordTradeable("TEST", "2023-01-04", false);
+    
+    const std::string path = "/tmp/test_simulation_bundle_" + std::to_string(::getpid()) + ".bundle";
+    auto save_result = bundle.save(path);
+    ASSERT_TRUE(save_result.isSuccess());
+    
+    auto load_result = SimulationBundle::load(path);
+    ASSERT_TRUE(load_result.isSuccess());
+    auto loaded = load_result.getValue();
+    ASSERT_EQ(std::string(TRADING_ENGINE_VERSION), loaded->getEngineVersion());
+    ASSERT_EQ(bundle.getConfigJson(), loaded->getConfigJson());
+    ASSERT_EQ(3, static_cast<int>(loaded->getPriceSeriesCount()));
+    ASSERT_EQ(302, static_cast<int>(loaded->getPriceRowCount()));
+    
+    bool flag = false;
+    ASSERT_TRUE(loaded->lookupSymbolExists("TEST", flag));
+    ASSERT_TRUE(flag);
+    ASSERT_TRUE(loaded->lookupSymbolExists("GONE", flag));
+    ASSERT_FALSE(flag);
+    ASSERT_FALSE(loaded->lookupSymbolExists("MSFT", flag));
+    ASSERT_TRUE(loaded->lookupTradeable("TEST", "2023-01-03", flag));
+    ASSERT_TRUE(flag);
+    ASSERT_TRUE(loaded->lookupTradeable("TEST", "2023-01-04", flag));
+    ASSERT_FALSE(flag);
+    ASSERT_FALSE(loaded->lookupTradeable("TEST", "2023-01-05", flag));
+    std::map<std::string, std::string> info;
+    ASSERT_TRUE(loaded->lookupTemporalInfo("TEST", info));
+    ASSERT_EQ(std::string("1990-01-01"), info["ipo_date"]);
+    
+    std::vector<PriceData> series;
+    ASSERT_TRUE(loaded->lookupPriceData("TEST", config.start_date, config.end_date, series));
+    ASSERT_EQ(150, static_cast<int>(series.size()));
+    ASSERT_EQ(bars[37].date, series[37].date);
+    ASSERT_TRUE(bars[37].close == series[37].close);
+    ASSERT_EQ(bars[149].volume, series[149].volume);
+    ASSERT_FALSE(loaded->lookupPriceData("TEST", config.start_date, "2023-12-31", series));
+    // Timestamps survive unchanged, whether stored as day numbers or as text
+    ASSERT_TRUE(loaded->lookupPriceData("STAMP", config.start_date, config.end_date, series));
+    ASSERT_EQ(150, static_cast<int>(series.size()));
+    ASSERT_EQ(stamped[0].date, series[0].date);
+    ASSERT_EQ(stamped[149].date, series[149].date);
+    ASSERT_TRUE(loaded->lookupPriceData("MIXED", "2023-01-01", "2023-01-31", series));
+    ASSERT_EQ(mixed[0].date, series[0].date);
+    ASSERT_EQ(mixed[1].date, series[1].date);
+    
+    // Midnight-UTC timestamps cost no more than plain dates
+    {
+        SimulationBundle plain_bundle;
+        SimulationBundle stamped_bundle;
+        plain_bundle.recordPriceData("TEST", config.start_date, config.end_date, bars);
+        stamped_bundle.recordPriceData("TEST", config.start_date, config.end_date, stamped);
+        auto plain_size = plain_bundle.save(path);
+        auto stamped_size = stamped_bundle.save(path);
+        ASSERT_TRUE(plain_size.isSuccess() && stamped_size.isSuccess());
+        ASSERT_EQ(plain_size.getValue(), stamped_size.getValue());
+        auto reloaded = SimulationBundle::load(path);
+        ASSERT_TRUE(reloaded.isSuccess());
+        ASSERT_TRUE(reloaded.getValue()->lookupPriceData("TEST", config.start_date, config.end_date, series));
+        ASSERT_EQ(stamped[75].date, series[75].date);
+    }
+    
+    // Replay: no database connection, identical output on every run
+    std::string outputs[2];
+    for (auto& output : outputs) {
+        TradingEngine engine(config.starting_capital);
+        engine.getStrategyManager()->setCurrentStrategy(engine.getStrategyManager()->createMovingAverageStrategy(5, 20));
+        engine.getMarketData()->setReplayBundle(loaded);
+        ASSERT_TRUE(engine.getMarketData()->hasDataSource());
+        ASSERT_TRUE(engine.getMarketData()->getDatabaseConnection() == nullptr);
+        ASSERT_FALSE(engine.getMarketData()->symbolExists("MSFT").getValue());
+        auto run = engine.getTradingOrchestrator()->runSimulation(parsed, engine.getPortfolio(), engine.getMarketData(),
+                                                                  engine.getDataProcessor(), engine.getStrategyManager(),
+                                                                  engine.getResultCalculator());
+        ASSERT_TRUE(run.isSuccess());
+        output = run.isSuccess() ? run.getValue() : "";
+    }
+    ASSERT_FALSE(outputs[0].empty());
+    ASSERT_EQ(outputs[0], outputs[1]);
+    ASSERT_TRUE(nlohmann::json::parse(outputs[0]).value("trades", 0) > 0);
+    
+    // Truncated and foreign files are rejected
+    {
+        std::ifstream in(path, std::ios::binary);
+        std::string data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        std::ofstream(path, std::ios::binary | std::ios::trunc).write(data.data(), static_cast<std::streamsize>(data.size() / 2));
+        auto truncated = SimulationBundle::load(path);
+        ASSERT_TRUE(truncated.isError());
+        ASSERT_TRUE(truncated.getError().code == ErrorCode::VALIDATION_INVALID_FORMAT);
+        std::ofstream(path, std::ios::binary | std::ios::trunc) << "not a bundle";
+        ASSERT_TRUE(SimulationBundle::load(path).isError());
+    }
+    std::remove(path.c_str());
+    ASSERT_TRUE(SimulationBundle::load(path).isError());
+    
+    std::cout << "[PASS]" << std::endl;
+}
+
+void test_allocator_reset_state() {
+    std::cout << "Testing PortfolioAllocator State Reset Between Runs - " << std::flush;
+    
+    AllocationConfig config;
+    config.strategy = AllocationStrategy::VOLATILITY_ADJUSTED;
+    config.max_position_weight = 1.0;
+    config.min_position_weight = 0.0;
+    config.cash_reserve_pct = 0.0;
+    Portfolio portfolio(10000.0);
+    std::map<std::string, double> prices = {{"AAA", 100.0}, {"BBB", 100.0}};
+    
+    // A previous run leaves uneven volatility history and a rebalance date behind
+    PortfolioAllocator used(config);
+    used.updatePriceHistory("AAA", {100.0, 110.0, 95.0, 112.0, 90.0});
+    used.updatePriceHistory("BBB", {100.0, 100.5, 100.2, 100.8, 100.4});
+    used.setTargetAllocation({{"AAA", 0.2}, {"BBB", 0.8}}, 10000.0);
+    auto skewed = used.calculateAllocation({"AAA", "BBB"}, 10000.0, portfolio, prices, "2023-06-30");
+    ASSERT_TRUE(skewed.isSuccess());
+    ASSERT_TRUE(skewed.getValue().target_weights.at("AAA") < skewed.getValue().target_weights.at("BBB"));
+    
+    // After a reset the allocator must answer exactly as a new one does
+    used.resetState();
+    ASSERT_TRUE(used.getLastRebalanceDate().empty());
+    PortfolioAllocator fresh(config);
+    auto expected = fresh.calculateAllocation({"AAA", "BBB"}, 10000.0, portfolio, prices, "2024-01-02");
+    auto actual = used.calculateAllocation({"AAA", "BBB"}, 10000.0, portfolio, prices, "2024-01-02");
+    ASSERT_TRUE(expected.isSuccess() && actual.isSuccess());
+    for (const auto& symbol : {"AAA", "BBB"}) {
+        ASSERT_TRUE(expected.getValue().target_weights.at(symbol) == actual.getValue().target_weights.at(symbol));
+    }
+    
+    std::cout << "[PASS]" << std::endl;
+}
+
 // Main Test Runner
 
+void test_scaling_benchmark() {
+    std::cout << "Testing Synthetic Scaling Benchmark - " << std::flush;
+    
+    // Universe: business days only, ending on the last session of 2023
+    TradingConfig config;
+    auto bundle = ScalingBenchmark::generateUniverse(3, 1, 7, config);
+    ASSERT_EQ(3, config.symbols.size());
+    ASSERT_EQ(std::string("2023-12-29"), config.end_date);
+    ASSERT_EQ(3 * 252, bundle->getPriceRowCount());
+    std::vector<PriceData> bars;
+    ASSERT_TRUE(bundle->lookupPriceData("BENCH1", config.start_date, config.end_date, bars));
+    ASSERT_EQ(252, bars.size());
+    ASSERT_EQ(config.start_date, bars.front().date);
+    for (const auto& bar : bars) {
+        ASSERT_TRUE(bar.low <= std::min(bar.open, bar.close) && bar.high >= std::max(bar.open, bar.close));
+        bool tradeable = false;
+        ASSERT_TRUE(bundle->lookupTradeable("BENCH1", bar.date, tradeable));
+        ASSERT_TRUE(tradeable);
+    }
+    
+    // Same seed, same prices
+    TradingConfig again;
+    std::vector<PriceData> repeated;
+    ASSERT_TRUE(ScalingBenchmark::generateUniverse(3, 1, 7, again)->lookupPriceData(
+        "BENCH1", again.start_date, again.end_date, repeated));
+    ASSERT_TRUE(repeated.back().close == bars.back().close);
+    
+    // One case per strategy x years x symbols; this binary does not count allocations
+    ScalingBenchmark::Options options;
+    options.symbol_counts = {2};
+    options.years = {1};
+    options.strategies = {"ma_crossover", "unknown_strategy"};
+    auto report = ScalingBenchmark().run(options);
+    ASSERT_TRUE(report.isSuccess());
+    const auto& cases = report.getValue()["cases"];
+    ASSERT_EQ(2, cases.size());
+    ASSERT_EQ(504, cases[0]["bars"].get<int>());
+    ASSERT_TRUE(cases[0]["bars_per_second"].get<double>() > 0.0);
+    ASSERT_TRUE(cases[0]["peak_rss_kb"].get<long>() > 0);
+    ASSERT_FALSE(report.getValue()["allocation_counting"].get<bool>());
+    ASSERT_TRUE(cases[0]["allocations_per_bar"].is_null());
+    ASSERT_TRUE(cases[1].contains("error"));
+    
+    options.years = {0};
+    auto invalid = ScalingBenchmark().run(options);
+    ASSERT_TRUE(invalid.isError());
+    ASSERT_TRUE(invalid.getError().code == ErrorCode::VALIDATION_INVALID_INPUT);
+    
+    std::cout << "[PASS]" << std::endl;
+}
+
+void test_trading_calendar() {
+    std::cout << "Testing Trading Calendar Business-Day Arithmetic - " << std::flush;
+    
+    // January 2024 sessions: New Year's Day and MLK Day (the 15th) are closed
+    auto day = [](int d) { return DateTimeUtils::daysFromCivil(2024, 1, d); };
+    std::vector<std::string> timeline = {"2024-01-31", "2024-01-02"};
+    for (int d = 3; d <= 30; ++d) {
+        if (TradingCalendar::isWeekday(day(d)) && d != 15) {
+            timeline.push_back(PgBinary::formatDate(day(d)));
+        }
+    }
+    timeline.push_back("2024-01-02");
+    auto calendar_result = TradingCalendar::fromTimeline(timeline);
+    ASSERT_TRUE(calendar_result.isSuccess());
+    const TradingCalendar& calendar = calendar_result.getValue();
+    ASSERT_EQ(21, calendar.sessionCount());
+    ASSERT_EQ(day(2), calendar.firstDay());
+    ASSERT_EQ(day(31), calendar.lastDay());
+    
+    // Weekends are neither sessions nor holidays; closed weekdays are holidays
+    ASSERT_FALSE(TradingCalendar::isWeekday(day(6)));
+    ASSERT_FALSE(calendar.isHoliday(day(6)));
+    ASSERT_TRUE(calendar.isHoliday(day(15)));
+    ASSERT_FALSE(calendar.isSession(day(15)));
+    ASSERT_TRUE(calendar.isSession(day(16)));
+    ASSERT_EQ(1, calendar.holidayCount());
+    
+    // Session counts and business days in (from, to]
+    ASSERT_EQ(0, calendar.sessionsThrough(day(1)));
+    ASSERT_EQ(9, calendar.sessionsThrough(day(15)));
+    ASSERT_EQ(10, calendar.sessionsThrough(day(16)));
+    ASSERT_EQ(21, calendar.sessionsThrough(day(31) + 10));
+    ASSERT_EQ(1, calendar.businessDaysBetween(day(12), day(16)));
+    ASSERT_EQ(20, calendar.businessDaysBetween(day(2), day(31)));
+    ASSERT_EQ(-20, calendar.businessDaysBetween(day(31), day(2)));
+    ASSERT_EQ(day(16), calendar.addBusinessDays(day(12), 1));
+    ASSERT_EQ(day(16), calendar.addBusinessDays(day(13), 1));
+    ASSERT_EQ(TradingCalendar::NO_DAY, calendar.addBusinessDays(day(29), 5));
+    ASSERT_EQ(day(9), calendar.nextRebalanceDay(day(2), 5));
+    ASSERT_TRUE(calendar.yearFraction(calendar.firstDay() - 1, calendar.lastDay()) == 21 / 252.0);
+    
+    // Rank queries agree with a binary search across many bitmap words
+    std::vector<int32_t> weekdays;
+    for (int32_t d = DateTimeUtils::daysFromCivil(2000, 1, 3); d <= DateTimeUtils::daysFromCivil(2023, 12, 29); ++d) {
+        if (TradingCalendar::isWeekday(d) && d % 97 != 0) {
+            weekdays.push_back(d);
+        }
+    }
+    TradingCalendar long_calendar = TradingCalendar::fromDays(weekdays);
+    ASSERT_EQ(weekdays.size(), long_calendar.sessionCount());
+    for (int32_t d = weekdays.front() - 3; d <= weekdays.back() + 3; d += 13) {
+        size_t expected = static_cast<size_t>(std::upper_bound(weekdays.begin(), weekdays.end(), d) - weekdays.begin());
+        ASSERT_EQ(expected, long_calendar.sessionsThrough(d));
+    }
+    ASSERT_EQ(weekdays[1000], long_calendar.sessionAt(1000));
+    ASSERT_EQ(TradingCalendar::NO_DAY, long_calendar.sessionAt(weekdays.size()));
+    
+    auto invalid = TradingCalendar::fromTimeline({"2024-01-02", "Jan 3"});
+    ASSERT_TRUE(invalid.isError());
+    ASSERT_TRUE(invalid.getError().code == ErrorCode::VALIDATION_INVALID_FORMAT);
+    
+    // The allocator counts rebalance periods in sessions, so the holiday pushes the next one out
+    AllocationConfig config;
+    config.rebalancing_frequency_days = 5;
+    PortfolioAllocator allocator(config);
+    allocator.setTradingCalendar(std::make_shared<const TradingCalendar>(calendar));
+    allocator.setTargetAllocation({{"AAA", 0.5}, {"BBB", 0.5}}, 10000.0);
+    Portfolio portfolio(10000.0);
+    ASSERT_TRUE(portfolio.buyStock("AAA", 30, 100.0));
+    ASSERT_TRUE(portfolio.buyStock("BBB", 10, 100.0));
+    std::map<std::string, double> prices = {{"AAA", 100.0}, {"BBB", 100.0}};
+    
+    ASSERT_EQ(day(9), allocator.getNextRebalanceDay());
+    ASSERT_FALSE(allocator.shouldRebalance(portfolio, prices, day(8)));
+    ASSERT_TRUE(allocator.shouldRebalance(portfolio, prices, day(9)));
+    ASSERT_TRUE(allocator.calculateRebalanceOrders(portfolio, prices, "2024-01-09").isSuccess());
+    ASSERT_EQ(day(17), allocator.getNextRebalanceDay());
+    ASSERT_FALSE(allocator.shouldRebalance(portfolio, prices, day(16)));
+    ASSERT_TRUE(allocator.shouldRebalance(portfolio, prices, "2024-01-17"));
+    
+    // Annualized return spans the sessions elapsed, not the number of values recorded
+    ResultCalculator calculator;
+    calculator.setTradingCalendar(std::make_shared<const TradingCalendar>(calendar));
+    calculator.beginStreaming(10000.0);
+    BacktestResult result;
+    result.starting_capital = 10000.0;
+    result.start_date = "2024-01-02";
+    result.end_date = "2024-01-31";
+    double value = 10000.0;
+    for (size_t i = 0; i < calendar.sessionCount(); i += 2) {
+        value *= 1.001;
+        calculator.recordEquity(value, calendar.sessionAt(i));
+    }
+    calculator.finalizeResults(result, Portfolio(10000.0));
+    ASSERT_NEAR((std::pow(value / 10000.0, 252.0 / 21.0) - 1.0) * 100.0, result.annualized_return, 1e-6);
+    
+    std::cout << "[PASS]" << std::endl;
+}
+
+// Places one buy limit on the first bar and one sell limit once the position is open
+class RestingOrderStrategy : public TradingStrategy {
+public:
+    RestingOrderStrategy() : TradingStrategy("resting_orders") {}
+    
+    TradingSignal evaluateSignal(const std::vector<PriceData>& price_data, const Portfolio& portfolio,
+                                 const std::string& symbol = "") override {
+        TradingSignal signal;
+        if (price_data.size() == 1) {
+            signal = TradingSignal(Signal::BUY, price_data.back().close, price_data.back().date, "Buy the dip");
+            signal.order_kind = OrderKind::LIMIT;
+            signal.order_price = 95.0;
+        } else if (price_data.size() == 3 && portfolio.hasPosition(symbol)) {
+            signal = TradingSignal(Signal::SELL, price_data.back().close, price_data.back().date, "Take profit");
+            signal.order_kind = OrderKind::LIMIT;
+            signal.order_price = 105.0;
+        }
+        return signal;
+    }
+    bool validateConfig() const override { return true; }
+    std::string getDescription() const override { return "Resting order test strategy"; }
+};
+
+// Buys once, then rests a take-profit sell on every later bar; together they outgrow the position
+class StackedSellStrategy : public TradingStrategy {
+public:
+    StackedSellStrategy() : TradingStrategy("stacked_sells") {}
+    
+    TradingSignal evaluateSignal(const std::vector<PriceData>& price_data, const Portfolio& portfolio,
+                                 const std::string& symbol = "") override {
+        TradingSignal signal;
+        if (price_data.size() == 1) {
+            signal = TradingSignal(Signal::BUY, price_data.back().close, price_data.back().date, "Enter");
+        } else if (portfolio.hasPosition(symbol)) {
+            signal = TradingSignal(Signal::SELL, price_data.back().close, price_data.back().date, "Take profit");
+            signal.order_kind = OrderKind::LIMIT;
+            signal.order_price = 110.0;
+        }
+        return signal;
+    }
+    bool validateConfig() const override { return true; }
+    std::string getDescription() const override { return "Stacked resting sell test strategy"; }
+};
+
+void test_order_book() {
+    std::cout << "Testing Resting Limit and Stop Order Book - " << std::flush;
+    
+    OrderBook book;
+    auto buy_low = book.place(Signal::BUY, OrderKind::LIMIT, 95.0, 10, "2024-01-02");
+    auto buy_high = book.place(Signal::BUY, OrderKind::LIMIT, 98.0, 20, "2024-01-02");
+    auto buy_later = book.place(Signal::BUY, OrderKind::LIMIT, 98.0, 30, "2024-01-03");
+    auto sell_limit = book.place(Signal::SELL, OrderKind::LIMIT, 110.0, 5, "2024-01-02");
+    auto sell_stop = book.place(Signal::SELL, OrderKind::STOP, 90.0, 7, "2024-01-02");
+    auto buy_stop = book.place(Signal::BUY, OrderKind::STOP, 105.0, 8, "2024-01-02");
+    ASSERT_TRUE(buy_low.isSuccess() && buy_high.isSuccess() && buy_later.isSuccess());
+    ASSERT_TRUE(sell_limit.isSuccess() && sell_stop.isSuccess() && buy_stop.isSuccess());
+    ASSERT_EQ(6, book.size());
+    ASSERT_EQ(20, book.find(buy_high.getValue())->shares);
+    
+    // Invalid orders never rest
+    ASSERT_TRUE(book.place(Signal::BUY, OrderKind::MARKET, 95.0, 10, "2024-01-02").getError().code ==
+                ErrorCode::EXECUTION_INVALID_SIGNAL_TYPE);
+    ASSERT_TRUE(book.place(Signal::HOLD, OrderKind::LIMIT, 95.0, 10, "2024-01-02").isError());
+    ASSERT_TRUE(book.place(Signal::SELL, OrderKind::STOP, 0.0, 10, "2024-01-02").getError().code ==
+                ErrorCode::EXECUTION_INVALID_PRICE);
+    ASSERT_TRUE(book.place(Signal::BUY, OrderKind::LIMIT, 95.0, 0, "2024-01-02").isError());
+    ASSERT_EQ(6, book.size());
+    
+    // A bar inside every level fills nothing
+    ASSERT_TRUE(book.cross(100.0, 104.0, 99.0).empty());
+    
+    // Buy limits at or above the low fill in price-time order, at the level
+    auto fills = book.cross(99.0, 100.0, 97.5);
+    ASSERT_EQ(2, fills.size());
+    ASSERT_EQ(buy_high.getValue(), fills[0].order.id);
+    ASSERT_EQ(buy_later.getValue(), fills[1].order.id);
+    ASSERT_TRUE(fills[0].fill_price == 98.0);
+    ASSERT_EQ(4, book.size());
+    ASSERT_TRUE(book.find(buy_high.getValue()) == nullptr);
+    
+    // A gap through several levels fills at the open; sells come out before buys
+    fills = book.cross(112.0, 115.0, 111.0);
+    ASSERT_EQ(2, fills.size());
+    ASSERT_EQ(sell_limit.getValue(), fills[0].order.id);
+    ASSERT_TRUE(fills[0].fill_price == 112.0);
+    ASSERT_EQ(buy_stop.getValue(), fills[1].order.id);
+    ASSERT_TRUE(fills[1].fill_price == 112.0);
+    
+    fills = book.cross(91.0, 92.0, 85.0);
+    ASSERT_EQ(2, fills.size());
+    ASSERT_EQ(sell_stop.getValue(), fills[0].order.id);
+    ASSERT_TRUE(fills[0].fill_price == 90.0);
+    ASSERT_EQ(buy_low.getValue(), fills[1].order.id);
+    ASSERT_TRUE(fills[1].fill_price == 91.0);
+    ASSERT_TRUE(book.empty());
+    
+    // Cancelled orders are gone from their level
+    auto cancelled = book.place(Signal::BUY, OrderKind::LIMIT, 50.0, 1, "2024-01-04");
+    ASSERT_TRUE(book.cancel(cancelled.getValue()));
+    ASSERT_FALSE(book.cancel(cancelled.getValue()));
+    ASSERT_TRUE(book.cross(40.0, 60.0, 40.0).empty());
+    
+    // Many resting orders: only the reached prefix comes out
+    for (int i = 1; i <= 10000; ++i) {
+        book.place(Signal::BUY, OrderKind::LIMIT, static_cast<double>(i) / 100.0, 1, "2024-01-04");
+    }
+    fills = book.cross(99.99, 100.0, 99.95);
+    ASSERT_EQ(6, fills.size());
+    ASSERT_TRUE(fills.front().fill_price == 99.99);
+    ASSERT_EQ(9994, book.size());
+    book.clear();
+    ASSERT_TRUE(book.empty());
+    
+    // In a backtest, a limit placed on one bar fills on a later bar that reaches it
+    TradingConfig config;
+    config.symbols = {"AAA"};
+    config.start_date = "2024-01-02";
+    config.end_date = "2024-01-08";
+    config.starting_capital = 100000.0;
+    std::vector<PriceData> bars = {
+        PriceData(100.0, 101.0, 99.0, 100.0, 1000, "2024-01-02"),
+        PriceData(99.0, 100.0, 96.0, 97.0, 1000, "2024-01-03"),
+        PriceData(94.0, 96.0, 93.0, 95.0, 1000, "2024-01-04"),   // Gaps below the buy limit
+        PriceData(96.0, 104.0, 95.0, 103.0, 1000, "2024-01-05"),
+        PriceData(103.0, 106.0, 102.0, 105.0, 1000, "2024-01-08"), // Reaches the sell limit
+    };
+    auto bundle = std::make_shared<SimulationBundle>();
+    bundle->recordSymbolExists("AAA", true);
+    bundle->recordTemporalInfo("AAA", {{"symbol", "AAA"}, {"ipo_date", "2024-01-02"}, {"delisting_date", ""}});
+    bundle->recordPriceData("AAA", config.start_date, config.end_date, bars);
+    
+    TradingEngine engine(config.starting_capital);
+    engine.getStrategyManager()->setCurrentStrategy(std::make_unique<RestingOrderStrategy>());
+    engine.getMarketData()->setReplayBundle(bundle);
+    engine.getProgressService()->setProgressReporting(false);
+    auto backtest = engine.getTradingOrchestrator()->runBacktest(
+        config, engine.getPortfolio(), engine.getMarketData(), engine.getExecutionService(),
+        engine.getProgressService(), engine.getPortfolioAllocator(), engine.getDataProcessor(),
+        engine.getStrategyManager(), engine.getResultCalculator());
+    ASSERT_TRUE(backtest.isSuccess());
+    const auto& result = backtest.getValue();
+    ASSERT_EQ(2, result.total_trades);
+    ASSERT_EQ(2, result.signals_generated.size());
+    ASSERT_TRUE(result.signals_generated[0].signal == Signal::BUY);
+    ASSERT_EQ(std::string("2024-01-04"), result.signals_generated[0].date);
+    ASSERT_TRUE(result.signals_generated[0].price == 94.0);
+    ASSERT_TRUE(result.signals_generated[1].signal == Signal::SELL);
+    ASSERT_EQ(std::string("2024-01-08"), result.signals_generated[1].date);
+    ASSERT_TRUE(result.signals_generated[1].price == 105.0);
+    ASSERT_EQ(1, result.round_trips.size());
+    ASSERT_TRUE(result.round_trips[0].pnl > 0.0);
+    
+    // A crossing bar whose participation cap floors to 0 shares leaves the whole limit resting;
+    // it fills on the next crossing bar once the trailing volume allows it
+    config.transaction_costs.max_participation_pct = 0.05;
+    std::vector<PriceData> thin_bars = {
+        PriceData(100.0, 101.0, 99.0, 100.0, 1000, "2024-01-02"),
+        PriceData(99.0, 100.0, 96.0, 97.0, 1000, "2024-01-03"),
+        PriceData(94.0, 96.0, 93.0, 95.0, 10000000, "2024-01-04"),  // Crosses; ADV 1000 caps to 0 shares
+        PriceData(96.0, 97.0, 94.0, 96.0, 10000000, "2024-01-05"),  // Crosses again with a deep ADV
+        PriceData(96.0, 97.0, 95.5, 96.5, 10000000, "2024-01-08"),
+    };
+    auto thin_bundle = std::make_shared<SimulationBundle>();
+    thin_bundle->recordSymbolExists("AAA", true);
+    thin_bundle->recordTemporalInfo("AAA", {{"symbol", "AAA"}, {"ipo_date", "2024-01-02"}, {"delisting_date", ""}});
+    thin_bundle->recordPriceData("AAA", config.start_date, config.end_date, thin_bars);
+    
+    TradingEngine thin_engine(config.starting_capital);
+    thin_engine.getStrategyManager()->setCurrentStrategy(std::make_unique<RestingOrderStrategy>());
+    thin_engine.getMarketData()->setReplayBundle(thin_bundle);
+    thin_engine.getProgressService()->setProgressReporting(false);
+    auto thin_backtest = thin_engine.getTradingOrchestrator()->runBacktest(
+        config, thin_engine.getPortfolio(), thin_engine.getMarketData(), thin_engine.getExecutionService(),
+        thin_engine.getProgressService(), thin_engine.getPortfolioAllocator(), thin_engine.getDataProcessor(),
+        thin_engine.getStrategyManager(), thin_engine.getResultCalculator());
+    ASSERT_TRUE(thin_backtest.isSuccess());
+    const auto& thin = thin_backtest.getValue();
+    ASSERT_EQ(1, thin.total_trades);
+    ASSERT_TRUE(thin.signals_generated[0].signal == Signal::BUY);
+    ASSERT_EQ(std::string("2024-01-05"), thin.signals_generated[0].date);
+    ASSERT_TRUE(thin.signals_generated[0].price == 95.0);
+    ASSERT_TRUE(thin_engine.getPortfolio().hasPosition("AAA"));
+    
+    std::cout << "[PASS]" << std::endl;
+}
+
+void test_transaction_cost_model() {
+    std::cout << "Testing Transaction Cost Model with Rolling ADV - " << std::flush;
+    
+    TransactionCostConfig config;
+    ASSERT_FALSE(config.isEnabled());
+    ASSERT_TRUE(config.validate().isSuccess());
+    config.spread_bps = -1.0;
+    ASSERT_TRUE(config.validate().getError().code == ErrorCode::VALIDATION_INVALID_INPUT);
+    config.spread_bps = 20.0;
+    config.max_participation_pct = 150.0;
+    ASSERT_TRUE(config.validate().isError());
+    config.max_participation_pct = 10.0;
+    config.impact_coefficient = 0.5;
+    config.commission_per_share = 0.01;
+    config.min_commission = 1.0;
+    config.adv_window = 2;
+    config.volatility_window = 3;
+    ASSERT_TRUE(config.validate().isSuccess());
+    ASSERT_TRUE(config.isEnabled());
+    
+    // Alternating +10% / -10% closes; the symbol has no bar in session 3
+    std::map<std::string, std::vector<PriceData>> data;
+    data["AAA"] = {
+        PriceData(100.0, 100.0, 100.0, 100.0, 1000, "2024-01-02"),
+        PriceData(110.0, 110.0, 110.0, 110.0, 2000, "2024-01-03"),
+        PriceData(99.0, 99.0, 99.0, 99.0, 3000, "2024-01-04"),
+        PriceData(108.9, 108.9, 108.9, 108.9, 4000, "2024-01-08"),
+        PriceData(98.01, 98.01, 98.01, 98.01, 5000, "2024-01-09"),
+    };
+    std::vector<std::vector<int32_t>> sessions = {{0, 1, 2, -1, 3, 4}};
+    TransactionCostModel model(config);
+    model.prepare(data, sessions);
+    ASSERT_EQ(0, model.symbolIndex("AAA"));
+    ASSERT_EQ(-1, model.symbolIndex("BBB"));
+    
+    // Trailing windows end on the previous bar; a session without a bar carries the last values
+    const double expected_adv[] = {1000.0, 1000.0, 1500.0, 1500.0, 2500.0, 3500.0};
+    for (size_t session = 0; session < 6; ++session) {
+        ASSERT_NEAR(expected_adv[session], model.getAverageDailyVolume(0, session), 1e-9);
+    }
+    ASSERT_TRUE(model.getDailyVolatility(0, 2) == 0.0);
+    ASSERT_NEAR(std::abs(std::log(1.1) - std::log(0.9)) / std::sqrt(2.0), model.getDailyVolatility(0, 4), 1e-12);
+    const double returns[] = {std::log(1.1), std::log(0.9), std::log(1.1)};
+    double mean = (returns[0] + returns[1] + returns[2]) / 3.0;
+    double variance = 0.0;
+    for (double r : returns) {
+        variance += (r - mean) * (r - mean) / 2.0;
+    }
+    const double volatility = std::sqrt(variance);
+    ASSERT_NEAR(volatility, model.getDailyVolatility(0, 5), 1e-12);
+    
+    // 10% of a 3500 share ADV caps the order; half the spread plus square-root impact on top
+    FillEstimate buy = model.estimate(0, 5, Signal::BUY, 1000, 100.0);
+    ASSERT_EQ(350, buy.shares);
+    const double cost_fraction = 0.001 + 0.5 * volatility * std::sqrt(350.0 / 3500.0);
+    ASSERT_NEAR(100.0 * (1.0 + cost_fraction), buy.price, 1e-9);
+    ASSERT_NEAR(3.5, buy.commission, 1e-12);
+    ASSERT_NEAR((buy.price - 100.0) * 350, buy.slippage, 1e-9);
+    ASSERT_NEAR(buy.price + 0.01, buy.netPrice(Signal::BUY), 1e-12);
+    
+    FillEstimate sell = model.estimate(0, 5, Signal::SELL, 10, 100.0);
+    ASSERT_EQ(10, sell.shares);
+    ASSERT_TRUE(sell.price < 100.0);
+    ASSERT_NEAR(1.0, sell.commission, 1e-12);
+    ASSERT_NEAR(sell.price - 0.1, sell.netPrice(Signal::SELL), 1e-12);
+    
+    // Free fills by default, with nothing precomputed
+    TransactionCostModel free_model;
+    free_model.prepare(data, sessions);
+    FillEstimate free_fill = free_model.estimate(0, 5, Signal::BUY, 1000, 100.0);
+    ASSERT_EQ(1000, free_fill.shares);
+    ASSERT_TRUE(free_fill.netPrice(Signal::BUY) == 100.0);
+    ASSERT_TRUE(free_model.getAverageDailyVolume(0, 5) == 0.0);
+    
+    // Config JSON round trip
+    ArgumentParser parser;
+    TradingConfig trading_config;
+    trading_config.transaction_costs = config;
+    TradingConfig parsed = parser.parseConfigJson(parser.configToJson(trading_config));
+    ASSERT_TRUE(parsed.transaction_costs.spread_bps == 20.0);
+    ASSERT_TRUE(parsed.transaction_costs.max_participation_pct == 10.0);
+    ASSERT_EQ(3, parsed.transaction_costs.volatility_window);
+    
+    // In a backtest, costs are charged and large orders are held to the participation cap
+    auto run = [](const TransactionCostConfig& costs) {
+        TradingConfig run_config;
+        run_config.strategy_name = "ma_crossover";
+        run_config.starting_capital = 10000000.0;
+        run_config.transaction_costs = costs;
+        auto bundle = ScalingBenchmark::generateUniverse(2, 2, 11, run_config);
+        TradingEngine engine(run_config.starting_capital);
+        engine.getStrategyManager()->setCurrentStrategy(
+            std::move(engine.getStrategyManager()->createStrategyFromConfig(run_config).getValue()));
+        engine.getMarketData()->setReplayBundle(bundle);
+        engine.getProgressService()->setProgressReporting(false);
+        return engine.getTradingOrchestrator()->runBacktest(
+            run_config, engine.getPortfolio(), engine.getMarketData(), engine.getExecutionService(),
+            engine.getProgressService(), engine.getPortfolioAllocator(), engine.getDataProcessor(),
+            engine.getStrategyManager(), engine.getResultCalculator());
+    };
+    auto free_run = run(TransactionCostConfig());
+    ASSERT_TRUE(free_run.isSuccess());
+    ASSERT_FALSE(free_run.getValue().transaction_costs.enabled);
+    ASSERT_FALSE(JsonHelpers::backTestResultToJson(free_run.getValue()).contains("transaction_costs"));
+    
+    TransactionCostConfig costs;
+    costs.spread_bps = 10.0;
+    costs.impact_coefficient = 0.1;
+    costs.commission_per_share = 0.005;
+    costs.max_participation_pct = 0.01;   // A few dozen shares a day on this universe
+    auto costed_run = run(costs);
+    ASSERT_TRUE(costed_run.isSuccess());
+    const auto& summary = costed_run.getValue().transaction_costs;
+    ASSERT_TRUE(free_run.getValue().total_trades > 0);
+    ASSERT_TRUE(summary.enabled);
+    ASSERT_TRUE(summary.commission > 0.0);
+    ASSERT_TRUE(summary.slippage > 0.0);
+    ASSERT_TRUE(summary.capped_orders > 0);
+    ASSERT_TRUE(summary.capped_shares > 0);
+    ASSERT_TRUE(JsonHelpers::backTestResultToJson(costed_run.getValue()).contains("transaction_costs"));
+    
+    costs.spread_bps = -5.0;
+    auto invalid_run = run(costs);
+    ASSERT_TRUE(invalid_run.isError());
+    ASSERT_TRUE(invalid_run.getError().code == ErrorCode::VALIDATION_INVALID_INPUT);
+    
+    std::cout << "[PASS]" << std::endl;
+}
+
+void test_execution_journal() {
+    std::cout << "Testing Memory-Mapped Execution Journal - " << std::flush;
+    
+    const std::string path = "/tmp/test_execution_journal_" + std::to_string(getpid()) + ".tejl";
+    
+    // Appends past the initial capacity grow the mapping; records keep their order
+    {
+        ExecutionJournal journal;
+        ASSERT_FALSE(journal.isOpen());
+        ASSERT_FALSE(journal.append(1, 0, 0, Signal::BUY, OrderKind::MARKET, OrderStatus::PENDING, 1, 1.0,
+                                    JournalReason::STRATEGY_SIGNAL));
+        ASSERT_TRUE(journal.open(path, {"AAA", std::string(40, 'X')}).getError().code ==
+                    ErrorCode::VALIDATION_INVALID_INPUT);
+        ASSERT_TRUE(journal.open(path, {"AAA", "BBB"}, 2).isSuccess());
+        ASSERT_TRUE(journal.isOpen());
+        const int32_t day = DateTimeUtils::daysFromCivil(2024, 1, 2);
+        for (int i = 0; i < 5; ++i) {
+            ASSERT_TRUE(journal.append(10 + i, i % 2, day + i, i % 2 == 0 ? Signal::BUY : Signal::SELL,
+                                       OrderKind::LIMIT, OrderStatus::FILLED, 100 * (i + 1), 50.0 + i,
+                                       JournalReason::RESTING_ORDER));
+        }
+        ASSERT_EQ(5, journal.getRecordCount());
+    }
+    
+    auto dump = ExecutionJournal::readJson(path);
+    ASSERT_TRUE(dump.isSuccess());
+    const auto& journal_json = dump.getValue();
+    ASSERT_EQ(std::string("execution_journal"), journal_json["type"].get<std::string>());
+    ASSERT_EQ(2, journal_json["symbols"].size());
+    ASSERT_EQ(5, journal_json["record_count"].get<int>());
+    const auto& event = journal_json["events"][3];
+    ASSERT_EQ(3, event["sequence"].get<int>());
+    ASSERT_EQ(13, event["order_id"].get<int>());
+    ASSERT_EQ(std::string("BBB"), event["symbol"].get<std::string>());
+    ASSERT_EQ(std::string("2024-01-05"), event["date"].get<std::string>());
+    ASSERT_EQ(std::string("SELL"), event["side"].get<std::string>());
+    ASSERT_EQ(std::string("LIMIT"), event["order_type"].get<std::string>());
+    ASSERT_EQ(std::string("FILLED"), event["status"].get<std::string>());
+    ASSERT_EQ(std::string("resting_order"), event["reason"].get<std::string>());
+    ASSERT_EQ(400, event["quantity"].get<int>());
+    ASSERT_TRUE(event["price"].get<double>() == 53.0);
+    
+    // Anything that is not a journal is refused
+    {
+        std::ofstream garbage(path, std::ios::binary | std::ios::trunc);
+        garbage << std::string(128, 'x');
+    }
+    ASSERT_TRUE(ExecutionJournal::readJson(path).getError().code == ErrorCode::SYSTEM_CONFIGURATION_ERROR);
+    std::remove(path.c_str());
+    ASSERT_TRUE(ExecutionJournal::readJson(path).getError().code == ErrorCode::SYSTEM_FILE_ACCESS_DENIED);
+    
+    // Caller-supplied book ids are kept and must be unique
+    OrderBook book;
+    ASSERT_EQ(7, book.place(Signal::BUY, OrderKind::LIMIT, 10.0, 1, "2024-01-02", 7).getValue());
+    ASSERT_TRUE(book.place(Signal::BUY, OrderKind::LIMIT, 11.0, 1, "2024-01-02", 7).isError());
+    ASSERT_EQ(8, book.place(Signal::BUY, OrderKind::LIMIT, 11.0, 1, "2024-01-02").getValue());
+    
+    // A backtest journals each order's placement and fill under one id
+    TradingConfig config;
+    config.symbols = {"AAA"};
+    config.start_date = "2024-01-02";
+    config.end_date = "2024-01-08";
+    config.starting_capital = 100000.0;
+    config.journal_path = path;
+    std::vector<PriceData> bars = {
+        PriceData(100.0, 101.0, 99.0, 100.0, 1000, "2024-01-02"),
+        PriceData(99.0, 100.0, 96.0, 97.0, 1000, "2024-01-03"),
+        PriceData(94.0, 96.0, 93.0, 95.0, 1000, "2024-01-04"),
+        PriceData(96.0, 104.0, 95.0, 103.0, 1000, "2024-01-05"),
+        PriceData(103.0, 106.0, 102.0, 105.0, 1000, "2024-01-08"),
+    };
+    auto bundle = std::make_shared<SimulationBundle>();
+    bundle->recordSymbolExists("AAA", true);
+    bundle->recordTemporalInfo("AAA", {{"symbol", "AAA"}, {"ipo_date", "2024-01-02"}, {"delisting_date", ""}});
+    bundle->recordPriceData("AAA", config.start_date, config.end_date, bars);
+    
+    TradingEngine engine(config.starting_capital);
+    engine.getStrategyManager()->setCurrentStrategy(std::make_unique<RestingOrderStrategy>());
+    engine.getMarketData()->setReplayBundle(bundle);
+    engine.getProgressService()->setProgressReporting(false);
+    auto backtest = engine.getTradingOrchestrator()->runBacktest(
+        config, engine.getPortfolio(), engine.getMarketData(), engine.getExecutionService(),
+        engine.getProgressService(), engine.getPortfolioAllocator(), engine.getDataProcessor(),
+        engine.getStrategyManager(), engine.getResultCalculator());
+    ASSERT_TRUE(backtest.isSuccess());
+    ASSERT_EQ(2, backtest.getValue().total_trades);
+    
+    auto run_dump = ExecutionJournal::readJson(path);
+    ASSERT_TRUE(run_dump.isSuccess());
+    const auto& events = run_dump.getValue()["events"];
+    ASSERT_EQ(4, events.size());
+    const std::vector<std::tuple<int, std::string, std::string, std::string>> expected = {
+        {1, "PLACED", "BUY", "2024-01-02"},
+        {1, "FILLED", "BUY", "2024-01-04"},
+        {2, "PLACED", "SELL", "2024-01-04"},
+        {2, "FILLED", "SELL", "2024-01-08"},
+    };
+    for (size_t i = 0; i < expected.size(); ++i) {
+        ASSERT_EQ(std::get<0>(expected[i]), events[i]["order_id"].get<int>());
+        ASSERT_EQ(std::get<1>(expected[i]), events[i]["status"].get<std::string>());
+        ASSERT_EQ(std::get<2>(expected[i]), events[i]["side"].get<std::string>());
+        ASSERT_EQ(std::get<3>(expected[i]), events[i]["date"].get<std::string>());
+        ASSERT_EQ(std::string("AAA"), events[i]["symbol"].get<std::string>());
+    }
+    ASSERT_TRUE(events[1]["price"].get<double>() == 94.0);
+    ASSERT_EQ(std::string("strategy_signal"), events[0]["reason"].get<std::string>());
+    ASSERT_EQ(std::string("resting_order"), events[3]["reason"].get<std::string>());
+    std::remove(path.c_str());
+    
+    // Resting sells that outgrow the position fill up to the shares held; the excess is journaled as cancelled
+    {
+        std::vector<PriceData> flat;
+        const int32_t flat_day = DateTimeUtils::daysFromCivil(2024, 1, 2);
+        for (int i = 0; i < 8; ++i) {
+            flat.emplace_back(100.0, i == 7 ? 120.0 : 101.0, 99.0, 100.0, 100000, PgBinary::formatDate(flat_day + i));
+        }
+        TradingConfig stacked_config = config;
+        stacked_config.end_date = flat.back().date;
+        auto stacked_bundle = std::make_shared<SimulationBundle>();
+        stacked_bundle->recordSymbolExists("AAA", true);
+        stacked_bundle->recordTemporalInfo("AAA", {{"symbol", "AAA"}, {"ipo_date", "2024-01-02"}, {"delisting_date", ""}});
+        stacked_bundle->recordPriceData("AAA", stacked_config.start_date, stacked_config.end_date, flat);
+        
+        TradingEngine stacked_engine(stacked_config.starting_capital);
+        stacked_engine.getStrategyManager()->setCurrentStrategy(std::make_unique<StackedSellStrategy>());
+        stacked_engine.getMarketData()->setReplayBundle(stacked_bundle);
+        stacked_engine.getProgressService()->setProgressReporting(false);
+        auto stacked = stacked_engine.getTradingOrchestrator()->runBacktest(
+            stacked_config, stacked_engine.getPortfolio(), stacked_engine.getMarketData(),
+            stacked_engine.getExecutionService(), stacked_engine.getProgressService(),
+            stacked_engine.getPortfolioAllocator(), stacked_engine.getDataProcessor(),
+            stacked_engine.getStrategyManager(), stacked_engine.getResultCalculator());
+        ASSERT_TRUE(stacked.isSuccess());
+        
+        auto stacked_dump = ExecutionJournal::readJson(path);
+        ASSERT_TRUE(stacked_dump.isSuccess());
+        int bought = 0;
+        int placed = 0;
+        int sold = 0;
+        int cancelled = 0;
+        for (const auto& stacked_event : stacked_dump.getValue()["events"]) {
+            const std::string status = stacked_event["status"].get<std::string>();
+            const int quantity = stacked_event["quantity"].get<int>();
+            if (stacked_event["side"].get<std::string>() == "BUY") {
+                bought += status == "FILLED" ? quantity : 0;
+            } else if (status == "PLACED") {
+                placed += quantity;
+            } else if (status == "FILLED") {
+                sold += quantity;
+                ASSERT_EQ(flat.back().date, stacked_event["date"].get<std::string>());
+            } else {
+                ASSERT_EQ(std::string("CANCELLED"), status);
+                ASSERT_EQ(std::string("insufficient_position"), stacked_event["reason"].get<std::string>());
+                ASSERT_EQ(flat.back().date, stacked_event["date"].get<std::string>());
+                cancelled += quantity;
+            }
+        }
+        ASSERT_TRUE(bought > 0 && placed > bought);
+        ASSERT_EQ(bought, sold);
+        ASSERT_EQ(placed - sold, cancelled);
+        ASSERT_FALSE(stacked_engine.getPortfolio().hasPosition("AAA"));
+        std::remove(path.c_str());
+    }
+    
+    std::cout << "[PASS]" << std::endl;
+}
+
+// Buys on every tenth bar and never sells, so its orders depend only on sizing and cash
+class AccumulatingStrategy : public TradingStrategy {
+public:
+    AccumulatingStrategy() : TradingStrategy("accumulate") {}
+    
+    TradingSignal evaluateSignal(const std::vector<PriceData>& price_data, const Portfolio& /*portfolio*/,
+                                 const std::string& /*symbol*/ = "") override {
+        if (price_data.size() % 10 != 0) {
+            return TradingSignal();
+        }
+        return TradingSignal(Signal::BUY, price_data.back().close, price_data.back().date, "Accumulate");
+    }
+    bool validateConfig() const override { return true; }
+    std::string getDescription() const override { return "Accumulating test strategy"; }
+    std::unique_ptr<TradingStrategy> clone() const override { return std::make_unique<AccumulatingStrategy>(); }
+};
+
+void test_sleeve_parallel_backtest() {
+    std::cout << "Testing Sleeve-Parallel Backtest Merge - " << std::flush;
+    
+    TradingConfig config;
+    config.strategy_name = "ma_crossover";
+    config.starting_capital = 1000000.0;
+    auto bundle = ScalingBenchmark::generateUniverse(4, 2, 23, config);
+    auto run = [&](const TradingConfig& run_config, std::unique_ptr<TradingStrategy> strategy = nullptr,
+                   AllocationStrategy allocation = AllocationStrategy::EQUAL_WEIGHT, bool rebalancing = true) {
+        TradingEngine engine(run_config.starting_capital);
+        auto* strategies = engine.getStrategyManager();
+        strategies->setCurrentStrategy(strategy ? std::move(strategy)
+                                                : std::move(strategies->createStrategyFromConfig(run_config).getValue()));
+        engine.getMarketData()->setReplayBundle(bundle);
+        engine.getProgressService()->setProgressReporting(false);
+        AllocationConfig allocation_config = engine.getPortfolioAllocator()->getConfig();
+        allocation_config.strategy = allocation;
+        allocation_config.enable_rebalancing = rebalancing;
+        engine.getPortfolioAllocator()->updateConfig(allocation_config);
+        return engine.getTradingOrchestrator()->runBacktest(
+            run_config, engine.getPortfolio(), engine.getMarketData(), engine.getExecutionService(),
+            engine.getProgressService(), engine.getPortfolioAllocator(), engine.getDataProcessor(),
+            engine.getStrategyManager(), engine.getResultCalculator());
+    };
+    
+    // Strategies copy with their parameters; custom ones without clone() opt out
+    auto moving_average = std::make_unique<MovingAverageCrossoverStrategy>(5, 15);
+    auto copy = moving_average->clone();
+    ASSERT_TRUE(copy != nullptr);
+    ASSERT_TRUE(dynamic_cast<MovingAverageCrossoverStrategy*>(copy.get())->getMovingAveragePeriods() ==
+                std::make_pair(5, 15));
+    ASSERT_TRUE(RestingOrderStrategy().clone() == nullptr);
+    
+    TradingConfig sleeve_config = config;
+    sleeve_config.sleeve_parallel = true;
+    sleeve_config.sleeve_threads = 3;
+    auto parallel = run(sleeve_config);
+    ASSERT_TRUE(parallel.isSuccess());
+    const auto& merged = parallel.getValue();
+    ASSERT_TRUE(merged.total_trades > 0);
+    ASSERT_EQ(merged.equity_curve.size(), 2 * 252 + 1);
+    ASSERT_TRUE(std::is_sorted(merged.round_trips.begin(), merged.round_trips.end(),
+                               [](const RoundTrip& a, const RoundTrip& b) { return a.exit_date < b.exit_date; }));
+    
+    int symbol_trades = 0;
+    for (const auto& symbol : config.symbols) {
+        symbol_trades += merged.symbol_performance.at(symbol).trades_count;
+    }
+    ASSERT_EQ(merged.total_trades, symbol_trades);
+    
+    // Sleeves size trades against the whole starting capital: where cash never binds, the merge
+    // places the same orders as the shared loop and ends at the same value
+    auto shared = run(config, std::make_unique<AccumulatingStrategy>(), AllocationStrategy::EQUAL_WEIGHT, false);
+    auto sleeved = run(sleeve_config, std::make_unique<AccumulatingStrategy>(), AllocationStrategy::EQUAL_WEIGHT, false);
+    ASSERT_TRUE(shared.isSuccess());
+    ASSERT_TRUE(sleeved.isSuccess());
+    ASSERT_TRUE(shared.getValue().total_trades > 0);
+    ASSERT_EQ(shared.getValue().total_trades, sleeved.getValue().total_trades);
+    for (const auto& symbol : config.symbols) {
+        ASSERT_EQ(shared.getValue().symbol_performance.at(symbol).trades_count,
+                  sleeved.getValue().symbol_performance.at(symbol).trades_count);
+    }
+    ASSERT_EQ(shared.getValue().equity_curve.size(), sleeved.getValue().equity_curve.size());
+    for (size_t i = 0; i < shared.getValue().equity_curve.size(); ++i) {
+        ASSERT_NEAR(shared.getValue().equity_curve[i], sleeved.getValue().equity_curve[i], 1e-6);
+    }
+    ASSERT_NEAR(shared.getValue().ending_value, sleeved.getValue().ending_value, 1e-6);
+    
+    // The thread count does not change the result
+    sleeve_config.sleeve_threads = 1;
+    auto serial = run(sleeve_config);
+    ASSERT_TRUE(serial.isSuccess());
+    ASSERT_TRUE(serial.getValue().ending_value == merged.ending_value);
+    ASSERT_TRUE(serial.getValue().equity_curve == merged.equity_curve);
+    
+    // Allocations that couple the symbols, and strategies that cannot be copied, are refused
+    auto coupled = run(sleeve_config, nullptr, AllocationStrategy::RISK_PARITY);
+    ASSERT_TRUE(coupled.getError().code == ErrorCode::VALIDATION_INVALID_INPUT);
+    auto uncopyable = run(sleeve_config, std::make_unique<RestingOrderStrategy>());
+    ASSERT_TRUE(uncopyable.getError().code == ErrorCode::ENGINE_NO_STRATEGY_CONFIGURED);
+    
+    // Per-run outputs that a sleeve cannot feed on its own are refused rather than dropped
+    TradingConfig journaled = sleeve_config;
+    journaled.journal_path = "/tmp/test_sleeve_journal_" + std::to_string(getpid()) + ".tejl";
+    ASSERT_TRUE(run(journaled).getError().code == ErrorCode::VALIDATION_INVALID_INPUT);
+    TradingConfig observed = sleeve_config;
+    observed.progress_shm_path = "/tmp/test_sleeve_progress_" + std::to_string(getpid()) + ".shm";
+    ASSERT_TRUE(run(observed).getError().code == ErrorCode::VALIDATION_INVALID_INPUT);
+    std::remove(journaled.journal_path.c_str());
+    std::remove(observed.progress_shm_path.c_str());
+    
+    // Sleeve sells are sized against the sleeve's value scaled to the whole portfolio: with identical
+    // symbols and no cash reserve, buying and selling runs match the shared loop
+    {
+        std::vector<PriceData> bars;
+        const int32_t first_day = DateTimeUtils::daysFromCivil(2023, 1, 2);
+        for (int i = 0; i < 200; ++i) {
+            double close = 100.0 + 10.0 * std::sin(i / 8.0) + i * 0.05;
+            bars.emplace_back(close - 0.5, close + 1.0, close - 1.0, close, 1000000, PgBinary::formatDate(first_day + i));
+        }
+        TradingConfig twins_config;
+        twins_config.symbols = {"T1", "T2", "T3", "T4"};
+        twins_config.start_date = bars.front().date;
+        twins_config.end_date = bars.back().date;
+        twins_config.starting_capital = 1000000.0;
+        auto twins = std::make_shared<SimulationBundle>();
+        for (const auto& symbol : twins_config.symbols) {
+            twins->recordSymbolExists(symbol, true);
+            twins->recordTemporalInfo(symbol, {{"symbol", symbol}, {"ipo_date", "2000-01-03"}, {"delisting_date", ""}});
+            twins->recordPriceData(symbol, twins_config.start_date, twins_config.end_date, bars);
+        }
+        auto run_twins = [&](const TradingConfig& run_config) {
+            TradingEngine engine(run_config.starting_capital);
+            engine.getStrategyManager()->setCurrentStrategy(std::make_unique<MovingAverageCrossoverStrategy>(5, 15));
+            engine.getMarketData()->setReplayBundle(twins);
+            engine.getProgressService()->setProgressReporting(false);
+            AllocationConfig allocation_config = engine.getPortfolioAllocator()->getConfig();
+            allocation_config.strategy = AllocationStrategy::EQUAL_WEIGHT;
+            allocation_config.enable_rebalancing = false;
+            allocation_config.cash_reserve_pct = 0.0;
+            engine.getPortfolioAllocator()->updateConfig(allocation_config);
+            return engine.getTradingOrchestrator()->runBacktest(
+                run_config, engine.getPortfolio(), engine.getMarketData(), engine.getExecutionService(),
+                engine.getProgressService(), engine.getPortfolioAllocator(), engine.getDataProcessor(),
+                engine.getStrategyManager(), engine.getResultCalculator());
+        };
+        TradingConfig twins_sleeved = twins_config;
+        twins_sleeved.sleeve_parallel = true;
+        auto shared_twins = run_twins(twins_config);
+        auto sleeved_twins = run_twins(twins_sleeved);
+        ASSERT_TRUE(shared_twins.isSuccess());
+        ASSERT_TRUE(sleeved_twins.isSuccess());
+        int sells = 0;
+        for (const auto& signal : shared_twins.getValue().signals_generated) {
+            sells += signal.signal == Signal::SELL ? 1 : 0;
+        }
+        ASSERT_TRUE(sells > 0);
+        ASSERT_EQ(shared_twins.getValue().total_trades, sleeved_twins.getValue().total_trades);
+        ASSERT_EQ(shared_twins.getValue().round_trips.size(), sleeved_twins.getValue().round_trips.size());
+        ASSERT_NEAR(shared_twins.getValue().ending_value, sleeved_twins.getValue().ending_value, 1e-6);
+    }
+    
+    std::cout << "[PASS]" << std::endl;
+}
+
 int main() {
     // Redirect stderr to suppress verbose logs during tests
     std::streambuf* orig_cerr = std::cerr.rdbuf();
@@ -1383,6 +3657,30 @@ int main() {
         test_technical_indicators_detailed();
         test_trading_strategy_detailed();
         test_service_component_integration();
+        test_streaming_metrics();
+        test_rolling_metrics();
+        test_trade_ledger();
+        test_covariance_matrix();
+        test_batched_rebalancing();
+        test_allocator_dense_weights();
+        test_progress_channel();
+        test_cancellation_token();
+        test_parse_config_json();
+        test_result_file();
+        test_query_cursor();
+        test_price_snapshot();
+        test_market_catalog();
+        test_async_query_executor();
+        test_fast_parsing();
+        test_lazy_services();
+        test_simulation_bundle();
+        test_allocator_reset_state();
+        test_scaling_benchmark();
+        test_trading_calendar();
+        test_order_book();
+        test_transaction_cost_model();
+        test_execution_journal();
+        test_sleeve_parallel_backtest();
         std::cout << std::endl;
         
         // Summary
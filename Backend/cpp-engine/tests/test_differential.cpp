@@ -0,0 +1,460 @@
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+#include <nlohmann/json.hpp>
+
+#include "argument_parser.h"
+#include "date_time_utils.h"
+#include "logger.h"
+#include "query_cursor.h"
+#include "result_calculator.h"
+#include "simulation_bundle.h"
+#include "trading_engine.h"
+
+// Differential harness: randomized synthetic markets and configs are run
+// through the reference simulation loop and through every alternative
+// engine path, and the results must agree within the tolerances below.
+// Scenarios are replayed from in-memory SimulationBundles, so no database
+// is needed. ./test_differential [scenarios] [seed] reruns any failure.
+//
+// To cover a new optimized path, add a Variant to variants(): it receives
+// the scenario and returns the BacktestResult that path produces.
+
+namespace {
+
+const size_t DEFAULT_SCENARIOS = 100;
+const uint64_t DEFAULT_SEED = 20240601;
+
+// Floating point fields may differ by summation order, nothing more
+const double RELATIVE_TOLERANCE = 1e-9;
+const double ABSOLUTE_TOLERANCE = 1e-9;
+
+struct Scenario {
+    uint64_t seed = 0;
+    TradingConfig config;
+    std::shared_ptr<SimulationBundle> bundle;
+};
+
+struct Variant {
+    std::string name;
+    bool retains_equity_curve;
+    std::function<Result<BacktestResult>(const Scenario&)> run;
+};
+
+// Collects mismatches as "field: a vs b" lines
+class Diff {
+public:
+    void number(const std::string& field, double a, double b) {
+        if (std::isnan(a) && std::isnan(b)) {
+            return;
+        }
+        double scale = std::max(std::abs(a), std::abs(b));
+        if (!(std::abs(a - b) <= std::max(ABSOLUTE_TOLERANCE, RELATIVE_TOLERANCE * scale))) {
+            add(field, a, b);
+        }
+    }
+
+    template<typename T>
+    void exact(const std::string& field, const T& a, const T& b) {
+        if (!(a == b)) {
+            add(field, a, b);
+        }
+    }
+
+    void series(const std::string& field, const std::vector<double>& a, const std::vector<double>& b) {
+        exact(field + ".size", a.size(), b.size());
+        for (size_t i = 0; i < std::min(a.size(), b.size()); ++i) {
+            number(field + "[" + std::to_string(i) + "]", a[i], b[i]);
+        }
+    }
+
+    bool empty() const { return lines_.empty(); }
+    const std::vector<std::string>& lines() const { return lines_; }
+
+private:
+    std::vector<std::string> lines_;
+
+    template<typename T>
+    void add(const std::string& field, const T& a, const T& b) {
+        // The first mismatches locate a drift; hundreds more add nothing
+        if (lines_.size() < 20) {
+            std::ostringstream line;
+            line.precision(17);
+            line << field << ": " << a << " vs " << b;
+            lines_.push_back(line.str());
+        }
+    }
+};
+
+std::string businessDate(int32_t first_day, int index) {
+    // 1970-01-01 was a Thursday; skip Saturdays and Sundays
+    int32_t day = first_day;
+    for (int remaining = index; remaining > 0;) {
+        ++day;
+        int weekday = ((day % 7) + 7 + 3) % 7;  // 0 = Monday
+        if (weekday < 5) {
+            --remaining;
+        }
+    }
+    return PgBinary::formatDate(day);
+}
+
+Scenario makeScenario(uint64_t seed) {
+    std::mt19937_64 rng(seed);
+    auto uniform = [&rng](double low, double high) { return std::uniform_real_distribution<double>(low, high)(rng); };
+    auto integer = [&rng](int low, int high) { return std::uniform_int_distribution<int>(low, high)(rng); };
+    std::normal_distribution<double> normal(0.0, 1.0);
+
+    Scenario scenario;
+    scenario.seed = seed;
+    scenario.bundle = std::make_shared<SimulationBundle>();
+    TradingConfig& config = scenario.config;
+
+    const int days = integer(60, 320);
+    const int32_t first_day = DateTimeUtils::daysFromCivil(2021, 1, 4);  // A Monday
+    std::vector<std::string> dates(days);
+    for (int i = 0; i < days; ++i) {
+        dates[i] = businessDate(first_day, i);
+    }
+
+    config.symbols.clear();
+    config.start_date = dates.front();
+    config.end_date = dates.back();
+    config.starting_capital = std::round(uniform(5000.0, 200000.0));
+    config.retain_equity_curve = true;
+    config.rolling_windows.clear();
+    for (int window : {5, 20, 63}) {
+        if (integer(0, 2) == 0) {
+            config.rolling_windows.push_back(window);
+        }
+    }
+    config.underwater_curve = integer(0, 1) == 1;
+
+    if (integer(0, 1) == 0) {
+        config.strategy_name = "ma_crossover";
+        int short_ma = integer(3, 15);
+        config.setParameter("short_ma", short_ma);
+        config.setParameter("long_ma", short_ma + integer(5, 45));
+    } else {
+        config.strategy_name = "rsi";
+        config.setParameter("rsi_period", integer(5, 20));
+        config.setParameter("rsi_oversold", integer(20, 40));
+        config.setParameter("rsi_overbought", integer(60, 80));
+    }
+
+    const int symbol_count = integer(1, 4);
+    for (int s = 0; s < symbol_count; ++s) {
+        const std::string symbol = "SYN" + std::to_string(s);
+        config.symbols.push_back(symbol);
+
+        // Late listings, early data ends and regime changes in drift and volatility
+        int listed = integer(0, 3) == 0 ? integer(1, days / 4) : 0;
+        int last = integer(0, 3) == 0 ? days - 1 - integer(1, days / 4) : days - 1;
+        int delisted = integer(0, 4) == 0 ? last - integer(0, 5) : -1;
+
+        std::vector<PriceData> bars;
+        double close = uniform(5.0, 500.0);
+        double drift = uniform(-0.002, 0.002);
+        double volatility = uniform(0.005, 0.04);
+        for (int i = listed; i <= last; ++i) {
+            if (integer(0, 39) == 0) {
+                drift = uniform(-0.004, 0.004);
+                volatility = uniform(0.005, 0.05);
+            }
+            double open = close * (1.0 + 0.25 * volatility * normal(rng));
+            close = std::max(0.5, close * std::exp(drift + volatility * normal(rng)));
+            double high = std::max(open, close) * (1.0 + uniform(0.0, volatility));
+            double low = std::min(open, close) * (1.0 - uniform(0.0, volatility));
+            bars.emplace_back(open, high, low, close, integer(1000, 5000000), dates[i]);
+        }
+
+        auto& bundle = *scenario.bundle;
+        bundle.recordSymbolExists(symbol, true);
+        bundle.recordTemporalInfo(symbol, {{"symbol", symbol}, {"ipo_date", dates[listed]},
+                                           {"delisting_date", delisted >= 0 ? dates[delisted] : ""}});
+        bundle.recordPriceData(symbol, config.start_date, config.end_date, bars);
+        for (int i = listed; i <= last; ++i) {
+            bundle.recordTradeable(symbol, dates[i], delisted < 0 || i < delisted);
+        }
+    }
+
+    scenario.bundle->setConfigJson(ArgumentParser().configToJson(config).dump());
+    return scenario;
+}
+
+// The engine exactly as the CLI wires it, reading the scenario's bundle
+Result<BacktestResult> runBacktest(TradingEngine& engine, const TradingConfig& config,
+                                   const std::shared_ptr<SimulationBundle>& bundle) {
+    auto strategy = engine.getStrategyManager()->createStrategyFromConfig(config);
+    if (strategy.isError()) {
+        return Result<BacktestResult>(strategy.getError());
+    }
+    engine.getStrategyManager()->setCurrentStrategy(std::move(strategy.getValue()));
+    engine.getMarketData()->setReplayBundle(bundle);
+    engine.getProgressService()->setProgressReporting(false);
+    return engine.getTradingOrchestrator()->runBacktest(
+        config, engine.getPortfolio(), engine.getMarketData(), engine.getExecutionService(),
+        engine.getProgressService(), engine.getPortfolioAllocator(), engine.getDataProcessor(),
+        engine.getStrategyManager(), engine.getResultCalculator());
+}
+
+Result<BacktestResult> runReference(const Scenario& scenario) {
+    TradingEngine engine(scenario.config.starting_capital);
+    return runBacktest(engine, scenario.config, scenario.bundle);
+}
+
+std::vector<Variant> variants() {
+    return {
+        // Metrics from the streaming accumulators only, no equity curve kept
+        {"streaming_metrics", false, [](const Scenario& scenario) {
+            TradingConfig config = scenario.config;
+            config.retain_equity_curve = false;
+            TradingEngine engine(config.starting_capital);
+            return runBacktest(engine, config, scenario.bundle);
+        }},
+        // Inputs written to a bundle file and read back, as --capture/--replay do
+        {"bundle_file_replay", true, [](const Scenario& scenario) {
+            const std::string path = "/tmp/test_differential_" + std::to_string(::getpid()) + ".bundle";
+            auto saved = scenario.bundle->save(path);
+            if (saved.isError()) {
+                return Result<BacktestResult>(saved.getError());
+            }
+            auto loaded = SimulationBundle::load(path);
+            std::remove(path.c_str());
+            if (loaded.isError()) {
+                return Result<BacktestResult>(loaded.getError());
+            }
+            TradingConfig config = ArgumentParser().parseConfigJson(
+                nlohmann::json::parse(loaded.getValue()->getConfigJson()));
+            TradingEngine engine(config.starting_capital);
+            return runBacktest(engine, config, loaded.getValue());
+        }},
+        // Second run on the same engine: no state may leak between runs
+        {"engine_reuse", true, [](const Scenario& scenario) {
+            TradingEngine engine(scenario.config.starting_capital);
+            auto first = runBacktest(engine, scenario.config, scenario.bundle);
+            if (first.isError()) {
+                return first;
+            }
+            return runBacktest(engine, scenario.config, scenario.bundle);
+        }},
+    };
+}
+
+void compareResults(const BacktestResult& a, const BacktestResult& b, bool compare_curve, Diff& diff) {
+    diff.exact("symbols.size", a.symbols.size(), b.symbols.size());
+    for (size_t i = 0; i < std::min(a.symbols.size(), b.symbols.size()); ++i) {
+        diff.exact("symbols[" + std::to_string(i) + "]", a.symbols[i], b.symbols[i]);
+    }
+    diff.number("starting_capital", a.starting_capital, b.starting_capital);
+    diff.number("ending_value", a.ending_value, b.ending_value);
+    diff.number("total_return_pct", a.total_return_pct, b.total_return_pct);
+    diff.number("cash_remaining", a.cash_remaining, b.cash_remaining);
+    diff.exact("total_trades", a.total_trades, b.total_trades);
+    diff.exact("winning_trades", a.winning_trades, b.winning_trades);
+    diff.exact("losing_trades", a.losing_trades, b.losing_trades);
+    diff.number("win_rate", a.win_rate, b.win_rate);
+    diff.number("max_drawdown", a.max_drawdown, b.max_drawdown);
+    diff.number("sharpe_ratio", a.sharpe_ratio, b.sharpe_ratio);
+    diff.number("sortino_ratio", a.sortino_ratio, b.sortino_ratio);
+    diff.number("volatility", a.volatility, b.volatility);
+    diff.number("profit_factor", a.profit_factor, b.profit_factor);
+    diff.number("average_win", a.average_win, b.average_win);
+    diff.number("average_loss", a.average_loss, b.average_loss);
+    diff.number("annualized_return", a.annualized_return, b.annualized_return);
+    diff.exact("signals_generated_count", a.signals_generated_count, b.signals_generated_count);
+    diff.number("portfolio_diversification_ratio", a.portfolio_diversification_ratio, b.portfolio_diversification_ratio);
+    diff.exact("truncated", a.truncated, b.truncated);
+
+    if (compare_curve) {
+        diff.series("equity_curve", a.equity_curve, b.equity_curve);
+    }
+    diff.series("underwater_curve", a.underwater_curve, b.underwater_curve);
+    diff.exact("rolling_metrics.size", a.rolling_metrics.size(), b.rolling_metrics.size());
+    for (size_t i = 0; i < std::min(a.rolling_metrics.size(), b.rolling_metrics.size()); ++i) {
+        const std::string prefix = "rolling[" + std::to_string(a.rolling_metrics[i].window) + "].";
+        diff.exact(prefix + "window", a.rolling_metrics[i].window, b.rolling_metrics[i].window);
+        diff.series(prefix + "sharpe_ratio", a.rolling_metrics[i].sharpe_ratio, b.rolling_metrics[i].sharpe_ratio);
+        diff.series(prefix + "volatility", a.rolling_metrics[i].volatility, b.rolling_metrics[i].volatility);
+        diff.series(prefix + "drawdown_pct", a.rolling_metrics[i].drawdown_pct, b.rolling_metrics[i].drawdown_pct);
+    }
+
+    diff.exact("signals.size", a.signals_generated.size(), b.signals_generated.size());
+    for (size_t i = 0; i < std::min(a.signals_generated.size(), b.signals_generated.size()); ++i) {
+        const auto& x = a.signals_generated[i];
+        const auto& y = b.signals_generated[i];
+        const std::string prefix = "signals[" + std::to_string(i) + "].";
+        diff.exact(prefix + "signal", static_cast<int>(x.signal), static_cast<int>(y.signal));
+        diff.exact(prefix + "symbol", x.symbol, y.symbol);
+        diff.exact(prefix + "date", x.date, y.date);
+        diff.exact(prefix + "reason", x.reason, y.reason);
+        diff.number(prefix + "price", x.price, y.price);
+        diff.number(prefix + "confidence", x.confidence, y.confidence);
+    }
+
+    diff.exact("round_trips.size", a.round_trips.size(), b.round_trips.size());
+    for (size_t i = 0; i < std::min(a.round_trips.size(), b.round_trips.size()); ++i) {
+        const auto& x = a.round_trips[i];
+        const auto& y = b.round_trips[i];
+        const std::string prefix = "round_trips[" + std::to_string(i) + "].";
+        diff.exact(prefix + "symbol", x.symbol, y.symbol);
+        diff.exact(prefix + "shares", x.shares, y.shares);
+        diff.exact(prefix + "entry_date", x.entry_date, y.entry_date);
+        diff.exact(prefix + "exit_date", x.exit_date, y.exit_date);
+        diff.exact(prefix + "holding_bars", x.holding_bars, y.holding_bars);
+        diff.number(prefix + "entry_price", x.entry_price, y.entry_price);
+        diff.number(prefix + "exit_price", x.exit_price, y.exit_price);
+        diff.number(prefix + "pnl", x.pnl, y.pnl);
+        diff.number(prefix + "return_pct", x.return_pct, y.return_pct);
+        diff.number(prefix + "mae_pct", x.mae_pct, y.mae_pct);
+        diff.number(prefix + "mfe_pct", x.mfe_pct, y.mfe_pct);
+    }
+
+    diff.exact("symbol_performance.size", a.symbol_performance.size(), b.symbol_performance.size());
+    for (const auto& [symbol, x] : a.symbol_performance) {
+        auto it = b.symbol_performance.find(symbol);
+        if (it == b.symbol_performance.end()) {
+            diff.exact("symbol_performance." + symbol, std::string("present"), std::string("missing"));
+            continue;
+        }
+        const auto& y = it->second;
+        const std::string prefix = "symbol_performance." + symbol + ".";
+        diff.exact(prefix + "trades_count", x.trades_count, y.trades_count);
+        diff.exact(prefix + "winning_trades", x.winning_trades, y.winning_trades);
+        diff.exact(prefix + "losing_trades", x.losing_trades, y.losing_trades);
+        diff.number(prefix + "win_rate", x.win_rate, y.win_rate);
+        diff.number(prefix + "total_return_pct", x.total_return_pct, y.total_return_pct);
+        diff.number(prefix + "symbol_allocation_pct", x.symbol_allocation_pct, y.symbol_allocation_pct);
+        diff.number(prefix + "final_position_value", x.final_position_value, y.final_position_value);
+        diff.exact(prefix + "signals.size", x.symbol_signals.size(), y.symbol_signals.size());
+    }
+}
+
+// Streaming metrics against the batch formulas applied to the retained curve
+void checkReferenceProperties(const BacktestResult& result, Diff& diff) {
+    const auto& curve = result.equity_curve;
+    if (curve.empty()) {
+        diff.exact("equity_curve.empty", false, true);
+        return;
+    }
+    ResultCalculator batch;
+    diff.number("equity_curve.front == starting_capital", curve.front(), result.starting_capital);
+    diff.number("equity_curve.back == ending_value", curve.back(), result.ending_value);
+    diff.number("batch max_drawdown", batch.calculateMaxDrawdown(curve), result.max_drawdown);
+    diff.number("batch sharpe_ratio", batch.calculateSharpeRatio(batch.calculateDailyReturns(curve)), result.sharpe_ratio);
+    diff.exact("closed trades <= trades", result.round_trips.size() <= static_cast<size_t>(result.total_trades), true);
+
+    // Rolling series recomputed naively over each trailing window
+    for (const auto& rolling : result.rolling_metrics) {
+        const size_t window = static_cast<size_t>(rolling.window);
+        const std::string prefix = "naive rolling[" + std::to_string(window) + "].";
+        diff.exact(prefix + "size", rolling.volatility.size(), curve.size());
+        for (size_t k = window; k < std::min(curve.size(), rolling.volatility.size()); ++k) {
+            double sum = 0.0;
+            double window_high = curve[k - window];
+            for (size_t j = k - window + 1; j <= k; ++j) {
+                sum += (curve[j] - curve[j - 1]) / curve[j - 1];
+                window_high = std::max(window_high, curve[j]);
+            }
+            double mean = sum / window;
+            double variance = 0.0;
+            for (size_t j = k - window + 1; j <= k; ++j) {
+                double r = (curve[j] - curve[j - 1]) / curve[j - 1] - mean;
+                variance += r * r;
+            }
+            double annualized_std = std::sqrt(variance / window) * std::sqrt(252.0);
+            // Rolling sums are re-accumulated every window, so allow their rounding
+            const double tolerance = 1e-6;
+            if (std::abs(annualized_std * 100.0 - rolling.volatility[k]) > tolerance) {
+                diff.number(prefix + "volatility[" + std::to_string(k) + "]", annualized_std * 100.0, rolling.volatility[k]);
+            }
+            diff.number(prefix + "drawdown_pct[" + std::to_string(k) + "]",
+                        (curve[k] / window_high - 1.0) * 100.0, rolling.drawdown_pct[k]);
+        }
+    }
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    const size_t scenarios = argc > 1 ? static_cast<size_t>(std::strtoull(argv[1], nullptr, 10)) : DEFAULT_SCENARIOS;
+    const uint64_t base_seed = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : DEFAULT_SEED;
+
+    Logger::setEnabled(false);
+
+    std::cout << "\n Trading Engine Differential Tests" << std::endl;
+    std::cout << "Scenarios: " << scenarios << ", base seed: " << base_seed << std::endl;
+
+    const auto paths = variants();
+    size_t comparisons = 0;
+    size_t failures = 0;
+    size_t total_trades = 0;
+
+    for (size_t i = 0; i < scenarios; ++i) {
+        const uint64_t seed = base_seed + i;
+        Scenario scenario = makeScenario(seed);
+
+        auto reference = runReference(scenario);
+        if (reference.isError()) {
+            std::cout << "FAIL seed " << seed << ": reference run failed: " << reference.getErrorMessage() << std::endl;
+            ++failures;
+            continue;
+        }
+        total_trades += static_cast<size_t>(reference.getValue().total_trades);
+
+        Diff properties;
+        checkReferenceProperties(reference.getValue(), properties);
+        ++comparisons;
+        if (!properties.empty()) {
+            ++failures;
+            std::cout << "FAIL seed " << seed << " [reference properties]" << std::endl;
+            for (const auto& line : properties.lines()) {
+                std::cout << "  " << line << std::endl;
+            }
+        }
+
+        for (const auto& path : paths) {
+            auto candidate = path.run(scenario);
+            ++comparisons;
+            if (candidate.isError()) {
+                ++failures;
+                std::cout << "FAIL seed " << seed << " [" << path.name << "]: " << candidate.getErrorMessage() << std::endl;
+                continue;
+            }
+            Diff diff;
+            compareResults(reference.getValue(), candidate.getValue(), path.retains_equity_curve, diff);
+            if (!path.retains_equity_curve && !candidate.getValue().equity_curve.empty()) {
+                diff.exact("equity_curve.size", size_t(0), candidate.getValue().equity_curve.size());
+            }
+            if (!diff.empty()) {
+                ++failures;
+                std::cout << "FAIL seed " << seed << " [" << path.name << "]" << std::endl;
+                for (const auto& line : diff.lines()) {
+                    std::cout << "  " << line << std::endl;
+                }
+            }
+        }
+    }
+
+    std::cout << "\nDifferential Results Summary:" << std::endl;
+    std::cout << "Comparisons run: " << comparisons << " (" << paths.size() << " engine paths, "
+              << total_trades << " reference trades)" << std::endl;
+    std::cout << "Comparisons failed: " << failures << std::endl;
+    if (failures == 0) {
+        std::cout << "\n[SUCCESS] All engine paths agree with the reference loop" << std::endl;
+        return 0;
+    }
+    std::cout << "\n[FAILURE] Rerun one scenario with: ./test_differential 1 <seed>" << std::endl;
+    return 1;
+}